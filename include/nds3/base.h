@@ -236,8 +236,8 @@ public:
     /**
      * @brief Create and run a thread using the control system facilities.
      *
-     * If the control system does not provide any thread facility then a std::thread
-     *  is created and executed.
+     * If the control system does not provide any thread facility then the function
+     *  is executed by a thread taken from the factory's thread pool.
      *
      * @param name     the name given to the thread
      * @param function the function to execute in the thread
@@ -245,12 +245,38 @@ public:
      */
     Thread runInThread(const std::string& name, threadFunction_t function);
 
+    /**
+     * @brief Create and run a thread using the control system facilities, with the
+     *        thread attributes configured for the task class
+     *        (see Factory::setTaskClassAttributes()).
+     *
+     * @param name      the name given to the thread
+     * @param taskClass the task class
+     * @param function  the function to execute in the thread
+     * @return          a Thread object referencing the new thread
+     */
+    Thread runInThread(const std::string& name, const taskClass_t taskClass, threadFunction_t function);
+
+    /**
+     * @brief Create and run a thread with the specified attributes (CPU affinity,
+     *        scheduling policy and priority, stack size, memory locking).
+     *
+     * The attributes that cannot be applied are left to the system defaults:
+     *  call Thread::getAppliedAttributes() to know which ones are in effect.
+     *
+     * @param name       the name given to the thread
+     * @param attributes the thread attributes
+     * @param function   the function to execute in the thread
+     * @return           a Thread object referencing the new thread
+     */
+    Thread runInThread(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
     /**
      * @brief Create and run a thread using the control system facilities. The created
      *        thread will have the node's name.
      *
-     * If the control system does not provide any thread facility then a std::thread
-     *  is created and executed.
+     * If the control system does not provide any thread facility then the function
+     *  is executed by a thread taken from the factory's thread pool.
      *
      * @param function the function to execute in the thread
      * @return         a Thread object referencing the new thread
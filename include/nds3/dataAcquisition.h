@@ -19,8 +19,10 @@
  * necessary header files (including this one).
  */
 
+#include <type_traits>
 #include "nds3/definitions.h"
 #include "nds3/node.h"
+#include "nds3/sharedBuffer.h"
 
 namespace nds
 {
@@ -38,6 +40,14 @@ namespace nds
  *  the data acquisition thread which pushes the acquired data via pushData(),
  *  while the transition from running to on should stop the data acquisition thread.
  *
+ * The arrays pushed to the control system can be reduced in size: the PV
+ *  ReductionMode selects the reduction (see reductionMode_t) and the PV
+ *  ReductionFactor the number of samples in each reduced group. The PVs
+ *  subscribed to the data PV and the replication destinations always receive
+ *  the full arrays. As for the decimation, the reduction settings are applied
+ *  when the acquisition starts: an unknown reduction mode rolls the state
+ *  machine back to the state on.
+ *
  * @tparam T  the PV data type.
  *            The following data types are supported:
  *            - std::int32_t
@@ -47,6 +57,14 @@ namespace nds
  *            - std::vector<std::int32_t>
  *            - std::vector<double>
  *            - std::string
+ *            - std::int16_t
+ *            - std::uint16_t
+ *            - std::int64_t
+ *            - float
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
  *
  */
 template <typename T>
@@ -105,6 +123,57 @@ public:
      */
     void push(const timespec& timestamp, const T& data);
 
+    /**
+     * @ingroup datareadwrite
+     * @brief Push acquired data held in a shared buffer to the control system.
+     *
+     * The buffer reaches the control system interface by reference, so the
+     *  data is not copied while it travels through NDS.
+     * Use a SharedBufferPool to avoid allocating a new buffer for each push.
+     *
+     * The content of the buffer must not be modified after the push.
+     *
+     * @param timestamp the timestamp for the data
+     * @param data      the buffer holding the data to push to the control system
+     */
+    void push(const timespec& timestamp, const SharedBuffer<T>& data);
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Convert raw samples (e.g. ADC counts) to engineering units and
+     *        push them to the control system.
+     *
+     * Each sample is converted to raw * Amplitude + Offset, where Amplitude
+     *  and Offset are the values of the node's PVs, directly into a buffer
+     *  reused by all the pushes. The conversion uses the SIMD instructions
+     *  available on the CPU.
+     *
+     * Available only for DataAcquisition<std::vector<double> >: calling it
+     *  on the other data types does not compile.
+     *
+     * @tparam U        the node's data type, must be left to its default
+     * @param timestamp the timestamp for the data
+     * @param rawData   the raw samples
+     */
+    template<typename U = T>
+    typename std::enable_if<std::is_same<U, std::vector<double> >::value>::type
+    pushRaw(const timespec& timestamp, const std::vector<std::int16_t>& rawData);
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Convert raw samples (e.g. ADC counts) to engineering units and
+     *        push them to the control system.
+     *
+     * See pushRaw(const timespec&, const std::vector<std::int16_t>&).
+     *
+     * @tparam U        the node's data type, must be left to its default
+     * @param timestamp the timestamp for the data
+     * @param rawData   the raw samples
+     */
+    template<typename U = T>
+    typename std::enable_if<std::is_same<U, std::vector<double> >::value>::type
+    pushRaw(const timespec& timestamp, const std::vector<std::int32_t>& rawData);
+
     /**
      * @brief Retrieve the desidered acquisition frequency, in Hertz.
      *
@@ -148,6 +217,22 @@ public:
      */
     size_t getDecimation();
 
+    /**
+     * @brief Retrieve the desidered reduction of the arrays pushed to the
+     *        control system.
+     *
+     * @return the reduction mode
+     */
+    reductionMode_t getReductionMode();
+
+    /**
+     * @brief Retrieve the desidered number of samples in each group reduced
+     *        by the reduction mode.
+     *
+     * @return the reduction factor
+     */
+    size_t getReductionFactor();
+
     /**
      * @brief Retrieve the desidered sampling mode value.
      *
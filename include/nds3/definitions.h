@@ -59,7 +59,15 @@ enum class dataType_t
     dataUint8Array,   ///< Array of unsigned 8 bit integers
     dataInt32Array,   ///< Array of signed 32 bit integers
     dataFloat64Array, ///< Array of 64 bit floats
-    dataString        ///< String
+    dataString,       ///< String
+    dataInt16,        ///< Signed integer, 16 bits
+    dataUint16,       ///< Unsigned integer, 16 bits
+    dataInt64,        ///< Signed integer, 64 bits
+    dataFloat32,      ///< Float, 32 bits
+    dataInt16Array,   ///< Array of signed 16 bit integers
+    dataUint16Array,  ///< Array of unsigned 16 bit integers
+    dataInt64Array,   ///< Array of signed 64 bit integers
+    dataFloat32Array  ///< Array of 32 bit floats
 };
 
 /**
@@ -95,6 +103,56 @@ enum class dataDirection_t
     output ///< The data is being written by the device support and read by the control system
 };
 
+/**
+ * @ingroup datareadwrite
+ * @brief Defines what happens when the values are pushed faster than the control
+ *        system receives them (see Port::setAsyncDelivery()).
+ */
+enum class overflowPolicy_t
+{
+    dropOldest, ///< The oldest queued value is discarded
+    dropNewest, ///< The pushed value is discarded
+    block       ///< The push waits until the control system receives a queued value
+};
+
+/**
+ * @ingroup datareadwrite
+ * @brief Defines how DataAcquisition reduces the number of samples in each
+ *        acquired array before pushing it to the control system.
+ *
+ * The array is split in groups of samples (see DataAcquisition::getReductionFactor())
+ *  and each group is replaced by one or two samples.
+ */
+enum class reductionMode_t
+{
+    none,      ///< The arrays are pushed unmodified
+    subsample, ///< The first sample of each group is pushed
+    minMax,    ///< The minimum and the maximum of each group are pushed
+    average    ///< The average of each group is pushed
+};
+
+/**
+ * @brief Defines the class of a task executed in a separate thread: each class
+ *        can have its own thread attributes (see Factory::setTaskClassAttributes()).
+ */
+enum class taskClass_t
+{
+    acquisition,    ///< Data acquisition and delivery of the data to the control system
+    housekeeping,   ///< Maintenance and other tasks that are not time critical
+    stateTransition ///< Asynchronous state machine transitions
+};
+
+/**
+ * @brief Defines the scheduling policy of a thread (see threadAttributes_t).
+ */
+enum class schedulingPolicy_t
+{
+    inherit,   ///< Keep the policy and priority inherited from the process (e.g. set with chrt)
+    other,     ///< The default time-sharing policy (SCHED_OTHER)
+    fifo,      ///< Real-time first-in first-out policy (SCHED_FIFO)
+    roundRobin ///< Real-time round-robin policy (SCHED_RR)
+};
+
 /**
  * @ingroup naming
  * @brief Defines the nodes' roles in the tree structure: it is used to build the node's
@@ -280,6 +338,30 @@ typedef std::function<timespec ()> getTimestampPlugin_t;
 
 typedef std::function<void ()> threadFunction_t;
 
+/**
+ * @brief Attributes of a thread started with Factory::runInThread() or
+ *        Base::runInThread().
+ *
+ * The same structure is used to report the attributes that have actually been
+ *  applied (see Thread::getAppliedAttributes()): the attributes that cannot be
+ *  applied, e.g. a real-time priority without the CAP_SYS_NICE capability, are
+ *  left to the system defaults.
+ */
+struct threadAttributes_t
+{
+    threadAttributes_t(): m_policy(schedulingPolicy_t::inherit), m_priority(0), m_stackSize(0),
+        m_bPrefaultStack(false), m_bLockMemory(false)
+    {
+    }
+
+    std::vector<size_t> m_cpus;  ///< The CPUs on which the thread may run. Empty to keep the affinity inherited from the process
+    schedulingPolicy_t m_policy; ///< The scheduling policy. The default keeps the one inherited from the process
+    int m_priority;              ///< The priority, used by the real-time policies
+    size_t m_stackSize;          ///< The stack size in bytes, or 0 for the default size
+    bool m_bPrefaultStack;       ///< If true then the stack pages are touched before running the function
+    bool m_bLockMemory;          ///< If true then the whole process memory is locked with mlockall()
+};
+
 
 /**
  * @brief List of strings used for enumeration in PVs that support
@@ -110,6 +110,17 @@ public:
 };
 
 
+/**
+ * @brief This exception is thrown when a value is read from or written to
+ *        a PV that does not support the value's data type.
+ */
+class NDS3_API PVDataTypeError: public NdsError
+{
+public:
+    PVDataTypeError(const std::string& what);
+};
+
+
 /**
  * @brief This exception is thrown when there isn't any Port defined in the
  *        device structure. Without a Port there cannot be any communication
@@ -63,6 +63,11 @@ public:
      *  this method to declare additional devices that have been statically linked
      *  to your application (e.g.: the NDS test units do this).
      *
+     * When the environment variable NDS_MODULES_MANIFEST contains a file name,
+     *  the driver exported by each module is cached in that file and the modules
+     *  already listed there are loaded only when a device that uses their driver
+     *  is created.
+     *
      * Your device lifecycle will be managed by NDS: an allocation function will be
      *  called when the device is needed and a deallocation function will be called
      *  when the device can be deleted.
@@ -81,6 +86,28 @@ public:
      */
     static void registerDriver(const std::string& driverName, allocateDriver_t allocateFunction, deallocateDriver_t deallocateFunction);
 
+    /**
+     * @brief Replace a device driver with a new version without restarting
+     *        the application.
+     *
+     * All the devices allocated with the driver in every control system are
+     *  destroyed, the module that exported the driver is unloaded and the
+     *  new module is loaded. The devices are then created again with their
+     *  original names and parameters.
+     *
+     * If the new module cannot be loaded or does not export the driver then
+     *  the old module is loaded again and the devices are re-created with it
+     *  before the error is thrown.
+     *
+     * The devices allocated with other drivers keep running.
+     *
+     * @param driverName       the name of the driver to reload
+     * @param driverModuleName the module that contains the new version of the driver.
+     *                         If empty then the devices are destroyed and created
+     *                         again with the currently registered driver
+     */
+    static void reloadDriver(const std::string& driverName, const std::string& driverModuleName);
+
     /**
      * @brief Register a new control system.
      *
@@ -175,7 +202,70 @@ public:
      */
     Thread runInThread(const std::string& name, threadFunction_t function);
 
+    /**
+     * @brief Executes the specified function in a thread taken from the factory's
+     *        thread pool, using the thread attributes configured for the task class.
+     *
+     * @param name      the thread name
+     * @param taskClass the task class
+     * @param function  the function to execute
+     * @return          a Thread object that references the task
+     */
+    Thread runInThread(const std::string& name, const taskClass_t taskClass, threadFunction_t function);
+
+    /**
+     * @brief Executes the specified function in a thread with the specified attributes
+     *        (CPU affinity, scheduling policy and priority, stack size, memory locking).
+     *
+     * The attributes that cannot be applied (e.g. a real-time policy without the
+     *  CAP_SYS_NICE capability) are left to the system defaults: call
+     *  Thread::getAppliedAttributes() to know which ones are in effect.
+     *
+     * @param name       the thread name
+     * @param attributes the thread attributes
+     * @param function   the function to execute
+     * @return           a Thread object that references the task
+     */
+    Thread runInThread(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
+    /**
+     * @brief Set the attributes of the threads that execute the tasks of the
+     *        specified class.
+     *
+     * The attributes apply to the tasks started after the call.
+     *
+     * @param taskClass  the task class
+     * @param attributes the thread attributes
+     */
+    void setTaskClassAttributes(const taskClass_t taskClass, const threadAttributes_t& attributes);
+
+    /**
+     * @brief Set the number of threads used to initialize the devices.
+     *
+     * When more than one thread is allowed then the names of the nodes and
+     *  PVs of a device are built in parallel by the factory's thread pool
+     *  (task class taskClass_t::housekeeping). The registration with the
+     *  control system is always executed by the thread that initializes
+     *  the device.
+     *
+     * The default value is 1 (the names are built sequentially).
+     *
+     * @param numThreads the number of threads. 0 means one thread per CPU core
+     */
+    void setInitializationThreads(const size_t numThreads);
+
     void loadNamingRules(std::istream& rules);
+
+    /**
+     * @brief Load the naming rules from an INI file.
+     *
+     * The file is read with a single read and only the sections that are
+     *  used are parsed.
+     *
+     * @param rulesFileName the name of the INI file containing the rules
+     */
+    void loadNamingRules(const std::string& rulesFileName);
+
     void setNamingRules(const std::string& rulesName);
 
 
@@ -0,0 +1,206 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSASYNCLOGSTREAMGETTERIMPL_H
+#define NDSASYNCLOGSTREAMGETTERIMPL_H
+
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include "nds3/definitions.h"
+#include "nds3/impl/logStreamGetterImpl.h"
+
+namespace nds
+{
+
+/**
+ * @brief Function that outputs a log record. Called by the flushing thread.
+ */
+typedef std::function<void (const timespec& timestamp, const logLevel_t logLevel, const std::string& message)> logWriter_t;
+
+/**
+ * @brief Single producer, single consumer ring of binary log records.
+ *
+ * Each record contains the log level, the timestamp and the bytes written
+ *  into the log stream. When the ring is full the new records are dropped
+ *  and counted.
+ */
+class LogRecordsRing
+{
+public:
+    LogRecordsRing(const size_t size);
+
+    /**
+     * @brief Append a record. Called only by the thread that owns the ring.
+     *
+     * @param logLevel  the log level
+     * @param timestamp the time at which the record was logged
+     * @param pText     the text of the record
+     * @param length    the length of the text
+     * @return true if the record was stored, false if it was dropped
+     */
+    bool write(const logLevel_t logLevel, const timespec& timestamp, const char* pText, const size_t length);
+
+    /**
+     * @brief Remove the oldest record. Called only by the flushing thread.
+     *
+     * @param pLogLevel  filled with the log level
+     * @param pTimestamp filled with the time at which the record was logged
+     * @param pText      filled with the text of the record
+     * @return true if a record was available, false if the ring is empty
+     */
+    bool read(logLevel_t* pLogLevel, timespec* pTimestamp, std::string* pText);
+
+    /**
+     * @brief Check if the ring contains records, without removing them.
+     *        Called only by the flushing thread.
+     *
+     * @return true if the ring is empty
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Return the number of records dropped because the ring was full.
+     *
+     * @return the number of dropped records
+     */
+    std::uint64_t getDroppedRecords() const;
+
+private:
+    struct recordHeader_t
+    {
+        std::uint32_t m_length;
+        logLevel_t m_logLevel;
+        timespec m_timestamp;
+    };
+
+    void copyIn(const std::uint64_t position, const void* pData, const size_t length);
+    void copyOut(const std::uint64_t position, void* pData, const size_t length) const;
+
+    std::vector<char> m_buffer;
+    const std::uint64_t m_mask;
+
+    std::atomic<std::uint64_t> m_writePosition;
+    char m_padding[64];
+    std::atomic<std::uint64_t> m_readPosition;
+    std::atomic<std::uint64_t> m_droppedRecords;
+};
+
+
+/**
+ * @brief Stream buffer that collects a log line in a fixed buffer and
+ *        moves it into a ring when the stream is flushed (e.g. std::endl).
+ *
+ * The characters that exceed the buffer are discarded.
+ */
+class AsyncLogStreamBufferImpl: public std::streambuf
+{
+public:
+    AsyncLogStreamBufferImpl(const logLevel_t logLevel, const size_t maxRecordLength, std::shared_ptr<LogRecordsRing> pRing);
+
+protected:
+    virtual int_type overflow(int_type character);
+    virtual int sync();
+
+private:
+    logLevel_t m_logLevel;
+    std::vector<char> m_buffer;
+    std::shared_ptr<LogRecordsRing> m_pRing;
+};
+
+class AsyncLogStream: public std::ostream
+{
+public:
+    AsyncLogStream(const logLevel_t logLevel, const size_t maxRecordLength, std::shared_ptr<LogRecordsRing> pRing);
+
+protected:
+    AsyncLogStreamBufferImpl m_buffer;
+};
+
+
+/**
+ * @brief Log stream getter that never blocks the logging threads.
+ *
+ * Each thread writes its log lines into its own rings as binary records,
+ *  without locking. A background thread moves the records to the log
+ *  writer function. When a ring is full the records are dropped and
+ *  counted, see getDroppedRecords().
+ *
+ * A control system opts in by returning an AsyncLogStreamGetterImpl from
+ *  FactoryBaseImpl::getLogStreamGetter().
+ */
+class NDS3_API AsyncLogStreamGetterImpl: public LogStreamGetterImpl
+{
+public:
+    /**
+     * @brief Constructor. Starts the flushing thread.
+     *
+     * @param writer          the function that outputs the records
+     * @param ringSize        the size in bytes of the ring used by each thread and log level
+     * @param maxRecordLength the maximum length of a log line: the longer lines are truncated
+     * @param flushInterval   the interval between the flushes of the rings
+     */
+    AsyncLogStreamGetterImpl(logWriter_t writer,
+                             const size_t ringSize = 64 * 1024,
+                             const size_t maxRecordLength = 1024,
+                             const std::chrono::milliseconds& flushInterval = std::chrono::milliseconds(10));
+
+    /**
+     * @brief Destructor. Stops the flushing thread and writes the records still
+     *        in the rings.
+     */
+    virtual ~AsyncLogStreamGetterImpl();
+
+    /**
+     * @brief Write all the records logged so far, in the calling thread.
+     */
+    void flush();
+
+    /**
+     * @brief Return the number of records dropped because a ring was full.
+     *
+     * @return the number of dropped records
+     */
+    std::uint64_t getDroppedRecords() const;
+
+protected:
+    virtual std::ostream* createLogStream(const logLevel_t logLevel);
+
+private:
+    void flushThread();
+
+    logWriter_t m_writer;
+    const size_t m_ringSize;
+    const size_t m_maxRecordLength;
+    const std::chrono::milliseconds m_flushInterval;
+
+    typedef std::list<std::shared_ptr<LogRecordsRing> > rings_t;
+    rings_t m_rings;                           ///< The rings of all the threads
+    mutable std::mutex m_lockRings;            ///< Protects m_rings
+    std::uint64_t m_removedRingsDropped;       ///< Records dropped by the rings of the terminated threads
+
+    std::mutex m_lockFlush;                    ///< Only one thread at a time flushes the rings
+
+    std::mutex m_lockTerminate;
+    std::condition_variable m_terminateCondition;
+    bool m_bTerminate;
+
+    std::thread m_flushThread;
+};
+
+}
+#endif // NDSASYNCLOGSTREAMGETTERIMPL_H
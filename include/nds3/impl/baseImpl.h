@@ -18,6 +18,7 @@
 #include <mutex>
 #include <ostream>
 #include "nds3/definitions.h"
+#include "nds3/impl/nameTableImpl.h"
 
 
 namespace nds
@@ -106,6 +107,23 @@ public:
 
     const std::string& getFullExternalNameFromPort() const;
 
+    /**
+     * @brief Return the ID of the full name in the factory-wide name table.
+     *
+     * @return the ID of the full name, or NameTableImpl::m_invalidNameId if
+     *         the object has not been initialized
+     */
+    nameId_t getFullNameId() const;
+
+    /**
+     * @brief Return the ID of the full external name in the factory-wide name table.
+     *        The control system interfaces can use it to index the PVs.
+     *
+     * @return the ID of the full external name, or NameTableImpl::m_invalidNameId
+     *         if the object has not been initialized
+     */
+    nameId_t getFullExternalNameId() const;
+
 
 
     /**
@@ -124,6 +142,10 @@ public:
 
     ThreadBaseImpl* runInThread(const std::string& name, threadFunction_t function);
 
+    ThreadBaseImpl* runInThread(const std::string& name, const taskClass_t taskClass, threadFunction_t function);
+
+    ThreadBaseImpl* runInThread(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
     /**
      * @ingroup logging
      * @brief Retrieve a stream that can be used for logging.
@@ -162,6 +184,41 @@ public:
      */
     void defineCommand(const std::string& command, const std::string& usage, const size_t numParameters, const command_t function);
 
+    /**
+     * @brief Enable or disable the collection of the runtime statistics
+     *        (push rate, read/write rate, latencies) of the PVs.
+     *
+     * The default implementation does nothing: the nodes forward the call
+     *  to their children, the PVs collect the statistics.
+     *
+     * @param bEnabled true to enable the statistics, false to disable them
+     */
+    virtual void setStatisticsEnabled(const bool bEnabled);
+
+    /**
+     * @brief Append the runtime statistics of the PVs to a list of strings.
+     *
+     * The default implementation does nothing: the nodes forward the call
+     *  to their children, the PVs append their own statistics.
+     *
+     * @param pStatistics the list to which the statistics are appended
+     */
+    virtual void collectStatistics(parameters_t* pStatistics);
+
+    /**
+     * @brief Build and intern the names of the node and resolve the objects used
+     *        during the initialization. Do not call this function directly:
+     *        call NodeImpl::initializeRootNode() instead.
+     *
+     * Does not communicate with the control system, so it is called without
+     *  holding the initialization lock and the nodes can prepare the children
+     *  in parallel.
+     *
+     * @param controlSystem the control system that the node is going to be registered with
+     * @param numThreads    the number of threads that can be used to prepare the children
+     */
+    virtual void prepareInitialization(FactoryBaseImpl& controlSystem, const size_t numThreads);
+
     /**
      * @brief Registers all the records with the control system. Do not call this
      *        function directly: call NodeImpl::initializeRootNode() instead.
@@ -244,10 +301,18 @@ protected:
     commands_t m_commands;
 
 protected:
-    std::string m_cachedFullName;
-    std::string m_cachedFullNameFromPort;
-    std::string m_cachedFullExternalName;
-    std::string m_cahcedFullExternalNameFromPort;
+    /**
+     * @brief The names calculated during the initialization, interned in the
+     *        factory-wide name table. Null before the initialization.
+     *        Released when the node is destroyed or initialized again.
+     */
+    const InternedName* m_pFullName;
+    const InternedName* m_pFullNameFromPort;
+    const InternedName* m_pFullExternalName;
+    const InternedName* m_pFullExternalNameFromPort;
+
+private:
+    void releaseNames();
 };
 
 
@@ -0,0 +1,180 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSCOPYONWRITELISTIMPL_H
+#define NDSCOPYONWRITELISTIMPL_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+namespace nds
+{
+
+/**
+ * @brief List optimized for frequent traversals and rare modifications.
+ *
+ * The readers traverse an immutable snapshot of the list without taking any
+ *  lock. insert() and erase() publish a modified copy of the list and then
+ *  wait until no reader is traversing the old snapshot before deleting it.
+ *
+ * Each published snapshot starts a new generation and the readers are counted
+ *  per generation: the readers that arrive after the publication are counted
+ *  in the new generation, so a writer waits only for the readers that were
+ *  already traversing the old snapshot, even when the list is traversed
+ *  continuously.
+ *
+ * @warning A reader must not modify the list it is traversing.
+ *
+ * @tparam T the type of the elements
+ */
+template<typename T>
+class CopyOnWriteList
+{
+public:
+    typedef std::vector<T> list_t;
+
+    CopyOnWriteList(): m_pList(new list_t), m_generation(0)
+    {
+        m_readers[0].store(0);
+        m_readers[1].store(0);
+    }
+
+    ~CopyOnWriteList()
+    {
+        delete m_pList.load();
+    }
+
+    /**
+     * @brief Holds a snapshot of the list for the time needed to traverse it.
+     */
+    class Reader
+    {
+    public:
+        Reader(const CopyOnWriteList<T>& list): m_list(list)
+        {
+            // Register as a reader of the current generation before loading
+            //  the snapshot, so the writers don't delete it while we are using
+            //  it. Retry if a writer started a new generation in the meantime
+            ////////////////////////////////////////////////////////////////////
+            for(;;)
+            {
+                m_generation = m_list.m_generation.load();
+                m_list.m_readers[m_generation & 1].fetch_add(1);
+                if(m_list.m_generation.load() == m_generation)
+                {
+                    break;
+                }
+                m_list.m_readers[m_generation & 1].fetch_sub(1, std::memory_order_release);
+            }
+            m_pSnapshot = m_list.m_pList.load();
+        }
+
+        ~Reader()
+        {
+            m_list.m_readers[m_generation & 1].fetch_sub(1, std::memory_order_release);
+        }
+
+        typename list_t::const_iterator begin() const
+        {
+            return m_pSnapshot->begin();
+        }
+
+        typename list_t::const_iterator end() const
+        {
+            return m_pSnapshot->end();
+        }
+
+    private:
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+
+        const CopyOnWriteList<T>& m_list;
+        std::uint32_t m_generation;
+        const list_t* m_pSnapshot;
+    };
+
+    /**
+     * @brief Add an element to the list, if not already present.
+     *
+     * @param element the element to add
+     * @return true if the element has been added
+     */
+    bool insert(const T& element)
+    {
+        std::lock_guard<std::mutex> lock(m_lockWriters);
+
+        const list_t* pList(m_pList.load());
+        if(std::find(pList->begin(), pList->end(), element) != pList->end())
+        {
+            return false;
+        }
+
+        list_t* pNewList(new list_t(*pList));
+        pNewList->push_back(element);
+        publish(pNewList);
+        return true;
+    }
+
+    /**
+     * @brief Remove an element from the list.
+     *
+     * @param element the element to remove
+     * @return true if the element has been removed
+     */
+    bool erase(const T& element)
+    {
+        std::lock_guard<std::mutex> lock(m_lockWriters);
+
+        const list_t* pList(m_pList.load());
+        if(std::find(pList->begin(), pList->end(), element) == pList->end())
+        {
+            return false;
+        }
+
+        list_t* pNewList(new list_t);
+        pNewList->reserve(pList->size() - 1);
+        std::remove_copy(pList->begin(), pList->end(), std::back_inserter(*pNewList), element);
+        publish(pNewList);
+        return true;
+    }
+
+private:
+    CopyOnWriteList(const CopyOnWriteList&);
+    CopyOnWriteList& operator=(const CopyOnWriteList&);
+
+    /*
+     * Replace the snapshot and start a new generation, then wait for
+     *  the readers of the old generation that may still be using
+     *  the old snapshot
+     *
+     ****************************************************************/
+    void publish(list_t* pNewList)
+    {
+        list_t* pOldList(m_pList.exchange(pNewList));
+        const std::uint32_t oldGeneration(m_generation.fetch_add(1));
+        while(m_readers[oldGeneration & 1].load() != 0)
+        {
+            std::this_thread::yield();
+        }
+        delete pOldList;
+    }
+
+    std::atomic<list_t*> m_pList;
+    std::atomic<std::uint32_t> m_generation;
+    mutable std::atomic<std::uint32_t> m_readers[2]; ///< Readers of the even and odd generations
+    std::mutex m_lockWriters;
+};
+
+}
+#endif // NDSCOPYONWRITELISTIMPL_H
@@ -11,7 +11,9 @@
 #define NDSDATAACQUISITIONIMPL_H
 
 #include <memory>
+#include <atomic>
 #include "nds3/definitions.h"
+#include "nds3/sharedBuffer.h"
 #include "nds3/impl/nodeImpl.h"
 
 namespace nds
@@ -48,12 +50,40 @@ public:
 
     void push(const timespec& timestamp, const T& data);
 
+    /**
+     * @brief Push data held in a shared buffer: the buffer is passed by reference
+     *        up to the control system interface.
+     *
+     * For scalar and string data types the buffer's content is pushed as a plain value.
+     *
+     * @param timestamp the timestamp for the data
+     * @param data      the buffer holding the data
+     */
+    void push(const timespec& timestamp, const SharedBuffer<T>& data);
+
+    /**
+     * @brief Convert raw samples to engineering units and push them.
+     *
+     * Each sample is converted to raw * Amplitude + Offset into a buffer
+     *  reused by all the pushes, then the buffer is pushed as with push().
+     *
+     * Instantiated only for T = std::vector<double>, with std::int16_t and
+     *  std::int32_t samples.
+     *
+     * @param timestamp the timestamp for the data
+     * @param rawData   the raw samples
+     */
+    template<typename R>
+    void pushRaw(const timespec& timestamp, const std::vector<R>& rawData);
+
     double getFrequencyHz();
     double getDurationSeconds();
     double getAmplitude();
     double getOffset();
     size_t getMaxElements();
     size_t getDecimation();
+    reductionMode_t getReductionMode();
+    size_t getReductionFactor();
     size_t getSamplingMode();
     size_t getGround();
 
@@ -68,8 +98,8 @@ public:
     timespec getStartTimestamp() const;
 
     /**
-     * @brief Called by the state machine. Store the current timestamp and then calls the
-     *        delegated onStart function.
+     * @brief Called by the state machine. Store the current timestamp, the decimation
+     *        and the reduction settings and then calls the delegated onStart function.
      */
     void onStart();
 
@@ -97,6 +127,30 @@ protected:
      */
     timespec m_startTime;
 
+    /**
+     * @brief Reduction applied to the arrays pushed to the control system.
+     *        Read from the PVs during onStart().
+     */
+    reductionMode_t m_reductionMode;
+    size_t m_reductionFactor;
+
+    /**
+     * @brief Reused by push() to store the reduced arrays.
+     */
+    T m_reducedData;
+
+    /**
+     * @brief Copies of the Amplitude and Offset PVs, updated when the PVs are
+     *        written, so pushRaw() reads them without locking.
+     */
+    std::atomic<double> m_amplitude;
+    std::atomic<double> m_offset;
+
+    /**
+     * @brief Reused by pushRaw() to store the converted samples.
+     */
+    T m_scaledData;
+
     // PVs
     std::shared_ptr<PVVariableInImpl<T> > m_dataPV;
     std::shared_ptr<PVVariableOutImpl<double> > m_frequencyPV;
@@ -104,6 +158,8 @@ protected:
     std::shared_ptr<PVVariableOutImpl<double> > m_amplitudePV;
     std::shared_ptr<PVVariableOutImpl<double> > m_offsetPV;
     std::shared_ptr<PVVariableOutImpl<std::int32_t> > m_decimationPV;
+    std::shared_ptr<PVVariableOutImpl<std::int32_t> > m_reductionModePV;
+    std::shared_ptr<PVVariableOutImpl<std::int32_t> > m_reductionFactorPV;
     std::shared_ptr<PVVariableOutImpl<std::int32_t> > m_samplingmodePV;
     std::shared_ptr<PVVariableOutImpl<std::int32_t> > m_groundPV;
     std::shared_ptr<StateMachineImpl> m_stateMachine;
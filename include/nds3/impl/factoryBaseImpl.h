@@ -10,11 +10,14 @@
 #ifndef NDSFACTORYBASEIMPL_H
 #define NDSFACTORYBASEIMPL_H
 
+#include <atomic>
+#include <list>
 #include <map>
 #include <mutex>
 #include <memory>
 #include <thread>
 #include "nds3/definitions.h"
+#include "nds3/impl/namingRulesImpl.h"
 
 namespace nds
 {
@@ -26,6 +29,7 @@ class PVBaseImpl;
 class LogStreamGetterImpl;
 class ThreadBaseImpl;
 class IniFileParserImpl;
+class ThreadPoolImpl;
 
 /**
  * @brief This is the base class for objects that interact with specific control systems
@@ -64,8 +68,62 @@ public:
      */
     virtual void preDelete();
 
+    /**
+     * @brief Execute a function in a thread taken from the factory's thread pool.
+     *        The task is assigned to the class taskClass_t::acquisition.
+     *
+     * @param name     the thread name
+     * @param function the function to execute
+     * @return a thread handle owned by the caller
+     */
     virtual ThreadBaseImpl* runInThread(const std::string& name, threadFunction_t function);
 
+    /**
+     * @brief Execute a function in a thread taken from the factory's thread pool,
+     *        with the affinity and the priority of the specified task class.
+     *
+     * @param name      the thread name
+     * @param taskClass the task class
+     * @param function  the function to execute
+     * @return a thread handle owned by the caller
+     */
+    virtual ThreadBaseImpl* runInThread(const std::string& name, const taskClass_t taskClass, threadFunction_t function);
+
+    /**
+     * @brief Execute a function in a thread with the specified attributes.
+     *
+     * @param name       the thread name
+     * @param attributes the thread attributes
+     * @param function   the function to execute
+     * @return a thread handle owned by the caller
+     */
+    virtual ThreadBaseImpl* runInThread(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
+    /**
+     * @brief Return the pool that executes the functions passed to runInThread().
+     *
+     * @return the factory's thread pool
+     */
+    ThreadPoolImpl& getThreadPool();
+
+    /**
+     * @brief Set the number of threads used to build the names of the nodes and
+     *        PVs when a root node is initialized.
+     *
+     * See Factory::setInitializationThreads().
+     *
+     * @param numThreads the number of threads. 0 means one thread per CPU core
+     */
+    void setInitializationThreads(const size_t numThreads);
+
+    /**
+     * @brief Return the number of threads used to prepare the initialization
+     *        of a root node.
+     *
+     * @return the number of threads, at least 1
+     */
+    size_t getInitializationThreads() const;
+
     static void loadDriver(const std::string& libraryName);
 
     /**
@@ -89,6 +147,26 @@ public:
 
     void destroyDevice(const std::string& deviceName);
 
+    /**
+     * @brief Name and parameters of an allocated device.
+     */
+    struct deviceParameters_t
+    {
+        std::string m_deviceName;
+        namedParameters_t m_parameters;
+    };
+
+    typedef std::list<deviceParameters_t> devicesParameters_t;
+
+    /**
+     * @brief Destroy all the devices allocated with a driver.
+     *
+     * @param driverName the driver that allocated the devices
+     * @return the names and parameters of the destroyed devices, so they can be
+     *         created again with createDevice()
+     */
+    devicesParameters_t destroyDriverDevices(const std::string& driverName);
+
     void holdNode(void* pDeviceObject, std::shared_ptr<NodeImpl> pHoldNode);
 
     /**
@@ -106,6 +184,7 @@ public:
     const std::string& getSeparator(const std::uint32_t nodeLevel) const;
 
     void loadNamingRules(std::istream& rules);
+    void loadNamingRules(const std::string& rulesFileName);
     void setNamingRules(const std::string& rulesName);
 
     std::string getRootNodeName(const std::string& name) const;
@@ -122,14 +201,6 @@ public:
     std::string getStateMachineGetGlobalStateName(const std::string& name) const;
     std::string getDecimationPVName(const std::string& name) const;
 
-    std::string buildNameFromRule(const std::string& name,
-                                  const std::string& rule0,
-                                  const std::string& rule1 = "",
-                                  const std::string& rule2 = "",
-                                  const std::string& rule3 = "",
-                                  const std::string& rule4 = ""
-                                  ) const;
-
     virtual const std::string& getDefaultSeparator(const std::uint32_t nodeLevel) const = 0;
 
     virtual const std::string getName() const = 0;
@@ -181,6 +252,8 @@ private:
     {
         void* m_pDevice;
         deallocateDriver_t m_deallocationFunction;
+        std::string m_driverName;
+        namedParameters_t m_parameters;
     };
 
     typedef std::map<std::string, allocatedDevice_t> allocatedDevices_t;
@@ -195,6 +268,32 @@ private:
     std::unique_ptr<IniFileParserImpl> m_namingRules;
     std::string m_namingRulesName;
 
+    /**
+     * @brief Compile the rules in the section m_namingRulesName of m_namingRules
+     *        into m_pCompiledNamingRules.
+     */
+    void compileNamingRules();
+
+    /**
+     * @brief Select the only section in m_namingRules, if the rules contain
+     *        just one section, then compile the rules.
+     */
+    void selectSingleNamingRules();
+
+    const std::string& getSeparatorFromRules(const std::uint32_t nodeLevel) const;
+
+    std::string buildNameFromRole(const namingRole_t role, const std::string& name) const;
+
+    /**
+     * @brief The active naming rules resolved for each role. Null when no rules
+     *        are active.
+     */
+    std::unique_ptr<NamingRulesImpl> m_pCompiledNamingRules;
+
+    std::unique_ptr<ThreadPoolImpl> m_pThreadPool;
+
+    std::atomic<size_t> m_initializationThreads;
+
 };
 
 }
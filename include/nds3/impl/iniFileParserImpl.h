@@ -13,16 +13,48 @@
 #include <map>
 #include <string>
 #include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
 
 namespace nds
 {
 
+/**
+ * @internal
+ * @brief Parses an INI file.
+ *
+ * The text is scanned once to build an open-addressing index of the sections;
+ *  the index refers to the section names directly in the text.
+ * The keys of a section are parsed when the section is accessed for the first
+ *  time.
+ */
 class IniFileParserImpl
 {
 public:
+    /**
+     * @brief Parse all the sections in the input stream.
+     *
+     * Throws INIParserSyntaxError if the stream contains a syntax error.
+     *
+     * @param inputStream the stream to parse
+     */
     IniFileParserImpl(std::istream& inputStream);
 
-    ~IniFileParserImpl();
+    /**
+     * @brief Read the INI file with a single read and index its sections.
+     *
+     * The keys of each section are parsed on the first access to the section,
+     *  so getString() and keyExists() throw INIParserSyntaxError if the section
+     *  contains a syntax error. The parser keeps its own copy of the text: the
+     *  file can be modified or truncated after the constructor returns.
+     *
+     * Throws std::runtime_error if the file cannot be opened or read.
+     *
+     * @param fileName the INI file to parse
+     */
+    IniFileParserImpl(const std::string& fileName);
 
     /**
      * @brief Retrieve the value for a specific key in the parsed INI file.
@@ -41,21 +73,86 @@ public:
     sectionsList_t getSections() const;
 
 private:
+    IniFileParserImpl(const IniFileParserImpl&);
+    IniFileParserImpl& operator=(const IniFileParserImpl&);
 
     typedef std::pair<std::string, std::string> keyValue_t;
 
     static std::string trim(const std::string& string);
 
-    static std::string getSection(const std::string& line);
-
     static size_t findFirstUnescapedChar(const std::string& string, const char findChar, const size_t startPosition = 0);
 
     static keyValue_t getKeyValue(const std::string& line);
 
     typedef std::map<std::string, std::string> keyValueMap_t;
-    typedef std::map<std::string, keyValueMap_t> sectionKeyMap_t;
 
-    sectionKeyMap_t m_sections;
+    /**
+     * @brief Position of a string in the parsed text.
+     */
+    struct textSlice_t
+    {
+        const char* m_pBegin;
+        size_t m_size;
+    };
+
+    /**
+     * @brief Lines of the text that belong to a section, from the line after
+     *        the section header to the line before the next header.
+     */
+    struct textRange_t
+    {
+        size_t m_begin;      ///< Offset of the first line
+        size_t m_end;        ///< Offset after the last line
+        size_t m_firstLine;  ///< Number of the first line, for the error messages
+    };
+
+    /**
+     * @brief A section may appear several times in the text: its keys are
+     *        merged in the order in which they appear.
+     */
+    struct section_t
+    {
+        textSlice_t m_name;
+        std::vector<textRange_t> m_ranges;
+        bool m_bHasKeys;                          ///< Sections without keys are ignored
+        mutable std::unique_ptr<keyValueMap_t> m_pKeys;   ///< Allocated when the section is parsed
+    };
+
+    /**
+     * @brief Split the text in sections and build the index.
+     */
+    void indexSections();
+
+    /**
+     * @brief Return the keys of a section, parsing them if necessary.
+     *
+     * Throws INIParserMissingSection if the section does not exist.
+     */
+    const keyValueMap_t& getSectionKeys(const std::string& section) const;
+
+    void parseSection(const section_t& section) const;
+
+    size_t findSection(const char* pName, const size_t nameSize) const;
+
+    static std::uint32_t hashName(const char* pName, const size_t nameSize);
+
+    static const size_t m_sectionNotFound = (size_t)-1;
+
+    std::string m_text;            ///< Text read from the input stream or from the file
+
+    const char* m_pText;
+    size_t m_textSize;
+
+    std::vector<section_t> m_indexedSections;
+
+    // Open-addressing index of m_indexedSections, with linear probing.
+    //  Each slot contains the position in m_indexedSections plus 1,
+    //  0 for the empty slots
+    ////////////////////////////////////////////////////////////////////
+    std::vector<std::uint32_t> m_sectionsIndex;
+    size_t m_sectionsIndexMask;
+
+    mutable std::mutex m_lockParse;
 };
 
 }
@@ -12,6 +12,8 @@
 
 #include <list>
 #include <memory>
+#include <vector>
+#include "nds3/sharedBuffer.h"
 #include "nds3/impl/pvBaseImpl.h"
 
 namespace nds
@@ -47,6 +49,34 @@ public:
      */
     virtual void deregisterPV(std::shared_ptr<PVBaseImpl> pv) = 0;
 
+    typedef std::vector<std::shared_ptr<PVBaseImpl> > pvsList_t;
+
+    /**
+     * @brief Register several PVs (attributes) with the control system.
+     *
+     * Called once by each port during the initialization with all the PVs
+     *  that belong to it, before registrationTerminated(). Control systems that
+     *  store the PVs in hash tables or record databases can override it in
+     *  order to allocate the storage once.
+     *
+     * The default implementation calls registerPV() for each PV.
+     *
+     * @param pvs the PVs to be registered
+     */
+    virtual void registerPVs(const pvsList_t& pvs);
+
+    /**
+     * @brief Deregister several PVs (attributes) from the control system.
+     *
+     * Called once by each port when it is deinitialized, with all the PVs that
+     *  belong to it.
+     *
+     * The default implementation calls deregisterPV() for each PV.
+     *
+     * @param pvs the PVs to be deregistered
+     */
+    virtual void deregisterPVs(const pvsList_t& pvs);
+
     /**
      * @brief Called by the nodes after all the PVs have been registered.
      *        The interface may commit all the registered PV at this point or
@@ -61,6 +91,74 @@ public:
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int32_t> & value) = 0;
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<double> & value) = 0;
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::string & value) = 0;
+
+    /**
+     * @brief Called to push the 16 bit, 64 bit and 32 bit float data types.
+     *
+     * The default implementation widens the values to the data types
+     *  that every control system supports and passes them to the push() overloads
+     *  above: the 16 bit integers become 32 bit integers, the 64 bit integers
+     *  and the 32 bit floats become 64 bit floats. Control systems that support
+     *  these data types natively should override these methods in order to avoid
+     *  the conversion.
+     *
+     * The conversion has a cost:
+     * - the 64 bit integers with a magnitude above 2^53 cannot be represented
+     *   exactly by a double and are rounded to the nearest double;
+     * - each push of a vector allocates and fills a temporary widened copy
+     *   of the vector.
+     *
+     * @param pv        the PV that is pushing the data
+     * @param timestamp the data's timestamp
+     * @param value     the data
+     */
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::int16_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::uint16_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::int64_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const float& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int16_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::uint16_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int64_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<float> & value);
+
+    /**
+     * @brief Called to push data held in a SharedBuffer.
+     *
+     * The default implementation passes the buffer's content to the push() overload
+     *  that accepts a std::vector. Control systems that can hold a reference to the
+     *  data (see SharedBuffer::getPointer()) should override these methods in order
+     *  to avoid copying the pushed arrays.
+     *
+     * @param pv        the PV that is pushing the data
+     * @param timestamp the data's timestamp
+     * @param value     the buffer holding the data
+     */
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int8_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint8_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int32_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<double> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int16_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint16_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int64_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<float> >& value);
+
+    /**
+     * @brief Called to push a block of scalar samples in one call.
+     *
+     * The default implementation calls push() for each sample. Control systems
+     *  that can accept many updates at once should override these methods.
+     *
+     * @param pv          the PV that is pushing the data
+     * @param pTimestamps the samples' timestamps
+     * @param pValues     the samples
+     * @param count       the number of samples in pTimestamps and pValues
+     */
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int32_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const double* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int16_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::uint16_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int64_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const float* pValues, const size_t count);
 };
 
 }
@@ -0,0 +1,100 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSMODULESMANIFESTIMPL_H
+#define NDSMODULESMANIFESTIMPL_H
+
+#include <string>
+#include <map>
+#include <cstdint>
+#include <time.h>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+/**
+ * @brief Cache of the names of the drivers exported by the device modules.
+ *
+ * Stored in a text file, one module per line. An entry is valid as long as
+ *  the module's modification time and size do not change: the modules
+ *  listed in a valid entry don't need to be loaded in order to know which
+ *  driver they export.
+ *
+ * The modules that don't export a driver are stored with an empty driver
+ *  name, so they are not loaded again at the next startup.
+ *
+ * Several processes may share the same manifest while scanning different
+ *  folders: the entries of the modules not seen by this process are kept.
+ */
+class NDS3_API ModulesManifestImpl
+{
+public:
+    /**
+     * @brief Load the manifest from a file. A missing or unreadable file
+     *        is treated as an empty manifest.
+     *
+     * @param fileName the manifest file
+     */
+    ModulesManifestImpl(const std::string& fileName);
+
+    /**
+     * @brief Return the driver exported by a module, if the manifest contains
+     *        a valid entry for it.
+     *
+     * @param moduleName  the module's file name
+     * @param pDriverName filled with the driver name. Empty if the module
+     *                    does not export a driver
+     * @return true if the manifest contains a valid entry for the module,
+     *         false if the module must be loaded
+     */
+    bool getDriverName(const std::string& moduleName, std::string* pDriverName);
+
+    /**
+     * @brief Store the driver exported by a module, together with the module's
+     *        current modification time and size.
+     *
+     * @param moduleName the module's file name
+     * @param driverName the driver name, empty if the module does not export a driver
+     */
+    void setDriverName(const std::string& moduleName, const std::string& driverName);
+
+    /**
+     * @brief Write the manifest if it has been modified.
+     *
+     * The entries written in the meantime by other processes are merged with
+     *  the ones of this process; the entries of the modules that no longer
+     *  exist are dropped.
+     *
+     * @return false if the manifest could not be written
+     */
+    bool save();
+
+private:
+    struct entry_t
+    {
+        timespec m_modificationTime;
+        std::uint64_t m_size;
+        std::string m_driverName;
+    };
+
+    typedef std::map<std::string, entry_t> entries_t;
+
+    static void readEntries(const std::string& fileName, entries_t* pEntries);
+    static bool getModuleStatus(const std::string& moduleName, timespec* pModificationTime, std::uint64_t* pSize);
+
+    std::string m_fileName;
+
+    entries_t m_entries;
+
+    bool m_bModified;
+};
+
+}
+#endif // NDSMODULESMANIFESTIMPL_H
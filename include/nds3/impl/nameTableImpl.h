@@ -0,0 +1,161 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSNAMETABLEIMPL_H
+#define NDSNAMETABLEIMPL_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+/**
+ * @brief Integer that identifies an interned name.
+ */
+typedef std::uint32_t nameId_t;
+
+/**
+ * @brief A name stored in the NameTableImpl. The address of the object and
+ *        its content don't change until the last reference to the name
+ *        is released.
+ */
+struct InternedName
+{
+    InternedName(const std::string& name, const nameId_t id): m_name(name), m_id(id), m_references(0)
+    {
+    }
+
+    std::string m_name;
+    const nameId_t m_id;
+    size_t m_references; ///< Number of intern() calls not balanced by release(). Protected by the shard's lock
+};
+
+/**
+ * @brief Table of interned names.
+ *
+ * Each distinct name is stored only once and receives a stable integer ID:
+ *  the nodes that have the same full name, full name from port or external
+ *  name share the same InternedName object, and the registries can be keyed
+ *  by ID instead of by string.
+ *
+ * Each intern() adds a reference to the name and each release() removes one:
+ *  when the last reference is released the name is removed and its slot and
+ *  ID are reused by the next new name, so the table doesn't grow when devices
+ *  with different names are destroyed and created.
+ *
+ * The table is split in shards selected by the hash of the name, each one
+ *  with its own lock, so the threads that prepare the device tree in
+ *  parallel rarely wait for each other. The shard is encoded in the lowest
+ *  bits of the ID.
+ */
+class NDS3_API NameTableImpl
+{
+public:
+    /**
+     * @brief Value returned by find() when the name is not in the table.
+     */
+    static const nameId_t m_invalidNameId = 0xffffffff;
+
+    NameTableImpl();
+
+    /**
+     * @brief Return the interned copy of a name, adding it to the table if necessary,
+     *        and add a reference to it.
+     *
+     * @param name the name to intern
+     * @return the interned name. The pointer stays valid until release() is
+     *         called for each call to intern().
+     */
+    const InternedName* intern(const std::string& name);
+
+    /**
+     * @brief Remove a reference added by intern(). The name is removed from the
+     *        table when its last reference is released.
+     *
+     * @param pName the name returned by intern()
+     */
+    void release(const InternedName* pName);
+
+    /**
+     * @brief Return the ID of a name without adding it to the table or
+     *        adding a reference.
+     *
+     * @param name the name to look for
+     * @return the name's ID, or m_invalidNameId if the name is not in the table
+     */
+    nameId_t find(const std::string& name) const;
+
+    /**
+     * @brief Return the name that has the specified ID.
+     *
+     * @param id the ID returned by intern() or find()
+     * @return the interned name
+     */
+    const InternedName& getName(const nameId_t id) const;
+
+    /**
+     * @brief Return the number of names in the table.
+     *
+     * @return the number of interned names
+     */
+    size_t size() const;
+
+private:
+    NameTableImpl(const NameTableImpl&);
+    NameTableImpl& operator=(const NameTableImpl&);
+
+    // The index points to the strings stored in m_names, so
+    //  each name is allocated only once
+    ////////////////////////////////////////////////////////
+    struct hashName_t
+    {
+        size_t operator()(const std::string* pName) const
+        {
+            return std::hash<std::string>()(*pName);
+        }
+    };
+
+    struct equalName_t
+    {
+        bool operator()(const std::string* pLeft, const std::string* pRight) const
+        {
+            return *pLeft == *pRight;
+        }
+    };
+
+    typedef std::unordered_map<const std::string*, nameId_t, hashName_t, equalName_t> index_t;
+    typedef std::deque<InternedName> names_t;
+    typedef std::vector<size_t> freeSlots_t;
+
+    struct shard_t
+    {
+        index_t m_index;
+        names_t m_names;
+        freeSlots_t m_freeSlots; ///< Slots in m_names of the removed names
+        mutable std::mutex m_lockNames;
+        char m_padding[64]; ///< Keep the locks of adjacent shards on different cache lines
+    };
+
+    static const size_t m_shardBits = 6;
+    static const size_t m_numShards = (size_t)1 << m_shardBits;
+
+    shard_t& getShard(const std::string& name);
+    const shard_t& getShard(const std::string& name) const;
+
+    shard_t m_shards[m_numShards];
+};
+
+}
+#endif // NDSNAMETABLEIMPL_H
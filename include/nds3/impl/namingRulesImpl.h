@@ -0,0 +1,140 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSNAMINGRULESIMPL_H
+#define NDSNAMINGRULESIMPL_H
+
+#include <string>
+#include <vector>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+class IniFileParserImpl;
+
+/**
+ * @brief The roles of the nodes and PVs for which a naming rule is defined.
+ */
+enum class namingRole_t
+{
+    rootNode,
+    genericNode,
+    inputNode,
+    outputNode,
+    sourceNode,
+    sinkNode,
+    inputPV,
+    outputPV,
+    stateMachineNode,
+    setStatePV,
+    getStatePV,
+    getGlobalStatePV,
+    decimationPV
+};
+
+/**
+ * @brief A naming rule (e.g. "CH%3s") parsed into literal text and placeholders
+ *        for the node name.
+ *
+ * Produces the same result as snprintf(rule, name) followed by the replacement
+ *  of the spaces with '0'. The rules that contain conversions other than
+ *  %s (with optional '-' flag, width and precision) are still passed to
+ *  snprintf.
+ */
+class NamingRuleTemplate
+{
+public:
+    NamingRuleTemplate(const std::string& rule);
+
+    /**
+     * @brief Apply the rule to a name.
+     *
+     * @param name the name (already converted to upper or lower case)
+     * @return the name built by the rule
+     */
+    std::string buildName(const std::string& name) const;
+
+private:
+    struct segment_t
+    {
+        segment_t(const std::string& text);
+        segment_t(const bool bLeftJustify, const size_t width, const size_t precision);
+
+        std::string m_text;   ///< Literal text, used when m_bName is false
+        bool m_bName;         ///< true if the segment is a placeholder for the name
+        bool m_bLeftJustify;
+        size_t m_width;
+        size_t m_precision;   ///< std::string::npos when not specified
+    };
+
+    typedef std::vector<segment_t> segments_t;
+    segments_t m_segments;
+
+    size_t m_literalLength;
+
+    bool m_bUseSnprintf;
+    std::string m_rule;
+};
+
+/**
+ * @brief Naming rules of a section of the INI file, resolved once for each
+ *        role and node level.
+ *
+ * Built by FactoryBaseImpl when the naming rules are loaded or selected, so
+ *  building a name requires only a table lookup and the application of
+ *  a pre-parsed template.
+ */
+class NamingRulesImpl
+{
+public:
+    /**
+     * @brief Number of node levels for which the separators are resolved in advance.
+     */
+    static const size_t m_numCompiledSeparators = 16;
+
+    /**
+     * @brief Compile the rules in a section of the INI file.
+     *
+     * @param rules      the parsed INI file
+     * @param rulesName  the section containing the rules to compile
+     * @param separators the separators for the levels 0 to m_numCompiledSeparators - 1,
+     *                   already resolved
+     */
+    NamingRulesImpl(const IniFileParserImpl& rules, const std::string& rulesName, const std::vector<std::string>& separators);
+
+    /**
+     * @brief Build the name of a node or PV according to its role.
+     *
+     * @param role the role of the node or PV
+     * @param name the node's external name
+     * @return the name built by the rule
+     */
+    std::string buildName(const namingRole_t role, const std::string& name) const;
+
+    /**
+     * @brief Return the separator for a node level.
+     *
+     * @param nodeLevel the node level
+     * @return the separator, or 0 if the level has not been compiled
+     */
+    const std::string* getSeparator(const std::uint32_t nodeLevel) const;
+
+private:
+    typedef std::vector<NamingRuleTemplate> templates_t;
+    templates_t m_templates;
+
+    bool m_bToUpper;
+    bool m_bToLower;
+
+    std::vector<std::string> m_separators;
+};
+
+}
+#endif // NDSNAMINGRULESIMPL_H
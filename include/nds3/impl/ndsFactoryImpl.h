@@ -12,11 +12,17 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <list>
+#include <vector>
 #include <memory>
 #include <mutex>
+#include <exception>
 #include <dirent.h>
 #include "nds3/definitions.h"
+#include "nds3/impl/factoryBaseImpl.h"
+#include "nds3/impl/nameTableImpl.h"
 
 namespace nds
 {
@@ -37,7 +43,37 @@ public:
 
     std::shared_ptr<FactoryBaseImpl> getControlSystem(const std::string& controlSystem);
 
-    void loadDriver(const std::string& driverModuleName);
+    /**
+     * @brief Load a device module and register the driver it exports.
+     *
+     * Throws DriverNotFound if the module cannot be loaded or if it does not
+     *  export the expected driver: in this case nothing is registered.
+     *
+     * @param driverModuleName   the module's file name
+     * @param expectedDriverName the driver that the module must export. If
+     *                           empty then any driver is accepted
+     * @return the name of the registered driver
+     */
+    std::string loadDriver(const std::string& driverModuleName, const std::string& expectedDriverName = "");
+
+    /**
+     * @brief Replace a device driver with a new version of its module.
+     *
+     * Destroys all the devices allocated with the driver, unloads the module that
+     *  exported it, loads the new module and creates the devices again with
+     *  their original names and parameters. The devices of the other drivers
+     *  are not affected.
+     *
+     * If the new module cannot be loaded or exports a different driver then
+     *  the old module is loaded again, the devices are re-created with it and
+     *  the load error is rethrown.
+     *
+     * @param driverName       the driver to reload
+     * @param driverModuleName the module containing the new version of the driver.
+     *                         If empty then the devices are re-created with the
+     *                         currently registered driver
+     */
+    void reloadDriver(const std::string& driverName, const std::string& driverModuleName);
 
     /**
      * @brief Called to register the functions that allocate and deallocate a device.
@@ -89,11 +125,32 @@ public:
     void stopReplicationTo(const std::string& replicateDestination);
 
 
+    /**
+     * @brief Return the table that interns the names of all the nodes and PVs.
+     *
+     * @return the factory-wide name table
+     */
+    NameTableImpl& getNameTable();
+
     void registerInputPV(PVBaseInImpl* pSender);
     void deregisterInputPV(PVBaseInImpl* pSender);
     void registerOutputPV(PVBaseOutImpl* pReceiver);
     void deregisterOutputPV(PVBaseOutImpl* pReceiver);
 
+    typedef std::vector<PVBaseInImpl*> inputPVsList_t;
+    typedef std::vector<PVBaseOutImpl*> outputPVsList_t;
+
+    /**
+     * @brief Register several PVs at once.
+     *
+     * If one of the names is already in use then none of the PVs is registered
+     *  and PVAlreadyDeclared is thrown.
+     *
+     * @param inputPVs  the input PVs to register
+     * @param outputPVs the output PVs to register
+     */
+    void registerPVs(const inputPVsList_t& inputPVs, const outputPVsList_t& outputPVs);
+
 private:
     typedef std::list<std::string> fileNames_t;
 
@@ -101,6 +158,11 @@ private:
 
     static fileNames_t separateFoldersList(const char* foldersList);
 
+    // Declared first so it is destroyed after the control systems and the
+    //  modules, which may still reference the interned names
+    ///////////////////////////////////////////////////////////////////////
+    NameTableImpl m_nameTable;
+
     typedef std::map<std::string, std::shared_ptr<FactoryBaseImpl> > controlSystems_t;
     controlSystems_t m_controlSystems;
     std::mutex m_lockControlSystems;
@@ -112,12 +174,54 @@ private:
     typedef std::list<std::shared_ptr<DynamicModule> > modules_t;
     modules_t m_modules;
 
-    typedef std::map<std::string, PVBaseInImpl*> registeredInputPVs_t;
+    // Modules that exported a driver: they are unloaded when the driver
+    //  is reloaded
+    ////////////////////////////////////////////////////////////////////
+    typedef std::map<std::string, std::shared_ptr<DynamicModule> > driverModules_t;
+    driverModules_t m_driverModules;
+    std::mutex m_lockModules;
+
+    std::mutex m_lockReload;
+
+    // Drivers listed in the modules manifest but not loaded yet:
+    //  driver name -> module file name
+    /////////////////////////////////////////////////////////////
+    typedef std::map<std::string, std::string> lazyDrivers_t;
+    lazyDrivers_t m_lazyDrivers;
+    std::mutex m_lockLazyDrivers;
+
+    void loadDeviceModules(const fileNames_t& deviceModules);
+
+    typedef std::list<std::pair<std::shared_ptr<FactoryBaseImpl>, FactoryBaseImpl::devicesParameters_t> > destroyedDevices_t;
+    std::exception_ptr createDriverDevices(const std::string& driverName, const destroyedDevices_t& destroyedDevices);
+
+    void removeSubscription(PVBaseInImpl* pSender, PVBaseOutImpl* pReceiver);
+    void removeReplication(PVBaseInImpl* pSource, PVBaseInImpl* pDestination);
+
+    // The registered PVs are indexed by the ID of their full name
+    //////////////////////////////////////////////////////////////
+    typedef std::unordered_map<nameId_t, PVBaseInImpl*> registeredInputPVs_t;
     registeredInputPVs_t m_registeredInputPVs;
 
-    typedef std::map<std::string, PVBaseOutImpl*> registeredOutputPVs_t;
+    typedef std::unordered_map<nameId_t, PVBaseOutImpl*> registeredOutputPVs_t;
     registeredOutputPVs_t m_registeredOutputPVs;
 
+    // Links between the registered PVs, indexed in both directions so
+    //  removing a PV touches only its own links
+    //////////////////////////////////////////////////////////////////
+    typedef std::unordered_set<PVBaseInImpl*> inputPVsSet_t;
+    typedef std::unordered_set<PVBaseOutImpl*> outputPVsSet_t;
+
+    typedef std::unordered_map<PVBaseInImpl*, outputPVsSet_t> subscriptionReceivers_t;
+    subscriptionReceivers_t m_subscriptionReceivers;   ///< Input PV -> subscribed output PVs
+
+    typedef std::unordered_map<PVBaseOutImpl*, inputPVsSet_t> subscriptionSenders_t;
+    subscriptionSenders_t m_subscriptionSenders;       ///< Output PV -> input PVs it is subscribed to
+
+    typedef std::unordered_map<PVBaseInImpl*, inputPVsSet_t> replicationLinks_t;
+    replicationLinks_t m_replicationDestinations;      ///< Source PV -> replication destinations
+    replicationLinks_t m_replicationSources;           ///< Destination PV -> replication sources
+
     std::recursive_mutex m_lockRegisteredPVs;
 };
 
@@ -131,13 +235,34 @@ private:
 class DynamicModule
 {
 public:
-    DynamicModule(const std::string& libraryName);
+    /**
+     * @brief Load a module.
+     *
+     * @param libraryName the module's file name
+     * @param bUnloadable if false then the module stays in memory after the
+     *                    destructor is called
+     */
+    DynamicModule(const std::string& libraryName, const bool bUnloadable = false);
     ~DynamicModule();
 
     void* getAddress(const std::string& functionName);
 
+    /**
+     * @brief Don't unload the module when the destructor is called.
+     */
+    void keepLoaded();
+
+    /**
+     * @brief Return the file name passed to the constructor.
+     */
+    const std::string& getLibraryName() const;
+
 public:
     void* m_moduleHandle;
+
+private:
+    const std::string m_libraryName;
+    bool m_bUnload;
 };
 
 
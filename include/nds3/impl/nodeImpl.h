@@ -11,6 +11,10 @@
 #define NDSNODEIMPL_H
 
 #include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
 #include "nds3/definitions.h"
 #include "nds3/impl/baseImpl.h"
 
@@ -42,17 +46,51 @@ public:
 
     void deinitializeRootNode();
 
+    virtual void prepareInitialization(FactoryBaseImpl& controlSystem, const size_t numThreads);
+
     virtual void initialize(FactoryBaseImpl& controlSystem);
 
     virtual void deinitialize();
 
     virtual state_t getLocalState() const;
 
+    /**
+     * @brief Return the global state: the state with the highest priority among the
+     *        local state of the node's state machine and the global states of the
+     *        children.
+     *
+     * After the initialization the global state is maintained incrementally and
+     *  reading it does not visit the children.
+     *
+     * @param pTimestamp filled with the time at which the global state was entered
+     * @param pState     filled with the global state
+     */
     virtual void getGlobalState(timespec* pTimestamp, state_t* pState) const;
     void getChildrenState(timespec* pTimestamp, state_t* pState) const;
 
+    /**
+     * @brief Called when the state of a contributor to the global state changes:
+     *        the local state of the node's state machine or the global state
+     *        of a child node.
+     *
+     * Updates the node's global state and, if it changes, notifies the parent
+     *  node. Then pushes the changed global states to the getGlobalState PVs,
+     *  without holding any node lock.
+     *
+     * Each contributor must notify its changes in order.
+     *
+     * @param pContributor the state machine or the child node that changed state
+     * @param newState     the new state of the contributor
+     * @param timestamp    the time of the change
+     */
+    void updateContributorState(const BaseImpl* pContributor, const state_t newState, const timespec& timestamp);
+
     virtual void setLogLevel(const logLevel_t logLevel);
 
+    virtual void setStatisticsEnabled(const bool bEnabled);
+
+    virtual void collectStatistics(parameters_t* pStatistics);
+
     virtual std::string buildFullExternalName(const FactoryBaseImpl& controlSystem) const;
     virtual std::string buildFullExternalNameFromPort(const FactoryBaseImpl& controlSystem) const;
 
@@ -62,11 +100,99 @@ protected:
     nodeType_t m_nodeType;
 
 private:
+    /**
+     * @brief User command that enables or disables the statistics of the PVs
+     *        in the node's subtree
+     * @param bEnabled   true to enable the statistics
+     * @param parameters ignored
+     * @return           empty list of parameters
+     */
+    parameters_t commandSetStatisticsEnabled(const bool bEnabled, const parameters_t& parameters);
+
+    /**
+     * @brief User command that returns the statistics of the PVs in the
+     *        node's subtree
+     * @param parameters ignored
+     * @return           one line per statistic
+     */
+    parameters_t commandGetStatistics(const parameters_t& parameters);
+
     typedef std::map<std::string, std::shared_ptr<BaseImpl> > tChildren;
     tChildren m_children;
 
     std::shared_ptr<StateMachineImpl> m_pStateMachine;
 
+    /**
+     * @brief Collect the states of the contributors and compute the global state.
+     *        Called at the end of the initialization, after the children have
+     *        been initialized.
+     */
+    void aggregateState();
+
+    /**
+     * @brief Record the new state of a contributor and notify the parent if
+     *        the global state changes.
+     *
+     * @param pContributor  the contributor that changed state
+     * @param newState      the new state of the contributor
+     * @param timestamp     the time of the change
+     * @param pChangedNodes filled with the nodes whose global state changed
+     */
+    void propagateContributorState(const BaseImpl* pContributor, const state_t newState, const timespec& timestamp,
+                                   std::vector<std::shared_ptr<NodeImpl> >* pChangedNodes);
+
+    /**
+     * @brief Store the state of a contributor. The caller must hold m_lockState.
+     */
+    void setContributorState(const BaseImpl* pContributor, const state_t state, const timespec& timestamp);
+
+    /**
+     * @brief Set m_globalState and m_globalStateTimestamp from the contributors'
+     *        states. The caller must hold m_lockState.
+     */
+    void computeGlobalState();
+
+    /**
+     * @brief Push the current global state to the state machine's getGlobalState
+     *        PV, if it differs from the last pushed one.
+     */
+    void pushGlobalStateChange();
+
+    struct contributorState_t
+    {
+        state_t m_state;
+        timespec m_timestamp;
+    };
+
+    struct compareTimestamps_t
+    {
+        bool operator()(const timespec& left, const timespec& right) const
+        {
+            return left.tv_sec < right.tv_sec || (left.tv_sec == right.tv_sec && left.tv_nsec < right.tv_nsec);
+        }
+    };
+
+    // The last known state of each contributor and, for each state, the
+    //  timestamps of the contributors in that state
+    /////////////////////////////////////////////////////////////////////
+    typedef std::unordered_map<const BaseImpl*, contributorState_t> contributors_t;
+    contributors_t m_contributors;
+
+    typedef std::multiset<timespec, compareTimestamps_t> timestamps_t;
+    timestamps_t m_stateTimestamps[(size_t)state_t::MAX_STATE_NUM];
+
+    state_t m_globalState;
+    timespec m_globalStateTimestamp;
+    bool m_bStateAggregated;          ///< true between the initialization and the deinitialization
+
+    mutable std::mutex m_lockState;   ///< Protects the states. No other lock is acquired while holding it
+
+    std::mutex m_lockStateUpdates;    ///< Delivers the changes to the parent in order. Locked from the children to the parents
+
+    state_t m_pushedGlobalState;
+    timespec m_pushedGlobalStateTimestamp;
+    std::recursive_mutex m_lockStatePush; ///< Pushes the global states in order. Recursive: the pushed PV may change the state
+
 };
 
 }
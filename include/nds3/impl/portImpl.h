@@ -10,6 +10,11 @@
 #ifndef NDSPORTIMPL_H
 #define NDSPORTIMPL_H
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
 #include "nds3/impl/nodeImpl.h"
 
 namespace nds
@@ -18,6 +23,8 @@ namespace nds
 class FactoryBaseImpl;
 class InterfaceBaseImpl;
 class PVBaseImpl;
+class PublishQueueBase;
+class ThreadBaseImpl;
 
 
 /**
@@ -49,19 +56,110 @@ public:
     virtual std::shared_ptr<PortImpl> getPort();
 
 
+    /**
+     * @brief Called by the PVs during the initialization. The PVs are registered
+     *        with NDS and with the control system all at once, when the port
+     *        completes its initialization and before registrationTerminated()
+     *        is called on the interface.
+     *
+     * @param pv the PV to register
+     */
     void registerPV(std::shared_ptr<PVBaseImpl> pv);
 
+    /**
+     * @brief Execute a function during the initialization, after the PVs have
+     *        been registered with the control system.
+     *
+     * Used by the nodes that must push the initial value of their PVs.
+     *
+     * @param function the function to execute
+     */
+    void runAfterRegistration(std::function<void()> function);
+
+    /**
+     * @brief Called by the PVs when they are deinitialized. The PVs are
+     *        deregistered from the control system all at once, after all
+     *        the port's children have been deinitialized.
+     *
+     * @param pv the PV to deregister
+     */
     void deregisterPV(std::shared_ptr<PVBaseImpl> pv);
 
-    template<typename T>
-    void push(std::shared_ptr<PVBaseImpl> pv, const timespec& timestamp, const T& value);
+    /**
+     * @brief Return the control system interface used by the port.
+     *
+     * The PVs keep a pointer to it while they are initialized and push the
+     *  values directly into it.
+     *
+     * @return the control system interface
+     */
+    InterfaceBaseImpl& getInterface();
+
+    /**
+     * @brief Enable the asynchronous delivery of the pushed values.
+     *
+     * See Port::setAsyncDelivery().
+     *
+     * @param queueSize      the size of the queue allocated for each input PV
+     * @param overflowPolicy what to do when a queue is full
+     */
+    void setAsyncDelivery(const size_t queueSize, const overflowPolicy_t overflowPolicy);
+
+    /**
+     * @brief Wait until the values queued so far have been passed to the
+     *        control system.
+     */
+    void flushAsyncDelivery();
+
+    /**
+     * @brief Called by the publish queues after a value has been queued:
+     *        wakes up the dispatcher thread if it is waiting for data.
+     */
+    void notifyDispatcher();
+
+    /**
+     * @brief Return true if the dispatcher thread is draining the publish queues.
+     *
+     * @return true if the dispatcher thread is running
+     */
+    bool isDispatcherRunning() const;
 
     virtual std::string buildFullNameFromPort(const FactoryBaseImpl& controlSystem) const;
     virtual std::string buildFullExternalNameFromPort(const FactoryBaseImpl& controlSystem) const;
 
 private:
+    void registerPendingPVs();
+    void deregisterPendingPVs();
+
+    void startDispatcher();
+    void stopDispatcher();
+    void dispatchQueuedValues();
+    bool dispatcherHasWork() const;
+
     std::unique_ptr<InterfaceBaseImpl> m_pInterface;
 
+    // Registration and deregistration batched during the
+    //  initialization and the deinitialization
+    //////////////////////////////////////////////////////
+    std::vector<std::shared_ptr<PVBaseImpl> > m_pendingPVs;
+
+    typedef std::vector<std::function<void()> > functionsList_t;
+    functionsList_t m_afterRegistration;
+
+    // Asynchronous delivery
+    ////////////////////////
+    size_t m_publishQueueSize; ///< 0 when the values are passed synchronously
+    overflowPolicy_t m_overflowPolicy;
+
+    typedef std::vector<std::shared_ptr<PublishQueueBase> > publishQueues_t;
+    publishQueues_t m_publishQueues; ///< Modified only while the dispatcher is stopped
+
+    std::unique_ptr<ThreadBaseImpl> m_pDispatcherThread;
+    std::atomic<bool> m_bDispatcherRunning;
+    std::atomic<bool> m_bDispatcherWaiting;
+    std::mutex m_lockDispatcher;
+    std::condition_variable m_dispatcherCondition;
+
     typedef std::map<int, std::shared_ptr<PVBaseImpl> > tRecords;
     tRecords m_records;
 };
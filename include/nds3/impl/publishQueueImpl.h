@@ -0,0 +1,238 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSPUBLISHQUEUEIMPL_H
+#define NDSPUBLISHQUEUEIMPL_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <time.h>
+
+#include "nds3/definitions.h"
+#include "nds3/sharedBuffer.h"
+
+namespace nds
+{
+
+class PVBaseImpl;
+class PortImpl;
+class InterfaceBaseImpl;
+
+/**
+ * @brief Returns the data type stored in the publish queue for a pushed type:
+ *        shared buffers are queued in the queue of the container they hold.
+ */
+template<typename T>
+struct PublishedType
+{
+    typedef T type;
+};
+
+template<typename T>
+struct PublishedType<SharedBuffer<T> >
+{
+    typedef T type;
+};
+
+
+/**
+ * @brief Holds a value queued in a PublishQueue.
+ *
+ * Strings and scalars are copied into the slot; the slot's content is swapped
+ *  with the dispatcher's one, so the string capacity is recycled.
+ */
+template<typename T>
+class PublishValue
+{
+public:
+    void store(const T& value)
+    {
+        m_value = value;
+    }
+
+    void swap(PublishValue<T>& other)
+    {
+        std::swap(m_value, other.m_value);
+    }
+
+    void publish(InterfaceBaseImpl& interface, const PVBaseImpl& pv, const timespec& timestamp);
+
+private:
+    T m_value;
+};
+
+/**
+ * @brief Holds an array queued in a PublishQueue.
+ *
+ * Arrays travel as shared containers: pushed SharedBuffer objects are queued
+ *  by reference, while plain vectors are copied into a container owned by the
+ *  slot and reused as soon as the control system releases it.
+ */
+template<typename T>
+class PublishValue<std::vector<T> >
+{
+public:
+    void store(const std::vector<T>& value);
+
+    void store(const SharedBuffer<std::vector<T> >& value)
+    {
+        m_pData = value.getPointer();
+    }
+
+    void swap(PublishValue<std::vector<T> >& other)
+    {
+        m_pData.swap(other.m_pData);
+    }
+
+    void publish(InterfaceBaseImpl& interface, const PVBaseImpl& pv, const timespec& timestamp);
+
+private:
+    std::shared_ptr<const std::vector<T> > m_pData;
+    std::shared_ptr<std::vector<T> > m_pOwnBuffer;
+};
+
+
+/**
+ * @brief Base class for the queues that transfer the pushed values from the
+ *        acquisition thread to the port's dispatcher thread.
+ */
+class PublishQueueBase
+{
+public:
+    PublishQueueBase(PVBaseImpl& pv, PortImpl& port, const overflowPolicy_t overflowPolicy);
+    virtual ~PublishQueueBase();
+
+    /**
+     * @brief Allocate a queue for the data type of the specified PV.
+     *
+     * @param pv             the PV that pushes the values
+     * @param port           the port that dispatches the values
+     * @param size           the maximum number of queued values (rounded up to
+     *                        a power of 2)
+     * @param overflowPolicy what to do when the queue is full
+     * @return the allocated queue
+     */
+    static PublishQueueBase* create(PVBaseImpl& pv, PortImpl& port, const size_t size, const overflowPolicy_t overflowPolicy);
+
+    /**
+     * @brief Called by the dispatcher thread: pass the queued values to the
+     *        control system.
+     *
+     * @param interface   the control system interface
+     * @param maxValues   maximum number of values to pass
+     * @return the number of values passed to the control system
+     */
+    virtual size_t dispatch(InterfaceBaseImpl& interface, const size_t maxValues) = 0;
+
+    /**
+     * @brief Return the data type held by the queue.
+     *
+     * @return the data type held by the queue
+     */
+    virtual dataType_t getDataType() const = 0;
+
+    /**
+     * @brief Return true if all the values pushed into the queue have been
+     *        dispatched or dropped.
+     *
+     * @return true if the queue is idle
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Return the number of values that have not reached the control
+     *        system because the queue was full.
+     *
+     * @return the number of dropped values
+     */
+    std::uint64_t getDroppedSamples() const;
+
+protected:
+    PVBaseImpl& m_pv;
+    PortImpl& m_port;
+    const overflowPolicy_t m_overflowPolicy;
+
+    std::atomic<std::uint64_t> m_queuedSamples;     ///< Written only by the producer
+    std::atomic<std::uint64_t> m_dispatchedSamples; ///< Written only by the dispatcher
+    std::atomic<std::uint64_t> m_discardedSamples;  ///< Queued samples dropped by the producer
+    std::atomic<std::uint64_t> m_droppedSamples;    ///< All the dropped samples
+};
+
+
+/**
+ * @brief Bounded lock-free queue between a PV's push() and the port's dispatcher.
+ *
+ * The PV (single producer) writes into the queue without locking; the port's
+ *  dispatcher thread reads from it. Only one thread at a time may push into
+ *  the queue: push() throws if it detects a concurrent producer.
+ *
+ * Each slot carries a sequence number that tells whether it is free or holds
+ *  a value: this allows the producer to remove the oldest value on its own
+ *  when the drop-oldest policy is in use.
+ *
+ * @tparam T the data type held by the queue
+ */
+template<typename T>
+class PublishQueue: public PublishQueueBase
+{
+public:
+    PublishQueue(PVBaseImpl& pv, PortImpl& port, const size_t size, const overflowPolicy_t overflowPolicy);
+
+    /**
+     * @brief Queue a value. Called only by the thread that pushes on the PV.
+     *
+     * With the block policy the producer waits for the dispatcher to free a
+     *  slot; if the dispatcher is not running then the value is dropped
+     *  instead. With the drop-oldest policy at most one queued value is
+     *  discarded per push.
+     *
+     * @tparam V        T or SharedBuffer<T>
+     * @param timestamp the value's timestamp
+     * @param value     the value to queue
+     */
+    template<typename V>
+    void push(const timespec& timestamp, const V& value);
+
+    virtual size_t dispatch(InterfaceBaseImpl& interface, const size_t maxValues);
+
+    virtual dataType_t getDataType() const;
+
+private:
+    template<typename V>
+    bool tryPush(const timespec& timestamp, const V& value);
+
+    bool pop(timespec* pTimestamp, PublishValue<T>* pValue);
+
+    struct Slot
+    {
+        std::atomic<size_t> m_sequence;
+        timespec m_timestamp;
+        PublishValue<T> m_value;
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // Keep the producer's and the consumers' positions on different cache lines
+    /////////////////////////////////////////////////////////////////////////////
+    char m_padding0[64];
+    std::atomic<size_t> m_writePosition;
+    std::atomic<bool> m_bPushing; ///< Set while a producer is in push()
+    char m_padding1[64];
+    std::atomic<size_t> m_readPosition;
+    char m_padding2[64];
+
+    PublishValue<T> m_dispatchValue; ///< Used only by the dispatcher thread
+};
+
+}
+#endif // NDSPUBLISHQUEUEIMPL_H
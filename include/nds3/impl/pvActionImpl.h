@@ -63,6 +63,12 @@ public:
      */
     virtual void read(timespec* pTimestamp, std::int32_t* pValue) const;
 
+    /**
+     * @brief Pass the values of the PV's data type to read() and the other
+     *        data types to PVBaseImpl::readValue().
+     */
+    virtual void readValue(timespec* pTimestamp, const TypedSpan& value) const;
+
     /**
      * @brief Called when the control system wants to write a value.
      *
@@ -73,6 +79,12 @@ public:
      */
     virtual void write(const timespec& timestamp, const std::int32_t& value);
 
+    /**
+     * @brief Pass the values of the PV's data type to write() and the other
+     *        data types to PVBaseImpl::writeValue().
+     */
+    virtual void writeValue(const timespec& timestamp, const ConstTypedSpan& value);
+
     /**
      * @brief Returns the PV's data type.
      *
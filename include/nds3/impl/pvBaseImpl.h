@@ -11,13 +11,27 @@
 #define NDSPVBASEIMPL_H
 
 #include <string>
+#include <stdexcept>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
 #include "nds3/definitions.h"
+#include "nds3/exceptions.h"
 #include "nds3/impl/baseImpl.h"
+#include "nds3/impl/pvStatisticsImpl.h"
 
 namespace nds
 {
 
 class PVBase;
+class PortImpl;
+class InterfaceBaseImpl;
+
+template<typename void_t> class TypedSpanBase;
+typedef TypedSpanBase<void> TypedSpan;
+typedef TypedSpanBase<const void> ConstTypedSpan;
 
 /**
  * @brief Base class for all the PVs.
@@ -39,37 +53,79 @@ public:
      */
     virtual void deinitialize();
 
+    virtual void setStatisticsEnabled(const bool bEnabled);
+
+    virtual void collectStatistics(parameters_t* pStatistics);
+
+    /**
+     * @brief Return the runtime statistics of the PV.
+     *
+     * @return the statistics, or 0 if the statistics are disabled
+     */
+    PVStatistics* getStatistics() const
+    {
+        return m_pStatistics.load(std::memory_order_acquire);
+    }
+
     /**
      * @brief Called when the control system wants to read the value.
      *
-     * The default implementation throws an exception.
+     * Wraps pValue in a TypedSpan and calls readValue(). The data type is
+     *  checked at compile time: only the types enumerated by dataType_t
+     *  are accepted.
      *
-     * @param pTimestamp
-     * @param pValue
+     * @tparam T         the type of the variable that receives the value
+     * @param pTimestamp pointer to a variable that will be filled with the timestamp
+     * @param pValue     pointer to a variable that will be filled with the value
      */
-    virtual void read(timespec* pTimestamp, std::int32_t* pValue) const;
-    virtual void read(timespec* pTimestamp, double* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::uint8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int32_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<double>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::string* pValue) const;
+    template<typename T>
+    void read(timespec* pTimestamp, T* pValue) const;
 
     /**
      * @brief Called when the control system wants to write a value.
      *
-     * The default implementation throws an exception.
+     * Wraps the value in a ConstTypedSpan and calls writeValue(). The data type is
+     *  checked at compile time: only the types enumerated by dataType_t
+     *  are accepted.
      *
-     * @param timestamp
-     * @param value
+     * @tparam T        the type of the value
+     * @param timestamp the timestamp related to the value
+     * @param value     the value to write
      */
-    virtual void write(const timespec& timestamp, const std::int32_t& value);
-    virtual void write(const timespec& timestamp, const double& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::int8_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::uint8_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::int32_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<double>& value);
-    virtual void write(const timespec& timestamp, const std::string& value);
+    template<typename T>
+    void write(const timespec& timestamp, const T& value);
+
+    /**
+     * @brief Read the value into a variable of any of the supported data types.
+     *
+     * This is the only virtual read function: the PVs override it for the data
+     *  type they store. The bridging code can retrieve the data type once
+     *  with getDataType() and then pass spans of that type.
+     *
+     * The default implementation reads the arrays of int8 as arrays of uint8
+     *  and the arrays of uint8 from the string PVs (EPICS uses those data
+     *  types interchangeably), and throws PVDataTypeError for the other
+     *  data types.
+     *
+     * @param pTimestamp pointer to a variable that will be filled with the timestamp
+     * @param value      references the variable that will be filled with the value
+     */
+    virtual void readValue(timespec* pTimestamp, const TypedSpan& value) const;
+
+    /**
+     * @brief Write a value of any of the supported data types.
+     *
+     * This is the only virtual write function: the PVs override it for the data
+     *  type they store.
+     *
+     * The default implementation writes the arrays of int8 as arrays of uint8
+     *  and the arrays of uint8 into the string PVs, and throws PVDataTypeError
+     *  for the other data types.
+     *
+     * @param timestamp the timestamp related to the value
+     * @param value     references the value to write
+     */
+    virtual void writeValue(const timespec& timestamp, const ConstTypedSpan& value);
 
     /**
      * @brief Retrieve the data direction.
@@ -184,26 +240,70 @@ public:
     /**
      * @brief Return the data type enumerator for the type in the template.
      *
+     * Unsupported types are rejected at compile time.
+     *
      * @tparam type for which the data type enumerator is requested
      * @return an enumerator for the data type in the template
      */
     template<typename T>
-    static dataType_t getDataTypeForCPPType()
+    static constexpr dataType_t getDataTypeForCPPType()
     {
-        const int type =
-                int(std::is_same<T, std::int32_t>::value) * (int)dataType_t::dataInt32 +
-                int(std::is_same<T, double>::value) * (int)dataType_t::dataFloat64 +
-                int(std::is_same<T, std::vector<std::int8_t> >::value) * (int)dataType_t::dataInt8Array +
-                int(std::is_same<T, std::vector<std::uint8_t> >::value) * (int)dataType_t::dataUint8Array +
-                int(std::is_same<T, std::vector<std::int32_t> >::value) * (int)dataType_t::dataInt32Array +
-                int(std::is_same<T, std::vector<double> >::value) * (int)dataType_t::dataFloat64Array +
-                int(std::is_same<T, std::string>::value) * (int)dataType_t::dataString;
-
-        static_assert(type != 0, "Undefined data type");
-        return(dataType_t)type;
+        static_assert(getDataTypeValueForCPPType<T>() != 0, "Undefined data type");
+        return (dataType_t)getDataTypeValueForCPPType<T>();
     }
 
 protected:
+    /**
+     * @brief Return the control system interface of the port that registered
+     *        the PV, resolved during initialize().
+     *
+     * @return the control system interface
+     */
+    InterfaceBaseImpl& getInterface() const
+    {
+        if(m_pInterface == 0)
+        {
+            throw std::logic_error("The PV has not been initialized");
+        }
+        return *m_pInterface;
+    }
+
+    /**
+     * @brief Copy a string into an array of uint8 referenced by a TypedSpan.
+     *
+     * Used by the PVs that store the value to read the string PVs as arrays
+     *  of uint8 without a temporary string. The data types must have been
+     *  checked by the caller: the overload for the other data types does
+     *  nothing.
+     *
+     * @param value the string to copy
+     * @param bytes references the array of uint8 that receives the value
+     */
+    template<typename T>
+    static void copyStringBytes(const T& /* value */, const TypedSpan& /* bytes */)
+    {
+    }
+
+    static void copyStringBytes(const std::string& value, const TypedSpan& bytes);
+
+    /**
+     * @brief Assign an array of uint8 referenced by a ConstTypedSpan to a string.
+     *
+     * Used by the PVs that store the value to write the string PVs from arrays
+     *  of uint8 directly into the stored string. The data types must have been
+     *  checked by the caller: the overload for the other data types does
+     *  nothing.
+     *
+     * @param bytes  references the array of uint8 to assign
+     * @param pValue the string that receives the value
+     */
+    template<typename T>
+    static void assignStringBytes(const ConstTypedSpan& /* bytes */, T* /* pValue */)
+    {
+    }
+
+    static void assignStringBytes(const ConstTypedSpan& bytes, std::string* pValue);
+
     std::string m_description;          ///< The PV's description.
     std::string m_units;                ///< Engineering units
     scanType_t m_scanType;              ///< The PV's scan type.
@@ -211,7 +311,118 @@ protected:
     size_t m_maxElements;               ///< Maximum number of elements that can be stored in the PV.
     enumerationStrings_t m_enumeration; ///< List of strings used for enumeration.
     bool m_bProcessAtInit;              ///< True if the PV has to be processed during the device initialization.
+
+    PortImpl* m_pPort;                  ///< The port that registered the PV. Valid while the PV is initialized.
+    InterfaceBaseImpl* m_pInterface;    ///< The port's control system interface. Valid while the PV is initialized.
+
+private:
+    template<typename T>
+    static constexpr int getDataTypeValueForCPPType()
+    {
+        return
+                int(std::is_same<T, std::int32_t>::value) * (int)dataType_t::dataInt32 +
+                int(std::is_same<T, double>::value) * (int)dataType_t::dataFloat64 +
+                int(std::is_same<T, std::vector<std::int8_t> >::value) * (int)dataType_t::dataInt8Array +
+                int(std::is_same<T, std::vector<std::uint8_t> >::value) * (int)dataType_t::dataUint8Array +
+                int(std::is_same<T, std::vector<std::int32_t> >::value) * (int)dataType_t::dataInt32Array +
+                int(std::is_same<T, std::vector<double> >::value) * (int)dataType_t::dataFloat64Array +
+                int(std::is_same<T, std::string>::value) * (int)dataType_t::dataString +
+                int(std::is_same<T, std::int16_t>::value) * (int)dataType_t::dataInt16 +
+                int(std::is_same<T, std::uint16_t>::value) * (int)dataType_t::dataUint16 +
+                int(std::is_same<T, std::int64_t>::value) * (int)dataType_t::dataInt64 +
+                int(std::is_same<T, float>::value) * (int)dataType_t::dataFloat32 +
+                int(std::is_same<T, std::vector<std::int16_t> >::value) * (int)dataType_t::dataInt16Array +
+                int(std::is_same<T, std::vector<std::uint16_t> >::value) * (int)dataType_t::dataUint16Array +
+                int(std::is_same<T, std::vector<std::int64_t> >::value) * (int)dataType_t::dataInt64Array +
+                int(std::is_same<T, std::vector<float> >::value) * (int)dataType_t::dataFloat32Array;
+    }
+
+    std::atomic<PVStatistics*> m_pStatistics;         ///< The statistics, or 0 if disabled.
+    std::unique_ptr<PVStatistics> m_pStatisticsStorage; ///< Allocated when first enabled, kept until the PV is destroyed.
+    std::mutex m_lockStatistics;                      ///< Serializes enabling and disabling the statistics.
 };
 
+
+/**
+ * @brief References a variable of one of the data types supported by the PVs
+ *        and remembers its data type.
+ *
+ * Used by PVBaseImpl::readValue() (TypedSpan) and PVBaseImpl::writeValue()
+ *  (ConstTypedSpan) to pass the values of all the data types through
+ *  a single virtual function.
+ *
+ * @tparam void_t void for the spans that can be modified, const void for
+ *                the read-only ones
+ */
+template<typename void_t>
+class TypedSpanBase
+{
+public:
+    /**
+     * @brief Reference a variable. The data type is deduced at compile time.
+     *
+     * @param pValue the referenced variable
+     */
+    template<typename T>
+    explicit TypedSpanBase(T* pValue):
+        m_dataType(PVBaseImpl::getDataTypeForCPPType<typename std::remove_const<T>::type>()), m_pValue(pValue)
+    {}
+
+    /**
+     * @brief Reference a variable with an explicit data type. Used to read or
+     *        write a variable as a data type with the same memory layout.
+     *
+     * @param dataType the data type to assign to the variable
+     * @param pValue   the referenced variable
+     */
+    TypedSpanBase(const dataType_t dataType, void_t* pValue): m_dataType(dataType), m_pValue(pValue)
+    {}
+
+    /**
+     * @brief Return the data type of the referenced variable.
+     *
+     * @return the data type of the referenced variable
+     */
+    dataType_t getDataType() const
+    {
+        return m_dataType;
+    }
+
+    /**
+     * @brief Return the referenced variable.
+     *
+     * Throws PVDataTypeError if T is not the data type of the variable.
+     *
+     * @tparam T the variable type (const qualified for ConstTypedSpan)
+     * @return a pointer to the referenced variable
+     */
+    template<typename T>
+    T* get() const
+    {
+        if(m_dataType != PVBaseImpl::getDataTypeForCPPType<typename std::remove_const<T>::type>())
+        {
+            throw PVDataTypeError("The requested data type does not match the data type of the value");
+        }
+        return static_cast<T*>(m_pValue);
+    }
+
+private:
+    dataType_t m_dataType;
+    void_t* m_pValue;
+};
+
+
+template<typename T>
+void PVBaseImpl::read(timespec* pTimestamp, T* pValue) const
+{
+    readValue(pTimestamp, TypedSpan(pValue));
+}
+
+template<typename T>
+void PVBaseImpl::write(const timespec& timestamp, const T& value)
+{
+    writeValue(timestamp, ConstTypedSpan(&value));
+}
+
 }
 #endif // NDSPVBASEIMPL_H
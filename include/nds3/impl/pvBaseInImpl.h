@@ -11,17 +11,20 @@
 #define NDSPVBASEINIMPL_H
 
 #include <string>
-#include <set>
 #include <mutex>
+#include <memory>
+#include <atomic>
 #include "nds3/definitions.h"
 #include "nds3/impl/baseImpl.h"
 #include "nds3/impl/pvBaseImpl.h"
+#include "nds3/impl/copyOnWriteListImpl.h"
 
 namespace nds
 {
 
 class PVBase;
 class PVBaseOutImpl;
+class PublishQueueBase;
 
 /**
  * @brief Base class for all the PVs.
@@ -36,18 +39,8 @@ public:
      */
     PVBaseInImpl(const std::string& name, const inputPvType_t pvType);
 
-    virtual void initialize(FactoryBaseImpl& controlSystem);
-
     virtual void deinitialize();
 
-    virtual void read(timespec* pTimestamp, std::int32_t* pValue) const;
-    virtual void read(timespec* pTimestamp, double* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::uint8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int32_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<double>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::string* pValue) const;
-
     /**
      * @brief Pushes data to the control system and to the subscribed PVs.
      *
@@ -58,6 +51,56 @@ public:
     template<typename T>
     void push(const timespec& timestamp, const T& value);
 
+    /**
+     * @brief Advances the decimation counter for a pushed value.
+     *
+     * Call it once per pushed value, before computing what
+     *  pushToControlSystem() will receive.
+     *
+     * @return true if the value must be pushed to the control system
+     */
+    bool passDecimation();
+
+    /**
+     * @brief Pushes data to the control system only, without applying the
+     *        decimation.
+     *
+     * push() calls this when passDecimation() returns true, and then
+     *  pushToLinkedPVs().
+     *
+     * @tparam T the data type
+     * @param timestamp    the timestamp related to the data
+     * @param value        the data to push
+     */
+    template<typename T>
+    void pushToControlSystem(const timespec& timestamp, const T& value);
+
+    /**
+     * @brief Pushes data to the subscribed output PVs and to the replication
+     *        destinations only.
+     *
+     * @tparam T the data type
+     * @param timestamp    the timestamp related to the data
+     * @param value        the data to push
+     */
+    template<typename T>
+    void pushToLinkedPVs(const timespec& timestamp, const T& value);
+
+    /**
+     * @brief Pushes a block of scalar samples to the control system and to the
+     *        subscribed PVs.
+     *
+     * The decimation is applied to the whole block at once: the samples that
+     *  pass it are passed to the control system in one call.
+     *
+     * @tparam T the data type
+     * @param pTimestamps  the samples' timestamps
+     * @param pValues      the samples to push
+     * @param count        the number of samples in pTimestamps and pValues
+     */
+    template<typename T>
+    void pushBatch(const timespec* pTimestamps, const T* pValues, const size_t count);
+
     /**
      * @brief Subscribe an output PV to this PV.
      *
@@ -109,6 +152,32 @@ public:
      */
     void replicateFrom(const std::string& sourceInputPVName);
 
+    /**
+     * @brief Set the queue used to pass the pushed values to the port's
+     *        dispatcher thread. Called by the port when the PV is registered,
+     *        before the dispatcher starts, and after the dispatcher has
+     *        stopped when the PV is deregistered.
+     *
+     * @param pQueue the queue, owned by the port, or 0 to push synchronously
+     */
+    void setPublishQueue(PublishQueueBase* pQueue);
+
+    /**
+     * @brief Return the queue used to pass the pushed values to the port's
+     *        dispatcher thread.
+     *
+     * @return the publish queue, or 0 if the values are pushed synchronously
+     */
+    PublishQueueBase* getPublishQueue() const;
+
+    /**
+     * @brief Return the number of pushed values that did not reach the control
+     *        system because the publish queue was full.
+     *
+     * @return the number of dropped values
+     */
+    std::uint64_t getDroppedSamples() const;
+
     virtual dataDirection_t getDataDirection() const;
 
     virtual std::string buildFullExternalName(const FactoryBaseImpl& controlSystem) const;
@@ -121,8 +190,11 @@ protected:
 
     /**
      * @brief List of subscribed PVs.
+     *
+     * The list is traversed without locking on every push: subscribing and
+     *  unsubscribing replace the whole list.
      */
-    typedef std::set<PVBaseOutImpl*> subscribersList_t;
+    typedef CopyOnWriteList<PVBaseOutImpl*> subscribersList_t;
 
     /**
      * @brief List of subscribed PVs.
@@ -132,19 +204,37 @@ protected:
     /**
      * @brief List of destination input PVs.
      */
-    typedef std::set<PVBaseInImpl*> destinationList_t;
+    typedef CopyOnWriteList<PVBaseInImpl*> destinationList_t;
 
     /**
      * @brief List of PVs to which the data must be pushed or written
      */
     destinationList_t m_replicationDestinationPVs;
 
-    std::mutex m_lockSubscribersList; ///< Lock the access to m_subscriberOutputPVs.
-
     std::uint32_t m_decimationFactor;  ///< Decimation factor.
     std::uint32_t m_decimationCount;   ///< Keeps track of the received data/vs data pushed to the control system.
 
+    /**
+     * @brief Buffers that receive the samples of a batch that pass the
+     *        decimation, allocated by the first decimated batch and reused
+     *        by the following ones.
+     */
+    std::shared_ptr<void> m_pDecimationBuffers;
+    dataType_t m_decimationBuffersType;
+
+    /**
+     * @brief Set when the port delivers the values asynchronously.
+     *
+     * The port owns the queue (PortImpl::m_publishQueues) and keeps it alive
+     *  while the PV is registered. A plain atomic pointer lets push() reach
+     *  the queue without a lock and without touching a reference count.
+     */
+    std::atomic<PublishQueueBase*> m_pPublishQueue;
+
 private:
+    template<typename T>
+    void pushBatchToControlSystem(const timespec* pTimestamps, const T* pValues, const size_t count);
+
     parameters_t commandReplicate(const parameters_t& parameters);
     parameters_t commandDecimation(const parameters_t& parameters);
 
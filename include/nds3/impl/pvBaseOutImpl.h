@@ -41,26 +41,8 @@ public:
      */
     void subscribeTo(const std::string& inputPVName);
 
-    virtual void initialize(FactoryBaseImpl& controlSystem);
-
     virtual void deinitialize();
 
-    virtual void read(timespec* pTimestamp, std::int32_t* pValue) const;
-    virtual void read(timespec* pTimestamp, double* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::uint8_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<std::int32_t>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::vector<double>* pValue) const;
-    virtual void read(timespec* pTimestamp, std::string* pValue) const;
-
-    virtual void write(const timespec& timestamp, const std::int32_t& value);
-    virtual void write(const timespec& timestamp, const double& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::int8_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::uint8_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<std::int32_t>& value);
-    virtual void write(const timespec& timestamp, const std::vector<double>& value);
-    virtual void write(const timespec& timestamp, const std::string& value);
-
     virtual dataDirection_t getDataDirection() const;
 
     virtual std::string buildFullExternalName(const FactoryBaseImpl& controlSystem) const;
@@ -0,0 +1,258 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSPVHISTORYINIMPL_H
+#define NDSPVHISTORYINIMPL_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include "nds3/impl/pvBaseInImpl.h"
+
+namespace nds
+{
+
+/**
+ * @internal
+ * @brief Value stored in a slot of the history ring.
+ *
+ * The vectors and the strings are stored in an immutable shared buffer
+ *  replaced with std::atomic_store(), so a reader can copy the value while
+ *  the writer replaces it. Each stored value allocates a new buffer, and
+ *  std::atomic_store() and std::atomic_load() on a shared_ptr take a lock
+ *  from a small pool shared by the whole process.
+ */
+template <typename T, bool bScalar = std::is_arithmetic<T>::value>
+class HistoryValue
+{
+public:
+    void store(const T& value)
+    {
+        std::shared_ptr<const T> pValue(std::make_shared<T>(value));
+        std::atomic_store(&m_pValue, pValue);
+    }
+
+    void load(T* pValue) const
+    {
+        std::shared_ptr<const T> pStoredValue(std::atomic_load(&m_pValue));
+        if(pStoredValue.get() == 0)
+        {
+            *pValue = T();
+            return;
+        }
+        *pValue = *pStoredValue;
+    }
+
+private:
+    std::shared_ptr<const T> m_pValue;
+};
+
+/**
+ * @internal
+ * @brief Value stored in a slot of the history ring: specialization for
+ *        the scalar types.
+ */
+template <typename T>
+class HistoryValue<T, true>
+{
+public:
+    HistoryValue(): m_value(T())
+    {}
+
+    void store(const T& value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    void load(T* pValue) const
+    {
+        *pValue = m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<T> m_value;
+};
+
+/**
+ * @internal
+ * @brief A slot in the history ring. Each slot occupies a whole cache line,
+ *        so the writer and the readers of adjacent slots don't contend for
+ *        the same line.
+ *
+ * m_sequence is 2 * position + 1 while the writer stores the sample for
+ *  the specified position and 2 * position + 2 when the sample is complete.
+ */
+template <typename T>
+struct alignas(64) HistorySlot
+{
+    HistorySlot(): m_sequence(0), m_seconds(0), m_nanoseconds(0)
+    {}
+
+    std::atomic<std::uint64_t> m_sequence;
+    std::atomic<std::int64_t> m_seconds;
+    std::atomic<std::int64_t> m_nanoseconds;
+    HistoryValue<T> m_value;
+};
+
+/**
+ * @brief Implementation of an input PV that keeps the last samples stored
+ *        into it.
+ *
+ * The samples are stored in a preallocated ring. Each slot has a sequence
+ *  number that tells the reader if the writer overwrote the slot while it
+ *  was being copied, in which case the sample is skipped because it is no
+ *  longer part of the history.
+ *
+ * For the scalar types the readers and the writer never lock and storing a
+ *  value does not allocate memory. The vectors and the strings are stored
+ *  in a buffer allocated for each sample and exchanged through a short
+ *  internal lock (see HistoryValue).
+ *
+ * Only one thread can store values into the PV at any given time.
+ *
+ * @tparam T  the PV data type.
+ *            The following data types are supported:
+ *            - std::int32_t
+ *            - std::double
+ *            - std::vector<std::int8_t>
+ *            - std::vector<std::uint8_t>
+ *            - std::vector<std::int32_t>
+ *            - std::vector<double>
+ *            - std::string
+ *            - std::int16_t
+ *            - std::uint16_t
+ *            - std::int64_t
+ *            - float
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
+ */
+template <typename T>
+class NDS3_API PVHistoryInImpl: public PVBaseInImpl
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param name        the PV name
+     * @param historySize the number of samples to keep. Rounded up to the next
+     *                    power of 2
+     */
+    PVHistoryInImpl(const std::string& name, const size_t historySize);
+
+    ~PVHistoryInImpl();
+
+    /**
+     * @brief Called by the control system to read the last stored value
+     *
+     * @param pTimestamp pointer to a variable that will be filled with the stored timestamp
+     * @param pValue     pointer to a variable that will be filled with the stored value
+     */
+    virtual void read(timespec* pTimestamp, T* pValue) const;
+
+    /**
+     * @brief Pass the values of the PV's data type to read() and the other
+     *        data types to PVBaseImpl::readValue().
+     */
+    virtual void readValue(timespec* pTimestamp, const TypedSpan& value) const;
+
+    /**
+     * @brief Return the PV data type
+     *
+     * @return the data type of the stored value
+     */
+    virtual dataType_t getDataType() const;
+
+    /**
+     * @brief Store a value in the history. The timestamp is set to the current time.
+     *
+     * If output PVs are subscribers of this PV then the new value will be pushed
+     *  to the subscribers in the same thread that call this function.
+     *
+     * @param value value to store into the PV
+     */
+    void setValue(const T& value);
+
+    /**
+     * @brief Store a value and its timestamp in the history.
+     *
+     * If output PVs are subscribers of this PV then the new value will be pushed
+     *  to the subscribers in the same thread that call this function.
+     *
+     * @param timestamp timestamp related to the value
+     * @param value     value to store in the PV
+     */
+    void setValue(const timespec& timestamp, const T& value);
+
+    /**
+     * @brief Copy the most recent samples, from the oldest to the newest.
+     *
+     * @param maxSamples  the maximum number of samples to copy
+     * @param pTimestamps filled with the timestamps of the samples
+     * @param pValues     filled with the values of the samples
+     * @return the number of copied samples
+     */
+    size_t getLast(const size_t maxSamples, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const;
+
+    /**
+     * @brief Copy the samples stored after the sample with the specified
+     *        timestamp, from the oldest to the newest.
+     *
+     * The history is scanned backwards from the newest sample and the scan
+     *  stops at the first sample with a timestamp equal or older than
+     *  the specified one.
+     *
+     * @param since       the timestamp of the last sample already retrieved
+     * @param pTimestamps filled with the timestamps of the samples
+     * @param pValues     filled with the values of the samples
+     * @return the number of copied samples
+     */
+    size_t getSince(const timespec& since, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const;
+
+    /**
+     * @brief Return the number of samples that the history can hold.
+     *
+     * @return the size of the ring
+     */
+    size_t getHistorySize() const;
+
+private:
+    /**
+     * @brief Copy the sample stored at the specified position.
+     *
+     * @return false if the sample has been overwritten
+     */
+    bool readSample(const std::uint64_t position, timespec* pTimestamp, T* pValue) const;
+
+    /**
+     * @brief Copy the timestamp of the sample stored at the specified position.
+     *
+     * @return false if the sample has been overwritten
+     */
+    bool readTimestamp(const std::uint64_t position, timespec* pTimestamp) const;
+
+    /**
+     * @brief Copy the samples in the range [firstPosition, endPosition).
+     */
+    size_t copySamples(const std::uint64_t firstPosition, const std::uint64_t endPosition, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const;
+
+    const size_t m_historySize;
+    const std::uint64_t m_positionMask;
+
+    HistorySlot<T>* m_pSlots;
+
+    char m_padding0[64];
+    std::atomic<std::uint64_t> m_writePosition; ///< Position of the next sample to store
+    char m_padding1[64];
+};
+
+}
+#endif // NDSPVHISTORYINIMPL_H
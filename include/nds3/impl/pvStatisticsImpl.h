@@ -0,0 +1,125 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSPVSTATISTICSIMPL_H
+#define NDSPVSTATISTICSIMPL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+/**
+ * @brief Lock-free histogram of durations, with fixed power-of-2 buckets.
+ *
+ * The first bucket holds the durations shorter than 256 ns, each following
+ *  bucket doubles the upper limit of the previous one; the last bucket holds
+ *  all the durations longer than about 4 ms.
+ */
+class LatencyHistogram
+{
+public:
+    static const size_t m_numBuckets = 16;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Add a duration to the histogram. Can be called concurrently
+     *        by several threads.
+     *
+     * @param nanoseconds the duration, in nanoseconds
+     */
+    void addSample(const std::uint64_t nanoseconds);
+
+    /**
+     * @brief Return the number of durations added to the histogram.
+     *
+     * @return the number of durations
+     */
+    std::uint64_t getCount() const;
+
+    /**
+     * @brief Describe the histogram in a human readable form.
+     *
+     * @return the count, mean, maximum and the non empty buckets
+     */
+    std::string describe() const;
+
+private:
+    std::atomic<std::uint64_t> m_buckets[m_numBuckets];
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::uint64_t> m_totalNanoseconds;
+    std::atomic<std::uint64_t> m_maxNanoseconds;
+};
+
+
+/**
+ * @brief Runtime statistics of a PV.
+ *
+ * The counters are updated without locking from the threads that push,
+ *  read or write the PV. getStatistics() calculates the rates since its
+ *  previous call.
+ */
+class PVStatistics
+{
+public:
+    PVStatistics();
+
+    void addPushes(const std::uint64_t pushes);
+    void addDecimatedSamples(const std::uint64_t samples);
+    void addInterfacePush(const std::uint64_t nanoseconds);
+
+    void addRead();
+    void addDelegateRead(const std::uint64_t nanoseconds);
+
+    void addWrite();
+    void addDelegateWrite(const std::uint64_t nanoseconds);
+
+    /**
+     * @brief Append the statistics to a list of strings, one line per
+     *        statistic, each one prefixed by the PV name.
+     *
+     * @param pvName      the name of the PV
+     * @param pStatistics the list to which the statistics are appended
+     */
+    void getStatistics(const std::string& pvName, parameters_t* pStatistics);
+
+    /**
+     * @brief Return the time from a monotonic clock, used to measure the
+     *        durations.
+     *
+     * @return the monotonic time, in nanoseconds
+     */
+    static std::uint64_t getMonotonicNanoseconds();
+
+private:
+    std::atomic<std::uint64_t> m_pushes;
+    std::atomic<std::uint64_t> m_decimatedSamples;
+    std::atomic<std::uint64_t> m_reads;
+    std::atomic<std::uint64_t> m_writes;
+
+    LatencyHistogram m_interfacePushTime;
+    LatencyHistogram m_delegateReadTime;
+    LatencyHistogram m_delegateWriteTime;
+
+    // Used to calculate the rates in getStatistics()
+    /////////////////////////////////////////////////
+    std::mutex m_lockRates;
+    std::uint64_t m_lastTime;
+    std::uint64_t m_lastPushes;
+    std::uint64_t m_lastReads;
+    std::uint64_t m_lastWrites;
+};
+
+}
+#endif // NDSPVSTATISTICSIMPL_H
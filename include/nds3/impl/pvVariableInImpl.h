@@ -29,6 +29,14 @@ namespace nds
  *            - std::vector<std::int32_t>
  *            - std::vector<double>
  *            - std::string
+ *            - std::int16_t
+ *            - std::uint16_t
+ *            - std::int64_t
+ *            - float
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
  */
 template <typename T>
 class NDS3_API PVVariableInImpl: public PVBaseInImpl
@@ -49,6 +57,12 @@ public:
      */
     virtual void read(timespec* pTimestamp, T* pValue) const;
 
+    /**
+     * @brief Pass the values of the PV's data type to read() and the other
+     *        data types to PVBaseImpl::readValue().
+     */
+    virtual void readValue(timespec* pTimestamp, const TypedSpan& value) const;
+
     /**
      * @brief Return the PV data type
      *
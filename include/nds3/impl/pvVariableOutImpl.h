@@ -29,6 +29,14 @@ namespace nds
  *            - std::vector<std::int32_t>
  *            - std::vector<double>
  *            - std::string
+ *            - std::int16_t
+ *            - std::uint16_t
+ *            - std::int64_t
+ *            - float
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
  */
 template <typename T>
 class PVVariableOutImpl: public PVBaseOutImpl
@@ -50,6 +58,12 @@ public:
      */
     virtual void read(timespec* pTimestamp, T* pValue) const;
 
+    /**
+     * @brief Pass the values of the PV's data type to read() and the other
+     *        data types to PVBaseImpl::readValue().
+     */
+    virtual void readValue(timespec* pTimestamp, const TypedSpan& value) const;
+
     /**
      * @brief Called when the control system wants to write a value into the PV.
      *
@@ -58,6 +72,12 @@ public:
      */
     virtual void write(const timespec& timestamp, const T& value);
 
+    /**
+     * @brief Pass the values of the PV's data type to write() and the other
+     *        data types to PVBaseImpl::writeValue().
+     */
+    virtual void writeValue(const timespec& timestamp, const ConstTypedSpan& value);
+
     /**
      * @brief Return the data type of the PV.
      * @return an enumeration representing the data type
@@ -10,9 +10,16 @@
 #ifndef NDSSTATEMACHINEIMPL_H
 #define NDSSTATEMACHINEIMPL_H
 
-#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
 #include "nds3/definitions.h"
 #include "nds3/impl/nodeImpl.h"
+#include "nds3/impl/threadBaseImpl.h"
 
 namespace nds
 {
@@ -91,19 +98,33 @@ public:
      *                 - state_t::on
      *                 - state_t::running
      *                 - state_t::fault
+     * @return a future that receives the local state reached at the end of the
+     *         transition, or the exception thrown by the transition.
+     *         If the state machine is asynchronous then the transition is queued
+     *         and executed after the transitions requested before it
      */
-    void setState(const state_t newState);
+    std::future<state_t> setState(const state_t newState);
 
     /**
      * @brief Return the local state. The local state does not reflect the state of the children.
+     *        Does not lock.
      *
      * @return the current local state
      */
     virtual state_t getLocalState() const;
 
+    /**
+     * @brief Return the local state and the time of its last change.
+     *
+     * @param pTimestamp filled with the time of the last local state change
+     * @param pState     filled with the local state
+     */
+    void getLocalState(timespec* pTimestamp, state_t* pState) const;
+
     /**
      * @brief Return the global state. The global state takes into consideration the states
      *        of the children of the node to which the state machine is attached.
+     *        Maintained by the node: does not visit the children.
      *
      * @param pTimestamp pointer to a variable that will be filled with the timestamp
      * @param pState     pointer to a variable that will be filled with the current global state
@@ -119,6 +140,15 @@ public:
      */
     bool canChange(const state_t newState) const;
 
+    /**
+     * @brief Push the global state to the getGlobalState PV. Called by the node
+     *        to which the state machine is attached when its global state changes.
+     *
+     * @param timestamp the time at which the global state was entered
+     * @param state     the new global state
+     */
+    void pushGlobalState(const timespec& timestamp, const state_t state);
+
     /**
      * @brief Returns true if the transition between two states is legal (does not
      *        check the delegate function allowChange_t declared in the constructor).
@@ -162,6 +192,29 @@ public:
 
 protected:
 
+    /**
+     * @brief Find the transition from the current local state to the requested one,
+     *        check that it is allowed and set the intermediate state.
+     *        Throws if the transition does not exist or is denied.
+     *
+     * @param newState            the requested state
+     * @param pInitialState       filled with the state before the transition
+     * @param pTransitionFunction filled with the delegate function that executes the transition
+     * @return false if the state machine is already in the requested state
+     */
+    bool prepareTransition(const state_t newState, state_t* pInitialState, stateChange_t* pTransitionFunction);
+
+    /**
+     * @brief Find the delegate function and the intermediate state of a transition.
+     *
+     * @param initialState        the state before the transition
+     * @param finalState          the requested state
+     * @param pTransitionFunction filled with the delegate function that executes the transition
+     * @param pTransitionState    filled with the intermediate state
+     * @return false if the transition does not exist
+     */
+    bool getTransition(const state_t initialState, const state_t finalState, stateChange_t* pTransitionFunction, state_t* pTransitionState) const;
+
     /**
      * @brief Execute the state transition. May be called from a separate thread.
      *
@@ -172,14 +225,39 @@ protected:
     void executeTransition(const state_t initialState, const state_t finalState, stateChange_t transitionFunction);
 
     /**
-     * @brief Thread function executed for asynchronous state machines. Calls executeTransition()
-     *        and catches its exceptions.
+     * @brief Set the local state, push it to the getState PV and notify the
+     *        node to which the state machine is attached.
+     *        The caller must hold m_stateMutex.
      *
-     * @param initialState       the initial state
-     * @param finalState         the final state
-     * @param transitionFunction the delegate function that executes the transition
+     * @param state the new local state
      */
-    void executeTransitionThread(const state_t initialState, const state_t finalState, stateChange_t transitionFunction);
+    void setLocalState(const state_t state);
+
+    /**
+     * @brief Push the local state to the getState PV. Called by the port after
+     *        the PVs have been registered with the control system.
+     */
+    void pushLocalState();
+
+    /**
+     * @brief Executed by a pooled thread for asynchronous state machines: executes the
+     *        queued transitions until the queue is empty.
+     */
+    void executeQueuedTransitions();
+
+    /**
+     * @brief Called when the thread that executes the queued transitions cannot be
+     *        launched: restores the state and fails all the queued transitions.
+     *
+     * @param error the error stored in the futures of the queued transitions
+     */
+    void failQueuedTransitions(std::exception_ptr error);
+
+    /**
+     * @brief Wait until the queued transitions have been executed and the thread
+     *        that executed them has terminated.
+     */
+    void waitQueuedTransitions();
 
     /**
      * @brief Delegate function called to read the local state.
@@ -213,14 +291,38 @@ protected:
      */
     static std::string getStateName(const state_t state);
 
-    bool m_bAsync;                     ///< If true then the state transitions happen in another thread (held by m_transitionThread)
+    bool m_bAsync;                     ///< If true then the state transitions happen in a pooled thread (held by m_pTransitionThread)
 
-    std::thread m_transitionThread;    ///< Thread that is used to execute the state transition when bAsync is true in the constructor
-    std::mutex m_lockTransitionThread; ///< Lock the access to m_transitionThread
-
-    state_t m_localState;              ///< The local state
+    /**
+     * @brief A transition requested to an asynchronous state machine.
+     */
+    struct transitionRequest_t
+    {
+        state_t m_newState;                    ///< The requested state
+        bool m_bPrepared;                      ///< true if setState() already set the intermediate state
+        state_t m_initialState;                ///< Valid when m_bPrepared is true
+        stateChange_t m_transitionFunction;    ///< Valid when m_bPrepared is true
+        std::shared_ptr<std::promise<state_t> > m_pResult;
+    };
+
+    typedef std::deque<transitionRequest_t> transitionsQueue_t;
+    transitionsQueue_t m_transitionsQueue; ///< Transitions waiting for execution. Protected by m_stateMutex
+    bool m_bExecutingTransitions;      ///< true while a pooled thread executes the queued transitions
+    state_t m_queuedState;             ///< The state reached after the queued transitions
+    std::condition_variable_any m_transitionsExecuted; ///< Notified when the queue has been emptied
+
+    std::unique_ptr<ThreadBaseImpl> m_pTransitionThread; ///< Pooled thread executing the queued transitions
+    std::mutex m_lockTransitionThread; ///< Lock the access to m_pTransitionThread
+
+    std::atomic<state_t> m_localState; ///< The local state. Written while holding m_stateMutex
     timespec m_stateTimestamp;         ///< The timestamp of the last local state change
 
+    /**
+     * @brief Serializes the state changes of this state machine. Recursive because the
+     *        allowChange delegate may query the state machine.
+     */
+    mutable std::recursive_mutex m_stateMutex;
+
     stateChange_t m_switchOn;          ///< Delegate function for the switch-on transition
     stateChange_t m_switchOff;         ///< Delegate function for the switch-off transition
     stateChange_t m_start;             ///< Delegate function for the start transition
@@ -229,6 +331,7 @@ protected:
     allowChange_t m_allowChange;       ///< Delegate function for the Allow-Change function
 
     std::shared_ptr<PVDelegateInImpl<std::int32_t> > m_pGetStatePV; ///< Delegate PV to which the local state change is pushed
+    std::shared_ptr<PVDelegateInImpl<std::int32_t> > m_pGetGlobalStatePV; ///< Delegate PV to which the global state change is pushed
 
 };
 
@@ -29,6 +29,15 @@ public:
 
     virtual void join() = 0;
 
+    /**
+     * @brief Return the attributes that have actually been applied to the thread.
+     *
+     * The default implementation returns the default attributes.
+     *
+     * @return the applied attributes
+     */
+    virtual threadAttributes_t getAppliedAttributes();
+
 private:
     FactoryBaseImpl* m_pFactory;
     std::string m_name;
@@ -0,0 +1,228 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSTHREADPOOLIMPL_H
+#define NDSTHREADPOOLIMPL_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <pthread.h>
+#include "nds3/definitions.h"
+#include "nds3/impl/threadBaseImpl.h"
+
+namespace nds
+{
+
+/**
+ * @brief A function submitted to the thread pool, shared by the worker that
+ *        executes it and by the handle used to join it.
+ */
+class ThreadPoolTask
+{
+public:
+    ThreadPoolTask(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
+    const std::string& getName() const;
+
+    /**
+     * @brief Return the attributes requested for the thread that executes the task.
+     *
+     * @return the requested attributes
+     */
+    const threadAttributes_t& getAttributes() const;
+
+    /**
+     * @brief Store the attributes applied to the worker and execute the task's
+     *        function. Called by the worker thread.
+     *
+     * @param appliedAttributes the attributes that the worker applied
+     */
+    void run(const threadAttributes_t& appliedAttributes);
+
+    /**
+     * @brief Wait until the task has been started and return the attributes
+     *        applied to the thread that executes it.
+     *
+     * @return the applied attributes
+     */
+    threadAttributes_t waitAppliedAttributes();
+
+    /**
+     * @brief Mark the task as completed and wake up the threads waiting for it.
+     */
+    void setFinished();
+
+    /**
+     * @brief Wait until the task has been completed.
+     */
+    void waitFinished();
+
+private:
+    std::string m_name;
+    threadAttributes_t m_attributes;
+    threadFunction_t m_function;
+
+    std::mutex m_lockStatus;
+    std::condition_variable m_statusCondition;
+    threadAttributes_t m_appliedAttributes;
+    bool m_bStarted;
+    bool m_bFinished;
+};
+
+
+/**
+ * @brief Thread handle returned by the thread pool: join() waits for the
+ *        completion of the submitted task, not for the worker thread.
+ */
+class NDS3_API ThreadPooled: public ThreadBaseImpl
+{
+public:
+    ThreadPooled(FactoryBaseImpl* pFactory, std::shared_ptr<ThreadPoolTask> pTask);
+
+    virtual void join();
+
+    virtual threadAttributes_t getAppliedAttributes();
+
+private:
+    std::shared_ptr<ThreadPoolTask> m_pTask;
+};
+
+
+/**
+ * @brief Pool of worker threads owned by a control system factory.
+ *
+ * A submitted task is executed by an idle worker when one is available,
+ *  otherwise a new worker is started: the tasks never wait for each other,
+ *  so long running acquisition loops can share the pool with short
+ *  state transitions.
+ *
+ * Workers that stay idle longer than the idle timeout, or that exceed the
+ *  maximum number of idle workers, terminate.
+ *
+ * Before executing a task the worker applies the task's thread attributes
+ *  (or the ones configured for the task's class) and takes the task's name.
+ *  The tasks that require a specific stack size are executed by a dedicated
+ *  thread that is not returned to the pool.
+ */
+class NDS3_API ThreadPoolImpl
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param maxIdleWorkers maximum number of workers kept waiting for new tasks
+     * @param idleTimeout    time after which an idle worker terminates
+     */
+    ThreadPoolImpl(const size_t maxIdleWorkers, const std::chrono::milliseconds& idleTimeout);
+
+    /**
+     * @brief Destructor. Tells the workers to terminate when their current
+     *        task completes and waits for them.
+     */
+    ~ThreadPoolImpl();
+
+    /**
+     * @brief Submit a task that uses the thread attributes of its class.
+     *
+     * @param pFactory  the factory that owns the pool
+     * @param name      the name given to the thread while it executes the task
+     * @param taskClass the task class, used to select the thread attributes
+     * @param function  the function to execute
+     * @return a thread handle that can be used to join the task. The caller
+     *         owns the handle.
+     */
+    ThreadBaseImpl* run(FactoryBaseImpl* pFactory, const std::string& name, const taskClass_t taskClass, threadFunction_t function);
+
+    /**
+     * @brief Submit a task that uses specific thread attributes.
+     *
+     * @param pFactory   the factory that owns the pool
+     * @param name       the name given to the thread while it executes the task
+     * @param attributes the thread attributes
+     * @param function   the function to execute
+     * @return a thread handle that can be used to join the task. The caller
+     *         owns the handle.
+     */
+    ThreadBaseImpl* run(FactoryBaseImpl* pFactory, const std::string& name, const threadAttributes_t& attributes, threadFunction_t function);
+
+    /**
+     * @brief Set the thread attributes for the tasks of a specific class.
+     *        Applies to the tasks started after the call.
+     *
+     * @param taskClass  the task class
+     * @param attributes the thread attributes
+     */
+    void setTaskClassAttributes(const taskClass_t taskClass, const threadAttributes_t& attributes);
+
+    /**
+     * @brief Return the number of workers, including the idle ones.
+     *
+     * @return the number of workers
+     */
+    size_t getNumWorkers() const;
+
+    /**
+     * @brief Return the number of workers waiting for a task.
+     *
+     * @return the number of idle workers
+     */
+    size_t getNumIdleWorkers() const;
+
+private:
+    ThreadPoolImpl(const ThreadPoolImpl&);
+    ThreadPoolImpl& operator=(const ThreadPoolImpl&);
+
+    static const size_t m_numTaskClasses = 3;
+
+    /*
+     * State shared with the workers. The workers that terminate on their
+     *  own are joined by the next run() or by the destructor
+     *
+     ********************************************************************/
+    struct poolState_t
+    {
+        poolState_t(const size_t maxIdleWorkers, const std::chrono::milliseconds& idleTimeout);
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_taskAvailable;
+        std::list<std::shared_ptr<ThreadPoolTask> > m_pendingTasks;
+        size_t m_numWorkers;
+        size_t m_numIdleWorkers;
+        bool m_bTerminate;
+
+        const size_t m_maxIdleWorkers;
+        const std::chrono::milliseconds m_idleTimeout;
+
+        threadAttributes_t m_classAttributes[m_numTaskClasses];
+
+        std::list<std::thread> m_workers;                ///< Workers not joined yet
+        std::list<std::thread::id> m_exitedWorkers;      ///< Workers that terminated on their own
+        std::list<pthread_t> m_dedicatedThreads;         ///< Dedicated threads not joined yet
+        std::list<pthread_t> m_exitedDedicatedThreads;   ///< Dedicated threads that completed their task
+    };
+
+    void joinExitedThreads();
+
+    ThreadBaseImpl* run(FactoryBaseImpl* pFactory, std::shared_ptr<ThreadPoolTask> pTask);
+
+    static void workerThread(std::shared_ptr<poolState_t> pState);
+
+    static void dedicatedThread(std::shared_ptr<poolState_t> pState, std::shared_ptr<ThreadPoolTask> pTask);
+
+    std::shared_ptr<poolState_t> m_pState;
+};
+
+}
+#endif // NDSTHREADPOOLIMPL_H
@@ -0,0 +1,76 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSWAVEFORMREDUCTIONIMPL_H
+#define NDSWAVEFORMREDUCTIONIMPL_H
+
+#include <vector>
+#include <cstddef>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+/**
+ * @internal
+ * @brief Reduce the number of samples in a waveform.
+ *
+ * The waveform is split in groups of reductionFactor samples (the last group
+ *  may be shorter) and each group is replaced by:
+ * - its first sample (reductionMode_t::subsample)
+ * - its minimum followed by its maximum (reductionMode_t::minMax). Both are
+ *   NaN when the group contains a NaN
+ * - the average of its samples (reductionMode_t::average). The averages of
+ *   the integer types are rounded toward zero
+ *
+ * The minimum, maximum and sum of the double and int32 groups are computed
+ *  with AVX2 when the CPU supports it, with SSE2 on the other x86-64 CPUs
+ *  and with plain C++ on the other architectures.
+ *
+ * @param mode            the reduction to apply. With reductionMode_t::none
+ *                        the waveform is copied
+ * @param reductionFactor the number of samples in each group. 0 and 1 copy
+ *                        the waveform
+ * @param pInput          the waveform to reduce
+ * @param inputSize       the number of samples in pInput
+ * @param pOutput         filled with the reduced waveform. Its capacity is
+ *                        reused across calls
+ */
+template<typename T>
+void reduceWaveform(const reductionMode_t mode,
+                    const size_t reductionFactor,
+                    const T* pInput,
+                    const size_t inputSize,
+                    std::vector<T>* pOutput);
+
+/**
+ * @internal
+ * @brief Convert raw integer samples to engineering units: each output sample
+ *        is input * amplitude + offset.
+ *
+ * The conversion runs in one pass with AVX2 when the CPU supports it, with
+ *  SSE2 on the other x86-64 CPUs and with plain C++ on the other architectures.
+ *
+ * @param pInput    the raw samples
+ * @param inputSize the number of samples in pInput
+ * @param amplitude the factor applied to each sample
+ * @param offset    the value added to each scaled sample
+ * @param pOutput   filled with the converted samples. Its capacity is
+ *                  reused across calls
+ */
+template<typename T>
+void scaleWaveform(const T* pInput,
+                   const size_t inputSize,
+                   const double amplitude,
+                   const double offset,
+                   std::vector<double>* pOutput);
+
+}
+
+#endif // NDSWAVEFORMREDUCTIONIMPL_H
@@ -45,6 +45,19 @@ public:
      */
     IniFileParser(std::istream& inputStream);
 
+    /**
+     * @brief Reads the INI file and indexes its sections.
+     *
+     * The keys of a section are parsed the first time the section is accessed,
+     *  so getString() and keyExists() throw INIParserSyntaxError if the section
+     *  contains a syntax error.
+     *
+     * Throws std::runtime_error if the file cannot be opened or read.
+     *
+     * @param fileName the name of the INI file
+     */
+    IniFileParser(const std::string& fileName);
+
     ~IniFileParser();
 
     /**
@@ -30,7 +30,9 @@
 #include "nds3/pvDelegateIn.h"
 #include "nds3/pvDelegateOut.h"
 #include "nds3/pvVariableIn.h"
+#include "nds3/pvHistoryIn.h"
 #include "nds3/pvVariableOut.h"
+#include "nds3/sharedBuffer.h"
 #include "nds3/dataAcquisition.h"
 #include "nds3/factory.h"
 #include "nds3/stateMachine.h"
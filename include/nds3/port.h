@@ -53,6 +53,40 @@ public:
      */
     Port(const std::string& name, const nodeType_t nodeType = nodeType_t::generic);
 
+    /**
+     * @ingroup datareadwrite
+     * @brief Pass the values pushed by the input PVs to the control system from
+     *        a dedicated thread.
+     *
+     * By default PVBaseIn::push() passes the value to the control system before
+     *  returning. When the asynchronous delivery is enabled each input PV in the
+     *  port gets a queue: push() stores the value into it without locking and a
+     *  thread owned by the port passes the queued values to the control system.
+     *  Each queue accepts a single producer: only one thread at a time can
+     *  push on a PV.
+     *
+     * Arrays are copied into the queue, unless they are pushed as SharedBuffer
+     *  objects. The values dropped because a queue was full are counted by
+     *  PVBaseIn::getDroppedSamples(). With overflowPolicy_t::block the pushing
+     *  thread waits for a free slot while the port's thread is running, and
+     *  drops the value when the port is not initialized.
+     *
+     * @warning Must be called before the port is initialized.
+     *
+     * @param queueSize      the number of values that each input PV can queue
+     *                       (rounded up to a power of 2)
+     * @param overflowPolicy what to do when a PV's queue is full
+     */
+    void setAsyncDelivery(const size_t queueSize, const overflowPolicy_t overflowPolicy = overflowPolicy_t::dropOldest);
+
+    /**
+     * @brief Wait until the values queued so far have been passed to the control
+     *        system.
+     *
+     * Returns immediately if the asynchronous delivery is not enabled.
+     */
+    void flushAsyncDelivery();
+
 };
 
 }
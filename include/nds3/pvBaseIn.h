@@ -75,11 +75,18 @@ public:
      *
      * See also Factory::subscribe() and PVBaseOut::subscribeTo().
      *
+     * Arrays can also be pushed as SharedBuffer objects: in this case the data
+     *  is passed by reference to the control system and is not copied.
+     *
      * @warning Only one thread can push data on one PV at any given time:
      *          two or more different threads can push data on different PVs
      *          but not on the same PV.\n
      *          If several threads push data on the same PV then the decimation
-     *           counter may become corrupted and stop the pushing operation.
+     *           counter may become corrupted and stop the pushing operation.\n
+     *          When the port delivers the values asynchronously (see
+     *           Port::setAsyncDelivery()) the PV's queue accepts a single
+     *           producer and push() throws std::logic_error if it detects
+     *           two threads pushing at the same time.
      *
      * @param timestamp    the new value's timestamp
      * @param value        the value to push to the control system
@@ -87,6 +94,31 @@ public:
     template<typename T>
     void push(const timespec& timestamp, const T& value);
 
+    /**
+     * @ingroup datareadwrite
+     * @brief Pushes a block of timestamped scalar samples to the control system.
+     *
+     * Equivalent to calling push() for each sample, but the samples that pass the
+     *  decimation reach the control system in one call and the subscribed PVs
+     *  are looked up only once.
+     *
+     * The following data types are supported:
+     * - std::int32_t
+     * - double
+     * - std::int16_t
+     * - std::uint16_t
+     * - std::int64_t
+     * - float
+     *
+     * @warning The same restrictions of push() apply.
+     *
+     * @param pTimestamps  the samples' timestamps
+     * @param pValues      the samples to push
+     * @param count        the number of samples in pTimestamps and pValues
+     */
+    template<typename T>
+    void pushBatch(const timespec* pTimestamps, const T* pValues, const size_t count);
+
     /**
      * @ingroup datareadwrite
      * @brief Specifies the decimation factor used when pushing data to the control system.
@@ -108,6 +140,18 @@ public:
      */
     void setDecimation(const std::uint32_t decimation);
 
+    /**
+     * @ingroup datareadwrite
+     * @brief Return the number of pushed values that did not reach the control
+     *        system because the PV's queue was full.
+     *
+     * Values can be dropped only when the PV's port delivers them asynchronously
+     *  (see Port::setAsyncDelivery()).
+     *
+     * @return the number of dropped values
+     */
+    std::uint64_t getDroppedSamples() const;
+
     /**
      * @brief Replicate the data from another input PV which may be located on any other
      *         device running in the same NDS process.
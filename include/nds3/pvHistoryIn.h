@@ -0,0 +1,146 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSPVHISTORYIN_H
+#define NDSPVHISTORYIN_H
+
+/**
+ * @file pvHistoryIn.h
+ *
+ * @brief Defines the nds::PVHistoryIn class, an input PV that keeps the
+ *        last values stored into it.
+ *
+ * Include nds.h instead of this one, since nds3.h takes care of including all the
+ * necessary header files (including this one).
+ */
+
+#include <vector>
+#include "nds3/definitions.h"
+#include "nds3/pvBaseIn.h"
+
+namespace nds
+{
+
+/**
+ * @brief An input PV object that keeps the last N values and timestamps
+ *        stored into it.
+ *
+ * The device support uses PVHistoryIn::setValue() to add a value to the
+ *  history; the control system reads the most recent value via read(),
+ *  while getLast() and getSince() return a window of the history so a slow
+ *  client can retrieve the values it did not poll in time.
+ *
+ * The history is a preallocated ring. For the scalar data types, reading it
+ *  never blocks the thread that stores the values and storing a value does
+ *  not allocate memory. The vectors and the strings are copied into a new
+ *  buffer for each stored value, and the buffer is exchanged with the
+ *  readers through a short internal lock. Only one thread can call
+ *  setValue() at any given time.
+ *
+ * @tparam T  the PV data type.
+ *            The following data types are supported:
+ *            - std::int32_t
+ *            - std::double
+ *            - std::vector<std::int8_t>
+ *            - std::vector<std::uint8_t>
+ *            - std::vector<std::int32_t>
+ *            - std::vector<double>
+ *            - std::string
+ *            - std::int16_t
+ *            - std::uint16_t
+ *            - std::int64_t
+ *            - float
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
+ */
+template <typename T>
+class NDS3_API PVHistoryIn: public PVBaseIn
+{
+public:
+
+    /**
+     * @brief Initializes an empty PVHistoryIn PV.
+     *
+     * You must assign a valid PVHistoryIn PV before calling Node::initialize() on the root node.
+     */
+    PVHistoryIn();
+
+    /**
+     * @brief Construct the PVHistoryIn object.
+     *
+     * @param name        name of the PV
+     * @param historySize the number of values to keep. It is rounded up to the
+     *                    next power of 2
+     */
+    PVHistoryIn(const std::string& name, const size_t historySize);
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Add a value to the history.
+     *
+     * If one or more output PVs have been suscribed to this PV via Factory::subscribe()
+     * then the value will be pushed immediately to all the subscribed PVs via PVBaseOut::write().
+     *
+     * @param value the value to store. The timestamp will be taken via the
+     *              getTimestamp() method.
+     */
+    void setValue(const T& value);
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Add a value and its timestamp to the history.
+     *
+     * If one or more output PVs have been suscribed to this PV via Factory::subscribe()
+     * then the value will be pushed immediately to all the subscribed PVs via PVBaseOut::write().
+     *
+     * @param timestamp the timestamp to assign to the value
+     * @param value     the value to store
+     */
+    void setValue(const timespec& timestamp, const T& value);
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Retrieve the most recent values, from the oldest to the newest.
+     *
+     * @param maxValues   the maximum number of values to retrieve
+     * @param pTimestamps filled with the timestamps of the values
+     * @param pValues     filled with the values
+     * @return the number of retrieved values
+     */
+    size_t getLast(const size_t maxValues, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const;
+
+    /**
+     * @ingroup datareadwrite
+     * @brief Retrieve the values newer than the specified timestamp, from
+     *        the oldest to the newest.
+     *
+     * Pass the timestamp of the last value already retrieved to get only
+     *  the new ones.
+     *
+     * @param since       values with a timestamp equal or older than this are
+     *                    not retrieved
+     * @param pTimestamps filled with the timestamps of the values
+     * @param pValues     filled with the values
+     * @return the number of retrieved values
+     */
+    size_t getSince(const timespec& since, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const;
+
+    /**
+     * @brief Return the number of values that the history can hold.
+     *
+     * @return the size of the history
+     */
+    size_t getHistorySize() const;
+};
+
+}
+
+#endif // NDSPVHISTORYIN_H
@@ -0,0 +1,213 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#ifndef NDSSHAREDBUFFER_H
+#define NDSSHAREDBUFFER_H
+
+/**
+ * @file sharedBuffer.h
+ *
+ * @brief Defines nds::SharedBuffer and nds::SharedBufferPool, used to push
+ *        acquired arrays to the control system without copying them.
+ *
+ * Include nds.h instead of this one, since nds3.h takes care of including all the
+ * necessary header files (including this one).
+ */
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include "nds3/definitions.h"
+
+namespace nds
+{
+
+/**
+ * @ingroup datareadwrite
+ * @brief Reference counted, immutable container of pushed data.
+ *
+ * A SharedBuffer can be pushed via DataAcquisition::push() or PVBaseIn::push()
+ *  instead of a plain std::vector: the buffer travels through NDS and reaches
+ *  the control system interface by reference, so the acquired data is never
+ *  copied on the way.
+ *
+ * The content of the buffer must not be modified once it has been pushed:
+ *  the control system may keep a reference to it for as long as it needs.
+ *  Use SharedBufferPool to recycle the buffers once the control system has
+ *  released them.
+ *
+ * @tparam T  the container type.
+ *            The following data types are supported:
+ *            - std::vector<std::int8_t>
+ *            - std::vector<std::uint8_t>
+ *            - std::vector<std::int32_t>
+ *            - std::vector<double>
+ *            - std::vector<std::int16_t>
+ *            - std::vector<std::uint16_t>
+ *            - std::vector<std::int64_t>
+ *            - std::vector<float>
+ */
+template <typename T>
+class SharedBuffer
+{
+public:
+    /**
+     * @brief Construct a buffer that holds an empty container.
+     */
+    SharedBuffer(): m_pData(std::make_shared<T>())
+    {
+    }
+
+    /**
+     * @brief Take ownership of the data held by a container.
+     *
+     * The content of the container is moved (not copied) into the buffer.
+     *
+     * @param data the container to move into the buffer
+     */
+    explicit SharedBuffer(T&& data): m_pData(std::make_shared<T>(std::move(data)))
+    {
+    }
+
+    /**
+     * @brief Share a container already allocated by the caller (e.g. by
+     *        SharedBufferPool::getBuffer()).
+     *
+     * No allocation takes place: the buffer shares the ownership of the container.
+     *
+     * @param pData the container to share. The caller must not modify it after
+     *              the buffer has been pushed
+     */
+    explicit SharedBuffer(const std::shared_ptr<const T>& pData): m_pData(pData)
+    {
+    }
+
+    /**
+     * @brief Return a reference to the shared container.
+     *
+     * @return the container held by the buffer
+     */
+    const T& get() const
+    {
+        return *m_pData;
+    }
+
+    const T& operator*() const
+    {
+        return *m_pData;
+    }
+
+    const T* operator->() const
+    {
+        return m_pData.get();
+    }
+
+    /**
+     * @brief Return the pointer that holds the container, so that the control
+     *        system can keep a reference to it after the push returns.
+     *
+     * @return the shared pointer to the container
+     */
+    const std::shared_ptr<const T>& getPointer() const
+    {
+        return m_pData;
+    }
+
+private:
+    std::shared_ptr<const T> m_pData;
+};
+
+
+/**
+ * @ingroup datareadwrite
+ * @brief Keeps a list of containers that can be filled and pushed as
+ *        SharedBuffer objects without allocating new memory for every push.
+ *
+ * getBuffer() returns a container that is not referenced by anybody else
+ *  (i.e. the control system released it): the container keeps the capacity
+ *  it had the last time it was used, so after the first few acquisitions
+ *  no memory allocation takes place.
+ *
+ * @warning A pool is meant to be used by a single thread (usually the
+ *          acquisition thread).
+ *
+ * @tparam T  the container type (see SharedBuffer)
+ */
+template <typename T>
+class SharedBufferPool
+{
+public:
+    /**
+     * @brief Construct the pool and preallocate the containers.
+     *
+     * @param numBuffers  number of containers allocated in advance. The pool grows
+     *                     if the control system holds all of them
+     * @param reserveSize number of elements reserved in each container, also
+     *                     in the containers added when the pool grows
+     */
+    SharedBufferPool(const size_t numBuffers, const size_t reserveSize = 0): m_reserveSize(reserveSize), m_nextBuffer(0)
+    {
+        m_buffers.reserve(numBuffers);
+        for(size_t allocate(0); allocate != numBuffers; ++allocate)
+        {
+            m_buffers.push_back(std::make_shared<T>());
+            m_buffers.back()->reserve(m_reserveSize);
+        }
+    }
+
+    /**
+     * @brief Return a container that is not referenced outside the pool.
+     *
+     * The content of the container is not cleared: the caller is expected to
+     *  resize it and overwrite it.
+     *
+     * @return a container that can be filled and then pushed as a SharedBuffer
+     */
+    std::shared_ptr<T> getBuffer()
+    {
+        for(size_t scanBuffers(0), numBuffers(m_buffers.size()); scanBuffers != numBuffers; ++scanBuffers)
+        {
+            const size_t bufferIndex((m_nextBuffer + scanBuffers) % numBuffers);
+            if(m_buffers[bufferIndex].use_count() == 1)
+            {
+                // Make sure that we see all the operations performed by the
+                //  thread that released the last reference
+                ////////////////////////////////////////////////////////////
+                std::atomic_thread_fence(std::memory_order_acquire);
+                m_nextBuffer = bufferIndex + 1;
+                return m_buffers[bufferIndex];
+            }
+        }
+
+        // All the buffers are in use: grow the pool
+        ////////////////////////////////////////////
+        m_buffers.push_back(std::make_shared<T>());
+        m_buffers.back()->reserve(m_reserveSize);
+        m_nextBuffer = 0;
+        return m_buffers.back();
+    }
+
+    /**
+     * @brief Return the number of containers owned by the pool.
+     *
+     * @return the number of containers in the pool
+     */
+    size_t getSize() const
+    {
+        return m_buffers.size();
+    }
+
+private:
+    std::vector<std::shared_ptr<T> > m_buffers;
+    const size_t m_reserveSize;
+    size_t m_nextBuffer;
+};
+
+}
+#endif // NDSSHAREDBUFFER_H
@@ -20,6 +20,7 @@
  */
 
 #include <cstdint>
+#include <future>
 
 #include "nds3/node.h"
 #include "nds3/definitions.h"
@@ -128,9 +129,11 @@ public:
      *   (the state active before the transition was requested)
      * - any exception: the state switches to Fault.
      *
-     * @warning If the state machine is asynchronous (parameter bAsync set to true in the constructor)
-     *           then exceptions thrown in state change functions are silenced and only the log messages
-     *           are sent to the control system.
+     * If the state machine is asynchronous (parameter bAsync set to true in the constructor)
+     *  then the transition is queued and executed by a pooled thread after the transitions
+     *  requested before it: setState() returns immediately. A queued transition is checked
+     *  against the state reached by the previous ones. The exceptions thrown by the state
+     *  change functions are logged and stored in the returned future.
      *
      * @param newState the new desidered local state. Intermediate states can be set only by
      *                 the state machine. The user can set only the following states:
@@ -138,13 +141,16 @@ public:
      *                 - state_t::on
      *                 - state_t::running
      *                 - state_t::fault
+     * @return a future that receives the local state reached at the end of the transition
+     *         or the exception thrown while executing it
      */
-    void setState(const state_t newState);
+    std::future<state_t> setState(const state_t newState);
 
     /**
      * @brief Returns the local state of the state machine.
      *
      * The local state does not reflect the state of the children nodes.
+     * Reading the local state does not wait for the running transitions.
      *
      * @return the local state
      */
@@ -40,6 +40,10 @@ class ThreadBaseImpl;
  *
  * Thread can be created by using the control system factory method Factory::runInThread()
  *  or by calling Base::runInThread() on any node or PV.
+ *
+ * Unless the control system provides its own threads, the function is executed by a
+ *  worker of the factory's thread pool: the Thread object is a handle to the task and
+ *  join() waits for the function to return.
  */
 class NDS3_API Thread
 {
@@ -60,6 +64,17 @@ public:
 
     void join();
 
+    /**
+     * @brief Return the attributes that have actually been applied to the thread.
+     *
+     * Waits until the thread has applied its attributes. The attributes that could
+     *  not be applied (e.g. a real-time policy without the CAP_SYS_NICE capability)
+     *  report the values used instead.
+     *
+     * @return the applied attributes
+     */
+    threadAttributes_t getAppliedAttributes() const;
+
 protected:
     std::shared_ptr<ThreadBaseImpl> m_pImplementation;
 
@@ -0,0 +1,244 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <cstring>
+#include <time.h>
+
+#include "nds3/impl/asyncLogStreamGetterImpl.h"
+
+namespace nds
+{
+
+/*
+ * Round the size up to a power of 2, so the positions can
+ *  be mapped to the buffer with a mask
+ *
+ *********************************************************/
+static size_t getRingSize(const size_t size)
+{
+    size_t roundedSize(64);
+    while(roundedSize < size)
+    {
+        roundedSize <<= 1;
+    }
+    return roundedSize;
+}
+
+LogRecordsRing::LogRecordsRing(const size_t size): m_buffer(getRingSize(size)), m_mask(m_buffer.size() - 1),
+    m_writePosition(0), m_readPosition(0), m_droppedRecords(0)
+{
+}
+
+bool LogRecordsRing::write(const logLevel_t logLevel, const timespec& timestamp, const char* pText, const size_t length)
+{
+    const std::uint64_t writePosition(m_writePosition.load(std::memory_order_relaxed));
+    const std::uint64_t readPosition(m_readPosition.load(std::memory_order_acquire));
+    const size_t recordSize(sizeof(recordHeader_t) + length);
+
+    if(m_buffer.size() - (writePosition - readPosition) < recordSize)
+    {
+        m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    recordHeader_t header;
+    header.m_length = (std::uint32_t)length;
+    header.m_logLevel = logLevel;
+    header.m_timestamp = timestamp;
+    copyIn(writePosition, &header, sizeof(header));
+    copyIn(writePosition + sizeof(header), pText, length);
+
+    m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+    return true;
+}
+
+bool LogRecordsRing::read(logLevel_t* pLogLevel, timespec* pTimestamp, std::string* pText)
+{
+    const std::uint64_t readPosition(m_readPosition.load(std::memory_order_relaxed));
+    const std::uint64_t writePosition(m_writePosition.load(std::memory_order_acquire));
+    if(readPosition == writePosition)
+    {
+        return false;
+    }
+
+    recordHeader_t header;
+    copyOut(readPosition, &header, sizeof(header));
+    pText->resize(header.m_length);
+    if(header.m_length != 0)
+    {
+        copyOut(readPosition + sizeof(header), &((*pText)[0]), header.m_length);
+    }
+    *pLogLevel = header.m_logLevel;
+    *pTimestamp = header.m_timestamp;
+
+    m_readPosition.store(readPosition + sizeof(header) + header.m_length, std::memory_order_release);
+    return true;
+}
+
+bool LogRecordsRing::isEmpty() const
+{
+    return m_readPosition.load(std::memory_order_relaxed) == m_writePosition.load(std::memory_order_acquire);
+}
+
+std::uint64_t LogRecordsRing::getDroppedRecords() const
+{
+    return m_droppedRecords.load(std::memory_order_relaxed);
+}
+
+void LogRecordsRing::copyIn(const std::uint64_t position, const void* pData, const size_t length)
+{
+    const size_t offset((size_t)(position & m_mask));
+    const size_t firstPart(std::min(length, m_buffer.size() - offset));
+    std::memcpy(&(m_buffer[offset]), pData, firstPart);
+    std::memcpy(&(m_buffer[0]), (const char*)pData + firstPart, length - firstPart);
+}
+
+void LogRecordsRing::copyOut(const std::uint64_t position, void* pData, const size_t length) const
+{
+    const size_t offset((size_t)(position & m_mask));
+    const size_t firstPart(std::min(length, m_buffer.size() - offset));
+    std::memcpy(pData, &(m_buffer[offset]), firstPart);
+    std::memcpy((char*)pData + firstPart, &(m_buffer[0]), length - firstPart);
+}
+
+
+AsyncLogStreamBufferImpl::AsyncLogStreamBufferImpl(const logLevel_t logLevel, const size_t maxRecordLength, std::shared_ptr<LogRecordsRing> pRing):
+    m_logLevel(logLevel), m_buffer(maxRecordLength == 0 ? 1 : maxRecordLength), m_pRing(pRing)
+{
+    setp(&(m_buffer[0]), &(m_buffer[0]) + m_buffer.size());
+}
+
+/*
+ * Called when the buffer is full: the character is discarded
+ *
+ ************************************************************/
+AsyncLogStreamBufferImpl::int_type AsyncLogStreamBufferImpl::overflow(int_type character)
+{
+    return traits_type::not_eof(character);
+}
+
+/*
+ * Move the collected line into the ring
+ *
+ ***************************************/
+int AsyncLogStreamBufferImpl::sync()
+{
+    timespec timestamp;
+    ::clock_gettime(CLOCK_REALTIME, &timestamp);
+
+    m_pRing->write(m_logLevel, timestamp, pbase(), (size_t)(pptr() - pbase()));
+    setp(&(m_buffer[0]), &(m_buffer[0]) + m_buffer.size());
+    return 0;
+}
+
+AsyncLogStream::AsyncLogStream(const logLevel_t logLevel, const size_t maxRecordLength, std::shared_ptr<LogRecordsRing> pRing):
+    std::ostream(&m_buffer), m_buffer(logLevel, maxRecordLength, pRing)
+{
+}
+
+
+AsyncLogStreamGetterImpl::AsyncLogStreamGetterImpl(logWriter_t writer,
+                                                   const size_t ringSize,
+                                                   const size_t maxRecordLength,
+                                                   const std::chrono::milliseconds& flushInterval):
+    m_writer(writer), m_ringSize(ringSize), m_maxRecordLength(maxRecordLength), m_flushInterval(flushInterval),
+    m_removedRingsDropped(0), m_bTerminate(false),
+    m_flushThread(std::bind(&AsyncLogStreamGetterImpl::flushThread, this))
+{
+}
+
+AsyncLogStreamGetterImpl::~AsyncLogStreamGetterImpl()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lockTerminate);
+        m_bTerminate = true;
+        m_terminateCondition.notify_all();
+    }
+    m_flushThread.join();
+    flush();
+}
+
+std::ostream* AsyncLogStreamGetterImpl::createLogStream(const logLevel_t logLevel)
+{
+    std::shared_ptr<LogRecordsRing> pRing(std::make_shared<LogRecordsRing>(m_ringSize));
+    {
+        std::lock_guard<std::mutex> lock(m_lockRings);
+        m_rings.push_back(pRing);
+    }
+    return new AsyncLogStream(logLevel, m_maxRecordLength, pRing);
+}
+
+void AsyncLogStreamGetterImpl::flush()
+{
+    std::lock_guard<std::mutex> lockFlush(m_lockFlush);
+
+    rings_t rings;
+    {
+        std::lock_guard<std::mutex> lock(m_lockRings);
+        rings = m_rings;
+    }
+
+    // The writer is called without holding m_lockRings: it may log
+    //  from a thread that creates its first log stream
+    ///////////////////////////////////////////////////////////////
+    logLevel_t logLevel;
+    timespec timestamp;
+    std::string text;
+    for(rings_t::iterator scanRings(rings.begin()), endRings(rings.end()); scanRings != endRings; ++scanRings)
+    {
+        while((*scanRings)->read(&logLevel, &timestamp, &text))
+        {
+            m_writer(timestamp, logLevel, text);
+        }
+    }
+    rings.clear();
+
+    // Remove the rings of the terminated threads: only the
+    //  list still references them
+    ///////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(m_lockRings);
+    for(rings_t::iterator scanRings(m_rings.begin()); scanRings != m_rings.end();)
+    {
+        if(scanRings->use_count() == 1 && (*scanRings)->isEmpty())
+        {
+            m_removedRingsDropped += (*scanRings)->getDroppedRecords();
+            scanRings = m_rings.erase(scanRings);
+        }
+        else
+        {
+            ++scanRings;
+        }
+    }
+}
+
+std::uint64_t AsyncLogStreamGetterImpl::getDroppedRecords() const
+{
+    std::lock_guard<std::mutex> lock(m_lockRings);
+    std::uint64_t droppedRecords(m_removedRingsDropped);
+    for(rings_t::const_iterator scanRings(m_rings.begin()), endRings(m_rings.end()); scanRings != endRings; ++scanRings)
+    {
+        droppedRecords += (*scanRings)->getDroppedRecords();
+    }
+    return droppedRecords;
+}
+
+void AsyncLogStreamGetterImpl::flushThread()
+{
+    std::unique_lock<std::mutex> lock(m_lockTerminate);
+    while(!m_bTerminate)
+    {
+        m_terminateCondition.wait_for(lock, m_flushInterval);
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+}
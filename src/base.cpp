@@ -115,6 +115,16 @@ Thread Base::runInThread(const std::string &name, threadFunction_t function)
     return Thread(std::shared_ptr<ThreadBaseImpl>(m_pImplementation->runInThread(name, function)));
 }
 
+Thread Base::runInThread(const std::string &name, const taskClass_t taskClass, threadFunction_t function)
+{
+    return Thread(std::shared_ptr<ThreadBaseImpl>(m_pImplementation->runInThread(name, taskClass, function)));
+}
+
+Thread Base::runInThread(const std::string &name, const threadAttributes_t& attributes, threadFunction_t function)
+{
+    return Thread(std::shared_ptr<ThreadBaseImpl>(m_pImplementation->runInThread(name, attributes, function)));
+}
+
 Thread Base::runInThread(threadFunction_t function)
 {
     return Thread(std::shared_ptr<ThreadBaseImpl>(m_pImplementation->runInThread(getFullName(), function)));
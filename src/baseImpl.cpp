@@ -12,6 +12,7 @@
 #include "nds3/impl/baseImpl.h"
 #include "nds3/impl/nodeImpl.h"
 #include "nds3/impl/factoryBaseImpl.h"
+#include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/logStreamGetterImpl.h"
 #include "nds3/impl/threadBaseImpl.h"
 
@@ -20,7 +21,7 @@ namespace nds
 
 BaseImpl::BaseImpl(const std::string& name): m_name(name), m_externalName(name), m_nodeLevel(0), m_pFactory(0),
     m_timestampFunction(std::bind(&BaseImpl::getLocalTimestamp, this)),
-    m_logLevel(logLevel_t::warning), m_cachedFullName(name), m_cachedFullNameFromPort()
+    m_logLevel(logLevel_t::warning), m_pFullName(0), m_pFullNameFromPort(0), m_pFullExternalName(0), m_pFullExternalNameFromPort(0)
 {
     // Register the commands for the log level
     //////////////////////////////////////////
@@ -32,7 +33,7 @@ BaseImpl::BaseImpl(const std::string& name): m_name(name), m_externalName(name),
 
 BaseImpl::~BaseImpl()
 {
-
+    releaseNames();
 }
 
 /*
@@ -70,7 +71,12 @@ std::uint32_t BaseImpl::getNodeLevel() const
     return m_nodeLevel;
 }
 
-std::string BaseImpl::buildFullName(const FactoryBaseImpl& controlSystem) const
+/*
+ * The parents are initialized before their children, so their
+ *  cached names are used instead of walking up the tree
+ *
+ **************************************************************/
+std::string BaseImpl::buildFullName(const FactoryBaseImpl& /* controlSystem */) const
 {
     std::shared_ptr<NodeImpl> temporaryPointer = m_pParent.lock();
     if(temporaryPointer == 0)
@@ -78,7 +84,7 @@ std::string BaseImpl::buildFullName(const FactoryBaseImpl& controlSystem) const
         return getComponentName();
     }
 
-    return temporaryPointer->buildFullName(controlSystem) + "-" + getComponentName();
+    return temporaryPointer->getFullName() + "-" + getComponentName();
 }
 
 void BaseImpl::setParent(std::shared_ptr<NodeImpl> pParent, const std::uint32_t parentLevel)
@@ -95,35 +101,52 @@ void BaseImpl::setParent(std::shared_ptr<NodeImpl> pParent, const std::uint32_t
 
 }
 
+/*
+ * Before the initialization the full name is the component name
+ *  and the other names are empty
+ *
+ ****************************************************************/
+static const std::string m_emptyName;
+
 const std::string& BaseImpl::getFullName() const
 {
-    return m_cachedFullName;
+    return m_pFullName == 0 ? m_name : m_pFullName->m_name;
 }
 
 const std::string& BaseImpl::getFullNameFromPort() const
 {
-    return m_cachedFullNameFromPort;
+    return m_pFullNameFromPort == 0 ? m_emptyName : m_pFullNameFromPort->m_name;
 }
 
 const std::string& BaseImpl::getFullExternalName() const
 {
-    return m_cachedFullExternalName;
+    return m_pFullExternalName == 0 ? m_emptyName : m_pFullExternalName->m_name;
 }
 
 const std::string& BaseImpl::getFullExternalNameFromPort() const
 {
-    return m_cahcedFullExternalNameFromPort;
+    return m_pFullExternalNameFromPort == 0 ? m_emptyName : m_pFullExternalNameFromPort->m_name;
 }
 
+nameId_t BaseImpl::getFullNameId() const
+{
+    return m_pFullName == 0 ? NameTableImpl::m_invalidNameId : m_pFullName->m_id;
+}
 
-std::string BaseImpl::buildFullNameFromPort(const FactoryBaseImpl& controlSystem) const
+nameId_t BaseImpl::getFullExternalNameId() const
+{
+    return m_pFullExternalName == 0 ? NameTableImpl::m_invalidNameId : m_pFullExternalName->m_id;
+}
+
+
+std::string BaseImpl::buildFullNameFromPort(const FactoryBaseImpl& /* controlSystem */) const
 {
     std::string parentName;
 
     std::shared_ptr<NodeImpl> temporaryPointer = m_pParent.lock();
     if(temporaryPointer != 0)
     {
-        parentName = temporaryPointer->buildFullNameFromPort(controlSystem);
+        parentName = temporaryPointer->getFullNameFromPort();
     }
     if(parentName.empty())
     {
@@ -132,20 +155,53 @@ std::string BaseImpl::buildFullNameFromPort(const FactoryBaseImpl& controlSystem
     return parentName + "-" + getComponentName();
 }
 
-void BaseImpl::initialize(FactoryBaseImpl &controlSystem)
+void BaseImpl::prepareInitialization(FactoryBaseImpl& controlSystem, const size_t /* numThreads */)
 {
     m_pFactory = &controlSystem;
 
-    m_cachedFullName = buildFullName(controlSystem);
-    m_cachedFullNameFromPort = buildFullNameFromPort(controlSystem);
+    NameTableImpl& nameTable(NdsFactoryImpl::getInstance().getNameTable());
+
+    // Intern the new names before releasing the old ones, so the names
+    //  that didn't change are not removed and added again
+    ///////////////////////////////////////////////////////////////////
+    const InternedName* pFullName(nameTable.intern(buildFullName(controlSystem)));
+    const InternedName* pFullNameFromPort(nameTable.intern(buildFullNameFromPort(controlSystem)));
+    const InternedName* pFullExternalName(nameTable.intern(buildFullExternalName(controlSystem)));
+    const InternedName* pFullExternalNameFromPort(nameTable.intern(buildFullExternalNameFromPort(controlSystem)));
+
+    releaseNames();
 
-    m_cachedFullExternalName = buildFullExternalName(controlSystem);
-    m_cahcedFullExternalNameFromPort = buildFullExternalNameFromPort(controlSystem);
+    m_pFullName = pFullName;
+    m_pFullNameFromPort = pFullNameFromPort;
+    m_pFullExternalName = pFullExternalName;
+    m_pFullExternalNameFromPort = pFullExternalNameFromPort;
 
     // Remember where we can go get our logging streams
     ///////////////////////////////////////////////////
     m_logStreamGetter = controlSystem.getLogStreamGetter();
+}
 
+void BaseImpl::releaseNames()
+{
+    if(m_pFullName == 0)
+    {
+        return;
+    }
+
+    NameTableImpl& nameTable(NdsFactoryImpl::getInstance().getNameTable());
+    nameTable.release(m_pFullName);
+    nameTable.release(m_pFullNameFromPort);
+    nameTable.release(m_pFullExternalName);
+    nameTable.release(m_pFullExternalNameFromPort);
+
+    m_pFullName = 0;
+    m_pFullNameFromPort = 0;
+    m_pFullExternalName = 0;
+    m_pFullExternalNameFromPort = 0;
+}
+
+void BaseImpl::initialize(FactoryBaseImpl &controlSystem)
+{
     // Register all the commands
     ////////////////////////////
     for(commands_t::const_iterator scanCommands(m_commands.begin()), endCommands(m_commands.end()); scanCommands != endCommands; ++scanCommands)
@@ -180,6 +236,16 @@ ThreadBaseImpl* BaseImpl::runInThread(const std::string &name, threadFunction_t
     return m_pFactory->runInThread(name, function);
 }
 
+ThreadBaseImpl* BaseImpl::runInThread(const std::string &name, const taskClass_t taskClass, threadFunction_t function)
+{
+    return m_pFactory->runInThread(name, taskClass, function);
+}
+
+ThreadBaseImpl* BaseImpl::runInThread(const std::string &name, const threadAttributes_t& attributes, threadFunction_t function)
+{
+    return m_pFactory->runInThread(name, attributes, function);
+}
+
 timespec BaseImpl::getLocalTimestamp() const
 {
     std::shared_ptr<NodeImpl> temporaryPointer = m_pParent.lock();
@@ -222,6 +288,14 @@ parameters_t BaseImpl::commandSetLogLevel(const logLevel_t logLevel, const param
     return parameters_t();
 }
 
+void BaseImpl::setStatisticsEnabled(const bool /* bEnabled */)
+{
+}
+
+void BaseImpl::collectStatistics(parameters_t* /* pStatistics */)
+{
+}
+
 }
 
 
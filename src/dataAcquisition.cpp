@@ -69,6 +69,28 @@ void DataAcquisition<T>::push(const timespec& timestamp, const T& data)
     std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->push(timestamp, data);
 }
 
+template <typename T>
+void DataAcquisition<T>::push(const timespec& timestamp, const SharedBuffer<T>& data)
+{
+    std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->push(timestamp, data);
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<std::is_same<U, std::vector<double> >::value>::type
+DataAcquisition<T>::pushRaw(const timespec& timestamp, const std::vector<std::int16_t>& rawData)
+{
+    std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->pushRaw(timestamp, rawData);
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<std::is_same<U, std::vector<double> >::value>::type
+DataAcquisition<T>::pushRaw(const timespec& timestamp, const std::vector<std::int32_t>& rawData)
+{
+    std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->pushRaw(timestamp, rawData);
+}
+
 template <typename T>
 double DataAcquisition<T>::getFrequencyHz()
 {
@@ -105,6 +127,18 @@ size_t DataAcquisition<T>::getDecimation()
     return std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->getDecimation();
 }
 
+template <typename T>
+reductionMode_t DataAcquisition<T>::getReductionMode()
+{
+    return std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->getReductionMode();
+}
+
+template <typename T>
+size_t DataAcquisition<T>::getReductionFactor()
+{
+    return std::static_pointer_cast<DataAcquisitionImpl<T> >(m_pImplementation)->getReductionFactor();
+}
+
 template <typename T>
 size_t DataAcquisition<T>::getSamplingMode()
 {
@@ -130,6 +164,17 @@ template class DataAcquisition<std::vector<std::uint8_t> >;
 template class DataAcquisition<std::vector<std::int32_t> >;
 template class DataAcquisition<std::vector<double> >;
 template class DataAcquisition<std::string >;
+template class DataAcquisition<std::int16_t>;
+template class DataAcquisition<std::uint16_t>;
+template class DataAcquisition<std::int64_t>;
+template class DataAcquisition<float>;
+template class DataAcquisition<std::vector<std::int16_t> >;
+template class DataAcquisition<std::vector<std::uint16_t> >;
+template class DataAcquisition<std::vector<std::int64_t> >;
+template class DataAcquisition<std::vector<float> >;
+
+template void DataAcquisition<std::vector<double> >::pushRaw<std::vector<double> >(const timespec&, const std::vector<std::int16_t>&);
+template void DataAcquisition<std::vector<double> >::pushRaw<std::vector<double> >(const timespec&, const std::vector<std::int32_t>&);
 
 
 }
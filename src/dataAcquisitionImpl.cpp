@@ -7,15 +7,43 @@
  * file included in the distribution.
  */
 
+#include <type_traits>
+#include <stdexcept>
+
 #include "nds3/definitions.h"
+#include "nds3/exceptions.h"
 #include "nds3/impl/dataAcquisitionImpl.h"
 #include "nds3/impl/stateMachineImpl.h"
 #include "nds3/impl/pvVariableInImpl.h"
 #include "nds3/impl/pvVariableOutImpl.h"
+#include "nds3/impl/waveformReductionImpl.h"
 
 namespace nds
 {
 
+/*
+ * Output PV that also stores its value in an atomic variable, so
+ *  the acquisition thread can read it without locking the PV
+ *
+ ****************************************************************/
+class CachedDoubleOutImpl: public PVVariableOutImpl<double>
+{
+public:
+    CachedDoubleOutImpl(const std::string& name, std::atomic<double>& cachedValue):
+        PVVariableOutImpl<double>(name), m_cachedValue(cachedValue)
+    {
+    }
+
+    virtual void write(const timespec& timestamp, const double& value)
+    {
+        PVVariableOutImpl<double>::write(timestamp, value);
+        m_cachedValue.store(value, std::memory_order_release);
+    }
+
+private:
+    std::atomic<double>& m_cachedValue;
+};
+
 template<typename T>
 DataAcquisitionImpl<T>::DataAcquisitionImpl(
         const std::string& name,
@@ -28,7 +56,11 @@ DataAcquisitionImpl<T>::DataAcquisitionImpl(
         allowChange_t allowStateChangeFunction):
     NodeImpl(name, nodeType_t::dataSourceChannel),
     m_onStartDelegate(startFunction),
-    m_startTimestampFunction(std::bind(&BaseImpl::getTimestamp, this))
+    m_startTimestampFunction(std::bind(&BaseImpl::getTimestamp, this)),
+    m_reductionMode(reductionMode_t::none),
+    m_reductionFactor(1),
+    m_amplitude(1),
+    m_offset(0)
 {
     // Add the children PVs
     m_dataPV.reset(new PVVariableInImpl<T>("Data"));
@@ -48,13 +80,13 @@ DataAcquisitionImpl<T>::DataAcquisitionImpl(
     m_durationPV->setScanType(scanType_t::passive, 0);
     addChild(m_durationPV);
 
-    m_amplitudePV.reset(new PVVariableOutImpl<double>("Amplitude"));
+    m_amplitudePV.reset(new CachedDoubleOutImpl("Amplitude", m_amplitude));
     m_amplitudePV->setDescription("Amplitude");
     m_amplitudePV->setScanType(scanType_t::passive, 0);
     m_amplitudePV->write(getTimestamp(), (double)1);
     addChild(m_amplitudePV);
 
-    m_offsetPV.reset(new PVVariableOutImpl<double>("Offset"));
+    m_offsetPV.reset(new CachedDoubleOutImpl("Offset", m_offset));
     m_offsetPV->setDescription("Offset");
     m_offsetPV->setScanType(scanType_t::passive, 0);
     addChild(m_offsetPV);
@@ -65,6 +97,26 @@ DataAcquisitionImpl<T>::DataAcquisitionImpl(
     m_decimationPV->write(getTimestamp(), (std::int32_t)1);
     addChild(m_decimationPV);
 
+    //add enumeration for the reduction mode: same order as reductionMode_t
+    enumerationStrings_t reductionModeEnumerationStrings;
+    reductionModeEnumerationStrings.push_back("None");
+    reductionModeEnumerationStrings.push_back("Subsample");
+    reductionModeEnumerationStrings.push_back("MinMax");
+    reductionModeEnumerationStrings.push_back("Average");
+
+    m_reductionModePV.reset(new PVVariableOutImpl<std::int32_t>("ReductionMode"));
+    m_reductionModePV->setDescription("Reduction of the arrays pushed to the control system");
+    m_reductionModePV->setScanType(scanType_t::passive, 0);
+    m_reductionModePV->setEnumeration(reductionModeEnumerationStrings);
+    m_reductionModePV->write(getTimestamp(), (std::int32_t)reductionMode_t::none);
+    addChild(m_reductionModePV);
+
+    m_reductionFactorPV.reset(new PVVariableOutImpl<std::int32_t>("ReductionFactor"));
+    m_reductionFactorPV->setDescription("Number of samples reduced to one (two for MinMax)");
+    m_reductionFactorPV->setScanType(scanType_t::passive, 0);
+    m_reductionFactorPV->write(getTimestamp(), (std::int32_t)1);
+    addChild(m_reductionFactorPV);
+
     //add enumeration for sampling mode
     enumerationStrings_t samplingModeEnumerationStrings;
     samplingModeEnumerationStrings.push_back("Single");
@@ -120,19 +172,13 @@ double DataAcquisitionImpl<T>::getDurationSeconds()
 template<typename T>
 double DataAcquisitionImpl<T>::getAmplitude()
 {
-    double amplitude;
-    timespec timestamp;
-    m_amplitudePV->read(&timestamp, &amplitude);
-    return amplitude;
+    return m_amplitude.load(std::memory_order_acquire);
 }
 
 template<typename T>
 double DataAcquisitionImpl<T>::getOffset()
 {
-    double offset;
-    timespec timestamp;
-    m_offsetPV->read(&timestamp, &offset);
-    return offset;
+    return m_offset.load(std::memory_order_acquire);
 }
 
 template<typename T>
@@ -150,6 +196,18 @@ size_t DataAcquisitionImpl<T>::getDecimation()
     return (size_t)decimation;
 }
 
+template<typename T>
+reductionMode_t DataAcquisitionImpl<T>::getReductionMode()
+{
+    return (reductionMode_t)m_reductionModePV->getValue();
+}
+
+template<typename T>
+size_t DataAcquisitionImpl<T>::getReductionFactor()
+{
+    return (size_t)m_reductionFactorPV->getValue();
+}
+
 template<typename T>
 size_t DataAcquisitionImpl<T>::getSamplingMode()
 {
@@ -180,10 +238,119 @@ void DataAcquisitionImpl<T>::setStartTimestampDelegate(getTimestampPlugin_t time
     m_startTimestampFunction = timestampDelegate;
 }
 
+/*
+ * Only the arrays can be reduced
+ *
+ ********************************/
+template<typename T>
+static bool reduceArray(const reductionMode_t mode, const size_t reductionFactor, const std::vector<T>& data, std::vector<T>* pReducedData)
+{
+    reduceWaveform(mode, reductionFactor, data.data(), data.size(), pReducedData);
+    return true;
+}
+
+template<typename T>
+static bool reduceArray(const reductionMode_t /* mode */, const size_t /* reductionFactor */, const T& /* data */, T* /* pReducedData */)
+{
+    return false;
+}
+
+/*
+ * When a reduction is active the control system receives the reduced
+ *  array while the subscribed and replicated PVs receive the full one.
+ * The decimation is applied first: the arrays that the control system
+ *  doesn't receive are not reduced
+ *
+ ********************************************************************/
 template<typename T>
 void DataAcquisitionImpl<T>::push(const timespec& timestamp, const T& data)
 {
-    m_dataPV->push(timestamp, data);
+    if(m_reductionMode == reductionMode_t::none)
+    {
+        m_dataPV->push(timestamp, data);
+        return;
+    }
+    if(m_dataPV->passDecimation())
+    {
+        if(reduceArray(m_reductionMode, m_reductionFactor, data, &m_reducedData))
+        {
+            m_dataPV->pushToControlSystem(timestamp, m_reducedData);
+        }
+        else
+        {
+            m_dataPV->pushToControlSystem(timestamp, data);
+        }
+    }
+    m_dataPV->pushToLinkedPVs(timestamp, data);
+}
+
+/*
+ * Only the arrays can be pushed as shared buffers through the port and the
+ *  control system interface: the other data types are pushed as plain values
+ *
+ ***************************************************************************/
+template<typename T>
+struct isSharedBufferType: public std::false_type
+{
+};
+
+template<typename T>
+struct isSharedBufferType<std::vector<T> >: public std::true_type
+{
+};
+
+template<typename T>
+static void pushSharedBuffer(PVBaseInImpl& pv, const timespec& timestamp, const SharedBuffer<T>& data, std::true_type)
+{
+    pv.push(timestamp, data);
+}
+
+template<typename T>
+static void pushSharedBuffer(PVBaseInImpl& pv, const timespec& timestamp, const SharedBuffer<T>& data, std::false_type)
+{
+    pv.push(timestamp, data.get());
+}
+
+template<typename T>
+static void pushSharedBufferToLinkedPVs(PVBaseInImpl& pv, const timespec& timestamp, const SharedBuffer<T>& data, std::true_type)
+{
+    pv.pushToLinkedPVs(timestamp, data);
+}
+
+template<typename T>
+static void pushSharedBufferToLinkedPVs(PVBaseInImpl& pv, const timespec& timestamp, const SharedBuffer<T>& data, std::false_type)
+{
+    pv.pushToLinkedPVs(timestamp, data.get());
+}
+
+template<typename T>
+void DataAcquisitionImpl<T>::push(const timespec& timestamp, const SharedBuffer<T>& data)
+{
+    if(m_reductionMode == reductionMode_t::none)
+    {
+        pushSharedBuffer(*m_dataPV, timestamp, data, isSharedBufferType<T>());
+        return;
+    }
+    if(m_dataPV->passDecimation())
+    {
+        if(reduceArray(m_reductionMode, m_reductionFactor, data.get(), &m_reducedData))
+        {
+            m_dataPV->pushToControlSystem(timestamp, m_reducedData);
+        }
+        else
+        {
+            m_dataPV->pushToControlSystem(timestamp, data.get());
+        }
+    }
+    pushSharedBufferToLinkedPVs(*m_dataPV, timestamp, data, isSharedBufferType<T>());
+}
+
+template<typename T>
+template<typename R>
+void DataAcquisitionImpl<T>::pushRaw(const timespec& timestamp, const std::vector<R>& rawData)
+{
+    scaleWaveform(rawData.data(), rawData.size(), m_amplitude.load(std::memory_order_acquire), m_offset.load(std::memory_order_acquire), &m_scaledData);
+    push(timestamp, m_scaledData);
 }
 
 template<typename T>
@@ -191,6 +358,19 @@ void DataAcquisitionImpl<T>::onStart()
 {
     m_startTime = m_startTimestampFunction();
     m_dataPV->setDecimation((std::uint32_t)(m_decimationPV->getValue()));
+
+    const std::int32_t reductionMode(m_reductionModePV->getValue());
+    if(reductionMode < (std::int32_t)reductionMode_t::none || reductionMode > (std::int32_t)reductionMode_t::average)
+    {
+        // The value comes from the control system: refuse to start and
+        //  roll back to the previous state
+        /////////////////////////////////////////////////////////////////
+        throw StateMachineRollBack("Invalid reduction mode");
+    }
+    const std::int32_t reductionFactor(m_reductionFactorPV->getValue());
+    m_reductionMode = (reductionMode_t)reductionMode;
+    m_reductionFactor = reductionFactor < 1 ? 1 : (size_t)reductionFactor;
+
     m_onStartDelegate();
 }
 
@@ -202,6 +382,17 @@ template class DataAcquisitionImpl<std::vector<std::uint8_t> >;
 template class DataAcquisitionImpl<std::vector<std::int32_t> >;
 template class DataAcquisitionImpl<std::vector<double> >;
 template class DataAcquisitionImpl<std::string >;
+template class DataAcquisitionImpl<std::int16_t>;
+template class DataAcquisitionImpl<std::uint16_t>;
+template class DataAcquisitionImpl<std::int64_t>;
+template class DataAcquisitionImpl<float>;
+template class DataAcquisitionImpl<std::vector<std::int16_t> >;
+template class DataAcquisitionImpl<std::vector<std::uint16_t> >;
+template class DataAcquisitionImpl<std::vector<std::int64_t> >;
+template class DataAcquisitionImpl<std::vector<float> >;
+
+template void DataAcquisitionImpl<std::vector<double> >::pushRaw<std::int16_t>(const timespec&, const std::vector<std::int16_t>&);
+template void DataAcquisitionImpl<std::vector<double> >::pushRaw<std::int32_t>(const timespec&, const std::vector<std::int32_t>&);
 
 
 }
@@ -36,6 +36,10 @@ TimeConversionError::TimeConversionError(const std::string &what): NdsError(what
 {
 }
 
+PVDataTypeError::PVDataTypeError(const std::string &what): NdsError(what)
+{
+}
+
 NoPortDefinedError::NoPortDefinedError(const std::string &what): std::logic_error(what)
 {
 }
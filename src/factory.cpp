@@ -12,6 +12,7 @@
 #include "nds3/impl/factoryBaseImpl.h"
 #include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/threadBaseImpl.h"
+#include "nds3/impl/threadPoolImpl.h"
 
 namespace nds
 {
@@ -31,6 +32,11 @@ void Factory::registerDriver(const std::string &driverName, allocateDriver_t all
     NdsFactoryImpl::getInstance().registerDriver(driverName, allocateFunction, deallocateFunction);
 }
 
+void Factory::reloadDriver(const std::string& driverName, const std::string& driverModuleName)
+{
+    NdsFactoryImpl::getInstance().reloadDriver(driverName, driverModuleName);
+}
+
 void Factory::registerControlSystem(Factory &factory)
 {
     NdsFactoryImpl::getInstance().registerControlSystem(factory.m_pFactory);
@@ -76,11 +82,36 @@ Thread Factory::runInThread(const std::string &name, threadFunction_t function)
     return Thread(std::shared_ptr<ThreadBaseImpl>(m_pFactory->runInThread(name, function)));
 }
 
+Thread Factory::runInThread(const std::string &name, const taskClass_t taskClass, threadFunction_t function)
+{
+    return Thread(std::shared_ptr<ThreadBaseImpl>(m_pFactory->runInThread(name, taskClass, function)));
+}
+
+Thread Factory::runInThread(const std::string &name, const threadAttributes_t& attributes, threadFunction_t function)
+{
+    return Thread(std::shared_ptr<ThreadBaseImpl>(m_pFactory->runInThread(name, attributes, function)));
+}
+
+void Factory::setTaskClassAttributes(const taskClass_t taskClass, const threadAttributes_t& attributes)
+{
+    m_pFactory->getThreadPool().setTaskClassAttributes(taskClass, attributes);
+}
+
+void Factory::setInitializationThreads(const size_t numThreads)
+{
+    m_pFactory->setInitializationThreads(numThreads);
+}
+
 void Factory::loadNamingRules(std::istream& rules)
 {
     m_pFactory->loadNamingRules(rules);
 }
 
+void Factory::loadNamingRules(const std::string& rulesFileName)
+{
+    m_pFactory->loadNamingRules(rulesFileName);
+}
+
 void Factory::setNamingRules(const std::string& rulesName)
 {
     m_pFactory->setNamingRules(rulesName);
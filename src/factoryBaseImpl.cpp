@@ -8,8 +8,6 @@
  */
 
 #include <sstream>
-#include <cstdio>
-#include <algorithm>
 
 #include "nds3/exceptions.h"
 #include "nds3/factory.h"
@@ -17,13 +15,21 @@
 #include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/baseImpl.h"
 #include "nds3/impl/nodeImpl.h"
-#include "nds3/impl/threadStd.h"
+#include "nds3/impl/threadPoolImpl.h"
 #include "nds3/impl/iniFileParserImpl.h"
 
 namespace nds
 {
 
-FactoryBaseImpl::FactoryBaseImpl()
+/*
+ * Idle workers kept by the thread pool and time after which they terminate
+ *
+ **************************************************************************/
+static const size_t m_maxIdleWorkers(8);
+static const std::chrono::milliseconds m_workerIdleTimeout(60000);
+
+FactoryBaseImpl::FactoryBaseImpl(): m_pThreadPool(new ThreadPoolImpl(m_maxIdleWorkers, m_workerIdleTimeout)),
+    m_initializationThreads(1)
 {
 
 }
@@ -91,7 +97,10 @@ void* FactoryBaseImpl::createDevice(const std::string& driverName, const std::st
             errorMessage << "A device with named " << deviceName << " for the control system " << getName() << " has already been created";
             throw DeviceAlreadyCreated(errorMessage.str());
         }
-        m_allocatedDevices[deviceName].m_pDevice = 0;
+        allocatedDevice_t& allocatedDevice(m_allocatedDevices[deviceName]);
+        allocatedDevice.m_pDevice = 0;
+        allocatedDevice.m_driverName = driverName;
+        allocatedDevice.m_parameters = parameters;
     }
 
     std::pair<void*, deallocateDriver_t> newDevice;
@@ -179,10 +188,72 @@ void FactoryBaseImpl::destroyDevice(const std::string& deviceName)
     destroyDevice(pDevice);
 }
 
+FactoryBaseImpl::devicesParameters_t FactoryBaseImpl::destroyDriverDevices(const std::string& driverName)
+{
+    devicesParameters_t devices;
+    std::list<void*> destroyDevices;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for(allocatedDevices_t::const_iterator scanAllocated(m_allocatedDevices.begin()), endAllocated(m_allocatedDevices.end()); scanAllocated != endAllocated; ++scanAllocated)
+        {
+            // Skip the devices that are still being allocated
+            ///////////////////////////////////////////////////
+            if(scanAllocated->second.m_driverName != driverName || scanAllocated->second.m_pDevice == 0)
+            {
+                continue;
+            }
+            deviceParameters_t device;
+            device.m_deviceName = scanAllocated->first;
+            device.m_parameters = scanAllocated->second.m_parameters;
+            devices.push_back(device);
+            destroyDevices.push_back(scanAllocated->second.m_pDevice);
+        }
+    }
+
+    for(std::list<void*>::const_iterator scanDevices(destroyDevices.begin()), endDevices(destroyDevices.end()); scanDevices != endDevices; ++scanDevices)
+    {
+        destroyDevice(*scanDevices);
+    }
+
+    return devices;
+}
+
 
 ThreadBaseImpl* FactoryBaseImpl::runInThread(const std::string &name, threadFunction_t function)
 {
-    return new ThreadStd(this, name, function);
+    return runInThread(name, taskClass_t::acquisition, function);
+}
+
+ThreadBaseImpl* FactoryBaseImpl::runInThread(const std::string &name, const taskClass_t taskClass, threadFunction_t function)
+{
+    return m_pThreadPool->run(this, name, taskClass, function);
+}
+
+ThreadBaseImpl* FactoryBaseImpl::runInThread(const std::string &name, const threadAttributes_t& attributes, threadFunction_t function)
+{
+    return m_pThreadPool->run(this, name, attributes, function);
+}
+
+ThreadPoolImpl& FactoryBaseImpl::getThreadPool()
+{
+    return *m_pThreadPool;
+}
+
+void FactoryBaseImpl::setInitializationThreads(const size_t numThreads)
+{
+    size_t actualThreads(numThreads);
+    if(actualThreads == 0)
+    {
+        actualThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_initializationThreads.store(actualThreads);
+}
+
+size_t FactoryBaseImpl::getInitializationThreads() const
+{
+    return m_initializationThreads.load();
 }
 
 
@@ -196,10 +267,27 @@ void FactoryBaseImpl::holdNode(void* pDeviceObject, std::shared_ptr<NodeImpl> pH
 
 const std::string& FactoryBaseImpl::getSeparator(const std::uint32_t nodeLevel) const
 {
-    if(m_namingRules.get() == 0 || m_namingRulesName.empty())
+    if(m_pCompiledNamingRules.get() == 0)
     {
         return getDefaultSeparator(nodeLevel);
     }
+
+    const std::string* pSeparator(m_pCompiledNamingRules->getSeparator(nodeLevel));
+    if(pSeparator != 0)
+    {
+        return *pSeparator;
+    }
+    return getSeparatorFromRules(nodeLevel);
+}
+
+/*
+ * Resolve the separator directly from the INI file.
+ * Used to compile the rules and for the levels that
+ *  have not been compiled
+ *
+ ***************************************************/
+const std::string& FactoryBaseImpl::getSeparatorFromRules(const std::uint32_t nodeLevel) const
+{
     if(nodeLevel == 0)
     {
         return m_namingRules->getString(m_namingRulesName, "separator0", getDefaultSeparator(0));
@@ -210,7 +298,7 @@ const std::string& FactoryBaseImpl::getSeparator(const std::uint32_t nodeLevel)
     if(m_namingRules->keyExists(m_namingRulesName, "separator1") || m_namingRules->keyExists(m_namingRulesName, "separator0"))
     {
         // At leas one separator rule has been defined
-        return m_namingRules->getString(m_namingRulesName, thisLevelKey.str(), getSeparator(nodeLevel - 1));
+        return m_namingRules->getString(m_namingRulesName, thisLevelKey.str(), getSeparatorFromRules(nodeLevel - 1));
     }
     return m_namingRules->getString(m_namingRulesName, thisLevelKey.str(), getDefaultSeparator(nodeLevel));
 }
@@ -218,7 +306,22 @@ const std::string& FactoryBaseImpl::getSeparator(const std::uint32_t nodeLevel)
 void FactoryBaseImpl::loadNamingRules(std::istream& rules)
 {
     m_namingRules.reset(new IniFileParserImpl(rules));
+    selectSingleNamingRules();
+}
 
+void FactoryBaseImpl::loadNamingRules(const std::string& rulesFileName)
+{
+    m_namingRules.reset(new IniFileParserImpl(rulesFileName));
+    selectSingleNamingRules();
+}
+
+/*
+ * If the rules file contains only one section then its rules are
+ *  used, otherwise setNamingRules() must select them
+ *
+ *****************************************************************/
+void FactoryBaseImpl::selectSingleNamingRules()
+{
     IniFileParserImpl::sectionsList_t sections(m_namingRules->getSections());
     if(sections.size() == 1)
     {
@@ -228,121 +331,116 @@ void FactoryBaseImpl::loadNamingRules(std::istream& rules)
     {
         m_namingRulesName.clear();
     }
+
+    compileNamingRules();
 }
 
 void FactoryBaseImpl::setNamingRules(const std::string& rulesName)
 {
+    std::string previousRulesName(m_namingRulesName);
     m_namingRulesName = rulesName;
+    try
+    {
+        compileNamingRules();
+    }
+    catch(...)
+    {
+        m_namingRulesName = previousRulesName;
+        throw;
+    }
+}
+
+void FactoryBaseImpl::compileNamingRules()
+{
+    if(m_namingRules.get() == 0 || m_namingRulesName.empty())
+    {
+        m_pCompiledNamingRules.reset();
+        return;
+    }
+
+    std::vector<std::string> separators;
+    separators.reserve(NamingRulesImpl::m_numCompiledSeparators);
+    for(std::uint32_t scanLevels(0); scanLevels != NamingRulesImpl::m_numCompiledSeparators; ++scanLevels)
+    {
+        separators.push_back(getSeparatorFromRules(scanLevels));
+    }
+
+    m_pCompiledNamingRules.reset(new NamingRulesImpl(*m_namingRules, m_namingRulesName, separators));
 }
 
 
 std::string FactoryBaseImpl::getRootNodeName(const std::string& name) const
 {
-    return buildNameFromRule(name, "rootNode", "genericNode");
+    return buildNameFromRole(namingRole_t::rootNode, name);
 }
 
 std::string FactoryBaseImpl::getGenericChannelName(const std::string& name) const
 {
-    return buildNameFromRule(name, "genericNode");
+    return buildNameFromRole(namingRole_t::genericNode, name);
 }
 
 std::string FactoryBaseImpl::getInputChannelName(const std::string& name) const
 {
-    return buildNameFromRule(name, "inputNode", "sourceNode","genericNode");
+    return buildNameFromRole(namingRole_t::inputNode, name);
 }
 
 std::string FactoryBaseImpl::getOutputChannelName(const std::string& name) const
 {
-    return buildNameFromRule(name, "outputNode", "sinkNode","genericNode");
+    return buildNameFromRole(namingRole_t::outputNode, name);
 }
 
 std::string FactoryBaseImpl::getSourceChannelName(const std::string& name) const
 {
-    return buildNameFromRule(name, "sourceNode", "inputNode","genericNode");
+    return buildNameFromRole(namingRole_t::sourceNode, name);
 }
 
 std::string FactoryBaseImpl::getSinkChannelName(const std::string& name) const
 {
-    return buildNameFromRule(name, "sinkNode", "outputNode","genericNode");
+    return buildNameFromRole(namingRole_t::sinkNode, name);
 }
 
 std::string FactoryBaseImpl::getInputPVName(const std::string& name) const
 {
-    return buildNameFromRule(name, "inputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::inputPV, name);
 }
 
 std::string FactoryBaseImpl::getOutputPVName(const std::string& name) const
 {
-    return buildNameFromRule(name, "outputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::outputPV, name);
 }
 
 std::string FactoryBaseImpl::getStateMachineNodeName(const std::string& name) const
 {
-    return buildNameFromRule(name, "stateMachineNode", "genericNode");
+    return buildNameFromRole(namingRole_t::stateMachineNode, name);
 }
 
 std::string FactoryBaseImpl::getStateMachineSetStateName(const std::string& name) const
 {
-    return buildNameFromRule(name, "setStatePV", "outputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::setStatePV, name);
 }
 
 std::string FactoryBaseImpl::getStateMachineGetStateName(const std::string& name) const
 {
-    return buildNameFromRule(name, "getStatePV", "inputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::getStatePV, name);
 }
 
 std::string FactoryBaseImpl::getStateMachineGetGlobalStateName(const std::string& name) const
 {
-    return buildNameFromRule(name, "getGlobalStatePV", "inputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::getGlobalStatePV, name);
 }
 
 std::string FactoryBaseImpl::getDecimationPVName(const std::string& name) const
 {
-    return buildNameFromRule(name, "setDecimationPV", "outputPV", "genericPV");
+    return buildNameFromRole(namingRole_t::decimationPV, name);
 }
 
-std::string FactoryBaseImpl::buildNameFromRule(const std::string& name,
-                                               const std::string& rule0,
-                                               const std::string& rule1,
-                                               const std::string& rule2,
-                                               const std::string& rule3,
-                                               const std::string& rule4
-                                               ) const
+std::string FactoryBaseImpl::buildNameFromRole(const namingRole_t role, const std::string& name) const
 {
-    if(m_namingRules.get() == 0 || m_namingRulesName.empty())
+    if(m_pCompiledNamingRules.get() == 0)
     {
         return name;
     }
-
-    const std::string defaultRule("%s");
-    const std::string& rule = m_namingRules->getString(m_namingRulesName, rule0,
-                               m_namingRules->getString(m_namingRulesName, rule1,
-                                m_namingRules->getString(m_namingRulesName, rule2,
-                                 m_namingRules->getString(m_namingRulesName, rule3,
-                                  m_namingRules->getString(m_namingRulesName, rule4, defaultRule)))));
-
-    std::string adjustedName(name);
-    bool toUpper = m_namingRules->getString(m_namingRulesName, "toUpper", "0") == "1";
-    bool toLower = m_namingRules->getString(m_namingRulesName, "toLower", "0") == "1";
-    if(toUpper)
-    {
-        std::transform(name.begin(), name.end(), adjustedName.begin(), ::toupper);
-    }
-    if(toLower)
-    {
-        std::transform(name.begin(), name.end(), adjustedName.begin(), ::tolower);
-    }
-
-    char buffer[1024];
-    snprintf(buffer, sizeof(buffer), rule.c_str(), adjustedName.c_str());
-
-    // Replace spaces with 0
-    std::string returnString(buffer);
-    std::replace(returnString.begin(), returnString.end(), ' ', '0');
-
-    return returnString;
-
-
+    return m_pCompiledNamingRules->buildName(role, name);
 }
 
 
@@ -18,6 +18,11 @@ IniFileParser::IniFileParser(std::istream &inputStream):
 {
 }
 
+IniFileParser::IniFileParser(const std::string& fileName):
+    m_pImplementation(std::make_shared<IniFileParserImpl>(fileName))
+{
+}
+
 IniFileParser::~IniFileParser()
 {
 }
@@ -9,6 +9,12 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include "nds3/exceptions.h"
 #include "nds3/impl/iniFileParserImpl.h"
@@ -21,44 +27,79 @@ static const std::string m_quotes("'\"");
 
 IniFileParserImpl::IniFileParserImpl(std::istream& inputStream)
 {
-    std::string lastSection;
+    std::ostringstream text;
+    text << inputStream.rdbuf();
+    m_text = text.str();
+    m_pText = m_text.data();
+    m_textSize = m_text.size();
 
-    std::string line;
-    size_t lineCounter(0);
-    for(
-        std::getline(inputStream, line);
-        (inputStream.rdstate() & std::istream::failbit) == 0;
-        std::getline(inputStream, line))
+    indexSections();
+
+    // Report the syntax errors right away
+    //////////////////////////////////////
+    for(std::vector<section_t>::const_iterator scanSections(m_indexedSections.begin()), endSections(m_indexedSections.end());
+        scanSections != endSections;
+        ++scanSections)
     {
-        ++lineCounter;
+        parseSection(*scanSections);
+    }
+}
+
+/*
+ * The file is copied in memory instead of being mapped: the sections are
+ *  parsed lazily and a mapped file truncated by another process would
+ *  raise SIGBUS
+ *
+ *************************************************************************/
+IniFileParserImpl::IniFileParserImpl(const std::string& fileName)
+{
+    int fileDescriptor(::open(fileName.c_str(), O_RDONLY));
+    if(fileDescriptor < 0)
+    {
+        throw std::runtime_error("Cannot open the INI file " + fileName);
+    }
 
-        try
+    struct stat status;
+    if(::fstat(fileDescriptor, &status) != 0)
+    {
+        ::close(fileDescriptor);
+        throw std::runtime_error("Cannot read the size of the INI file " + fileName);
+    }
+
+    // Read until the end of the file, which may have changed size
+    //  after fstat()
+    //////////////////////////////////////////////////////////////
+    m_text.resize((size_t)status.st_size + 1);
+    size_t textSize(0);
+    for(;;)
+    {
+        if(textSize == m_text.size())
+        {
+            m_text.resize(m_text.size() * 2);
+        }
+        const ssize_t readBytes(::read(fileDescriptor, &(m_text[textSize]), m_text.size() - textSize));
+        if(readBytes < 0)
         {
-            std::string section = getSection(line);
-            if(!section.empty())
+            if(errno == EINTR)
             {
-                lastSection = section;
                 continue;
             }
-
-            keyValue_t valueKey(getKeyValue(line));
-            if(!valueKey.first.empty())
-            {
-                m_sections[lastSection][valueKey.first] = valueKey.second;
-            }
+            ::close(fileDescriptor);
+            throw std::runtime_error("Cannot read the INI file " + fileName);
         }
-        catch(const INIParserError& e)
+        if(readBytes == 0)
         {
-            std::ostringstream errorMessage;
-            errorMessage << "Syntax error on line " << lineCounter << ": " << e.what();
-            throw INIParserSyntaxError(errorMessage.str());
+            break;
         }
+        textSize += (size_t)readBytes;
     }
-}
+    ::close(fileDescriptor);
 
-IniFileParserImpl::~IniFileParserImpl()
-{
+    m_text.resize(textSize);
+    m_pText = m_text.data();
+    m_textSize = m_text.size();
 
+    indexSections();
 }
 
 const std::string& IniFileParserImpl::getString(const std::string &section, const std::string &key, const std::string &defaultValue) const
@@ -68,16 +109,10 @@ const std::string& IniFileParserImpl::getString(const std::string &section, cons
         return defaultValue;
     }
 
-    sectionKeyMap_t::const_iterator findSection(m_sections.find(section));
-    if(findSection == m_sections.end())
-    {
-        std::ostringstream errorMessage;
-        errorMessage << "The section " << section << " is missing from the INI file";
-        throw INIParserMissingSection(errorMessage.str());
-    }
+    const keyValueMap_t& keys(getSectionKeys(section));
 
-    keyValueMap_t::const_iterator findKey(findSection->second.find(key));
-    if(findKey == findSection->second.end())
+    keyValueMap_t::const_iterator findKey(keys.find(key));
+    if(findKey == keys.end())
     {
         return defaultValue;
     }
@@ -86,32 +121,276 @@ const std::string& IniFileParserImpl::getString(const std::string &section, cons
 
 bool IniFileParserImpl::keyExists(const std::string &section, const std::string &key) const
 {
-    sectionKeyMap_t::const_iterator findSection(m_sections.find(section));
-    if(findSection == m_sections.end())
-    {
-        std::ostringstream errorMessage;
-        errorMessage << "The section " << section << " is missing from the INI file";
-        throw INIParserMissingSection(errorMessage.str());
-    }
+    const keyValueMap_t& keys(getSectionKeys(section));
 
-    keyValueMap_t::const_iterator findKey(findSection->second.find(key));
-    return (findKey != findSection->second.end());
+    keyValueMap_t::const_iterator findKey(keys.find(key));
+    return (findKey != keys.end());
 }
 
 IniFileParserImpl::sectionsList_t IniFileParserImpl::getSections() const
 {
     sectionsList_t sectionsList;
-    for(sectionKeyMap_t::const_iterator scanSections(m_sections.begin()), endSections(m_sections.end());
+    for(std::vector<section_t>::const_iterator scanSections(m_indexedSections.begin()), endSections(m_indexedSections.end());
         scanSections != endSections;
         ++scanSections)
     {
-        sectionsList.push_back(scanSections->first);
+        if(scanSections->m_bHasKeys)
+        {
+            sectionsList.push_back(std::string(scanSections->m_name.m_pBegin, scanSections->m_name.m_size));
+        }
     }
+    sectionsList.sort();
 
     return sectionsList;
 
 }
 
+/*
+ * Split the text in lines and look for the section headers without
+ *  copying the lines.
+ * The keys before the first header belong to the section with an
+ *  empty name.
+ *
+ ******************************************************************/
+void IniFileParserImpl::indexSections()
+{
+    static const std::string commentStart("#;");
+
+    // Locate the sections
+    //////////////////////
+    struct sectionHeader_t
+    {
+        textSlice_t m_name;
+        textRange_t m_range;
+        bool m_bHasKeys;
+    };
+    std::vector<sectionHeader_t> headers;
+
+    sectionHeader_t header;
+    header.m_name.m_pBegin = m_pText;
+    header.m_name.m_size = 0;
+    header.m_range.m_begin = 0;
+    header.m_range.m_firstLine = 1;
+    header.m_bHasKeys = false;
+
+    size_t lineCounter(0);
+    for(size_t lineBegin(0); lineBegin < m_textSize;)
+    {
+        ++lineCounter;
+        const char* pLineEnd((const char*)std::memchr(m_pText + lineBegin, '\n', m_textSize - lineBegin));
+        size_t lineEnd(pLineEnd == 0 ? m_textSize : (size_t)(pLineEnd - m_pText));
+        size_t nextLine(pLineEnd == 0 ? m_textSize : lineEnd + 1);
+
+        size_t trimmedBegin(lineBegin);
+        size_t trimmedEnd(lineEnd);
+        while(trimmedBegin != trimmedEnd && m_spaces.find(m_pText[trimmedBegin]) != std::string::npos)
+        {
+            ++trimmedBegin;
+        }
+        while(trimmedBegin != trimmedEnd && m_spaces.find(m_pText[trimmedEnd - 1]) != std::string::npos)
+        {
+            --trimmedEnd;
+        }
+
+        if(trimmedBegin == trimmedEnd)
+        {
+            lineBegin = nextLine;
+            continue;
+        }
+
+        // Same rule as getKeyValue(): a comment containing an unescaped '='
+        //  is parsed as a key
+        ////////////////////////////////////////////////////////////////////
+        if(commentStart.find(m_pText[trimmedBegin]) != std::string::npos)
+        {
+            for(size_t scanLine(trimmedBegin + 1); scanLine != trimmedEnd; ++scanLine)
+            {
+                if(m_pText[scanLine] == '=' && m_pText[scanLine - 1] != '\\')
+                {
+                    header.m_bHasKeys = true;
+                    break;
+                }
+            }
+            lineBegin = nextLine;
+            continue;
+        }
+
+        // The section name ends at the first unescaped ']'
+        //  and a header with an empty name is parsed as a key
+        ///////////////////////////////////////////////////////////////////////
+        size_t nameBegin(trimmedBegin + 1);
+        size_t nameEnd(trimmedEnd);
+        if(m_pText[trimmedBegin] == '[')
+        {
+            for(nameEnd = nameBegin; nameEnd != trimmedEnd; ++nameEnd)
+            {
+                if(m_pText[nameEnd] == ']' && m_pText[nameEnd - 1] != '\\')
+                {
+                    break;
+                }
+            }
+            while(nameBegin != nameEnd && m_spaces.find(m_pText[nameBegin]) != std::string::npos)
+            {
+                ++nameBegin;
+            }
+            while(nameBegin != nameEnd && m_spaces.find(m_pText[nameEnd - 1]) != std::string::npos)
+            {
+                --nameEnd;
+            }
+        }
+        if(m_pText[trimmedBegin] != '[' || nameEnd == trimmedEnd || nameBegin == nameEnd)
+        {
+            // Key or syntax error
+            //////////////////////
+            header.m_bHasKeys = true;
+            lineBegin = nextLine;
+            continue;
+        }
+
+        header.m_range.m_end = lineBegin;
+        headers.push_back(header);
+
+        header.m_name.m_pBegin = m_pText + nameBegin;
+        header.m_name.m_size = nameEnd - nameBegin;
+        header.m_range.m_begin = nextLine;
+        header.m_range.m_firstLine = lineCounter + 1;
+        header.m_bHasKeys = false;
+
+        lineBegin = nextLine;
+    }
+    header.m_range.m_end = m_textSize;
+    headers.push_back(header);
+
+    // Build the index: at least twice as many slots as the sections
+    ////////////////////////////////////////////////////////////////
+    size_t indexSize(16);
+    while(indexSize < headers.size() * 2)
+    {
+        indexSize <<= 1;
+    }
+    m_sectionsIndex.assign(indexSize, 0);
+    m_sectionsIndexMask = indexSize - 1;
+
+    m_indexedSections.reserve(headers.size());
+    for(std::vector<sectionHeader_t>::const_iterator scanHeaders(headers.begin()), endHeaders(headers.end());
+        scanHeaders != endHeaders;
+        ++scanHeaders)
+    {
+        size_t slot(hashName(scanHeaders->m_name.m_pBegin, scanHeaders->m_name.m_size) & m_sectionsIndexMask);
+        for(; m_sectionsIndex[slot] != 0; slot = (slot + 1) & m_sectionsIndexMask)
+        {
+            const textSlice_t& name(m_indexedSections[m_sectionsIndex[slot] - 1].m_name);
+            if(name.m_size == scanHeaders->m_name.m_size &&
+               std::memcmp(name.m_pBegin, scanHeaders->m_name.m_pBegin, name.m_size) == 0)
+            {
+                break;
+            }
+        }
+
+        if(m_sectionsIndex[slot] == 0)
+        {
+            m_indexedSections.push_back(section_t());
+            m_indexedSections.back().m_name = scanHeaders->m_name;
+            m_indexedSections.back().m_bHasKeys = false;
+            m_sectionsIndex[slot] = (std::uint32_t)m_indexedSections.size();
+        }
+
+        section_t& section(m_indexedSections[m_sectionsIndex[slot] - 1]);
+        section.m_ranges.push_back(scanHeaders->m_range);
+        section.m_bHasKeys = section.m_bHasKeys || scanHeaders->m_bHasKeys;
+    }
+}
+
+const IniFileParserImpl::keyValueMap_t& IniFileParserImpl::getSectionKeys(const std::string& section) const
+{
+    size_t sectionNumber(findSection(section.data(), section.size()));
+    if(sectionNumber == m_sectionNotFound || !m_indexedSections[sectionNumber].m_bHasKeys)
+    {
+        std::ostringstream errorMessage;
+        errorMessage << "The section " << section << " is missing from the INI file";
+        throw INIParserMissingSection(errorMessage.str());
+    }
+
+    const section_t& foundSection(m_indexedSections[sectionNumber]);
+
+    std::lock_guard<std::mutex> lock(m_lockParse);
+    if(foundSection.m_pKeys.get() == 0)
+    {
+        parseSection(foundSection);
+    }
+    return *(foundSection.m_pKeys);
+}
+
+/*
+ * Parse the keys of a section. The keys are stored only if all the
+ *  lines are valid, so a section with a syntax error throws on
+ *  every access
+ *
+ ******************************************************************/
+void IniFileParserImpl::parseSection(const section_t& section) const
+{
+    std::unique_ptr<keyValueMap_t> pKeys(new keyValueMap_t());
+
+    for(std::vector<textRange_t>::const_iterator scanRanges(section.m_ranges.begin()), endRanges(section.m_ranges.end());
+        scanRanges != endRanges;
+        ++scanRanges)
+    {
+        size_t lineCounter(scanRanges->m_firstLine);
+        for(size_t lineBegin(scanRanges->m_begin); lineBegin < scanRanges->m_end; ++lineCounter)
+        {
+            const char* pLineEnd((const char*)std::memchr(m_pText + lineBegin, '\n', scanRanges->m_end - lineBegin));
+            size_t lineEnd(pLineEnd == 0 ? scanRanges->m_end : (size_t)(pLineEnd - m_pText));
+            std::string line(m_pText + lineBegin, lineEnd - lineBegin);
+            lineBegin = lineEnd + 1;
+
+            try
+            {
+                keyValue_t valueKey(getKeyValue(line));
+                if(!valueKey.first.empty())
+                {
+                    (*pKeys)[valueKey.first] = valueKey.second;
+                }
+            }
+            catch(const INIParserError& e)
+            {
+                std::ostringstream errorMessage;
+                errorMessage << "Syntax error on line " << lineCounter << ": " << e.what();
+                throw INIParserSyntaxError(errorMessage.str());
+            }
+        }
+    }
+
+    section.m_pKeys = std::move(pKeys);
+}
+
+size_t IniFileParserImpl::findSection(const char* pName, const size_t nameSize) const
+{
+    for(size_t slot(hashName(pName, nameSize) & m_sectionsIndexMask); m_sectionsIndex[slot] != 0; slot = (slot + 1) & m_sectionsIndexMask)
+    {
+        const textSlice_t& name(m_indexedSections[m_sectionsIndex[slot] - 1].m_name);
+        if(name.m_size == nameSize && std::memcmp(name.m_pBegin, pName, nameSize) == 0)
+        {
+            return m_sectionsIndex[slot] - 1;
+        }
+    }
+    return m_sectionNotFound;
+}
+
+/*
+ * FNV-1a
+ *
+ ********/
+std::uint32_t IniFileParserImpl::hashName(const char* pName, const size_t nameSize)
+{
+    std::uint32_t hash(2166136261u);
+    for(const char* pScanName(pName), *pEndName(pName + nameSize); pScanName != pEndName; ++pScanName)
+    {
+        hash ^= (std::uint8_t)*pScanName;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 std::string IniFileParserImpl::trim(const std::string& string)
 {
     size_t lastChar = string.find_last_not_of(m_spaces);
@@ -137,24 +416,6 @@ std::string IniFileParserImpl::trim(const std::string& string)
     return returnString;
 }
 
-std::string IniFileParserImpl::getSection(const std::string &line)
-{
-    std::string section(trim(line));
-    if(section.empty() || section.at(0) != '[')
-    {
-        return "";
-    }
-
-    size_t endSection(findFirstUnescapedChar(section, ']'));
-    if(endSection == std::string::npos)
-    {
-        return "";
-    }
-
-    return trim(section.substr(1, --endSection));
-
-}
-
 size_t IniFileParserImpl::findFirstUnescapedChar(const std::string &string, const char findChar, const size_t startPosition)
 {
     for(size_t startPos(startPosition); startPos < string.size();)
@@ -188,7 +449,7 @@ IniFileParserImpl::keyValue_t IniFileParserImpl::getKeyValue(const std::string&
     std::string variable(trim(line.substr(0, equalSign)));
     if(variable.empty())
     {
-        throw;
+        throw INIParserSyntaxError("Missing key name");
     }
 
     std::string value(trim(line.substr(++equalSign)));
@@ -199,7 +460,7 @@ IniFileParserImpl::keyValue_t IniFileParserImpl::getKeyValue(const std::string&
             size_t findEndQuotes = findFirstUnescapedChar(value, value.at(0), 1);
             if(findEndQuotes == std::string::npos)
             {
-                throw;
+                throw INIParserSyntaxError("Missing closing quotes");
             }
             return keyValue_t(variable, value.substr(1, --findEndQuotes));
         }
@@ -16,5 +16,148 @@ InterfaceBaseImpl::~InterfaceBaseImpl()
 {
 }
 
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::int16_t& value)
+{
+    push(pv, timestamp, (std::int32_t)value);
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::uint16_t& value)
+{
+    push(pv, timestamp, (std::int32_t)value);
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::int64_t& value)
+{
+    push(pv, timestamp, (double)value);
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const float& value)
+{
+    push(pv, timestamp, (double)value);
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int16_t>& value)
+{
+    push(pv, timestamp, std::vector<std::int32_t>(value.begin(), value.end()));
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::uint16_t>& value)
+{
+    push(pv, timestamp, std::vector<std::int32_t>(value.begin(), value.end()));
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int64_t>& value)
+{
+    push(pv, timestamp, std::vector<double>(value.begin(), value.end()));
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<float>& value)
+{
+    push(pv, timestamp, std::vector<double>(value.begin(), value.end()));
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int8_t> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint8_t> >& value)
+{
+    push(pv, timestamp, value.get());
 }
 
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int32_t> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<double> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int16_t> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint16_t> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int64_t> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<float> >& value)
+{
+    push(pv, timestamp, value.get());
+}
+
+void InterfaceBaseImpl::registerPVs(const pvsList_t& pvs)
+{
+    for(pvsList_t::const_iterator scanPVs(pvs.begin()), endPVs(pvs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        registerPV(*scanPVs);
+    }
+}
+
+void InterfaceBaseImpl::deregisterPVs(const pvsList_t& pvs)
+{
+    for(pvsList_t::const_iterator scanPVs(pvs.begin()), endPVs(pvs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        deregisterPV(*scanPVs);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int32_t* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const double* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int16_t* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::uint16_t* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int64_t* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+void InterfaceBaseImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const float* pValues, const size_t count)
+{
+    for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+    {
+        push(pv, pTimestamps[scanSamples], pValues[scanSamples]);
+    }
+}
+
+}
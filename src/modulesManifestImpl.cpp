@@ -0,0 +1,166 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "nds3/impl/modulesManifestImpl.h"
+
+namespace nds
+{
+
+/*
+ * Each line contains the module name, the modification time (seconds
+ *  and nanoseconds), the size and the driver name separated by tabs
+ *
+ *********************************************************************/
+static const char m_fieldSeparator('\t');
+
+ModulesManifestImpl::ModulesManifestImpl(const std::string& fileName): m_fileName(fileName), m_bModified(false)
+{
+    readEntries(fileName, &m_entries);
+}
+
+void ModulesManifestImpl::readEntries(const std::string& fileName, entries_t* pEntries)
+{
+    std::ifstream manifest(fileName.c_str());
+    std::string line;
+    while(std::getline(manifest, line))
+    {
+        std::istringstream lineStream(line);
+        std::string moduleName, seconds, nanoseconds, size;
+        entry_t entry;
+        if(!std::getline(lineStream, moduleName, m_fieldSeparator) ||
+           !std::getline(lineStream, seconds, m_fieldSeparator) ||
+           !std::getline(lineStream, nanoseconds, m_fieldSeparator) ||
+           !std::getline(lineStream, size, m_fieldSeparator))
+        {
+            // Malformed line: the module will be loaded again
+            //////////////////////////////////////////////////
+            continue;
+        }
+        std::getline(lineStream, entry.m_driverName);
+
+        std::istringstream(seconds) >> entry.m_modificationTime.tv_sec;
+        std::istringstream(nanoseconds) >> entry.m_modificationTime.tv_nsec;
+        std::istringstream(size) >> entry.m_size;
+        (*pEntries)[moduleName] = entry;
+    }
+}
+
+bool ModulesManifestImpl::getDriverName(const std::string& moduleName, std::string* pDriverName)
+{
+    entries_t::iterator findEntry(m_entries.find(moduleName));
+    if(findEntry == m_entries.end())
+    {
+        return false;
+    }
+
+    timespec modificationTime;
+    std::uint64_t size;
+    if(!getModuleStatus(moduleName, &modificationTime, &size) ||
+       modificationTime.tv_sec != findEntry->second.m_modificationTime.tv_sec ||
+       modificationTime.tv_nsec != findEntry->second.m_modificationTime.tv_nsec ||
+       size != findEntry->second.m_size)
+    {
+        return false;
+    }
+
+    *pDriverName = findEntry->second.m_driverName;
+    return true;
+}
+
+void ModulesManifestImpl::setDriverName(const std::string& moduleName, const std::string& driverName)
+{
+    entry_t entry;
+    if(!getModuleStatus(moduleName, &entry.m_modificationTime, &entry.m_size))
+    {
+        return;
+    }
+    entry.m_driverName = driverName;
+    m_entries[moduleName] = entry;
+    m_bModified = true;
+}
+
+bool ModulesManifestImpl::save()
+{
+    // Keep the entries written by other processes since the manifest
+    //  was loaded. This process' entries are the most recent ones
+    //////////////////////////////////////////////////////////////////
+    entries_t fileEntries;
+    readEntries(m_fileName, &fileEntries);
+    m_entries.insert(fileEntries.begin(), fileEntries.end());
+
+    // Drop the modules that have been removed
+    //////////////////////////////////////////
+    for(entries_t::iterator scanEntries(m_entries.begin()); scanEntries != m_entries.end();)
+    {
+        timespec modificationTime;
+        std::uint64_t size;
+        if(getModuleStatus(scanEntries->first, &modificationTime, &size))
+        {
+            ++scanEntries;
+            continue;
+        }
+        m_entries.erase(scanEntries++);
+        m_bModified = true;
+    }
+
+    if(!m_bModified)
+    {
+        return true;
+    }
+
+    // Write a temporary file and rename it, so a concurrent reader
+    //  never sees a partial manifest
+    ///////////////////////////////////////////////////////////////
+    const std::string temporaryFileName(m_fileName + ".tmp");
+    {
+        std::ofstream manifest(temporaryFileName.c_str(), std::ios::out | std::ios::trunc);
+        for(entries_t::const_iterator scanEntries(m_entries.begin()), endEntries(m_entries.end()); scanEntries != endEntries; ++scanEntries)
+        {
+            manifest << scanEntries->first << m_fieldSeparator
+                     << scanEntries->second.m_modificationTime.tv_sec << m_fieldSeparator
+                     << scanEntries->second.m_modificationTime.tv_nsec << m_fieldSeparator
+                     << scanEntries->second.m_size << m_fieldSeparator
+                     << scanEntries->second.m_driverName << "\n";
+        }
+        manifest.flush();
+        if(!manifest.good())
+        {
+            std::remove(temporaryFileName.c_str());
+            return false;
+        }
+    }
+
+    if(std::rename(temporaryFileName.c_str(), m_fileName.c_str()) != 0)
+    {
+        std::remove(temporaryFileName.c_str());
+        return false;
+    }
+
+    m_bModified = false;
+    return true;
+}
+
+bool ModulesManifestImpl::getModuleStatus(const std::string& moduleName, timespec* pModificationTime, std::uint64_t* pSize)
+{
+    struct stat status;
+    if(::stat(moduleName.c_str(), &status) != 0)
+    {
+        return false;
+    }
+    *pModificationTime = status.st_mtim;
+    *pSize = (std::uint64_t)status.st_size;
+    return true;
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <stdexcept>
+#include <sstream>
+
+#include "nds3/impl/nameTableImpl.h"
+
+namespace nds
+{
+
+const nameId_t NameTableImpl::m_invalidNameId;
+const size_t NameTableImpl::m_shardBits;
+const size_t NameTableImpl::m_numShards;
+
+NameTableImpl::NameTableImpl()
+{
+}
+
+/*
+ * Select the shard from the upper bits of the hash: the lower ones
+ *  select the bucket in the shard's index
+ *
+ ******************************************************************/
+NameTableImpl::shard_t& NameTableImpl::getShard(const std::string& name)
+{
+    const size_t hash(std::hash<std::string>()(name));
+    return m_shards[(hash >> (sizeof(size_t) * 8 - m_shardBits)) & (m_numShards - 1)];
+}
+
+const NameTableImpl::shard_t& NameTableImpl::getShard(const std::string& name) const
+{
+    return const_cast<NameTableImpl*>(this)->getShard(name);
+}
+
+const InternedName* NameTableImpl::intern(const std::string& name)
+{
+    shard_t& shard(getShard(name));
+    std::lock_guard<std::mutex> lock(shard.m_lockNames);
+
+    index_t::const_iterator findName(shard.m_index.find(&name));
+    if(findName != shard.m_index.end())
+    {
+        InternedName* pName(&(shard.m_names[findName->second >> m_shardBits]));
+        ++(pName->m_references);
+        return pName;
+    }
+
+    // Reuse the slot of a removed name: the slot keeps its ID
+    ///////////////////////////////////////////////////////////
+    InternedName* pName;
+    if(!shard.m_freeSlots.empty())
+    {
+        pName = &(shard.m_names[shard.m_freeSlots.back()]);
+        shard.m_freeSlots.pop_back();
+        pName->m_name = name;
+    }
+    else
+    {
+        const nameId_t id((nameId_t)((shard.m_names.size() << m_shardBits) | (size_t)(&shard - m_shards)));
+        if((shard.m_names.size() << m_shardBits) >= m_invalidNameId - m_numShards)
+        {
+            throw std::runtime_error("Too many names in the name table");
+        }
+
+        shard.m_names.push_back(InternedName(name, id));
+        pName = &(shard.m_names.back());
+    }
+    pName->m_references = 1;
+    shard.m_index.insert(std::make_pair(&(pName->m_name), pName->m_id));
+    return pName;
+}
+
+void NameTableImpl::release(const InternedName* pName)
+{
+    shard_t& shard(m_shards[pName->m_id & (m_numShards - 1)]);
+    std::lock_guard<std::mutex> lock(shard.m_lockNames);
+
+    const size_t slot(pName->m_id >> m_shardBits);
+    InternedName& name(shard.m_names[slot]);
+    if(name.m_references == 0)
+    {
+        std::ostringstream errorMessage;
+        errorMessage << "The name with ID " << name.m_id << " has already been released";
+        throw std::logic_error(errorMessage.str());
+    }
+    if(--(name.m_references) != 0)
+    {
+        return;
+    }
+
+    shard.m_index.erase(&(name.m_name));
+    std::string().swap(name.m_name);
+    shard.m_freeSlots.push_back(slot);
+}
+
+nameId_t NameTableImpl::find(const std::string& name) const
+{
+    const shard_t& shard(getShard(name));
+    std::lock_guard<std::mutex> lock(shard.m_lockNames);
+
+    index_t::const_iterator findName(shard.m_index.find(&name));
+    if(findName == shard.m_index.end())
+    {
+        return m_invalidNameId;
+    }
+    return findName->second;
+}
+
+const InternedName& NameTableImpl::getName(const nameId_t id) const
+{
+    const shard_t& shard(m_shards[id & (m_numShards - 1)]);
+    std::lock_guard<std::mutex> lock(shard.m_lockNames);
+
+    if(id == m_invalidNameId || (id >> m_shardBits) >= shard.m_names.size() || shard.m_names[id >> m_shardBits].m_references == 0)
+    {
+        std::ostringstream errorMessage;
+        errorMessage << "The name with ID " << id << " does not exist";
+        throw std::logic_error(errorMessage.str());
+    }
+    return shard.m_names[id >> m_shardBits];
+}
+
+size_t NameTableImpl::size() const
+{
+    size_t numNames(0);
+    for(size_t scanShards(0); scanShards != m_numShards; ++scanShards)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[scanShards].m_lockNames);
+        numNames += m_shards[scanShards].m_names.size() - m_shards[scanShards].m_freeSlots.size();
+    }
+    return numNames;
+}
+
+}
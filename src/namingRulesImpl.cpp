@@ -0,0 +1,225 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "nds3/impl/namingRulesImpl.h"
+#include "nds3/impl/iniFileParserImpl.h"
+
+namespace nds
+{
+
+/*
+ * The keys searched for each role, in order of preference
+ *
+ *********************************************************/
+static const size_t m_maxRulesPerRole(3);
+static const char* const m_roleRules[][m_maxRulesPerRole] =
+{
+    {"rootNode", "genericNode", 0},                   // rootNode
+    {"genericNode", 0, 0},                            // genericNode
+    {"inputNode", "sourceNode", "genericNode"},       // inputNode
+    {"outputNode", "sinkNode", "genericNode"},        // outputNode
+    {"sourceNode", "inputNode", "genericNode"},       // sourceNode
+    {"sinkNode", "outputNode", "genericNode"},        // sinkNode
+    {"inputPV", "genericPV", 0},                      // inputPV
+    {"outputPV", "genericPV", 0},                     // outputPV
+    {"stateMachineNode", "genericNode", 0},           // stateMachineNode
+    {"setStatePV", "outputPV", "genericPV"},          // setStatePV
+    {"getStatePV", "inputPV", "genericPV"},           // getStatePV
+    {"getGlobalStatePV", "inputPV", "genericPV"},     // getGlobalStatePV
+    {"setDecimationPV", "outputPV", "genericPV"}      // decimationPV
+};
+
+static const size_t m_numRoles(sizeof(m_roleRules) / sizeof(m_roleRules[0]));
+
+/*
+ * The names were built into a buffer of 1024 chars
+ *
+ **************************************************/
+static const size_t m_maxNameLength(1023);
+
+
+NamingRuleTemplate::segment_t::segment_t(const std::string& text):
+    m_text(text), m_bName(false), m_bLeftJustify(false), m_width(0), m_precision(std::string::npos)
+{
+    std::replace(m_text.begin(), m_text.end(), ' ', '0');
+}
+
+NamingRuleTemplate::segment_t::segment_t(const bool bLeftJustify, const size_t width, const size_t precision):
+    m_bName(true), m_bLeftJustify(bLeftJustify), m_width(width), m_precision(precision)
+{
+}
+
+NamingRuleTemplate::NamingRuleTemplate(const std::string& rule): m_literalLength(0), m_bUseSnprintf(false), m_rule(rule)
+{
+    std::string literal;
+    for(size_t scanRule(0); scanRule != rule.size(); ++scanRule)
+    {
+        if(rule[scanRule] != '%')
+        {
+            literal.push_back(rule[scanRule]);
+            continue;
+        }
+
+        size_t scanConversion(scanRule + 1);
+        if(scanConversion != rule.size() && rule[scanConversion] == '%')
+        {
+            literal.push_back('%');
+            scanRule = scanConversion;
+            continue;
+        }
+
+        // Parse the flags, width and precision
+        ///////////////////////////////////////
+        bool bLeftJustify(false);
+        while(scanConversion != rule.size() && std::string("-0 +#").find(rule[scanConversion]) != std::string::npos)
+        {
+            bLeftJustify |= rule[scanConversion] == '-';
+            ++scanConversion;
+        }
+        size_t width(0);
+        while(scanConversion != rule.size() && rule[scanConversion] >= '0' && rule[scanConversion] <= '9')
+        {
+            width = width * 10 + (size_t)(rule[scanConversion] - '0');
+            ++scanConversion;
+        }
+        size_t precision(std::string::npos);
+        if(scanConversion != rule.size() && rule[scanConversion] == '.')
+        {
+            precision = 0;
+            ++scanConversion;
+            while(scanConversion != rule.size() && rule[scanConversion] >= '0' && rule[scanConversion] <= '9')
+            {
+                precision = precision * 10 + (size_t)(rule[scanConversion] - '0');
+                ++scanConversion;
+            }
+        }
+
+        if(scanConversion == rule.size() || rule[scanConversion] != 's')
+        {
+            m_bUseSnprintf = true;
+            m_segments.clear();
+            return;
+        }
+
+        if(!literal.empty())
+        {
+            m_literalLength += literal.size();
+            m_segments.push_back(segment_t(literal));
+            literal.clear();
+        }
+        m_segments.push_back(segment_t(bLeftJustify, width, precision));
+        scanRule = scanConversion;
+    }
+
+    if(!literal.empty())
+    {
+        m_literalLength += literal.size();
+        m_segments.push_back(segment_t(literal));
+    }
+}
+
+std::string NamingRuleTemplate::buildName(const std::string& name) const
+{
+    std::string returnString;
+
+    if(m_bUseSnprintf)
+    {
+        char buffer[m_maxNameLength + 1];
+        snprintf(buffer, sizeof(buffer), m_rule.c_str(), name.c_str());
+        returnString = buffer;
+        std::replace(returnString.begin(), returnString.end(), ' ', '0');
+        return returnString;
+    }
+
+    returnString.reserve(m_literalLength + name.size());
+    for(segments_t::const_iterator scanSegments(m_segments.begin()), endSegments(m_segments.end()); scanSegments != endSegments; ++scanSegments)
+    {
+        if(!scanSegments->m_bName)
+        {
+            returnString.append(scanSegments->m_text);
+            continue;
+        }
+
+        const size_t nameLength(std::min(name.size(), scanSegments->m_precision));
+        const size_t padding(scanSegments->m_width > nameLength ? scanSegments->m_width - nameLength : 0);
+
+        // The padding spaces are replaced by '0'
+        /////////////////////////////////////////
+        if(!scanSegments->m_bLeftJustify)
+        {
+            returnString.append(padding, '0');
+        }
+        const size_t nameStart(returnString.size());
+        returnString.append(name, 0, nameLength);
+        std::replace(returnString.begin() + nameStart, returnString.end(), ' ', '0');
+        if(scanSegments->m_bLeftJustify)
+        {
+            returnString.append(padding, '0');
+        }
+    }
+
+    if(returnString.size() > m_maxNameLength)
+    {
+        returnString.resize(m_maxNameLength);
+    }
+    return returnString;
+}
+
+
+NamingRulesImpl::NamingRulesImpl(const IniFileParserImpl& rules, const std::string& rulesName, const std::vector<std::string>& separators):
+    m_bToUpper(rules.getString(rulesName, "toUpper", "0") == "1"),
+    m_bToLower(rules.getString(rulesName, "toLower", "0") == "1"),
+    m_separators(separators)
+{
+    const std::string defaultRule("%s");
+
+    m_templates.reserve(m_numRoles);
+    for(size_t scanRoles(0); scanRoles != m_numRoles; ++scanRoles)
+    {
+        const std::string* pRule(&defaultRule);
+        for(size_t scanRules(0); scanRules != m_maxRulesPerRole && m_roleRules[scanRoles][scanRules] != 0; ++scanRules)
+        {
+            if(rules.keyExists(rulesName, m_roleRules[scanRoles][scanRules]))
+            {
+                pRule = &(rules.getString(rulesName, m_roleRules[scanRoles][scanRules], defaultRule));
+                break;
+            }
+        }
+        m_templates.push_back(NamingRuleTemplate(*pRule));
+    }
+}
+
+std::string NamingRulesImpl::buildName(const namingRole_t role, const std::string& name) const
+{
+    const NamingRuleTemplate& ruleTemplate(m_templates[(size_t)role]);
+
+    if(!m_bToUpper && !m_bToLower)
+    {
+        return ruleTemplate.buildName(name);
+    }
+
+    std::string adjustedName(name);
+    std::transform(name.begin(), name.end(), adjustedName.begin(), m_bToLower ? ::tolower : ::toupper);
+    return ruleTemplate.buildName(adjustedName);
+}
+
+const std::string* NamingRulesImpl::getSeparator(const std::uint32_t nodeLevel) const
+{
+    if(nodeLevel >= m_separators.size())
+    {
+        return 0;
+    }
+    return &(m_separators[nodeLevel]);
+}
+
+}
@@ -13,6 +13,7 @@
 #include <dlfcn.h>
 #include <errno.h>
 #include <sstream>
+#include <exception>
 #include <string.h>
 #include <iostream>
 
@@ -20,6 +21,7 @@
 #include "nds3/factory.h"
 #include "nds3/impl/factoryBaseImpl.h"
 #include "nds3/impl/ndsFactoryImpl.h"
+#include "nds3/impl/modulesManifestImpl.h"
 #include "nds3/impl/pvBaseInImpl.h"
 #include "nds3/impl/pvBaseOutImpl.h"
 
@@ -70,20 +72,7 @@ NdsFactoryImpl::NdsFactoryImpl()
     devicesFolders.splice(devicesFolders.end(), separateFoldersList(std::getenv("LD_LIBRARY_PATH")));
     devicesFolders.splice(devicesFolders.end(), separateFoldersList(std::getenv("NDS_DEVICES")));
 
-    fileNames_t deviceModules = listFiles(devicesFolders, "lib", "NdsDevice.so");
-    for(fileNames_t::const_iterator scanFiles(deviceModules.begin()), endFiles(deviceModules.end());
-        scanFiles != endFiles;
-        ++scanFiles)
-    {
-        try
-        {
-            loadDriver(*scanFiles);
-        }
-        catch(const DriverDoesNotExportRegistrationFunctions& e)
-        {
-            std::cout << "Skipped library " << *scanFiles << " because it does not export the registration functions" << std::endl;
-        }
-    }
+    loadDeviceModules(listFiles(devicesFolders, "lib", "NdsDevice.so"));
 }
 
 NdsFactoryImpl::~NdsFactoryImpl()
@@ -101,12 +90,99 @@ NdsFactoryImpl::~NdsFactoryImpl()
     {
         scanControlSystems->second->preDelete();
     }
+
+    // The registered drivers and the control systems are deleted after the
+    //  modules: keep the code of the drivers in memory
+    ///////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(m_lockModules);
+    for(driverModules_t::iterator scanModules(m_driverModules.begin()), endModules(m_driverModules.end());
+        scanModules != endModules;
+        ++scanModules)
+    {
+        scanModules->second->keepLoaded();
+    }
 }
 
 
-void NdsFactoryImpl::loadDriver(const std::string& driverModuleName)
+void NdsFactoryImpl::loadDeviceModules(const fileNames_t& deviceModules)
+{
+    // Without a manifest all the modules are loaded immediately
+    ////////////////////////////////////////////////////////////
+    const char* manifestFileName(std::getenv("NDS_MODULES_MANIFEST"));
+    if(manifestFileName == 0 || *manifestFileName == 0)
+    {
+        for(fileNames_t::const_iterator scanFiles(deviceModules.begin()), endFiles(deviceModules.end());
+            scanFiles != endFiles;
+            ++scanFiles)
+        {
+            try
+            {
+                loadDriver(*scanFiles);
+            }
+            catch(const DriverDoesNotExportRegistrationFunctions& e)
+            {
+                std::cout << "Skipped library " << *scanFiles << " because it does not export the registration functions" << std::endl;
+            }
+            catch(const DriverNotFound& e)
+            {
+                std::cout << "Skipped library " << *scanFiles << " because it cannot be loaded" << std::endl;
+            }
+        }
+        return;
+    }
+
+    // The modules listed in the manifest are loaded by createDevice() when
+    //  their driver is needed; the other ones are loaded now and added to
+    //  the manifest.
+    // The modules that don't export the registration functions may register
+    //  their drivers from static initializers: they are loaded at every
+    //  start and are not added to the manifest
+    ///////////////////////////////////////////////////////////////////////
+    ModulesManifestImpl manifest(manifestFileName);
+    for(fileNames_t::const_iterator scanFiles(deviceModules.begin()), endFiles(deviceModules.end());
+        scanFiles != endFiles;
+        ++scanFiles)
+    {
+        std::string driverName;
+        if(manifest.getDriverName(*scanFiles, &driverName) && !driverName.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_lockLazyDrivers);
+            m_lazyDrivers.insert(std::make_pair(driverName, *scanFiles));
+            continue;
+        }
+
+        try
+        {
+            driverName = loadDriver(*scanFiles);
+        }
+        catch(const DriverDoesNotExportRegistrationFunctions& e)
+        {
+            std::cout << "Skipped library " << *scanFiles << " because it does not export the registration functions" << std::endl;
+            continue;
+        }
+        catch(const DriverNotFound& e)
+        {
+            std::cout << "Skipped library " << *scanFiles << " because it cannot be loaded" << std::endl;
+            continue;
+        }
+        manifest.setDriverName(*scanFiles, driverName);
+    }
+
+    if(!manifest.save())
+    {
+        std::cout << "Cannot write the modules manifest " << manifestFileName << std::endl;
+    }
+}
+
+std::string NdsFactoryImpl::loadDriver(const std::string& driverModuleName, const std::string& expectedDriverName)
 {
-    std::shared_ptr<DynamicModule> module(std::make_shared<DynamicModule>(driverModuleName));
+    std::shared_ptr<DynamicModule> module(std::make_shared<DynamicModule>(driverModuleName, true));
+    if(module->m_moduleHandle == 0)
+    {
+        std::ostringstream error;
+        error << "The module " << driverModuleName << " cannot be loaded";
+        throw DriverNotFound(error.str());
+    }
 
     typedef void* (*deviceAllocateFunction_t)(Factory& factory, const std::string& deviceName, const namedParameters_t& parameters) ;
     typedef void (*deviceDeallocateFunction_t)(void*) ;
@@ -118,16 +194,179 @@ void NdsFactoryImpl::loadDriver(const std::string& driverModuleName)
 
     if(allocateFunction == 0 || deallocateFunction == 0 || nameFunction == 0)
     {
+        // The module may have registered its drivers while loading:
+        //  keep it in memory
+        ////////////////////////////////////////////////////////////
+        module->keepLoaded();
+        {
+            std::lock_guard<std::mutex> lock(m_lockModules);
+            m_modules.push_back(module);
+        }
         std::ostringstream error;
         error << "The driver " << driverModuleName << " does not export the registration functions";
         throw DriverDoesNotExportRegistrationFunctions(error.str());
     }
 
-    registerDriver(nameFunction(),
+    const std::string driverName(nameFunction());
+    if(!expectedDriverName.empty() && driverName != expectedDriverName)
+    {
+        // Keep the module in memory for the same reason as above
+        /////////////////////////////////////////////////////////
+        module->keepLoaded();
+        {
+            std::lock_guard<std::mutex> lock(m_lockModules);
+            m_modules.push_back(module);
+        }
+        std::ostringstream error;
+        error << "The module " << driverModuleName << " exports the driver " << driverName << " instead of " << expectedDriverName;
+        throw DriverNotFound(error.str());
+    }
+
+    registerDriver(driverName,
                    std::bind(allocateFunction, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
                    std::bind(deallocateFunction, std::placeholders::_1)
                    );
-    m_modules.push_back(module);
+
+    std::lock_guard<std::mutex> lock(m_lockModules);
+
+    // A module replaced by another one exporting the same driver stays loaded
+    //////////////////////////////////////////////////////////////////////////
+    driverModules_t::iterator findModule(m_driverModules.find(driverName));
+    if(findModule != m_driverModules.end())
+    {
+        findModule->second->keepLoaded();
+        m_modules.push_back(findModule->second);
+    }
+    m_driverModules[driverName] = module;
+
+    return driverName;
+}
+
+void NdsFactoryImpl::reloadDriver(const std::string& driverName, const std::string& driverModuleName)
+{
+    std::lock_guard<std::mutex> lockReload(m_lockReload);
+
+    controlSystems_t controlSystems;
+    {
+        std::lock_guard<std::mutex> lock(m_lockControlSystems);
+        controlSystems = m_controlSystems;
+    }
+
+    // Destroy the devices allocated with the driver
+    ////////////////////////////////////////////////
+    destroyedDevices_t destroyedDevices;
+    for(controlSystems_t::const_iterator scanControlSystems(controlSystems.begin()), endControlSystems(controlSystems.end());
+        scanControlSystems != endControlSystems;
+        ++scanControlSystems)
+    {
+        destroyedDevices.push_back(std::make_pair(scanControlSystems->second, scanControlSystems->second->destroyDriverDevices(driverName)));
+    }
+
+    if(!driverModuleName.empty())
+    {
+        // Unload the old module, then load the new one. The old registration
+        //  and the name of the old module are kept for the rollback
+        //////////////////////////////////////////////////////////////////////
+        bool bOldRegistration(false);
+        std::pair<allocateDriver_t, deallocateDriver_t> oldRegistration;
+        {
+            std::lock_guard<std::mutex> lock(m_lockDrivers);
+            driverAllocDeallocMap_t::iterator findDriver(m_driversAllocDealloc.find(driverName));
+            if(findDriver != m_driversAllocDealloc.end())
+            {
+                bOldRegistration = true;
+                oldRegistration = findDriver->second;
+                m_driversAllocDealloc.erase(findDriver);
+            }
+        }
+        std::string oldModuleName;
+        {
+            std::shared_ptr<DynamicModule> oldModule;
+            {
+                std::lock_guard<std::mutex> lock(m_lockModules);
+                driverModules_t::iterator findModule(m_driverModules.find(driverName));
+                if(findModule != m_driverModules.end())
+                {
+                    oldModule = findModule->second;
+                    oldModuleName = oldModule->getLibraryName();
+                    m_driverModules.erase(findModule);
+                }
+            }
+        }
+
+        try
+        {
+            loadDriver(driverModuleName, driverName);
+        }
+        catch(...)
+        {
+            // Load the old module again, or restore the registration of a
+            //  driver that was not loaded from a module, then re-create the
+            //  devices. The load error is reported anyway
+            //////////////////////////////////////////////////////////////////
+            std::exception_ptr loadError(std::current_exception());
+            try
+            {
+                if(!oldModuleName.empty())
+                {
+                    loadDriver(oldModuleName, driverName);
+                }
+                else if(bOldRegistration)
+                {
+                    registerDriver(driverName, oldRegistration.first, oldRegistration.second);
+                }
+                createDriverDevices(driverName, destroyedDevices);
+            }
+            catch(...)
+            {
+            }
+            std::rethrow_exception(loadError);
+        }
+
+        // The driver is loaded: the manifest entry is obsolete
+        ///////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(m_lockLazyDrivers);
+        m_lazyDrivers.erase(driverName);
+    }
+
+    std::exception_ptr firstError(createDriverDevices(driverName, destroyedDevices));
+    if(firstError)
+    {
+        std::rethrow_exception(firstError);
+    }
+}
+
+/*
+ * Create again the devices destroyed by reloadDriver(). A device that
+ *  cannot be created does not prevent the creation of the other ones:
+ *  the first error is returned
+ *
+ **********************************************************************/
+std::exception_ptr NdsFactoryImpl::createDriverDevices(const std::string& driverName, const destroyedDevices_t& destroyedDevices)
+{
+    std::exception_ptr firstError;
+    for(destroyedDevices_t::const_iterator scanControlSystems(destroyedDevices.begin()), endControlSystems(destroyedDevices.end());
+        scanControlSystems != endControlSystems;
+        ++scanControlSystems)
+    {
+        for(FactoryBaseImpl::devicesParameters_t::const_iterator scanDevices(scanControlSystems->second.begin()), endDevices(scanControlSystems->second.end());
+            scanDevices != endDevices;
+            ++scanDevices)
+        {
+            try
+            {
+                scanControlSystems->first->createDevice(driverName, scanDevices->m_deviceName, scanDevices->m_parameters);
+            }
+            catch(...)
+            {
+                if(!firstError)
+                {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    }
+    return firstError;
 }
 
 void NdsFactoryImpl::registerDriver(const std::string &driverName, allocateDriver_t allocateFunction, deallocateDriver_t deallocateFunction)
@@ -157,6 +396,31 @@ std::pair<void*, deallocateDriver_t> NdsFactoryImpl::createDevice(FactoryBaseImp
     allocateDriver_t allocationFunction;
     deallocateDriver_t deallocationFunction;
 
+    // Load the module of a driver listed in the manifest the first time
+    //  a device is created with it
+    ////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lockLazy(m_lockLazyDrivers);
+
+        lazyDrivers_t::iterator findLazyDriver(m_lazyDrivers.find(driverName));
+        if(findLazyDriver != m_lazyDrivers.end())
+        {
+            bool bRegistered;
+            {
+                std::lock_guard<std::mutex> lock(m_lockDrivers);
+                bRegistered = m_driversAllocDealloc.find(driverName) != m_driversAllocDealloc.end();
+            }
+            if(!bRegistered)
+            {
+                // A module that fails to load stays listed: the next
+                //  createDevice() tries again
+                /////////////////////////////////////////////////////
+                loadDriver(findLazyDriver->second);
+            }
+            m_lazyDrivers.erase(findLazyDriver);
+        }
+    }
+
     {
         std::lock_guard<std::mutex> lock(m_lockDrivers);
 
@@ -179,72 +443,127 @@ std::pair<void*, deallocateDriver_t> NdsFactoryImpl::createDevice(FactoryBaseImp
 }
 
 
+NameTableImpl& NdsFactoryImpl::getNameTable()
+{
+    return m_nameTable;
+}
+
 void NdsFactoryImpl::registerInputPV(PVBaseInImpl *pSender)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    std::string fullName(pSender->getFullName());
-    if(m_registeredInputPVs.find(fullName) != m_registeredInputPVs.end())
+    const nameId_t fullNameId(pSender->getFullNameId());
+    if(m_registeredInputPVs.find(fullNameId) != m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
-        errorMessage << "The input PV with name " << fullName << " has already been registered";
+        errorMessage << "The input PV with name " << pSender->getFullName() << " has already been registered";
         throw PVAlreadyDeclared(errorMessage.str());
     }
-    if(m_registeredOutputPVs.find(fullName) != m_registeredOutputPVs.end())
+    if(m_registeredOutputPVs.find(fullNameId) != m_registeredOutputPVs.end())
     {
         std::ostringstream errorMessage;
-        errorMessage << "The input PV with name " << fullName << " has already been registered as an output PV";
+        errorMessage << "The input PV with name " << pSender->getFullName() << " has already been registered as an output PV";
         throw PVAlreadyDeclared(errorMessage.str());
     }
-    m_registeredInputPVs[fullName] = pSender;
+    m_registeredInputPVs[fullNameId] = pSender;
 }
 
 void NdsFactoryImpl::registerOutputPV(PVBaseOutImpl *pReceiver)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    std::string fullName(pReceiver->getFullName());
-    if(m_registeredOutputPVs.find(fullName) != m_registeredOutputPVs.end())
+    const nameId_t fullNameId(pReceiver->getFullNameId());
+    if(m_registeredOutputPVs.find(fullNameId) != m_registeredOutputPVs.end())
     {
         std::ostringstream errorMessage;
-        errorMessage << "The output PV with name " << fullName << " has already been registered";
+        errorMessage << "The output PV with name " << pReceiver->getFullName() << " has already been registered";
         throw PVAlreadyDeclared(errorMessage.str());
     }
-    if(m_registeredInputPVs.find(fullName) != m_registeredInputPVs.end())
+    if(m_registeredInputPVs.find(fullNameId) != m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
-        errorMessage << "The output PV with name " << fullName << " has already been registered as an input PV";
+        errorMessage << "The output PV with name " << pReceiver->getFullName() << " has already been registered as an input PV";
         throw PVAlreadyDeclared(errorMessage.str());
     }
-    m_registeredOutputPVs[fullName] = pReceiver;
+    m_registeredOutputPVs[fullNameId] = pReceiver;
 }
 
-void NdsFactoryImpl::deregisterInputPV(PVBaseInImpl *pSender)
+void NdsFactoryImpl::registerPVs(const inputPVsList_t& inputPVs, const outputPVsList_t& outputPVs)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    m_registeredInputPVs.erase(pSender->getFullName());
+    m_registeredInputPVs.reserve(m_registeredInputPVs.size() + inputPVs.size());
+    m_registeredOutputPVs.reserve(m_registeredOutputPVs.size() + outputPVs.size());
 
-    for(registeredInputPVs_t::iterator scanInputs(m_registeredInputPVs.begin()), endInputs(m_registeredInputPVs.end());
-        scanInputs != endInputs;
-        ++scanInputs)
+    inputPVsList_t::const_iterator scanInputs(inputPVs.begin());
+    outputPVsList_t::const_iterator scanOutputs(outputPVs.begin());
+    try
     {
-        scanInputs->second->stopReplicationTo(pSender);
+        for(; scanInputs != inputPVs.end(); ++scanInputs)
+        {
+            registerInputPV(*scanInputs);
+        }
+        for(; scanOutputs != outputPVs.end(); ++scanOutputs)
+        {
+            registerOutputPV(*scanOutputs);
+        }
+    }
+    catch(...)
+    {
+        // Remove the PVs registered before the failure
+        ///////////////////////////////////////////////
+        for(inputPVsList_t::const_iterator removeInputs(inputPVs.begin()); removeInputs != scanInputs; ++removeInputs)
+        {
+            m_registeredInputPVs.erase((*removeInputs)->getFullNameId());
+        }
+        for(outputPVsList_t::const_iterator removeOutputs(outputPVs.begin()); removeOutputs != scanOutputs; ++removeOutputs)
+        {
+            m_registeredOutputPVs.erase((*removeOutputs)->getFullNameId());
+        }
+        throw;
     }
 }
 
-void NdsFactoryImpl::deregisterOutputPV(PVBaseOutImpl *pReceiver)
+void NdsFactoryImpl::deregisterInputPV(PVBaseInImpl *pSender)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    m_registeredOutputPVs.erase(pReceiver->getFullName());
+    m_registeredInputPVs.erase(pSender->getFullNameId());
+
+    // Remove the links in which the PV is the source
+    /////////////////////////////////////////////////
+    subscriptionReceivers_t::iterator findReceivers(m_subscriptionReceivers.find(pSender));
+    if(findReceivers != m_subscriptionReceivers.end())
+    {
+        outputPVsSet_t receivers(findReceivers->second);
+        for(outputPVsSet_t::iterator scanReceivers(receivers.begin()), endReceivers(receivers.end()); scanReceivers != endReceivers; ++scanReceivers)
+        {
+            removeSubscription(pSender, *scanReceivers);
+        }
+    }
 
-    for(registeredInputPVs_t::iterator scanInputs(m_registeredInputPVs.begin()), endInputs(m_registeredInputPVs.end());
-        scanInputs != endInputs;
-        ++scanInputs)
+    replicationLinks_t::iterator findDestinations(m_replicationDestinations.find(pSender));
+    if(findDestinations != m_replicationDestinations.end())
     {
-        scanInputs->second->unsubscribeReceiver(pReceiver);
+        inputPVsSet_t destinations(findDestinations->second);
+        for(inputPVsSet_t::iterator scanDestinations(destinations.begin()), endDestinations(destinations.end()); scanDestinations != endDestinations; ++scanDestinations)
+        {
+            removeReplication(pSender, *scanDestinations);
+        }
     }
+
+    // Remove the links in which the PV is the destination
+    //////////////////////////////////////////////////////
+    stopReplicationTo(pSender);
+}
+
+void NdsFactoryImpl::deregisterOutputPV(PVBaseOutImpl *pReceiver)
+{
+    std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
+
+    m_registeredOutputPVs.erase(pReceiver->getFullNameId());
+
+    unsubscribe(pReceiver);
 }
 
 void NdsFactoryImpl::subscribe(const std::string &pushFrom, PVBaseOutImpl *pReceiver)
@@ -252,7 +571,7 @@ void NdsFactoryImpl::subscribe(const std::string &pushFrom, PVBaseOutImpl *pRece
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
     // Sanity check
-    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(pReceiver->getFullName());
+    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(pReceiver->getFullNameId());
     if(findOutput == m_registeredOutputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -266,7 +585,7 @@ void NdsFactoryImpl::subscribe(const std::string &pushFrom, PVBaseOutImpl *pRece
         throw std::logic_error(errorMessage.str());
     }
 
-    registeredInputPVs_t::iterator findInput = m_registeredInputPVs.find(pushFrom);
+    registeredInputPVs_t::iterator findInput = m_registeredInputPVs.find(m_nameTable.find(pushFrom));
     if(findInput == m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -275,13 +594,15 @@ void NdsFactoryImpl::subscribe(const std::string &pushFrom, PVBaseOutImpl *pRece
     }
 
     findInput->second->subscribeReceiver(pReceiver);
+    m_subscriptionReceivers[findInput->second].insert(pReceiver);
+    m_subscriptionSenders[pReceiver].insert(findInput->second);
 }
 
 void NdsFactoryImpl::subscribe(const std::string& pushFrom, const std::string& pushTo)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(pushTo);
+    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(m_nameTable.find(pushTo));
     if(findOutput == m_registeredOutputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -296,11 +617,16 @@ void NdsFactoryImpl::unsubscribe(PVBaseOutImpl *pReceiver)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    for(registeredInputPVs_t::iterator scanInputs(m_registeredInputPVs.begin()), endInputs(m_registeredInputPVs.end());
-        scanInputs != endInputs;
-        ++scanInputs)
+    subscriptionSenders_t::iterator findSenders(m_subscriptionSenders.find(pReceiver));
+    if(findSenders == m_subscriptionSenders.end())
+    {
+        return;
+    }
+
+    inputPVsSet_t senders(findSenders->second);
+    for(inputPVsSet_t::iterator scanSenders(senders.begin()), endSenders(senders.end()); scanSenders != endSenders; ++scanSenders)
     {
-        scanInputs->second->unsubscribeReceiver(pReceiver);
+        removeSubscription(*scanSenders, pReceiver);
     }
 }
 
@@ -308,7 +634,7 @@ void NdsFactoryImpl::unsubscribe(const std::string &pushTo)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(pushTo);
+    registeredOutputPVs_t::const_iterator findOutput = m_registeredOutputPVs.find(m_nameTable.find(pushTo));
     if(findOutput == m_registeredOutputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -322,7 +648,7 @@ void NdsFactoryImpl::replicate(const std::string &replicateSource, const std::st
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(replicateDestination);
+    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(m_nameTable.find(replicateDestination));
     if(findDestination == m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -337,7 +663,7 @@ void NdsFactoryImpl::replicate(const std::string &replicateSource, PVBaseInImpl
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
     // Sanity check
-    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(pDestination->getFullName());
+    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(pDestination->getFullNameId());
     if(findDestination == m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -351,7 +677,7 @@ void NdsFactoryImpl::replicate(const std::string &replicateSource, PVBaseInImpl
         throw std::logic_error(errorMessage.str());
     }
 
-    registeredInputPVs_t::iterator findInput = m_registeredInputPVs.find(replicateSource);
+    registeredInputPVs_t::iterator findInput = m_registeredInputPVs.find(m_nameTable.find(replicateSource));
     if(findInput == m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -360,17 +686,24 @@ void NdsFactoryImpl::replicate(const std::string &replicateSource, PVBaseInImpl
     }
 
     findInput->second->replicateTo(pDestination);
+    m_replicationDestinations[findInput->second].insert(pDestination);
+    m_replicationSources[pDestination].insert(findInput->second);
 }
 
 void NdsFactoryImpl::stopReplicationTo(PVBaseInImpl *pDestination)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    for(registeredInputPVs_t::iterator scanInputs(m_registeredInputPVs.begin()), endInputs(m_registeredInputPVs.end());
-        scanInputs != endInputs;
-        ++scanInputs)
+    replicationLinks_t::iterator findSources(m_replicationSources.find(pDestination));
+    if(findSources == m_replicationSources.end())
+    {
+        return;
+    }
+
+    inputPVsSet_t sources(findSources->second);
+    for(inputPVsSet_t::iterator scanSources(sources.begin()), endSources(sources.end()); scanSources != endSources; ++scanSources)
     {
-        scanInputs->second->stopReplicationTo(pDestination);
+        removeReplication(*scanSources, pDestination);
     }
 }
 
@@ -378,7 +711,7 @@ void NdsFactoryImpl::stopReplicationTo(const std::string &replicateDestination)
 {
     std::lock_guard<std::recursive_mutex> lockRegisteredPVs(m_lockRegisteredPVs);
 
-    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(replicateDestination);
+    registeredInputPVs_t::const_iterator findDestination = m_registeredInputPVs.find(m_nameTable.find(replicateDestination));
     if(findDestination == m_registeredInputPVs.end())
     {
         std::ostringstream errorMessage;
@@ -390,6 +723,67 @@ void NdsFactoryImpl::stopReplicationTo(const std::string &replicateDestination)
 }
 
 
+/*
+ * Remove a subscription from the input PV and from both the indexes.
+ * Called with m_lockRegisteredPVs held.
+ *
+ *******************************************************************/
+void NdsFactoryImpl::removeSubscription(PVBaseInImpl* pSender, PVBaseOutImpl* pReceiver)
+{
+    pSender->unsubscribeReceiver(pReceiver);
+
+    subscriptionReceivers_t::iterator findReceivers(m_subscriptionReceivers.find(pSender));
+    if(findReceivers != m_subscriptionReceivers.end())
+    {
+        findReceivers->second.erase(pReceiver);
+        if(findReceivers->second.empty())
+        {
+            m_subscriptionReceivers.erase(findReceivers);
+        }
+    }
+
+    subscriptionSenders_t::iterator findSenders(m_subscriptionSenders.find(pReceiver));
+    if(findSenders != m_subscriptionSenders.end())
+    {
+        findSenders->second.erase(pSender);
+        if(findSenders->second.empty())
+        {
+            m_subscriptionSenders.erase(findSenders);
+        }
+    }
+}
+
+/*
+ * Remove a replication from the source PV and from both the indexes.
+ * Called with m_lockRegisteredPVs held.
+ *
+ ********************************************************************/
+void NdsFactoryImpl::removeReplication(PVBaseInImpl* pSource, PVBaseInImpl* pDestination)
+{
+    pSource->stopReplicationTo(pDestination);
+
+    replicationLinks_t::iterator findDestinations(m_replicationDestinations.find(pSource));
+    if(findDestinations != m_replicationDestinations.end())
+    {
+        findDestinations->second.erase(pDestination);
+        if(findDestinations->second.empty())
+        {
+            m_replicationDestinations.erase(findDestinations);
+        }
+    }
+
+    replicationLinks_t::iterator findSources(m_replicationSources.find(pDestination));
+    if(findSources != m_replicationSources.end())
+    {
+        findSources->second.erase(pSource);
+        if(findSources->second.empty())
+        {
+            m_replicationSources.erase(findSources);
+        }
+    }
+}
+
+
 std::shared_ptr<FactoryBaseImpl> NdsFactoryImpl::getControlSystem(const std::string& controlSystem)
 {
     if(controlSystem.empty())
@@ -495,8 +889,10 @@ NdsFactoryImpl::fileNames_t NdsFactoryImpl::separateFoldersList(const char* fold
 }
 
 
-DynamicModule::DynamicModule(const std::string& libraryName):
-    m_moduleHandle(dlopen(libraryName.c_str(), RTLD_NOW | RTLD_GLOBAL | RTLD_NODELETE))
+DynamicModule::DynamicModule(const std::string& libraryName, const bool bUnloadable):
+    m_moduleHandle(dlopen(libraryName.c_str(), RTLD_NOW | RTLD_GLOBAL | (bUnloadable ? 0 : RTLD_NODELETE))),
+    m_libraryName(libraryName),
+    m_bUnload(bUnloadable)
 {
     if (!m_moduleHandle)
             fprintf(stderr, "%s\n", dlerror());
@@ -504,12 +900,22 @@ DynamicModule::DynamicModule(const std::string& libraryName):
 
 DynamicModule::~DynamicModule()
 {
-    if(m_moduleHandle != 0)
+    if(m_moduleHandle != 0 && m_bUnload)
     {
         dlclose(m_moduleHandle);
     }
 }
 
+const std::string& DynamicModule::getLibraryName() const
+{
+    return m_libraryName;
+}
+
+void DynamicModule::keepLoaded()
+{
+    m_bUnload = false;
+}
+
 void* DynamicModule::getAddress(const std::string &functionName)
 {
     return dlsym(m_moduleHandle, functionName.c_str());
@@ -7,22 +7,82 @@
  * file included in the distribution.
  */
 
+#include <algorithm>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "nds3/definitions.h"
 #include "nds3/impl/nodeImpl.h"
 #include "nds3/impl/stateMachineImpl.h"
 #include "nds3/impl/factoryBaseImpl.h"
+#include "nds3/impl/threadBaseImpl.h"
 
 namespace nds
 {
 
 static std::mutex m_initializationMutex;
 
-NodeImpl::NodeImpl(const std::string &name, const nodeType_t nodeType): BaseImpl(name), m_nodeType(nodeType)
-{}
+/*
+ * Minimum number of children prepared by each thread during
+ *  the parallel initialization
+ *
+ ***********************************************************/
+static const size_t m_minChildrenPerThread(16);
+
+/*
+ * Return true if the first state has a higher priority than the second
+ *  one, or if the states are equal and the first one is more recent
+ *
+ **********************************************************************/
+static bool isHigherState(const state_t state0, const timespec& timestamp0, const state_t state1, const timespec& timestamp1)
+{
+    return ((int)state1 < (int)state0) ||
+            ((int)state1 == (int)state0 &&
+             (timestamp1.tv_sec < timestamp0.tv_sec ||
+              (timestamp1.tv_sec == timestamp0.tv_sec && timestamp1.tv_nsec < timestamp0.tv_nsec)));
+}
+
+/*
+ * Prepare a range of children, storing the exception thrown by
+ *  the preparation so it can be rethrown by the calling thread
+ *
+ ***************************************************************/
+typedef std::vector<std::shared_ptr<BaseImpl> > childrenList_t;
+
+static void prepareChildren(FactoryBaseImpl* pControlSystem, const childrenList_t* pChildren,
+                            const size_t firstChild, const size_t lastChild, const size_t numThreads,
+                            std::exception_ptr* pException)
+{
+    try
+    {
+        for(size_t scanChildren(firstChild); scanChildren != lastChild; ++scanChildren)
+        {
+            (*pChildren)[scanChildren]->prepareInitialization(*pControlSystem, numThreads);
+        }
+    }
+    catch(...)
+    {
+        *pException = std::current_exception();
+    }
+}
+
+NodeImpl::NodeImpl(const std::string &name, const nodeType_t nodeType): BaseImpl(name), m_nodeType(nodeType),
+    m_globalState(state_t::unknown), m_bStateAggregated(false), m_pushedGlobalState(state_t::unknown)
+{
+    m_globalStateTimestamp.tv_sec = 0;
+    m_globalStateTimestamp.tv_nsec = 0;
+    m_pushedGlobalStateTimestamp.tv_sec = 0;
+    m_pushedGlobalStateTimestamp.tv_nsec = 0;
+
+    // Register the commands for the statistics of the subtree
+    //////////////////////////////////////////////////////////
+    defineCommand("enableStats", "", 0, std::bind(&NodeImpl::commandSetStatisticsEnabled, this, true, std::placeholders::_1));
+    defineCommand("disableStats", "", 0, std::bind(&NodeImpl::commandSetStatisticsEnabled, this, false, std::placeholders::_1));
+    defineCommand("stats", "", 0, std::bind(&NodeImpl::commandGetStatistics, this, std::placeholders::_1));
+}
 
 void NodeImpl::addChild(std::shared_ptr<BaseImpl> pChild)
 {
@@ -59,6 +119,12 @@ void NodeImpl::initializeRootNode(void *pDeviceObject, FactoryBaseImpl &controlS
         throw std::logic_error("You can initialize only the root nodes");
     }
 
+    // The names are built outside the lock, so several root nodes
+    //  can be prepared at the same time. Only the registration with
+    //  the control system is serialized
+    ////////////////////////////////////////////////////////////////
+    prepareInitialization(controlSystem, controlSystem.getInitializationThreads());
+
     std::lock_guard<std::mutex> serializeInitialization(m_initializationMutex);
 
     initialize(controlSystem);
@@ -66,18 +132,87 @@ void NodeImpl::initializeRootNode(void *pDeviceObject, FactoryBaseImpl &controlS
     controlSystem.holdNode(pDeviceObject, std::static_pointer_cast<NodeImpl>(shared_from_this()) );
 }
 
-void NodeImpl::initialize(FactoryBaseImpl& controlSystem)
+/*
+ * Prepare the node, then the children. When more threads are
+ *  allowed and there are enough children then the children are
+ *  split between the calling thread and the factory's thread pool
+ *
+ ****************************************************************/
+void NodeImpl::prepareInitialization(FactoryBaseImpl& controlSystem, const size_t numThreads)
 {
-    BaseImpl::initialize(controlSystem);
+    BaseImpl::prepareInitialization(controlSystem, numThreads);
 
+    childrenList_t children;
+    children.reserve(m_children.size());
     for(tChildren::iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
     {
         scanChildren->second->setParent(std::static_pointer_cast<NodeImpl>(shared_from_this()), m_nodeLevel);
+        children.push_back(scanChildren->second);
+    }
+
+    const size_t numChunks(std::min(numThreads, children.size() / m_minChildrenPerThread));
+    if(numChunks <= 1)
+    {
+        for(childrenList_t::iterator scanChildren(children.begin()), endScan(children.end()); scanChildren != endScan; ++scanChildren)
+        {
+            (*scanChildren)->prepareInitialization(controlSystem, numThreads);
+        }
+        return;
     }
+
+    // The subtrees prepared by the pool are not split again
+    ////////////////////////////////////////////////////////
+    std::vector<std::exception_ptr> exceptions(numChunks);
+    std::vector<std::unique_ptr<ThreadBaseImpl> > threads;
+    threads.reserve(numChunks - 1);
+
+    const size_t chunkSize((children.size() + numChunks - 1) / numChunks);
+    try
+    {
+        for(size_t scanChunks(1); scanChunks != numChunks; ++scanChunks)
+        {
+            const size_t firstChild(std::min(scanChunks * chunkSize, children.size()));
+            const size_t lastChild(std::min(firstChild + chunkSize, children.size()));
+            threads.push_back(std::unique_ptr<ThreadBaseImpl>(
+                                  controlSystem.runInThread("nds-init",
+                                                            taskClass_t::housekeeping,
+                                                            std::bind(&prepareChildren, &controlSystem, &children, firstChild, lastChild, 1, &(exceptions[scanChunks])))));
+        }
+    }
+    catch(...)
+    {
+        exceptions[0] = std::current_exception();
+    }
+
+    if(!exceptions[0])
+    {
+        prepareChildren(&controlSystem, &children, 0, std::min(chunkSize, children.size()), 1, &(exceptions[0]));
+    }
+
+    for(std::vector<std::unique_ptr<ThreadBaseImpl> >::iterator scanThreads(threads.begin()), endThreads(threads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        (*scanThreads)->join();
+    }
+
+    for(std::vector<std::exception_ptr>::const_iterator scanExceptions(exceptions.begin()), endExceptions(exceptions.end()); scanExceptions != endExceptions; ++scanExceptions)
+    {
+        if(*scanExceptions)
+        {
+            std::rethrow_exception(*scanExceptions);
+        }
+    }
+}
+
+void NodeImpl::initialize(FactoryBaseImpl& controlSystem)
+{
+    BaseImpl::initialize(controlSystem);
+
     for(tChildren::iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
     {
         scanChildren->second->initialize(controlSystem);
     }
+
+    aggregateState();
 }
 
 void NodeImpl::deinitializeRootNode()
@@ -93,6 +228,11 @@ void NodeImpl::deinitializeRootNode()
 
 void NodeImpl::deinitialize()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_lockState);
+        m_bStateAggregated = false;
+    }
+
     BaseImpl::deinitialize();
     for(tChildren::iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
     {
@@ -111,12 +251,30 @@ state_t NodeImpl::getLocalState() const
 
 void NodeImpl::getGlobalState(timespec* pTimestamp, state_t* pState) const
 {
-    if(m_pStateMachine.get() == 0)
     {
-        getChildrenState(pTimestamp, pState);
-        return;
+        std::lock_guard<std::mutex> lock(m_lockState);
+        if(m_bStateAggregated)
+        {
+            *pTimestamp = m_globalStateTimestamp;
+            *pState = m_globalState;
+            return;
+        }
+    }
+
+    // Not initialized: scan the children
+    /////////////////////////////////////
+    getChildrenState(pTimestamp, pState);
+    if(m_pStateMachine.get() != 0)
+    {
+        timespec localTimestamp;
+        state_t localState;
+        m_pStateMachine->getLocalState(&localTimestamp, &localState);
+        if(isHigherState(localState, localTimestamp, *pState, *pTimestamp))
+        {
+            *pTimestamp = localTimestamp;
+            *pState = localState;
+        }
     }
-    m_pStateMachine->getGlobalState(pTimestamp, pState);
 }
 
 void NodeImpl::getChildrenState(timespec* pTimestamp, state_t* pState) const
@@ -133,11 +291,7 @@ void NodeImpl::getChildrenState(timespec* pTimestamp, state_t* pState) const
                 state_t childState;
                 child->getGlobalState(&childTimestamp, &childState);
 
-                if(
-                        ((int)*pState < (int)childState) ||
-                        ((int)*pState == (int)childState &&
-                         (pTimestamp->tv_sec < childTimestamp.tv_sec ||
-                          (pTimestamp->tv_sec == childTimestamp.tv_sec && pTimestamp->tv_nsec < childTimestamp.tv_nsec))))
+                if(isHigherState(childState, childTimestamp, *pState, *pTimestamp))
                 {
                     *pTimestamp = childTimestamp;
                     *pState = childState;
@@ -147,6 +301,181 @@ void NodeImpl::getChildrenState(timespec* pTimestamp, state_t* pState) const
     }
 }
 
+/*
+ * Collect the states of the state machine and of the children.
+ *
+ * The flag is set before the contributors are read, so no change is lost:
+ *  a change notified while the children are read is recorded first and is
+ *  not overwritten by the older value read here. The children are read
+ *  without holding the node's lock, because the state machine notifies
+ *  its changes while holding its own lock
+ *
+ ****************************************************************************/
+void NodeImpl::aggregateState()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lockState);
+        m_contributors.clear();
+        for(size_t scanStates(0); scanStates != (size_t)state_t::MAX_STATE_NUM; ++scanStates)
+        {
+            m_stateTimestamps[scanStates].clear();
+        }
+        m_bStateAggregated = true;
+    }
+
+    for(tChildren::const_iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
+    {
+        timespec contributorTimestamp;
+        state_t contributorState;
+        if(scanChildren->second.get() == m_pStateMachine.get())
+        {
+            m_pStateMachine->getLocalState(&contributorTimestamp, &contributorState);
+        }
+        else
+        {
+            std::shared_ptr<NodeImpl> child = std::dynamic_pointer_cast<NodeImpl>(scanChildren->second);
+            if(child.get() == 0)
+            {
+                continue;
+            }
+            child->getGlobalState(&contributorTimestamp, &contributorState);
+        }
+
+        std::lock_guard<std::mutex> lock(m_lockState);
+        if(m_contributors.find(scanChildren->second.get()) == m_contributors.end())
+        {
+            setContributorState(scanChildren->second.get(), contributorState, contributorTimestamp);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_lockState);
+    computeGlobalState();
+    m_pushedGlobalState = m_globalState;
+    m_pushedGlobalStateTimestamp = m_globalStateTimestamp;
+}
+
+void NodeImpl::updateContributorState(const BaseImpl* pContributor, const state_t newState, const timespec& timestamp)
+{
+    std::vector<std::shared_ptr<NodeImpl> > changedNodes;
+    propagateContributorState(pContributor, newState, timestamp, &changedNodes);
+
+    for(std::vector<std::shared_ptr<NodeImpl> >::const_iterator scanNodes(changedNodes.begin()), endNodes(changedNodes.end()); scanNodes != endNodes; ++scanNodes)
+    {
+        (*scanNodes)->pushGlobalStateChange();
+    }
+}
+
+/*
+ * Update the contributor's state, then notify the parent if the global
+ *  state changed. m_lockStateUpdates is held while the parent is notified,
+ *  so the parent receives the changes in the same order as the node
+ *
+ **************************************************************************/
+void NodeImpl::propagateContributorState(const BaseImpl* pContributor, const state_t newState, const timespec& timestamp,
+                                         std::vector<std::shared_ptr<NodeImpl> >* pChangedNodes)
+{
+    std::lock_guard<std::mutex> lockUpdates(m_lockStateUpdates);
+
+    state_t globalState;
+    timespec globalStateTimestamp;
+    {
+        std::lock_guard<std::mutex> lock(m_lockState);
+        if(!m_bStateAggregated)
+        {
+            return;
+        }
+
+        setContributorState(pContributor, newState, timestamp);
+
+        const state_t previousGlobalState(m_globalState);
+        const timespec previousGlobalTimestamp(m_globalStateTimestamp);
+        computeGlobalState();
+        if(m_globalState == previousGlobalState &&
+           m_globalStateTimestamp.tv_sec == previousGlobalTimestamp.tv_sec &&
+           m_globalStateTimestamp.tv_nsec == previousGlobalTimestamp.tv_nsec)
+        {
+            return;
+        }
+        globalState = m_globalState;
+        globalStateTimestamp = m_globalStateTimestamp;
+    }
+
+    pChangedNodes->push_back(std::static_pointer_cast<NodeImpl>(shared_from_this()));
+
+    std::shared_ptr<NodeImpl> pParent(getParent());
+    if(pParent.get() != 0)
+    {
+        pParent->propagateContributorState(this, globalState, globalStateTimestamp, pChangedNodes);
+    }
+}
+
+void NodeImpl::setContributorState(const BaseImpl* pContributor, const state_t state, const timespec& timestamp)
+{
+    std::pair<contributors_t::iterator, bool> insertContributor(m_contributors.insert(std::make_pair(pContributor, contributorState_t())));
+    contributorState_t& contributorState(insertContributor.first->second);
+    if(!insertContributor.second)
+    {
+        timestamps_t& previousTimestamps(m_stateTimestamps[(size_t)contributorState.m_state]);
+        previousTimestamps.erase(previousTimestamps.find(contributorState.m_timestamp));
+    }
+    contributorState.m_state = state;
+    contributorState.m_timestamp = timestamp;
+    m_stateTimestamps[(size_t)state].insert(timestamp);
+}
+
+/*
+ * The global state is the highest state of the contributors, with the
+ *  timestamp of the most recent contributor in that state
+ *
+ **********************************************************************/
+void NodeImpl::computeGlobalState()
+{
+    m_globalState = state_t::unknown;
+    m_globalStateTimestamp.tv_sec = 0;
+    m_globalStateTimestamp.tv_nsec = 0;
+    for(size_t scanStates((size_t)state_t::MAX_STATE_NUM); scanStates != 0; --scanStates)
+    {
+        if(!m_stateTimestamps[scanStates - 1].empty())
+        {
+            m_globalState = (state_t)(scanStates - 1);
+            m_globalStateTimestamp = *(m_stateTimestamps[scanStates - 1].rbegin());
+            return;
+        }
+    }
+}
+
+/*
+ * Push the current global state. The lock makes sure that the last pushed
+ *  value is the most recent one
+ *
+ *************************************************************************/
+void NodeImpl::pushGlobalStateChange()
+{
+    if(m_pStateMachine.get() == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> lockPush(m_lockStatePush);
+
+    state_t globalState;
+    timespec globalStateTimestamp;
+    {
+        std::lock_guard<std::mutex> lock(m_lockState);
+        if(!m_bStateAggregated ||
+           (m_globalState == m_pushedGlobalState &&
+            m_globalStateTimestamp.tv_sec == m_pushedGlobalStateTimestamp.tv_sec &&
+            m_globalStateTimestamp.tv_nsec == m_pushedGlobalStateTimestamp.tv_nsec))
+        {
+            return;
+        }
+        globalState = m_pushedGlobalState = m_globalState;
+        globalStateTimestamp = m_pushedGlobalStateTimestamp = m_globalStateTimestamp;
+    }
+
+    m_pStateMachine->pushGlobalState(globalStateTimestamp, globalState);
+}
+
 void NodeImpl::setLogLevel(const logLevel_t logLevel)
 {
     BaseImpl::setLogLevel(logLevel);
@@ -158,6 +487,35 @@ void NodeImpl::setLogLevel(const logLevel_t logLevel)
 
 }
 
+void NodeImpl::setStatisticsEnabled(const bool bEnabled)
+{
+    for(tChildren::const_iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
+    {
+        scanChildren->second->setStatisticsEnabled(bEnabled);
+    }
+}
+
+void NodeImpl::collectStatistics(parameters_t* pStatistics)
+{
+    for(tChildren::const_iterator scanChildren(m_children.begin()), endScan(m_children.end()); scanChildren != endScan; ++scanChildren)
+    {
+        scanChildren->second->collectStatistics(pStatistics);
+    }
+}
+
+parameters_t NodeImpl::commandSetStatisticsEnabled(const bool bEnabled, const parameters_t &)
+{
+    setStatisticsEnabled(bEnabled);
+    return parameters_t();
+}
+
+parameters_t NodeImpl::commandGetStatistics(const parameters_t &)
+{
+    parameters_t statistics;
+    collectStatistics(&statistics);
+    return statistics;
+}
+
 std::string NodeImpl::buildFullExternalName(const FactoryBaseImpl& controlSystem) const
 {
     return buildFullExternalName(controlSystem, false);
@@ -203,19 +561,19 @@ std::string NodeImpl::buildFullExternalName(const FactoryBaseImpl& controlSystem
     {
         if(bStopAtPort)
         {
-            return temporaryPointer->buildFullExternalNameFromPort(controlSystem);
+            return temporaryPointer->getFullExternalNameFromPort();
         }
         else
         {
-            return temporaryPointer->buildFullExternalName(controlSystem);
+            return temporaryPointer->getFullExternalName();
         }
     }
 
     if(bStopAtPort)
     {
-        return temporaryPointer->buildFullExternalNameFromPort(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+        return temporaryPointer->getFullExternalNameFromPort() + controlSystem.getSeparator(m_nodeLevel) + name;
     }
-    return temporaryPointer->buildFullExternalName(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+    return temporaryPointer->getFullExternalName() + controlSystem.getSeparator(m_nodeLevel) + name;
 }
 
 
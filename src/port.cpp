@@ -24,4 +24,14 @@ Port::Port(const std::string &name, const nodeType_t nodeType):
 {
 }
 
+void Port::setAsyncDelivery(const size_t queueSize, const overflowPolicy_t overflowPolicy)
+{
+    std::static_pointer_cast<PortImpl>(m_pImplementation)->setAsyncDelivery(queueSize, overflowPolicy);
+}
+
+void Port::flushAsyncDelivery()
+{
+    std::static_pointer_cast<PortImpl>(m_pImplementation)->flushAsyncDelivery();
+}
+
 }
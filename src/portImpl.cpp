@@ -7,21 +7,38 @@
  * file included in the distribution.
  */
 
+#include <chrono>
+#include <thread>
+
 #include "nds3/impl/portImpl.h"
-#include "nds3/impl/pvBaseImpl.h"
+#include "nds3/impl/pvBaseInImpl.h"
+#include "nds3/impl/pvBaseOutImpl.h"
+#include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/factoryBaseImpl.h"
 #include "nds3/impl/interfaceBaseImpl.h"
+#include "nds3/impl/publishQueueImpl.h"
+#include "nds3/impl/threadBaseImpl.h"
 
 namespace nds
 {
 
 
-PortImpl::PortImpl(const std::string& name, const nodeType_t nodeType): NodeImpl(name, nodeType)
+/*
+ * Maximum number of values passed by the dispatcher from a PV
+ *  before it moves to the next PV's queue
+ *
+ **************************************************************/
+static const size_t m_maxDispatchBatch(64);
+
+PortImpl::PortImpl(const std::string& name, const nodeType_t nodeType): NodeImpl(name, nodeType),
+    m_publishQueueSize(0), m_overflowPolicy(overflowPolicy_t::dropOldest),
+    m_bDispatcherRunning(false), m_bDispatcherWaiting(false)
 {
 }
 
 PortImpl::~PortImpl()
 {
+    stopDispatcher();
 }
 
 
@@ -45,11 +62,27 @@ void PortImpl::initialize(FactoryBaseImpl& controlSystem)
 {
     if(m_pInterface.get() == 0)
     {
-        m_pInterface.reset(controlSystem.getNewInterface(buildFullName(controlSystem)));
+        m_pInterface.reset(controlSystem.getNewInterface(getFullName()));
+    }
+    try
+    {
+        NodeImpl::initialize(controlSystem);
     }
-    NodeImpl::initialize(controlSystem);
+    catch(...)
+    {
+        // Forget the PVs collected by the nodes initialized before the
+        //  failure: a later initialization registers them again
+        ////////////////////////////////////////////////////////////////
+        m_pendingPVs.clear();
+        m_afterRegistration.clear();
+        throw;
+    }
+
+    registerPendingPVs();
 
     m_pInterface->registrationTerminated();
+
+    startDispatcher();
 }
 
 void PortImpl::deinitialize()
@@ -58,30 +91,258 @@ void PortImpl::deinitialize()
     {
         throw std::logic_error("deinitialize called on non initialized port");
     }
+
+    // Deliver the queued values before the PVs are deregistered
+    /////////////////////////////////////////////////////////////
+    stopDispatcher();
+
     NodeImpl::deinitialize();
+
+    deregisterPendingPVs();
 }
 
 void PortImpl::registerPV(std::shared_ptr<PVBaseImpl> pv)
 {
-    m_pInterface->registerPV(pv);
+    m_pendingPVs.push_back(pv);
+}
+
+void PortImpl::runAfterRegistration(std::function<void()> function)
+{
+    m_afterRegistration.push_back(function);
+}
+
+/*
+ * Register the PVs collected during the initialization
+ *
+ ******************************************************/
+void PortImpl::registerPendingPVs()
+{
+    InterfaceBaseImpl::pvsList_t pendingPVs;
+    pendingPVs.swap(m_pendingPVs);
+    functionsList_t afterRegistration;
+    afterRegistration.swap(m_afterRegistration);
+
+    // Register with NDS: if a name is already in use then
+    //  none of the PVs is registered
+    //////////////////////////////////////////////////////
+    NdsFactoryImpl::inputPVsList_t inputPVs;
+    NdsFactoryImpl::outputPVsList_t outputPVs;
+    inputPVs.reserve(pendingPVs.size());
+    outputPVs.reserve(pendingPVs.size());
+    for(InterfaceBaseImpl::pvsList_t::const_iterator scanPVs(pendingPVs.begin()), endPVs(pendingPVs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        if((*scanPVs)->getDataDirection() == dataDirection_t::input)
+        {
+            inputPVs.push_back(static_cast<PVBaseInImpl*>(scanPVs->get()));
+        }
+        else
+        {
+            outputPVs.push_back(static_cast<PVBaseOutImpl*>(scanPVs->get()));
+        }
+    }
+    NdsFactoryImpl::getInstance().registerPVs(inputPVs, outputPVs);
+
+    m_pInterface->registerPVs(pendingPVs);
+
+    // Allocate the publish queues for the input PVs
+    /////////////////////////////////////////////////
+    if(m_publishQueueSize != 0)
+    {
+        m_publishQueues.reserve(m_publishQueues.size() + inputPVs.size());
+        for(NdsFactoryImpl::inputPVsList_t::const_iterator scanPVs(inputPVs.begin()), endPVs(inputPVs.end()); scanPVs != endPVs; ++scanPVs)
+        {
+            std::shared_ptr<PublishQueueBase> pQueue(PublishQueueBase::create(**scanPVs, *this, m_publishQueueSize, m_overflowPolicy));
+            m_publishQueues.push_back(pQueue);
+            (*scanPVs)->setPublishQueue(pQueue.get());
+        }
+    }
+
+    for(functionsList_t::iterator scanFunctions(afterRegistration.begin()), endFunctions(afterRegistration.end()); scanFunctions != endFunctions; ++scanFunctions)
+    {
+        (*scanFunctions)();
+    }
 }
 
 void PortImpl::deregisterPV(std::shared_ptr<PVBaseImpl> pv)
 {
-    m_pInterface->deregisterPV(pv);
+    m_pendingPVs.push_back(pv);
+}
+
+/*
+ * Deregister the PVs collected during the deinitialization
+ *
+ **********************************************************/
+void PortImpl::deregisterPendingPVs()
+{
+    InterfaceBaseImpl::pvsList_t pendingPVs;
+    pendingPVs.swap(m_pendingPVs);
+
+    // Release the publish queues. The dispatcher has already stopped
+    //  and delivered the queued values
+    //////////////////////////////////////////////////////////////////
+    for(InterfaceBaseImpl::pvsList_t::const_iterator scanPVs(pendingPVs.begin()), endPVs(pendingPVs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        if((*scanPVs)->getDataDirection() != dataDirection_t::input)
+        {
+            continue;
+        }
+        PVBaseInImpl* pInputPV(static_cast<PVBaseInImpl*>(scanPVs->get()));
+        PublishQueueBase* pQueue(pInputPV->getPublishQueue());
+        if(pQueue != 0)
+        {
+            pInputPV->setPublishQueue(0);
+            for(publishQueues_t::iterator scanQueues(m_publishQueues.begin()); scanQueues != m_publishQueues.end(); ++scanQueues)
+            {
+                if(scanQueues->get() == pQueue)
+                {
+                    m_publishQueues.erase(scanQueues);
+                    break;
+                }
+            }
+        }
+    }
+
+    m_pInterface->deregisterPVs(pendingPVs);
+}
+
+InterfaceBaseImpl& PortImpl::getInterface()
+{
+    if(m_pInterface.get() == 0)
+    {
+        throw std::logic_error("The port has not been initialized");
+    }
+    return *m_pInterface;
+}
+
+void PortImpl::setAsyncDelivery(const size_t queueSize, const overflowPolicy_t overflowPolicy)
+{
+    if(m_pInterface.get() != 0)
+    {
+        throw std::logic_error("The asynchronous delivery must be configured before the port is initialized");
+    }
+    m_publishQueueSize = queueSize;
+    m_overflowPolicy = overflowPolicy;
+}
+
+void PortImpl::flushAsyncDelivery()
+{
+    if(!m_bDispatcherRunning.load())
+    {
+        return;
+    }
+
+    for(publishQueues_t::const_iterator scanQueues(m_publishQueues.begin()), endQueues(m_publishQueues.end()); scanQueues != endQueues; ++scanQueues)
+    {
+        while(!(*scanQueues)->isIdle())
+        {
+            notifyDispatcher();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void PortImpl::notifyDispatcher()
+{
+    // Pairs with the fence in dispatchQueuedValues(): either the dispatcher sees
+    //  the queued value or we see that it is waiting
+    /////////////////////////////////////////////////////////////////////////////
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_bDispatcherWaiting.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(m_lockDispatcher);
+        m_dispatcherCondition.notify_one();
+    }
+}
+
+bool PortImpl::isDispatcherRunning() const
+{
+    return m_bDispatcherRunning.load();
+}
+
+void PortImpl::startDispatcher()
+{
+    if(m_publishQueues.empty() || m_bDispatcherRunning.load())
+    {
+        return;
+    }
+    m_bDispatcherRunning.store(true);
+    m_pDispatcherThread.reset(runInThread(getFullName() + "-publish", taskClass_t::acquisition, std::bind(&PortImpl::dispatchQueuedValues, this)));
+}
+
+void PortImpl::stopDispatcher()
+{
+    if(!m_bDispatcherRunning.load())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lockDispatcher);
+        m_bDispatcherRunning.store(false);
+        m_dispatcherCondition.notify_one();
+    }
+    m_pDispatcherThread->join();
+    m_pDispatcherThread.reset();
 }
 
-template<typename T>
-void PortImpl::push(std::shared_ptr<PVBaseImpl> pv, const timespec& timestamp, const T& value)
+bool PortImpl::dispatcherHasWork() const
 {
-    m_pInterface->push(*(pv.get()), timestamp, value);
+    for(publishQueues_t::const_iterator scanQueues(m_publishQueues.begin()), endQueues(m_publishQueues.end()); scanQueues != endQueues; ++scanQueues)
+    {
+        if(!(*scanQueues)->isIdle())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Dispatcher thread: pass the queued values to the control system
+ *
+ ******************************************************************/
+void PortImpl::dispatchQueuedValues()
+{
+    for(;;)
+    {
+        // Read the flag before draining, so the values queued before
+        //  stopDispatcher() are always delivered
+        //////////////////////////////////////////////////////////////
+        const bool bRunning(m_bDispatcherRunning.load());
+
+        size_t dispatched(0);
+        for(publishQueues_t::iterator scanQueues(m_publishQueues.begin()), endQueues(m_publishQueues.end()); scanQueues != endQueues; ++scanQueues)
+        {
+            try
+            {
+                dispatched += (*scanQueues)->dispatch(*m_pInterface, m_maxDispatchBatch);
+            }
+            catch(const std::exception& e)
+            {
+                ndsErrorStream(*this) << "Error while passing a queued value to the control system: " << e.what() << std::endl;
+            }
+        }
+
+        if(dispatched != 0)
+        {
+            continue;
+        }
+        if(!bRunning)
+        {
+            return;
+        }
+
+        // Nothing to do: wait for the producers
+        ////////////////////////////////////////
+        std::unique_lock<std::mutex> lock(m_lockDispatcher);
+        m_bDispatcherWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_bDispatcherRunning.load() && !dispatcherHasWork())
+        {
+            m_dispatcherCondition.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        m_bDispatcherWaiting.store(false, std::memory_order_relaxed);
+    }
 }
 
-template void PortImpl::push<std::int32_t>(std::shared_ptr<PVBaseImpl>, const timespec&, const std::int32_t&);
-template void PortImpl::push<double>(std::shared_ptr<PVBaseImpl>, const timespec&, const double&);
-template void PortImpl::push<std::vector<std::int8_t> >(std::shared_ptr<PVBaseImpl>, const timespec&, const std::vector<std::int8_t>&);
-template void PortImpl::push<std::vector<std::uint8_t> >(std::shared_ptr<PVBaseImpl>, const timespec&, const std::vector<std::uint8_t>&);
-template void PortImpl::push<std::vector<std::int32_t> >(std::shared_ptr<PVBaseImpl>, const timespec&, const std::vector<std::int32_t>&);
-template void PortImpl::push<std::vector<double> >(std::shared_ptr<PVBaseImpl>, const timespec&, const std::vector<double>&);
-template void PortImpl::push<std::string >(std::shared_ptr<PVBaseImpl>, const timespec&, const std::string&);
 }
@@ -0,0 +1,363 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <thread>
+#include <stdexcept>
+
+#include "nds3/impl/publishQueueImpl.h"
+#include "nds3/impl/pvBaseImpl.h"
+#include "nds3/impl/portImpl.h"
+#include "nds3/impl/interfaceBaseImpl.h"
+
+namespace nds
+{
+
+/*
+ * Publish a scalar or a string
+ *
+ ******************************/
+template<typename T>
+void PublishValue<T>::publish(InterfaceBaseImpl& interface, const PVBaseImpl& pv, const timespec& timestamp)
+{
+    interface.push(pv, timestamp, m_value);
+}
+
+/*
+ * Copy a plain vector into the container owned by the slot
+ *
+ **********************************************************/
+template<typename T>
+void PublishValue<std::vector<T> >::store(const std::vector<T>& value)
+{
+    if(m_pOwnBuffer.get() == 0 || m_pOwnBuffer.use_count() != 1)
+    {
+        // The control system still holds the previous container
+        /////////////////////////////////////////////////////////
+        m_pOwnBuffer = std::make_shared<std::vector<T> >();
+    }
+    else
+    {
+        // Make sure that we see all the operations performed by the
+        //  thread that released the last reference
+        ////////////////////////////////////////////////////////////
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    m_pOwnBuffer->assign(value.begin(), value.end());
+    m_pData = m_pOwnBuffer;
+}
+
+/*
+ * Publish an array and release the reference to it
+ *
+ **************************************************/
+template<typename T>
+void PublishValue<std::vector<T> >::publish(InterfaceBaseImpl& interface, const PVBaseImpl& pv, const timespec& timestamp)
+{
+    interface.push(pv, timestamp, SharedBuffer<std::vector<T> >(m_pData));
+    m_pData.reset();
+}
+
+
+PublishQueueBase::PublishQueueBase(PVBaseImpl& pv, PortImpl& port, const overflowPolicy_t overflowPolicy):
+    m_pv(pv), m_port(port), m_overflowPolicy(overflowPolicy),
+    m_queuedSamples(0), m_dispatchedSamples(0), m_discardedSamples(0), m_droppedSamples(0)
+{
+}
+
+PublishQueueBase::~PublishQueueBase()
+{
+}
+
+PublishQueueBase* PublishQueueBase::create(PVBaseImpl& pv, PortImpl& port, const size_t size, const overflowPolicy_t overflowPolicy)
+{
+    switch(pv.getDataType())
+    {
+    case dataType_t::dataInt32:
+        return new PublishQueue<std::int32_t>(pv, port, size, overflowPolicy);
+    case dataType_t::dataFloat64:
+        return new PublishQueue<double>(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt8Array:
+        return new PublishQueue<std::vector<std::int8_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataUint8Array:
+        return new PublishQueue<std::vector<std::uint8_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt32Array:
+        return new PublishQueue<std::vector<std::int32_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataFloat64Array:
+        return new PublishQueue<std::vector<double> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataString:
+        return new PublishQueue<std::string>(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt16:
+        return new PublishQueue<std::int16_t>(pv, port, size, overflowPolicy);
+    case dataType_t::dataUint16:
+        return new PublishQueue<std::uint16_t>(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt64:
+        return new PublishQueue<std::int64_t>(pv, port, size, overflowPolicy);
+    case dataType_t::dataFloat32:
+        return new PublishQueue<float>(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt16Array:
+        return new PublishQueue<std::vector<std::int16_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataUint16Array:
+        return new PublishQueue<std::vector<std::uint16_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataInt64Array:
+        return new PublishQueue<std::vector<std::int64_t> >(pv, port, size, overflowPolicy);
+    case dataType_t::dataFloat32Array:
+        return new PublishQueue<std::vector<float> >(pv, port, size, overflowPolicy);
+    }
+    throw std::logic_error("Unknown data type for the publish queue");
+}
+
+bool PublishQueueBase::isIdle() const
+{
+    return m_queuedSamples.load() == m_dispatchedSamples.load() + m_discardedSamples.load();
+}
+
+std::uint64_t PublishQueueBase::getDroppedSamples() const
+{
+    return m_droppedSamples.load(std::memory_order_relaxed);
+}
+
+
+/*
+ * Round the size up to a power of 2, so the positions can
+ *  be mapped to the slots with a mask
+ *
+ *********************************************************/
+static size_t getQueueMask(const size_t size)
+{
+    size_t roundedSize(2);
+    while(roundedSize < size)
+    {
+        roundedSize <<= 1;
+    }
+    return roundedSize - 1;
+}
+
+template<typename T>
+PublishQueue<T>::PublishQueue(PVBaseImpl& pv, PortImpl& port, const size_t size, const overflowPolicy_t overflowPolicy):
+    PublishQueueBase(pv, port, overflowPolicy),
+    m_mask(getQueueMask(size)), m_slots(new Slot[m_mask + 1]),
+    m_writePosition(0), m_bPushing(false), m_readPosition(0)
+{
+    for(size_t scanSlots(0); scanSlots != m_mask + 1; ++scanSlots)
+    {
+        m_slots[scanSlots].m_sequence.store(scanSlots, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Clears the producer flag when push() returns or throws
+ *
+ ********************************************************/
+class ProducerGuard
+{
+public:
+    ProducerGuard(std::atomic<bool>& bPushing): m_bPushing(bPushing)
+    {
+        if(m_bPushing.exchange(true, std::memory_order_acquire))
+        {
+            throw std::logic_error("A PV with asynchronous delivery is being pushed from more than one thread");
+        }
+    }
+
+    ~ProducerGuard()
+    {
+        m_bPushing.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool>& m_bPushing;
+};
+
+template<typename T>
+template<typename V>
+void PublishQueue<T>::push(const timespec& timestamp, const V& value)
+{
+    ProducerGuard producerGuard(m_bPushing);
+
+    bool bDiscarded(false);
+    while(!tryPush(timestamp, value))
+    {
+        switch(m_overflowPolicy)
+        {
+        case overflowPolicy_t::dropNewest:
+            m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+            return;
+
+        case overflowPolicy_t::dropOldest:
+        {
+            // Remove the oldest value, at most once per push. If the dispatcher
+            //  has claimed the slot we write into but not released it yet then
+            //  popping again would discard a newer value: wait for the slot
+            //  instead, it is released after a few instructions
+            /////////////////////////////////////////////////////////////////////
+            if(bDiscarded)
+            {
+                std::this_thread::yield();
+                break;
+            }
+            bDiscarded = true;
+            timespec discardTimestamp;
+            PublishValue<T> discardValue;
+            if(pop(&discardTimestamp, &discardValue))
+            {
+                m_discardedSamples.fetch_add(1);
+                m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+
+        case overflowPolicy_t::block:
+            // Nobody frees the slots while the dispatcher is stopped
+            /////////////////////////////////////////////////////////
+            if(!m_port.isDispatcherRunning())
+            {
+                m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            m_port.notifyDispatcher();
+            std::this_thread::yield();
+            break;
+        }
+    }
+
+    m_queuedSamples.fetch_add(1);
+    m_port.notifyDispatcher();
+}
+
+template<typename T>
+template<typename V>
+bool PublishQueue<T>::tryPush(const timespec& timestamp, const V& value)
+{
+    const size_t position(m_writePosition.load(std::memory_order_relaxed));
+    Slot& slot(m_slots[position & m_mask]);
+
+    if(slot.m_sequence.load(std::memory_order_acquire) != position)
+    {
+        return false; // The queue is full
+    }
+
+    slot.m_timestamp = timestamp;
+    slot.m_value.store(value);
+    slot.m_sequence.store(position + 1, std::memory_order_release);
+    m_writePosition.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename T>
+bool PublishQueue<T>::pop(timespec* pTimestamp, PublishValue<T>* pValue)
+{
+    // Both the dispatcher and the producer (drop-oldest policy) may
+    //  remove values: the read position is claimed atomically
+    ////////////////////////////////////////////////////////////////
+    size_t position(m_readPosition.load(std::memory_order_relaxed));
+    for(;;)
+    {
+        Slot& slot(m_slots[position & m_mask]);
+        const size_t sequence(slot.m_sequence.load(std::memory_order_acquire));
+
+        if(sequence == position + 1)
+        {
+            if(m_readPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                *pTimestamp = slot.m_timestamp;
+                pValue->swap(slot.m_value);
+                slot.m_sequence.store(position + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(sequence == position)
+        {
+            return false; // The queue is empty
+        }
+        else
+        {
+            position = m_readPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+size_t PublishQueue<T>::dispatch(InterfaceBaseImpl& interface, const size_t maxValues)
+{
+    size_t dispatched(0);
+    timespec timestamp;
+    while(dispatched != maxValues && pop(&timestamp, &m_dispatchValue))
+    {
+        try
+        {
+            PVStatistics* pStatistics(m_pv.getStatistics());
+            if(pStatistics == 0)
+            {
+                m_dispatchValue.publish(interface, m_pv, timestamp);
+            }
+            else
+            {
+                const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
+                m_dispatchValue.publish(interface, m_pv, timestamp);
+                pStatistics->addInterfacePush(PVStatistics::getMonotonicNanoseconds() - startTime);
+            }
+        }
+        catch(...)
+        {
+            m_dispatchedSamples.fetch_add(1);
+            throw;
+        }
+        m_dispatchedSamples.fetch_add(1);
+        ++dispatched;
+    }
+    return dispatched;
+}
+
+template<typename T>
+dataType_t PublishQueue<T>::getDataType() const
+{
+    return PVBaseImpl::getDataTypeForCPPType<T>();
+}
+
+template class PublishQueue<std::int32_t>;
+template class PublishQueue<double>;
+template class PublishQueue<std::vector<std::int8_t> >;
+template class PublishQueue<std::vector<std::uint8_t> >;
+template class PublishQueue<std::vector<std::int32_t> >;
+template class PublishQueue<std::vector<double> >;
+template class PublishQueue<std::string>;
+template class PublishQueue<std::int16_t>;
+template class PublishQueue<std::uint16_t>;
+template class PublishQueue<std::int64_t>;
+template class PublishQueue<float>;
+template class PublishQueue<std::vector<std::int16_t> >;
+template class PublishQueue<std::vector<std::uint16_t> >;
+template class PublishQueue<std::vector<std::int64_t> >;
+template class PublishQueue<std::vector<float> >;
+
+template void PublishQueue<std::int32_t>::push<std::int32_t>(const timespec&, const std::int32_t&);
+template void PublishQueue<double>::push<double>(const timespec&, const double&);
+template void PublishQueue<std::vector<std::int8_t> >::push<std::vector<std::int8_t> >(const timespec&, const std::vector<std::int8_t>&);
+template void PublishQueue<std::vector<std::uint8_t> >::push<std::vector<std::uint8_t> >(const timespec&, const std::vector<std::uint8_t>&);
+template void PublishQueue<std::vector<std::int32_t> >::push<std::vector<std::int32_t> >(const timespec&, const std::vector<std::int32_t>&);
+template void PublishQueue<std::vector<double> >::push<std::vector<double> >(const timespec&, const std::vector<double>&);
+template void PublishQueue<std::string>::push<std::string>(const timespec&, const std::string&);
+template void PublishQueue<std::int16_t>::push<std::int16_t>(const timespec&, const std::int16_t&);
+template void PublishQueue<std::uint16_t>::push<std::uint16_t>(const timespec&, const std::uint16_t&);
+template void PublishQueue<std::int64_t>::push<std::int64_t>(const timespec&, const std::int64_t&);
+template void PublishQueue<float>::push<float>(const timespec&, const float&);
+template void PublishQueue<std::vector<std::int16_t> >::push<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+template void PublishQueue<std::vector<std::uint16_t> >::push<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+template void PublishQueue<std::vector<std::int64_t> >::push<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+template void PublishQueue<std::vector<float> >::push<std::vector<float> >(const timespec&, const std::vector<float>&);
+template void PublishQueue<std::vector<std::int8_t> >::push<SharedBuffer<std::vector<std::int8_t> > >(const timespec&, const SharedBuffer<std::vector<std::int8_t> >&);
+template void PublishQueue<std::vector<std::uint8_t> >::push<SharedBuffer<std::vector<std::uint8_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint8_t> >&);
+template void PublishQueue<std::vector<std::int32_t> >::push<SharedBuffer<std::vector<std::int32_t> > >(const timespec&, const SharedBuffer<std::vector<std::int32_t> >&);
+template void PublishQueue<std::vector<double> >::push<SharedBuffer<std::vector<double> > >(const timespec&, const SharedBuffer<std::vector<double> >&);
+template void PublishQueue<std::vector<std::int16_t> >::push<SharedBuffer<std::vector<std::int16_t> > >(const timespec&, const SharedBuffer<std::vector<std::int16_t> >&);
+template void PublishQueue<std::vector<std::uint16_t> >::push<SharedBuffer<std::vector<std::uint16_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint16_t> >&);
+template void PublishQueue<std::vector<std::int64_t> >::push<SharedBuffer<std::vector<std::int64_t> > >(const timespec&, const SharedBuffer<std::vector<std::int64_t> >&);
+template void PublishQueue<std::vector<float> >::push<SharedBuffer<std::vector<float> > >(const timespec&, const SharedBuffer<std::vector<float> >&);
+
+}
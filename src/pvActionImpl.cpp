@@ -59,6 +59,36 @@ void PVActionImpl::write(const timespec& timestamp, const std::int32_t& value)
 }
 
 
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+void PVActionImpl::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<std::int32_t>())
+    {
+        PVBaseOutImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<std::int32_t>());
+}
+
+
+/*
+ * Pass the values of the PV's data type to write()
+ *
+ **************************************************/
+void PVActionImpl::writeValue(const timespec& timestamp, const ConstTypedSpan& value)
+{
+    if(value.getDataType() != getDataTypeForCPPType<std::int32_t>())
+    {
+        PVBaseOutImpl::writeValue(timestamp, value);
+        return;
+    }
+    write(timestamp, *value.get<const std::int32_t>());
+}
+
+
 /*
  * Return the PV's data type
  *
@@ -7,6 +7,8 @@
  * file included in the distribution.
  */
 
+#include <stdexcept>
+
 #include "nds3/port.h"
 #include "nds3/pvBase.h"
 #include "nds3/impl/pvBaseImpl.h"
@@ -23,97 +25,102 @@ PVBaseImpl::PVBaseImpl(const std::string& name): BaseImpl(name),
     m_scanType(scanType_t::passive),
     m_periodicScanSeconds(1),
     m_maxElements(1),
-    m_bProcessAtInit(false)
+    m_bProcessAtInit(false),
+    m_pPort(0),
+    m_pInterface(0),
+    m_pStatistics(0)
 {
 
 }
 
 
 /*
- * Read functions for all the supported data types
+ * Read function for the data types not supported by the PV
  *
- *************************************************/
-void PVBaseImpl::read(timespec* /* pTimestamp */, std::int32_t* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseImpl::read(timespec* /* pTimestamp */, double* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseImpl::read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const
-{
-    // TODO
-    // Epics calls this also for unsigned-int.
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    read(pTimestamp, (std::vector<std::uint8_t>*) pValue);
-}
-
-void PVBaseImpl::read(timespec* /* pTimestamp */, std::vector<std::uint8_t>* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseImpl::read(timespec* /* pTimestamp */, std::vector<std::int32_t>* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseImpl::read(timespec* /* pTimestamp */, std::vector<double>* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseImpl::read(timespec* /* pTimestamp */, std::string* /* pValue */) const
+ **********************************************************/
+void PVBaseImpl::readValue(timespec* pTimestamp, const TypedSpan& value) const
 {
-    throw;
+    switch(value.getDataType())
+    {
+    case dataType_t::dataInt8Array:
+        // EPICS reads also the arrays of uint8 as arrays of int8: the two
+        //  vectors have the same layout
+        //////////////////////////////////////////////////////////////////
+        readValue(pTimestamp, TypedSpan(dataType_t::dataUint8Array, value.get<std::vector<std::int8_t> >()));
+        return;
+
+    case dataType_t::dataUint8Array:
+        // ...and the strings as arrays of uint8
+        ////////////////////////////////////////
+        //  The PVs that store the string copy it directly; the delegate
+        //  PVs fill a temporary string
+        if(getDataType() == dataType_t::dataString)
+        {
+            std::string temporaryValue;
+            readValue(pTimestamp, TypedSpan(&temporaryValue));
+            copyStringBytes(temporaryValue, value);
+            return;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    throw PVDataTypeError("The PV " + getFullName() + " cannot be read with the requested data type");
 }
 
 
 /*
- * Write functions for all the supported data types
+ * Write function for the data types not supported by the PV
  *
- **************************************************/
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const std::int32_t& /* value */)
+ ***********************************************************/
+void PVBaseImpl::writeValue(const timespec& timestamp, const ConstTypedSpan& value)
 {
-    throw;
+    switch(value.getDataType())
+    {
+    case dataType_t::dataInt8Array:
+        // EPICS writes also the arrays of uint8 as arrays of int8: the two
+        //  vectors have the same layout
+        ///////////////////////////////////////////////////////////////////
+        writeValue(timestamp, ConstTypedSpan(dataType_t::dataUint8Array, value.get<const std::vector<std::int8_t> >()));
+        return;
+
+    case dataType_t::dataUint8Array:
+        // ...and the strings as arrays of uint8
+        ////////////////////////////////////////
+        //  The PVs that store the string assign it directly; the delegate
+        //  PVs receive a temporary string
+        if(getDataType() == dataType_t::dataString)
+        {
+            std::string temporaryValue;
+            assignStringBytes(value, &temporaryValue);
+            writeValue(timestamp, ConstTypedSpan(&temporaryValue));
+            return;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    throw PVDataTypeError("The PV " + getFullName() + " cannot be written with the requested data type");
 }
 
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const double& /* value */)
-{
-    throw;
-}
 
-void PVBaseImpl::write(const timespec& pTimestamp, const std::vector<std::int8_t>& value)
-{
-    // TODO
-    // Epics calls this also for unsigned-int.
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    write(pTimestamp, (const std::vector<std::uint8_t>&) value);
-}
-
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const std::vector<std::uint8_t>& /* value */)
-{
-    throw;
-}
-
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const std::vector<std::int32_t>& /* value */)
-{
-    throw;
-}
-
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const std::vector<double>& /* value */)
+/*
+ * Conversions between the strings and the arrays of uint8
+ *
+ *********************************************************/
+void PVBaseImpl::copyStringBytes(const std::string& value, const TypedSpan& bytes)
 {
-    throw;
+    bytes.get<std::vector<std::uint8_t> >()->assign(value.begin(), value.end());
 }
 
-void PVBaseImpl::write(const timespec& /* pTimestamp */, const std::string& /* value */)
+void PVBaseImpl::assignStringBytes(const ConstTypedSpan& bytes, std::string* pValue)
 {
-    throw;
+    const std::vector<std::uint8_t>& source(*bytes.get<const std::vector<std::uint8_t> >());
+    pValue->assign(source.begin(), source.end());
 }
 
 
@@ -255,7 +262,15 @@ bool PVBaseImpl::getProcessAtInit() const
 void PVBaseImpl::initialize(FactoryBaseImpl& controlSystem)
 {
     BaseImpl::initialize(controlSystem);
-    getPort()->registerPV(std::static_pointer_cast<PVBaseImpl>(shared_from_this()));
+
+    // Resolve the port and the interface once: the push operations
+    //  use them directly
+    ////////////////////////////////////////////////////////////////
+    std::shared_ptr<PortImpl> pPort(getPort());
+    m_pPort = pPort.get();
+    m_pInterface = &(pPort->getInterface());
+
+    pPort->registerPV(std::static_pointer_cast<PVBaseImpl>(shared_from_this()));
 }
 
 
@@ -266,7 +281,50 @@ void PVBaseImpl::initialize(FactoryBaseImpl& controlSystem)
 void PVBaseImpl::deinitialize()
 {
     BaseImpl::deinitialize();
-    getPort()->deregisterPV(std::static_pointer_cast<PVBaseImpl>(shared_from_this()));
+    if(m_pPort == 0)
+    {
+        throw std::logic_error("deinitialize called on non initialized PV");
+    }
+    m_pPort->deregisterPV(std::static_pointer_cast<PVBaseImpl>(shared_from_this()));
+
+    m_pPort = 0;
+    m_pInterface = 0;
+}
+
+
+/*
+ * Enable or disable the statistics. The counters are kept
+ *  while the statistics are disabled, because the threads that
+ *  push or read the PV may still be updating them
+ *
+ **************************************************************/
+void PVBaseImpl::setStatisticsEnabled(const bool bEnabled)
+{
+    std::lock_guard<std::mutex> lock(m_lockStatistics);
+    if(!bEnabled)
+    {
+        m_pStatistics.store(0, std::memory_order_release);
+        return;
+    }
+    if(m_pStatisticsStorage.get() == 0)
+    {
+        m_pStatisticsStorage.reset(new PVStatistics);
+    }
+    m_pStatistics.store(m_pStatisticsStorage.get(), std::memory_order_release);
+}
+
+
+/*
+ * Append the statistics of the PV, if enabled
+ *
+ *********************************************/
+void PVBaseImpl::collectStatistics(parameters_t* pStatistics)
+{
+    PVStatistics* pPVStatistics(getStatistics());
+    if(pPVStatistics != 0)
+    {
+        pPVStatistics->getStatistics(getFullName(), pStatistics);
+    }
 }
 
 
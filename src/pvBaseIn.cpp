@@ -8,6 +8,7 @@
  */
 
 #include "nds3/pvBaseIn.h"
+#include "nds3/sharedBuffer.h"
 #include "nds3/impl/pvBaseInImpl.h"
 
 namespace nds
@@ -34,11 +35,22 @@ void PVBaseIn::push(const timespec& timestamp, const T& value)
     std::static_pointer_cast<PVBaseInImpl>(m_pImplementation)->push(timestamp, value);
 }
 
+template<typename T>
+void PVBaseIn::pushBatch(const timespec* pTimestamps, const T* pValues, const size_t count)
+{
+    std::static_pointer_cast<PVBaseInImpl>(m_pImplementation)->pushBatch(pTimestamps, pValues, count);
+}
+
 void PVBaseIn::setDecimation(const std::uint32_t decimation)
 {
     std::static_pointer_cast<PVBaseInImpl>(m_pImplementation)->setDecimation(decimation);
 }
 
+std::uint64_t PVBaseIn::getDroppedSamples() const
+{
+    return std::static_pointer_cast<PVBaseInImpl>(m_pImplementation)->getDroppedSamples();
+}
+
 void PVBaseIn::replicateFrom(const std::string &sourceInputPVName)
 {
     std::static_pointer_cast<PVBaseInImpl>(m_pImplementation)->replicateFrom(sourceInputPVName);
@@ -46,9 +58,11 @@ void PVBaseIn::replicateFrom(const std::string &sourceInputPVName)
 
 template void PVBaseIn::read<std::int32_t>(timespec*, std::int32_t*) const;
 template void PVBaseIn::push<std::int32_t>(const timespec&, const std::int32_t&);
+template void PVBaseIn::pushBatch<std::int32_t>(const timespec*, const std::int32_t*, const size_t);
 
 template void PVBaseIn::read<double>(timespec*, double*) const;
 template void PVBaseIn::push<double>(const timespec&, const double&);
+template void PVBaseIn::pushBatch<double>(const timespec*, const double*, const size_t);
 
 template void PVBaseIn::read<std::vector<std::int8_t> >(timespec*, std::vector<std::int8_t>*) const;
 template void PVBaseIn::push<std::vector<std::int8_t> >(const timespec&, const std::vector<std::int8_t>&);
@@ -65,5 +79,42 @@ template void PVBaseIn::push<std::vector<double> >(const timespec&, const std::v
 template void PVBaseIn::read<std::string >(timespec*, std::string*) const;
 template void PVBaseIn::push<std::string >(const timespec&, const std::string&);
 
+template void PVBaseIn::read<std::int16_t>(timespec*, std::int16_t*) const;
+template void PVBaseIn::push<std::int16_t>(const timespec&, const std::int16_t&);
+template void PVBaseIn::pushBatch<std::int16_t>(const timespec*, const std::int16_t*, const size_t);
+
+template void PVBaseIn::read<std::uint16_t>(timespec*, std::uint16_t*) const;
+template void PVBaseIn::push<std::uint16_t>(const timespec&, const std::uint16_t&);
+template void PVBaseIn::pushBatch<std::uint16_t>(const timespec*, const std::uint16_t*, const size_t);
+
+template void PVBaseIn::read<std::int64_t>(timespec*, std::int64_t*) const;
+template void PVBaseIn::push<std::int64_t>(const timespec&, const std::int64_t&);
+template void PVBaseIn::pushBatch<std::int64_t>(const timespec*, const std::int64_t*, const size_t);
+
+template void PVBaseIn::read<float>(timespec*, float*) const;
+template void PVBaseIn::push<float>(const timespec&, const float&);
+template void PVBaseIn::pushBatch<float>(const timespec*, const float*, const size_t);
+
+template void PVBaseIn::read<std::vector<std::int16_t> >(timespec*, std::vector<std::int16_t>*) const;
+template void PVBaseIn::push<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+
+template void PVBaseIn::read<std::vector<std::uint16_t> >(timespec*, std::vector<std::uint16_t>*) const;
+template void PVBaseIn::push<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+
+template void PVBaseIn::read<std::vector<std::int64_t> >(timespec*, std::vector<std::int64_t>*) const;
+template void PVBaseIn::push<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+
+template void PVBaseIn::read<std::vector<float> >(timespec*, std::vector<float>*) const;
+template void PVBaseIn::push<std::vector<float> >(const timespec&, const std::vector<float>&);
+
+template void PVBaseIn::push<SharedBuffer<std::vector<std::int8_t> > >(const timespec&, const SharedBuffer<std::vector<std::int8_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<std::uint8_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint8_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<std::int32_t> > >(const timespec&, const SharedBuffer<std::vector<std::int32_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<double> > >(const timespec&, const SharedBuffer<std::vector<double> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<std::int16_t> > >(const timespec&, const SharedBuffer<std::vector<std::int16_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<std::uint16_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint16_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<std::int64_t> > >(const timespec&, const SharedBuffer<std::vector<std::int64_t> >&);
+template void PVBaseIn::push<SharedBuffer<std::vector<float> > >(const timespec&, const SharedBuffer<std::vector<float> >&);
+
 }
 
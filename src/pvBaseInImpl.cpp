@@ -8,11 +8,13 @@
  */
 
 #include <sstream>
-#include <cstring>
 
+#include "nds3/sharedBuffer.h"
 #include "nds3/impl/pvBaseInImpl.h"
 #include "nds3/impl/pvBaseOutImpl.h"
 #include "nds3/impl/portImpl.h"
+#include "nds3/impl/interfaceBaseImpl.h"
+#include "nds3/impl/publishQueueImpl.h"
 #include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/factoryBaseImpl.h"
 
@@ -20,18 +22,12 @@ namespace nds
 {
 
 PVBaseInImpl::PVBaseInImpl(const std::string& name, const inputPvType_t pvType): PVBaseImpl(name), m_pvType(pvType),
-    m_decimationFactor(1), m_decimationCount(1)
+    m_decimationFactor(1), m_decimationCount(1), m_decimationBuffersType(dataType_t::dataInt32), m_pPublishQueue(0)
 {
     defineCommand("replicate", "replicate destination source", 1, std::bind(&PVBaseInImpl::commandReplicate,this, std::placeholders::_1));
     defineCommand("decimation", "decimation node decimationFactor", 1, std::bind(&PVBaseInImpl::commandDecimation,this, std::placeholders::_1));
 }
 
-void PVBaseInImpl::initialize(FactoryBaseImpl &controlSystem)
-{
-    PVBaseImpl::initialize(controlSystem);
-    NdsFactoryImpl::getInstance().registerInputPV(this);
-}
-
 void PVBaseInImpl::deinitialize()
 {
     NdsFactoryImpl::getInstance().deregisterInputPV(this);
@@ -43,77 +39,120 @@ void PVBaseInImpl::replicateFrom(const std::string &sourceInputPVName)
     NdsFactoryImpl::getInstance().replicate(sourceInputPVName, this);
 }
 
-void PVBaseInImpl::read(timespec* /* pTimestamp */, std::int32_t* /* pValue */) const
-{
-    throw;
-}
+// push() must not take a lock to reach the publish queue
+/////////////////////////////////////////////////////////
+static_assert(ATOMIC_POINTER_LOCK_FREE == 2, "Atomic pointers are not lock free");
 
-void PVBaseInImpl::read(timespec* /* pTimestamp */, double* /* pValue */) const
+void PVBaseInImpl::setPublishQueue(PublishQueueBase* pQueue)
 {
-    throw;
+    m_pPublishQueue.store(pQueue, std::memory_order_release);
 }
 
-void PVBaseInImpl::read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const
+PublishQueueBase* PVBaseInImpl::getPublishQueue() const
 {
-    // TODO
-    // Epics calls this also for unsigned-int and strings
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    read(pTimestamp, (std::vector<std::uint8_t>*) pValue);
+    return m_pPublishQueue.load(std::memory_order_acquire);
 }
 
-void PVBaseInImpl::read(timespec* pTimestamp, std::vector<std::uint8_t>* pValue) const
+std::uint64_t PVBaseInImpl::getDroppedSamples() const
 {
-    // TODO
-    // Epics calls this also for strings.
-    // If we arrive here maybe we really wanted to call the string function.
-    // This is as ugly as it can get: consider modifying this
-    std::string temporaryValue;
-    read(pTimestamp, &temporaryValue);
-    pValue->resize(temporaryValue.size());
-    ::memcpy(pValue->data(), temporaryValue.data(), temporaryValue.size());
+    PublishQueueBase* pQueue(getPublishQueue());
+    if(pQueue == 0)
+    {
+        return 0;
+    }
+    return pQueue->getDroppedSamples();
 }
 
-void PVBaseInImpl::read(timespec* /* pTimestamp */, std::vector<std::int32_t>* /* pValue */) const
-{
-    throw;
-}
 
-void PVBaseInImpl::read(timespec* /* pTimestamp */, std::vector<double>* /* pValue */) const
+/*
+ * Return the plain value for the output PVs, which don't accept
+ *  shared buffers
+ *
+ ***************************************************************/
+template<typename T>
+static inline const T& getPlainValue(const T& value)
 {
-    throw;
+    return value;
 }
 
-void PVBaseInImpl::read(timespec* /* pTimestamp */, std::string* /* pValue */) const
+template<typename T>
+static inline const T& getPlainValue(const SharedBuffer<T>& value)
 {
-    throw;
+    return value.get();
 }
 
 
 template<typename T>
 void PVBaseInImpl::push(const timespec& timestamp, const T& value)
 {
-    // Find the port then push the value
-    ////////////////////////////////////
-    std::shared_ptr<PortImpl> pPort(getPort());
+    if(passDecimation())
+    {
+        pushToControlSystem(timestamp, value);
+    }
+    pushToLinkedPVs(timestamp, value);
+}
+
+bool PVBaseInImpl::passDecimation()
+{
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addPushes(1);
+    }
+
     if(--m_decimationCount == 0) // push can only happen from one thread. No sync needed
     {
         m_decimationCount = m_decimationFactor;
-        pPort->push(std::static_pointer_cast<PVBaseImpl>(shared_from_this()), timestamp, value);
+        return true;
+    }
+
+    if(pStatistics != 0)
+    {
+        pStatistics->addDecimatedSamples(1);
+    }
+    return false;
+}
+
+template<typename T>
+void PVBaseInImpl::pushToControlSystem(const timespec& timestamp, const T& value)
+{
+    // Queue the value for the port's dispatcher thread, or push it
+    //  directly into the control system interface
+    ///////////////////////////////////////////////////////////////
+    typedef typename PublishedType<T>::type publishedType_t;
+    PublishQueueBase* pQueue(getPublishQueue());
+    PVStatistics* pStatistics(getStatistics());
+    if(pQueue != 0 && pQueue->getDataType() == getDataTypeForCPPType<publishedType_t>())
+    {
+        static_cast<PublishQueue<publishedType_t>*>(pQueue)->push(timestamp, value);
     }
+    else if(pStatistics == 0)
+    {
+        getInterface().push(*this, timestamp, value);
+    }
+    else
+    {
+        const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
+        getInterface().push(*this, timestamp, value);
+        pStatistics->addInterfacePush(PVStatistics::getMonotonicNanoseconds() - startTime);
+    }
+}
 
+template<typename T>
+void PVBaseInImpl::pushToLinkedPVs(const timespec& timestamp, const T& value)
+{
     // Push the value to the outputs (subscription) and inputs (replication)
     ////////////////////////////////////////////////////////////////////////
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
-
-    for(subscribersList_t::iterator scanOutputs(m_subscriberOutputPVs.begin()), endOutputs(m_subscriberOutputPVs.end());
+    subscribersList_t::Reader outputs(m_subscriberOutputPVs);
+    for(subscribersList_t::list_t::const_iterator scanOutputs(outputs.begin()), endOutputs(outputs.end());
         scanOutputs != endOutputs;
         ++scanOutputs)
     {
-        (*scanOutputs)->write(timestamp, value);
+        (*scanOutputs)->write(timestamp, getPlainValue(value));
     }
 
-    for(destinationList_t::iterator scanInputs(m_replicationDestinationPVs.begin()), endInputs(m_replicationDestinationPVs.end());
+    destinationList_t::Reader inputs(m_replicationDestinationPVs);
+    for(destinationList_t::list_t::const_iterator scanInputs(inputs.begin()), endInputs(inputs.end());
         scanInputs != endInputs;
         ++scanInputs)
     {
@@ -121,38 +160,146 @@ void PVBaseInImpl::push(const timespec& timestamp, const T& value)
     }
 }
 
-void PVBaseInImpl::subscribeReceiver(PVBaseOutImpl* pReceiver)
+/*
+ * Samples of a batch that pass the decimation
+ *
+ *********************************************/
+template<typename T>
+struct DecimationBuffers
 {
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
-    m_subscriberOutputPVs.insert(pReceiver);
+    std::vector<timespec> m_timestamps;
+    std::vector<T> m_values;
+};
+
+template<typename T>
+void PVBaseInImpl::pushBatch(const timespec* pTimestamps, const T* pValues, const size_t count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addPushes(count);
+    }
+
+    // Apply the decimation to the whole block
+    //////////////////////////////////////////
+    if(m_decimationFactor == 1)
+    {
+        pushBatchToControlSystem(pTimestamps, pValues, count);
+    }
+    else if(m_decimationFactor == 0)
+    {
+        if(pStatistics != 0)
+        {
+            pStatistics->addDecimatedSamples(count);
+        }
+    }
+    else
+    {
+        // The buffers keep their capacity across the batches
+        //////////////////////////////////////////////////////
+        if(m_pDecimationBuffers.get() == 0 || m_decimationBuffersType != getDataTypeForCPPType<T>())
+        {
+            m_pDecimationBuffers = std::make_shared<DecimationBuffers<T> >();
+            m_decimationBuffersType = getDataTypeForCPPType<T>();
+        }
+        std::vector<timespec>& decimatedTimestamps(static_cast<DecimationBuffers<T>*>(m_pDecimationBuffers.get())->m_timestamps);
+        std::vector<T>& decimatedValues(static_cast<DecimationBuffers<T>*>(m_pDecimationBuffers.get())->m_values);
+        decimatedTimestamps.clear();
+        decimatedValues.clear();
+
+        size_t scanSamples(m_decimationCount - 1);
+        for(; scanSamples < count; scanSamples += m_decimationFactor)
+        {
+            decimatedTimestamps.push_back(pTimestamps[scanSamples]);
+            decimatedValues.push_back(pValues[scanSamples]);
+        }
+        m_decimationCount = (std::uint32_t)(scanSamples - count + 1);
+
+        if(pStatistics != 0)
+        {
+            pStatistics->addDecimatedSamples(count - decimatedValues.size());
+        }
+
+        if(!decimatedValues.empty())
+        {
+            pushBatchToControlSystem(decimatedTimestamps.data(), decimatedValues.data(), decimatedValues.size());
+        }
+    }
+
+    // Push the samples to the outputs (subscription) and inputs (replication)
+    //////////////////////////////////////////////////////////////////////////
+    subscribersList_t::Reader outputs(m_subscriberOutputPVs);
+    for(subscribersList_t::list_t::const_iterator scanOutputs(outputs.begin()), endOutputs(outputs.end());
+        scanOutputs != endOutputs;
+        ++scanOutputs)
+    {
+        for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+        {
+            (*scanOutputs)->write(pTimestamps[scanSamples], pValues[scanSamples]);
+        }
+    }
+
+    destinationList_t::Reader inputs(m_replicationDestinationPVs);
+    for(destinationList_t::list_t::const_iterator scanInputs(inputs.begin()), endInputs(inputs.end());
+        scanInputs != endInputs;
+        ++scanInputs)
+    {
+        (*scanInputs)->pushBatch(pTimestamps, pValues, count);
+    }
 }
 
-void PVBaseInImpl::unsubscribeReceiver(PVBaseOutImpl* pReceiver)
+/*
+ * Queue the block for the port's dispatcher thread, or pass it
+ *  to the control system in one call
+ *
+ **************************************************************/
+template<typename T>
+void PVBaseInImpl::pushBatchToControlSystem(const timespec* pTimestamps, const T* pValues, const size_t count)
 {
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
+    PublishQueueBase* pQueue(getPublishQueue());
+    if(pQueue != 0 && pQueue->getDataType() == getDataTypeForCPPType<T>())
+    {
+        for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+        {
+            static_cast<PublishQueue<T>*>(pQueue)->push(pTimestamps[scanSamples], pValues[scanSamples]);
+        }
+        return;
+    }
 
-    subscribersList_t::const_iterator findReceiver = m_subscriberOutputPVs.find(pReceiver);
-    if(findReceiver != m_subscriberOutputPVs.end())
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics == 0)
     {
-        m_subscriberOutputPVs.erase(findReceiver);
+        getInterface().pushBatch(*this, pTimestamps, pValues, count);
+        return;
     }
+    const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
+    getInterface().pushBatch(*this, pTimestamps, pValues, count);
+    pStatistics->addInterfacePush(PVStatistics::getMonotonicNanoseconds() - startTime);
+}
+
+void PVBaseInImpl::subscribeReceiver(PVBaseOutImpl* pReceiver)
+{
+    m_subscriberOutputPVs.insert(pReceiver);
+}
+
+void PVBaseInImpl::unsubscribeReceiver(PVBaseOutImpl* pReceiver)
+{
+    m_subscriberOutputPVs.erase(pReceiver);
 }
 
 void PVBaseInImpl::replicateTo(PVBaseInImpl *pDestination)
 {
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
     m_replicationDestinationPVs.insert(pDestination);
 }
 
 void PVBaseInImpl::stopReplicationTo(PVBaseInImpl* pDestination)
 {
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
-
-    destinationList_t::const_iterator findDestination = m_replicationDestinationPVs.find(pDestination);
-    if(findDestination != m_replicationDestinationPVs.end())
-    {
-        m_replicationDestinationPVs.erase(findDestination);
-    }
+    m_replicationDestinationPVs.erase(pDestination);
 }
 
 
@@ -220,23 +367,30 @@ std::string PVBaseInImpl::buildFullExternalName(const FactoryBaseImpl& controlSy
     {
         if(bStopAtPort)
         {
-            return temporaryPointer->buildFullExternalNameFromPort(controlSystem);
+            return temporaryPointer->getFullExternalNameFromPort();
         }
         else
         {
-            return temporaryPointer->buildFullExternalName(controlSystem);
+            return temporaryPointer->getFullExternalName();
         }
     }
 
     if(bStopAtPort)
     {
-        return temporaryPointer->buildFullExternalNameFromPort(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+        return temporaryPointer->getFullExternalNameFromPort() + controlSystem.getSeparator(m_nodeLevel) + name;
     }
 
-    return temporaryPointer->buildFullExternalName(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+    return temporaryPointer->getFullExternalName() + controlSystem.getSeparator(m_nodeLevel) + name;
 }
 
 
+template void PVBaseInImpl::pushBatch<std::int32_t>(const timespec*, const std::int32_t*, const size_t);
+template void PVBaseInImpl::pushBatch<double>(const timespec*, const double*, const size_t);
+template void PVBaseInImpl::pushBatch<std::int16_t>(const timespec*, const std::int16_t*, const size_t);
+template void PVBaseInImpl::pushBatch<std::uint16_t>(const timespec*, const std::uint16_t*, const size_t);
+template void PVBaseInImpl::pushBatch<std::int64_t>(const timespec*, const std::int64_t*, const size_t);
+template void PVBaseInImpl::pushBatch<float>(const timespec*, const float*, const size_t);
+
 template void PVBaseInImpl::push<std::int32_t>(const timespec&, const std::int32_t&);
 template void PVBaseInImpl::push<double>(const timespec&, const double&);
 template void PVBaseInImpl::push<std::vector<std::int8_t> >(const timespec&, const std::vector<std::int8_t>&);
@@ -244,6 +398,68 @@ template void PVBaseInImpl::push<std::vector<std::uint8_t> >(const timespec&, co
 template void PVBaseInImpl::push<std::vector<std::int32_t> >(const timespec&, const std::vector<std::int32_t>&);
 template void PVBaseInImpl::push<std::vector<double> >(const timespec&, const std::vector<double>&);
 template void PVBaseInImpl::push<std::string >(const timespec&, const std::string&);
+template void PVBaseInImpl::push<std::int16_t>(const timespec&, const std::int16_t&);
+template void PVBaseInImpl::push<std::uint16_t>(const timespec&, const std::uint16_t&);
+template void PVBaseInImpl::push<std::int64_t>(const timespec&, const std::int64_t&);
+template void PVBaseInImpl::push<float>(const timespec&, const float&);
+template void PVBaseInImpl::push<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+template void PVBaseInImpl::push<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+template void PVBaseInImpl::push<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+template void PVBaseInImpl::push<std::vector<float> >(const timespec&, const std::vector<float>&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::int8_t> > >(const timespec&, const SharedBuffer<std::vector<std::int8_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::uint8_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint8_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::int32_t> > >(const timespec&, const SharedBuffer<std::vector<std::int32_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<double> > >(const timespec&, const SharedBuffer<std::vector<double> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::int16_t> > >(const timespec&, const SharedBuffer<std::vector<std::int16_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::uint16_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint16_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<std::int64_t> > >(const timespec&, const SharedBuffer<std::vector<std::int64_t> >&);
+template void PVBaseInImpl::push<SharedBuffer<std::vector<float> > >(const timespec&, const SharedBuffer<std::vector<float> >&);
+template void PVBaseInImpl::pushToControlSystem<std::int32_t>(const timespec&, const std::int32_t&);
+template void PVBaseInImpl::pushToControlSystem<double>(const timespec&, const double&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::int8_t> >(const timespec&, const std::vector<std::int8_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::uint8_t> >(const timespec&, const std::vector<std::uint8_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::int32_t> >(const timespec&, const std::vector<std::int32_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<double> >(const timespec&, const std::vector<double>&);
+template void PVBaseInImpl::pushToControlSystem<std::string >(const timespec&, const std::string&);
+template void PVBaseInImpl::pushToControlSystem<std::int16_t>(const timespec&, const std::int16_t&);
+template void PVBaseInImpl::pushToControlSystem<std::uint16_t>(const timespec&, const std::uint16_t&);
+template void PVBaseInImpl::pushToControlSystem<std::int64_t>(const timespec&, const std::int64_t&);
+template void PVBaseInImpl::pushToControlSystem<float>(const timespec&, const float&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+template void PVBaseInImpl::pushToControlSystem<std::vector<float> >(const timespec&, const std::vector<float>&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::int8_t> > >(const timespec&, const SharedBuffer<std::vector<std::int8_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::uint8_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint8_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::int32_t> > >(const timespec&, const SharedBuffer<std::vector<std::int32_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<double> > >(const timespec&, const SharedBuffer<std::vector<double> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::int16_t> > >(const timespec&, const SharedBuffer<std::vector<std::int16_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::uint16_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint16_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<std::int64_t> > >(const timespec&, const SharedBuffer<std::vector<std::int64_t> >&);
+template void PVBaseInImpl::pushToControlSystem<SharedBuffer<std::vector<float> > >(const timespec&, const SharedBuffer<std::vector<float> >&);
+template void PVBaseInImpl::pushToLinkedPVs<std::int32_t>(const timespec&, const std::int32_t&);
+template void PVBaseInImpl::pushToLinkedPVs<double>(const timespec&, const double&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::int8_t> >(const timespec&, const std::vector<std::int8_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::uint8_t> >(const timespec&, const std::vector<std::uint8_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::int32_t> >(const timespec&, const std::vector<std::int32_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<double> >(const timespec&, const std::vector<double>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::string >(const timespec&, const std::string&);
+template void PVBaseInImpl::pushToLinkedPVs<std::int16_t>(const timespec&, const std::int16_t&);
+template void PVBaseInImpl::pushToLinkedPVs<std::uint16_t>(const timespec&, const std::uint16_t&);
+template void PVBaseInImpl::pushToLinkedPVs<std::int64_t>(const timespec&, const std::int64_t&);
+template void PVBaseInImpl::pushToLinkedPVs<float>(const timespec&, const float&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+template void PVBaseInImpl::pushToLinkedPVs<std::vector<float> >(const timespec&, const std::vector<float>&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::int8_t> > >(const timespec&, const SharedBuffer<std::vector<std::int8_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::uint8_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint8_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::int32_t> > >(const timespec&, const SharedBuffer<std::vector<std::int32_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<double> > >(const timespec&, const SharedBuffer<std::vector<double> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::int16_t> > >(const timespec&, const SharedBuffer<std::vector<std::int16_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::uint16_t> > >(const timespec&, const SharedBuffer<std::vector<std::uint16_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<std::int64_t> > >(const timespec&, const SharedBuffer<std::vector<std::int64_t> >&);
+template void PVBaseInImpl::pushToLinkedPVs<SharedBuffer<std::vector<float> > >(const timespec&, const SharedBuffer<std::vector<float> >&);
 
 }
 
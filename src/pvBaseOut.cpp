@@ -59,5 +59,29 @@ template void PVBaseOut::write<std::vector<double> >(const timespec&, const std:
 template void PVBaseOut::read<std::string >(timespec*, std::string*) const;
 template void PVBaseOut::write<std::string >(const timespec&, const std::string&);
 
+template void PVBaseOut::read<std::int16_t>(timespec*, std::int16_t*) const;
+template void PVBaseOut::write<std::int16_t>(const timespec&, const std::int16_t&);
+
+template void PVBaseOut::read<std::uint16_t>(timespec*, std::uint16_t*) const;
+template void PVBaseOut::write<std::uint16_t>(const timespec&, const std::uint16_t&);
+
+template void PVBaseOut::read<std::int64_t>(timespec*, std::int64_t*) const;
+template void PVBaseOut::write<std::int64_t>(const timespec&, const std::int64_t&);
+
+template void PVBaseOut::read<float>(timespec*, float*) const;
+template void PVBaseOut::write<float>(const timespec&, const float&);
+
+template void PVBaseOut::read<std::vector<std::int16_t> >(timespec*, std::vector<std::int16_t>*) const;
+template void PVBaseOut::write<std::vector<std::int16_t> >(const timespec&, const std::vector<std::int16_t>&);
+
+template void PVBaseOut::read<std::vector<std::uint16_t> >(timespec*, std::vector<std::uint16_t>*) const;
+template void PVBaseOut::write<std::vector<std::uint16_t> >(const timespec&, const std::vector<std::uint16_t>&);
+
+template void PVBaseOut::read<std::vector<std::int64_t> >(timespec*, std::vector<std::int64_t>*) const;
+template void PVBaseOut::write<std::vector<std::int64_t> >(const timespec&, const std::vector<std::int64_t>&);
+
+template void PVBaseOut::read<std::vector<float> >(timespec*, std::vector<float>*) const;
+template void PVBaseOut::write<std::vector<float> >(const timespec&, const std::vector<float>&);
+
 }
 
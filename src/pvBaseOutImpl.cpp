@@ -7,8 +7,6 @@
  * file included in the distribution.
  */
 
-#include <cstring>
-
 #include "nds3/impl/pvBaseOutImpl.h"
 #include "nds3/impl/ndsFactoryImpl.h"
 #include "nds3/impl/factoryBaseImpl.h"
@@ -22,12 +20,6 @@ PVBaseOutImpl::PVBaseOutImpl(const std::string& name, const outputPvType_t pvTyp
     defineCommand("subscribe", "subscribe destination source", 1, std::bind(&PVBaseOutImpl::commandSubscribeTo, this, std::placeholders::_1));
 }
 
-void PVBaseOutImpl::initialize(FactoryBaseImpl &controlSystem)
-{
-    PVBaseImpl::initialize(controlSystem);
-    NdsFactoryImpl::getInstance().registerOutputPV(this);
-}
-
 void PVBaseOutImpl::deinitialize()
 {
     NdsFactoryImpl::getInstance().deregisterOutputPV(this);
@@ -40,96 +32,6 @@ void PVBaseOutImpl::subscribeTo(const std::string &inputPVName)
 }
 
 
-void PVBaseOutImpl::read(timespec* /* pTimestamp */, std::int32_t* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseOutImpl::read(timespec* /* pTimestamp */, double* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseOutImpl::read(timespec* pTimestamp, std::vector<std::int8_t>* pValue) const
-{
-    // TODO
-    // Epics calls this also for unsigned-int and strings.
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    read(pTimestamp, (std::vector<std::uint8_t>*) pValue);
-}
-
-void PVBaseOutImpl::read(timespec* pTimestamp, std::vector<std::uint8_t>* pValue) const
-{
-    // TODO
-    // Epics calls this also for strings.
-    // If we arrive here maybe we really wanted to call the string function.
-    // This is as ugly as it can get: consider modifying this
-    std::string temporaryValue;
-    read(pTimestamp, &temporaryValue);
-    pValue->resize(temporaryValue.size());
-    ::memcpy(pValue->data(), temporaryValue.data(), temporaryValue.size());
-}
-
-void PVBaseOutImpl::read(timespec* /* pTimestamp */, std::vector<std::int32_t>* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseOutImpl::read(timespec* /* pTimestamp */, std::vector<double>* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseOutImpl::read(timespec* /* pTimestamp */, std::string* /* pValue */) const
-{
-    throw;
-}
-
-void PVBaseOutImpl::write(const timespec& /* pTimestamp */, const std::int32_t& /* value */)
-{
-    throw;
-}
-
-void PVBaseOutImpl::write(const timespec& /* pTimestamp */, const double& /* value */)
-{
-    throw;
-}
-
-void PVBaseOutImpl::write(const timespec& pTimestamp, const std::vector<std::int8_t>& value)
-{
-    // TODO
-    // Epics calls this also for unsigned-int and strings.
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    write(pTimestamp, (const std::vector<std::uint8_t>&) value);
-}
-
-void PVBaseOutImpl::write(const timespec& timestamp, const std::vector<std::uint8_t>& value)
-{
-    // TODO
-    // Epics calls this also for strings.
-    // If we arrive here maybe we really wanted to call the unsigned int function.
-    // This is as ugly as it can get: consider modifying this
-    const std::string temporaryString((char*)value.data(), value.size());
-    write(timestamp, temporaryString);
-}
-
-void PVBaseOutImpl::write(const timespec& /* pTimestamp */, const std::vector<std::int32_t>& /* value */)
-{
-    throw;
-}
-
-void PVBaseOutImpl::write(const timespec& /* pTimestamp */, const std::vector<double>& /* value */)
-{
-    throw;
-}
-
-void PVBaseOutImpl::write(const timespec& /* pTimestamp */, const std::string& /* value */)
-{
-    throw;
-}
-
 dataDirection_t PVBaseOutImpl::getDataDirection() const
 {
     return dataDirection_t::output;
@@ -174,20 +76,20 @@ std::string PVBaseOutImpl::buildFullExternalName(const FactoryBaseImpl& controlS
     {
         if(bStopAtPort)
         {
-            return temporaryPointer->buildFullExternalNameFromPort(controlSystem);
+            return temporaryPointer->getFullExternalNameFromPort();
         }
         else
         {
-            return temporaryPointer->buildFullExternalName(controlSystem);
+            return temporaryPointer->getFullExternalName();
         }
     }
 
     if(bStopAtPort)
     {
-        return temporaryPointer->buildFullExternalNameFromPort(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+        return temporaryPointer->getFullExternalNameFromPort() + controlSystem.getSeparator(m_nodeLevel) + name;
     }
 
-    return temporaryPointer->buildFullExternalName(controlSystem) + controlSystem.getSeparator(m_nodeLevel) + name;
+    return temporaryPointer->getFullExternalName() + controlSystem.getSeparator(m_nodeLevel) + name;
 }
 
 
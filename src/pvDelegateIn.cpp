@@ -35,6 +35,14 @@ template class PVDelegateIn<std::vector<std::uint8_t> >;
 template class PVDelegateIn<std::vector<std::int32_t> >;
 template class PVDelegateIn<std::vector<double> >;
 template class PVDelegateIn<std::string>;
+template class PVDelegateIn<std::int16_t>;
+template class PVDelegateIn<std::uint16_t>;
+template class PVDelegateIn<std::int64_t>;
+template class PVDelegateIn<float>;
+template class PVDelegateIn<std::vector<std::int16_t> >;
+template class PVDelegateIn<std::vector<std::uint16_t> >;
+template class PVDelegateIn<std::vector<std::int64_t> >;
+template class PVDelegateIn<std::vector<float> >;
 
 
 }
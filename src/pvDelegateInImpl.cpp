@@ -31,7 +31,31 @@ PVDelegateInImpl<T>::PVDelegateInImpl(const std::string& name, read_t readFuncti
 template <typename T>
 void PVDelegateInImpl<T>::read(timespec* pTimestamp, T* pValue) const
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics == 0)
+    {
+        m_reader(pTimestamp, pValue);
+        return;
+    }
+    const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
     m_reader(pTimestamp, pValue);
+    pStatistics->addDelegateRead(PVStatistics::getMonotonicNanoseconds() - startTime);
+}
+
+
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+template <typename T>
+void PVDelegateInImpl<T>::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        PVBaseInImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<T>());
 }
 
 
@@ -55,6 +79,14 @@ template class PVDelegateInImpl<std::vector<std::uint8_t> >;
 template class PVDelegateInImpl<std::vector<std::int32_t> >;
 template class PVDelegateInImpl<std::vector<double> >;
 template class PVDelegateInImpl<std::string>;
+template class PVDelegateInImpl<std::int16_t>;
+template class PVDelegateInImpl<std::uint16_t>;
+template class PVDelegateInImpl<std::int64_t>;
+template class PVDelegateInImpl<float>;
+template class PVDelegateInImpl<std::vector<std::int16_t> >;
+template class PVDelegateInImpl<std::vector<std::uint16_t> >;
+template class PVDelegateInImpl<std::vector<std::int64_t> >;
+template class PVDelegateInImpl<std::vector<float> >;
 
 }
 
@@ -45,6 +45,14 @@ template class PVDelegateOut<std::vector<std::uint8_t> >;
 template class PVDelegateOut<std::vector<std::int32_t> >;
 template class PVDelegateOut<std::vector<double> >;
 template class PVDelegateOut<std::string>;
+template class PVDelegateOut<std::int16_t>;
+template class PVDelegateOut<std::uint16_t>;
+template class PVDelegateOut<std::int64_t>;
+template class PVDelegateOut<float>;
+template class PVDelegateOut<std::vector<std::int16_t> >;
+template class PVDelegateOut<std::vector<std::uint16_t> >;
+template class PVDelegateOut<std::vector<std::int64_t> >;
+template class PVDelegateOut<std::vector<float> >;
 
 
 }
@@ -50,7 +50,15 @@ PVDelegateOutImpl<T>::PVDelegateOutImpl(const std::string& name, write_t writeFu
 template <typename T>
 void PVDelegateOutImpl<T>::read(timespec* pTimestamp, T* pValue) const
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics == 0)
+    {
+        m_initializer(pTimestamp, pValue);
+        return;
+    }
+    const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
     m_initializer(pTimestamp, pValue);
+    pStatistics->addDelegateRead(PVStatistics::getMonotonicNanoseconds() - startTime);
 }
 
 
@@ -61,7 +69,47 @@ void PVDelegateOutImpl<T>::read(timespec* pTimestamp, T* pValue) const
 template <typename T>
 void PVDelegateOutImpl<T>::write(const timespec& timestamp, const T& value)
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics == 0)
+    {
+        m_writer(timestamp, value);
+        return;
+    }
+    const std::uint64_t startTime(PVStatistics::getMonotonicNanoseconds());
     m_writer(timestamp, value);
+    pStatistics->addDelegateWrite(PVStatistics::getMonotonicNanoseconds() - startTime);
+}
+
+
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+template <typename T>
+void PVDelegateOutImpl<T>::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        PVBaseOutImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<T>());
+}
+
+
+/*
+ * Pass the values of the PV's data type to write()
+ *
+ **************************************************/
+template <typename T>
+void PVDelegateOutImpl<T>::writeValue(const timespec& timestamp, const ConstTypedSpan& value)
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        PVBaseOutImpl::writeValue(timestamp, value);
+        return;
+    }
+    write(timestamp, *value.get<const T>());
 }
 
 
@@ -96,6 +144,14 @@ template class PVDelegateOutImpl<std::vector<std::uint8_t> >;
 template class PVDelegateOutImpl<std::vector<std::int32_t> >;
 template class PVDelegateOutImpl<std::vector<double> >;
 template class PVDelegateOutImpl<std::string>;
+template class PVDelegateOutImpl<std::int16_t>;
+template class PVDelegateOutImpl<std::uint16_t>;
+template class PVDelegateOutImpl<std::int64_t>;
+template class PVDelegateOutImpl<float>;
+template class PVDelegateOutImpl<std::vector<std::int16_t> >;
+template class PVDelegateOutImpl<std::vector<std::uint16_t> >;
+template class PVDelegateOutImpl<std::vector<std::int64_t> >;
+template class PVDelegateOutImpl<std::vector<float> >;
 
 }
 
@@ -0,0 +1,114 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "nds3/pvHistoryIn.h"
+#include "nds3/impl/pvHistoryInImpl.h"
+
+namespace nds
+{
+
+/*
+ * Default constructor
+ *
+ *********************/
+template <typename T>
+PVHistoryIn<T>::PVHistoryIn()
+{
+
+}
+
+
+/*
+ * Constructor
+ *
+ *************/
+template <typename T>
+PVHistoryIn<T>::PVHistoryIn(const std::string& name, const size_t historySize):
+    PVBaseIn(std::shared_ptr<PVBaseInImpl>(new PVHistoryInImpl<T>(name, historySize)))
+{}
+
+
+/*
+ * Store a value in the history
+ *
+ ******************************/
+template <typename T>
+void PVHistoryIn<T>::setValue(const T& value)
+{
+    std::static_pointer_cast<PVHistoryInImpl<T> >(m_pImplementation)->setValue(value);
+}
+
+
+/*
+ * Store a value and its timestamp in the history
+ *
+ ************************************************/
+template <typename T>
+void PVHistoryIn<T>::setValue(const timespec& timestamp, const T& value)
+{
+    std::static_pointer_cast<PVHistoryInImpl<T> >(m_pImplementation)->setValue(timestamp, value);
+}
+
+
+/*
+ * Retrieve the most recent values
+ *
+ *********************************/
+template <typename T>
+size_t PVHistoryIn<T>::getLast(const size_t maxValues, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const
+{
+    return std::static_pointer_cast<PVHistoryInImpl<T> >(m_pImplementation)->getLast(maxValues, pTimestamps, pValues);
+}
+
+
+/*
+ * Retrieve the values stored after a timestamp
+ *
+ **********************************************/
+template <typename T>
+size_t PVHistoryIn<T>::getSince(const timespec& since, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const
+{
+    return std::static_pointer_cast<PVHistoryInImpl<T> >(m_pImplementation)->getSince(since, pTimestamps, pValues);
+}
+
+
+/*
+ * Return the size of the history
+ *
+ ********************************/
+template <typename T>
+size_t PVHistoryIn<T>::getHistorySize() const
+{
+    return std::static_pointer_cast<PVHistoryInImpl<T> >(m_pImplementation)->getHistorySize();
+}
+
+
+// Instantiate all the needed data types
+////////////////////////////////////////
+template class PVHistoryIn<std::int32_t>;
+template class PVHistoryIn<double>;
+template class PVHistoryIn<std::vector<std::int8_t> >;
+template class PVHistoryIn<std::vector<std::uint8_t> >;
+template class PVHistoryIn<std::vector<std::int32_t> >;
+template class PVHistoryIn<std::vector<double> >;
+template class PVHistoryIn<std::string>;
+template class PVHistoryIn<std::int16_t>;
+template class PVHistoryIn<std::uint16_t>;
+template class PVHistoryIn<std::int64_t>;
+template class PVHistoryIn<float>;
+template class PVHistoryIn<std::vector<std::int16_t> >;
+template class PVHistoryIn<std::vector<std::uint16_t> >;
+template class PVHistoryIn<std::vector<std::int64_t> >;
+template class PVHistoryIn<std::vector<float> >;
+
+
+}
@@ -0,0 +1,350 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#include "nds3/impl/pvHistoryInImpl.h"
+#include "nds3/impl/pvBaseOutImpl.h"
+
+namespace nds
+{
+
+/*
+ * Round the history size up to a power of 2, so the position of a
+ *  sample in the ring is obtained with a mask
+ *
+ *****************************************************************/
+static size_t roundHistorySize(const size_t historySize)
+{
+    if(historySize == 0)
+    {
+        throw std::logic_error("The history of a PV must contain at least one sample");
+    }
+
+    size_t roundedSize(1);
+    while(roundedSize < historySize)
+    {
+        roundedSize <<= 1;
+    }
+    return roundedSize;
+}
+
+
+/*
+ * Constructor
+ *
+ *************/
+template <typename T>
+PVHistoryInImpl<T>::PVHistoryInImpl(const std::string& name, const size_t historySize):
+    PVBaseInImpl(name, inputPvType_t::generic),
+    m_historySize(roundHistorySize(historySize)),
+    m_positionMask(m_historySize - 1),
+    m_pSlots(0),
+    m_writePosition(0)
+{
+    // Align the ring on the cache lines
+    ////////////////////////////////////
+    void* pMemory(0);
+    if(::posix_memalign(&pMemory, alignof(HistorySlot<T>), m_historySize * sizeof(HistorySlot<T>)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    m_pSlots = (HistorySlot<T>*)pMemory;
+    for(size_t scanSlots(0); scanSlots != m_historySize; ++scanSlots)
+    {
+        new (m_pSlots + scanSlots) HistorySlot<T>();
+    }
+}
+
+
+/*
+ * Destructor
+ *
+ ************/
+template <typename T>
+PVHistoryInImpl<T>::~PVHistoryInImpl()
+{
+    for(size_t scanSlots(0); scanSlots != m_historySize; ++scanSlots)
+    {
+        m_pSlots[scanSlots].~HistorySlot<T>();
+    }
+    ::free(m_pSlots);
+}
+
+
+/*
+ * Called by the control system to read the last stored value
+ *
+ *************************************************************/
+template <typename T>
+void PVHistoryInImpl<T>::read(timespec* pTimestamp, T* pValue) const
+{
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addRead();
+    }
+
+    // Retry if the writer overwrites the sample while it is being copied
+    /////////////////////////////////////////////////////////////////////
+    for(;;)
+    {
+        std::uint64_t writePosition(m_writePosition.load(std::memory_order_acquire));
+        if(writePosition == 0)
+        {
+            *pValue = T();
+            pTimestamp->tv_sec = 0;
+            pTimestamp->tv_nsec = 0;
+            return;
+        }
+        if(readSample(writePosition - 1, pTimestamp, pValue))
+        {
+            return;
+        }
+    }
+}
+
+
+/*
+ * Store a new value and its timestamp in the history
+ *
+ ****************************************************/
+template <typename T>
+void PVHistoryInImpl<T>::setValue(const timespec& timestamp, const T& value)
+{
+    {
+        // Store the value: the odd sequence number tells the readers
+        //  that the slot is being modified
+        /////////////////////////////////////////////////////////////
+        std::uint64_t writePosition(m_writePosition.load(std::memory_order_relaxed));
+        HistorySlot<T>& slot(m_pSlots[writePosition & m_positionMask]);
+
+        slot.m_sequence.store(writePosition * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.m_seconds.store((std::int64_t)timestamp.tv_sec, std::memory_order_relaxed);
+        slot.m_nanoseconds.store((std::int64_t)timestamp.tv_nsec, std::memory_order_relaxed);
+        slot.m_value.store(value);
+
+        slot.m_sequence.store(writePosition * 2 + 2, std::memory_order_release);
+        m_writePosition.store(writePosition + 1, std::memory_order_release);
+    }
+
+    // Push the value to the outputs
+    ////////////////////////////////
+    typename subscribersList_t::Reader outputs(m_subscriberOutputPVs);
+    for(typename subscribersList_t::list_t::const_iterator scanOutputs(outputs.begin()), endOutputs(outputs.end());
+        scanOutputs != endOutputs;
+        ++scanOutputs)
+    {
+        (*scanOutputs)->write(timestamp, value);
+    }
+}
+
+
+/*
+ * Store a new value in the history
+ *
+ **********************************/
+template <typename T>
+void PVHistoryInImpl<T>::setValue(const T& value)
+{
+    setValue(getTimestamp(), value);
+}
+
+
+/*
+ * Copy the most recent samples
+ *
+ ******************************/
+template <typename T>
+size_t PVHistoryInImpl<T>::getLast(const size_t maxSamples, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const
+{
+    std::uint64_t endPosition(m_writePosition.load(std::memory_order_acquire));
+
+    std::uint64_t numSamples(maxSamples);
+    if(numSamples > m_historySize)
+    {
+        numSamples = m_historySize;
+    }
+    if(numSamples > endPosition)
+    {
+        numSamples = endPosition;
+    }
+
+    return copySamples(endPosition - numSamples, endPosition, pTimestamps, pValues);
+}
+
+
+/*
+ * Copy the samples stored after the specified timestamp
+ *
+ *******************************************************/
+template <typename T>
+size_t PVHistoryInImpl<T>::getSince(const timespec& since, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const
+{
+    std::uint64_t endPosition(m_writePosition.load(std::memory_order_acquire));
+    std::uint64_t oldestPosition(endPosition > m_historySize ? endPosition - m_historySize : 0);
+
+    // Look for the oldest sample newer than since. A sample overwritten
+    //  during the scan is older than all the ones still in the history
+    ////////////////////////////////////////////////////////////////////
+    std::uint64_t firstPosition(endPosition);
+    for(; firstPosition != oldestPosition; --firstPosition)
+    {
+        timespec timestamp;
+        if(!readTimestamp(firstPosition - 1, &timestamp))
+        {
+            break;
+        }
+        if(timestamp.tv_sec < since.tv_sec ||
+           (timestamp.tv_sec == since.tv_sec && timestamp.tv_nsec <= since.tv_nsec))
+        {
+            break;
+        }
+    }
+
+    return copySamples(firstPosition, endPosition, pTimestamps, pValues);
+}
+
+
+/*
+ * Return the number of samples in the ring
+ *
+ ******************************************/
+template <typename T>
+size_t PVHistoryInImpl<T>::getHistorySize() const
+{
+    return m_historySize;
+}
+
+
+/*
+ * Copy a range of samples, skipping the ones overwritten by
+ *  the writer in the meantime
+ *
+ ***********************************************************/
+template <typename T>
+size_t PVHistoryInImpl<T>::copySamples(const std::uint64_t firstPosition, const std::uint64_t endPosition, std::vector<timespec>* pTimestamps, std::vector<T>* pValues) const
+{
+    pTimestamps->resize((size_t)(endPosition - firstPosition));
+    pValues->resize((size_t)(endPosition - firstPosition));
+
+    size_t copiedSamples(0);
+    for(std::uint64_t scanPositions(firstPosition); scanPositions != endPosition; ++scanPositions)
+    {
+        if(readSample(scanPositions, &((*pTimestamps)[copiedSamples]), &((*pValues)[copiedSamples])))
+        {
+            ++copiedSamples;
+        }
+    }
+
+    pTimestamps->resize(copiedSamples);
+    pValues->resize(copiedSamples);
+    return copiedSamples;
+}
+
+
+/*
+ * Copy a sample and check that the writer did not modify it
+ *  during the copy
+ *
+ ***********************************************************/
+template <typename T>
+bool PVHistoryInImpl<T>::readSample(const std::uint64_t position, timespec* pTimestamp, T* pValue) const
+{
+    const HistorySlot<T>& slot(m_pSlots[position & m_positionMask]);
+
+    const std::uint64_t sequence(slot.m_sequence.load(std::memory_order_acquire));
+    if(sequence != position * 2 + 2)
+    {
+        return false;
+    }
+
+    pTimestamp->tv_sec = (time_t)slot.m_seconds.load(std::memory_order_relaxed);
+    pTimestamp->tv_nsec = (long)slot.m_nanoseconds.load(std::memory_order_relaxed);
+    slot.m_value.load(pValue);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.m_sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+
+/*
+ * Copy the timestamp of a sample and check that the writer did
+ *  not modify it during the copy
+ *
+ **************************************************************/
+template <typename T>
+bool PVHistoryInImpl<T>::readTimestamp(const std::uint64_t position, timespec* pTimestamp) const
+{
+    const HistorySlot<T>& slot(m_pSlots[position & m_positionMask]);
+
+    const std::uint64_t sequence(slot.m_sequence.load(std::memory_order_acquire));
+    if(sequence != position * 2 + 2)
+    {
+        return false;
+    }
+
+    pTimestamp->tv_sec = (time_t)slot.m_seconds.load(std::memory_order_relaxed);
+    pTimestamp->tv_nsec = (long)slot.m_nanoseconds.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.m_sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+template <typename T>
+void PVHistoryInImpl<T>::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        PVBaseInImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<T>());
+}
+
+
+/*
+ * Return the PV's data type
+ *
+ ***************************/
+template <typename T>
+dataType_t PVHistoryInImpl<T>::getDataType() const
+{
+    return getDataTypeForCPPType<T>();
+}
+
+
+// Instantiate all the needed data types
+////////////////////////////////////////
+template class PVHistoryInImpl<std::int32_t>;
+template class PVHistoryInImpl<double>;
+template class PVHistoryInImpl<std::vector<std::int8_t> >;
+template class PVHistoryInImpl<std::vector<std::uint8_t> >;
+template class PVHistoryInImpl<std::vector<std::int32_t> >;
+template class PVHistoryInImpl<std::vector<double> >;
+template class PVHistoryInImpl<std::string>;
+template class PVHistoryInImpl<std::int16_t>;
+template class PVHistoryInImpl<std::uint16_t>;
+template class PVHistoryInImpl<std::int64_t>;
+template class PVHistoryInImpl<float>;
+template class PVHistoryInImpl<std::vector<std::int16_t> >;
+template class PVHistoryInImpl<std::vector<std::uint16_t> >;
+template class PVHistoryInImpl<std::vector<std::int64_t> >;
+template class PVHistoryInImpl<std::vector<float> >;
+
+}
@@ -0,0 +1,186 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <sstream>
+#include <time.h>
+
+#include "nds3/impl/pvStatisticsImpl.h"
+
+namespace nds
+{
+
+/*
+ * Upper limit of the first histogram bucket, in nanoseconds
+ *
+ ***********************************************************/
+static const std::uint64_t m_firstBucketLimit(256);
+
+LatencyHistogram::LatencyHistogram(): m_count(0), m_totalNanoseconds(0), m_maxNanoseconds(0)
+{
+    for(size_t scanBuckets(0); scanBuckets != m_numBuckets; ++scanBuckets)
+    {
+        m_buckets[scanBuckets].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::addSample(const std::uint64_t nanoseconds)
+{
+    size_t bucket(0);
+    for(std::uint64_t limit(m_firstBucketLimit); nanoseconds >= limit && bucket != m_numBuckets - 1; limit <<= 1)
+    {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    std::uint64_t maxNanoseconds(m_maxNanoseconds.load(std::memory_order_relaxed));
+    while(nanoseconds > maxNanoseconds &&
+          !m_maxNanoseconds.compare_exchange_weak(maxNanoseconds, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+std::string LatencyHistogram::describe() const
+{
+    const std::uint64_t count(getCount());
+
+    std::ostringstream description;
+    description << "count=" << count
+                << " meanNs=" << (count == 0 ? 0 : m_totalNanoseconds.load(std::memory_order_relaxed) / count)
+                << " maxNs=" << m_maxNanoseconds.load(std::memory_order_relaxed);
+
+    std::uint64_t limit(m_firstBucketLimit);
+    for(size_t scanBuckets(0); scanBuckets != m_numBuckets; ++scanBuckets, limit <<= 1)
+    {
+        const std::uint64_t bucketCount(m_buckets[scanBuckets].load(std::memory_order_relaxed));
+        if(bucketCount == 0)
+        {
+            continue;
+        }
+        if(scanBuckets == m_numBuckets - 1)
+        {
+            description << " >=" << (limit >> 1) << "ns:" << bucketCount;
+        }
+        else
+        {
+            description << " <" << limit << "ns:" << bucketCount;
+        }
+    }
+    return description.str();
+}
+
+
+PVStatistics::PVStatistics(): m_pushes(0), m_decimatedSamples(0), m_reads(0), m_writes(0),
+    m_lastTime(getMonotonicNanoseconds()), m_lastPushes(0), m_lastReads(0), m_lastWrites(0)
+{
+}
+
+void PVStatistics::addPushes(const std::uint64_t pushes)
+{
+    m_pushes.fetch_add(pushes, std::memory_order_relaxed);
+}
+
+void PVStatistics::addDecimatedSamples(const std::uint64_t samples)
+{
+    m_decimatedSamples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void PVStatistics::addInterfacePush(const std::uint64_t nanoseconds)
+{
+    m_interfacePushTime.addSample(nanoseconds);
+}
+
+void PVStatistics::addRead()
+{
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PVStatistics::addDelegateRead(const std::uint64_t nanoseconds)
+{
+    addRead();
+    m_delegateReadTime.addSample(nanoseconds);
+}
+
+void PVStatistics::addWrite()
+{
+    m_writes.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PVStatistics::addDelegateWrite(const std::uint64_t nanoseconds)
+{
+    addWrite();
+    m_delegateWriteTime.addSample(nanoseconds);
+}
+
+/*
+ * Calculate a rate per second
+ *
+ *****************************/
+static double getRate(const std::uint64_t events, const std::uint64_t nanoseconds)
+{
+    if(nanoseconds == 0)
+    {
+        return 0;
+    }
+    return (double)events * 1000000000.0 / (double)nanoseconds;
+}
+
+void PVStatistics::getStatistics(const std::string& pvName, parameters_t* pStatistics)
+{
+    const std::uint64_t pushes(m_pushes.load(std::memory_order_relaxed));
+    const std::uint64_t reads(m_reads.load(std::memory_order_relaxed));
+    const std::uint64_t writes(m_writes.load(std::memory_order_relaxed));
+    const std::uint64_t now(getMonotonicNanoseconds());
+
+    std::ostringstream counters;
+    {
+        std::lock_guard<std::mutex> lock(m_lockRates);
+        const std::uint64_t elapsed(now - m_lastTime);
+
+        counters << pvName
+                 << " pushes=" << pushes << " pushesPerSecond=" << getRate(pushes - m_lastPushes, elapsed)
+                 << " decimated=" << m_decimatedSamples.load(std::memory_order_relaxed)
+                 << " reads=" << reads << " readsPerSecond=" << getRate(reads - m_lastReads, elapsed)
+                 << " writes=" << writes << " writesPerSecond=" << getRate(writes - m_lastWrites, elapsed);
+
+        m_lastTime = now;
+        m_lastPushes = pushes;
+        m_lastReads = reads;
+        m_lastWrites = writes;
+    }
+    pStatistics->push_back(counters.str());
+
+    if(m_interfacePushTime.getCount() != 0)
+    {
+        pStatistics->push_back(pvName + " interfacePush " + m_interfacePushTime.describe());
+    }
+    if(m_delegateReadTime.getCount() != 0)
+    {
+        pStatistics->push_back(pvName + " delegateRead " + m_delegateReadTime.describe());
+    }
+    if(m_delegateWriteTime.getCount() != 0)
+    {
+        pStatistics->push_back(pvName + " delegateWrite " + m_delegateWriteTime.describe());
+    }
+}
+
+std::uint64_t PVStatistics::getMonotonicNanoseconds()
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return (std::uint64_t)now.tv_sec * 1000000000 + (std::uint64_t)now.tv_nsec;
+}
+
+}
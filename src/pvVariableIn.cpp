@@ -68,6 +68,14 @@ template class PVVariableIn<std::vector<std::uint8_t> >;
 template class PVVariableIn<std::vector<std::int32_t> >;
 template class PVVariableIn<std::vector<double> >;
 template class PVVariableIn<std::string>;
+template class PVVariableIn<std::int16_t>;
+template class PVVariableIn<std::uint16_t>;
+template class PVVariableIn<std::int64_t>;
+template class PVVariableIn<float>;
+template class PVVariableIn<std::vector<std::int16_t> >;
+template class PVVariableIn<std::vector<std::uint16_t> >;
+template class PVVariableIn<std::vector<std::int64_t> >;
+template class PVVariableIn<std::vector<float> >;
 
 
 }
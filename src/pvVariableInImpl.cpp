@@ -33,6 +33,12 @@ PVVariableInImpl<T>::PVVariableInImpl(const std::string& name, const inputPvType
 template <typename T>
 void PVVariableInImpl<T>::read(timespec* pTimestamp, T* pValue) const
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addRead();
+    }
+
     std::unique_lock<std::mutex> lock(m_pvMutex);
     *pValue = m_value;
     *pTimestamp = m_timestamp;
@@ -56,8 +62,8 @@ void PVVariableInImpl<T>::setValue(const timespec& timestamp, const T& value)
 
     // Push the value to the outputs
     ////////////////////////////////
-    std::lock_guard<std::mutex> lock(m_lockSubscribersList);
-    for(subscribersList_t::iterator scanOutputs(m_subscriberOutputPVs.begin()), endOutputs(m_subscriberOutputPVs.end());
+    typename subscribersList_t::Reader outputs(m_subscriberOutputPVs);
+    for(typename subscribersList_t::list_t::const_iterator scanOutputs(outputs.begin()), endOutputs(outputs.end());
         scanOutputs != endOutputs;
         ++scanOutputs)
     {
@@ -77,6 +83,37 @@ void PVVariableInImpl<T>::setValue(const T& value)
 }
 
 
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+template <typename T>
+void PVVariableInImpl<T>::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        // The string is copied directly into the array of uint8
+        /////////////////////////////////////////////////////////
+        if(getDataTypeForCPPType<T>() == dataType_t::dataString && value.getDataType() == dataType_t::dataUint8Array)
+        {
+            PVStatistics* pStatistics(getStatistics());
+            if(pStatistics != 0)
+            {
+                pStatistics->addRead();
+            }
+
+            std::unique_lock<std::mutex> lock(m_pvMutex);
+            copyStringBytes(m_value, value);
+            *pTimestamp = m_timestamp;
+            return;
+        }
+        PVBaseInImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<T>());
+}
+
+
 /*
  * Return the PV's data type
  *
@@ -97,5 +134,13 @@ template class PVVariableInImpl<std::vector<std::uint8_t> >;
 template class PVVariableInImpl<std::vector<std::int32_t> >;
 template class PVVariableInImpl<std::vector<double> >;
 template class PVVariableInImpl<std::string>;
+template class PVVariableInImpl<std::int16_t>;
+template class PVVariableInImpl<std::uint16_t>;
+template class PVVariableInImpl<std::int64_t>;
+template class PVVariableInImpl<float>;
+template class PVVariableInImpl<std::vector<std::int16_t> >;
+template class PVVariableInImpl<std::vector<std::uint16_t> >;
+template class PVVariableInImpl<std::vector<std::int64_t> >;
+template class PVVariableInImpl<std::vector<float> >;
 
 }
@@ -67,6 +67,14 @@ template class PVVariableOut<std::vector<std::uint8_t> >;
 template class PVVariableOut<std::vector<std::int32_t> >;
 template class PVVariableOut<std::vector<double> >;
 template class PVVariableOut<std::string>;
+template class PVVariableOut<std::int16_t>;
+template class PVVariableOut<std::uint16_t>;
+template class PVVariableOut<std::int64_t>;
+template class PVVariableOut<float>;
+template class PVVariableOut<std::vector<std::int16_t> >;
+template class PVVariableOut<std::vector<std::uint16_t> >;
+template class PVVariableOut<std::vector<std::int64_t> >;
+template class PVVariableOut<std::vector<float> >;
 
 
 }
@@ -32,6 +32,12 @@ PVVariableOutImpl<T>::PVVariableOutImpl(const std::string& name, const outputPvT
 template <typename T>
 void PVVariableOutImpl<T>::read(timespec* pTimestamp, T* pValue) const
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addRead();
+    }
+
     std::unique_lock<std::mutex> lock(m_pvMutex);
     *pValue = m_value;
     *pTimestamp = m_timestamp;
@@ -45,12 +51,80 @@ void PVVariableOutImpl<T>::read(timespec* pTimestamp, T* pValue) const
 template <typename T>
 void PVVariableOutImpl<T>::write(const timespec& timestamp, const T& value)
 {
+    PVStatistics* pStatistics(getStatistics());
+    if(pStatistics != 0)
+    {
+        pStatistics->addWrite();
+    }
+
     std::unique_lock<std::mutex> lock(m_pvMutex);
     m_value =value;
     m_timestamp = timestamp;
 }
 
 
+/*
+ * Pass the values of the PV's data type to read()
+ *
+ *************************************************/
+template <typename T>
+void PVVariableOutImpl<T>::readValue(timespec* pTimestamp, const TypedSpan& value) const
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        // The string is copied directly into the array of uint8
+        /////////////////////////////////////////////////////////
+        if(getDataTypeForCPPType<T>() == dataType_t::dataString && value.getDataType() == dataType_t::dataUint8Array)
+        {
+            PVStatistics* pStatistics(getStatistics());
+            if(pStatistics != 0)
+            {
+                pStatistics->addRead();
+            }
+
+            std::unique_lock<std::mutex> lock(m_pvMutex);
+            copyStringBytes(m_value, value);
+            *pTimestamp = m_timestamp;
+            return;
+        }
+        PVBaseOutImpl::readValue(pTimestamp, value);
+        return;
+    }
+    read(pTimestamp, value.get<T>());
+}
+
+
+/*
+ * Pass the values of the PV's data type to write()
+ *
+ **************************************************/
+template <typename T>
+void PVVariableOutImpl<T>::writeValue(const timespec& timestamp, const ConstTypedSpan& value)
+{
+    if(value.getDataType() != getDataTypeForCPPType<T>())
+    {
+        // The array of uint8 is assigned directly to the stored string
+        ////////////////////////////////////////////////////////////////
+        if(getDataTypeForCPPType<T>() == dataType_t::dataString && value.getDataType() == dataType_t::dataUint8Array)
+        {
+            PVStatistics* pStatistics(getStatistics());
+            if(pStatistics != 0)
+            {
+                pStatistics->addWrite();
+            }
+
+            std::unique_lock<std::mutex> lock(m_pvMutex);
+            assignStringBytes(value, &m_value);
+            m_timestamp = timestamp;
+            return;
+        }
+        PVBaseOutImpl::writeValue(timestamp, value);
+        return;
+    }
+    write(timestamp, *value.get<const T>());
+}
+
+
 /*
  * Returns the PV data type
  *
@@ -96,6 +170,14 @@ template class PVVariableOutImpl<std::vector<std::uint8_t> >;
 template class PVVariableOutImpl<std::vector<std::int32_t> >;
 template class PVVariableOutImpl<std::vector<double> >;
 template class PVVariableOutImpl<std::string>;
+template class PVVariableOutImpl<std::int16_t>;
+template class PVVariableOutImpl<std::uint16_t>;
+template class PVVariableOutImpl<std::int64_t>;
+template class PVVariableOutImpl<float>;
+template class PVVariableOutImpl<std::vector<std::int16_t> >;
+template class PVVariableOutImpl<std::vector<std::uint16_t> >;
+template class PVVariableOutImpl<std::vector<std::int64_t> >;
+template class PVVariableOutImpl<std::vector<float> >;
 
 }
 
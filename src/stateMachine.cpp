@@ -48,9 +48,9 @@ StateMachine::StateMachine(bool bAsync,
  * Change the local state
  *
  ************************/
-void StateMachine::setState(state_t newState)
+std::future<state_t> StateMachine::setState(state_t newState)
 {
-    std::static_pointer_cast<StateMachineImpl>(m_pImplementation)->setState(newState);
+    return std::static_pointer_cast<StateMachineImpl>(m_pImplementation)->setState(newState);
 }
 
 
@@ -16,17 +16,11 @@
 #include "nds3/impl/pvDelegateOutImpl.h"
 #include "nds3/impl/pvDelegateInImpl.h"
 #include "nds3/impl/pvBaseImpl.h"
+#include "nds3/impl/portImpl.h"
 
 namespace nds
 {
 
-/* The state change mutex is the same across all the state machines.
- * This allows to read consistent states across the hierarchical state
- * machine
- */
-std::recursive_mutex m_stateMutex;
-
-
 /*
  * Constructor
  *
@@ -39,6 +33,8 @@ StateMachineImpl::StateMachineImpl(bool bAsync,
                                    stateChange_t recoverFunction,
                                    allowChange_t allowStateChangeFunction): NodeImpl("StateMachine", nodeType_t::stateMachine),
             m_bAsync(bAsync),
+            m_bExecutingTransitions(false),
+            m_queuedState(state_t::off),
             m_localState(state_t::off),
             m_switchOn(switchOnFunction), m_switchOff(switchOffFunction), m_start(startFunction), m_stop(stopFunction), m_recover(recoverFunction),
             m_allowChange(allowStateChangeFunction)
@@ -71,13 +67,14 @@ StateMachineImpl::StateMachineImpl(bool bAsync,
     m_pGetStatePV->processAtInit(true);
     addChild(m_pGetStatePV);
 
-    std::shared_ptr<PVDelegateInImpl<std::int32_t> > pGetGlobalStatePV(
+    m_pGetGlobalStatePV.reset(
                 new PVDelegateInImpl<std::int32_t>("getGlobalState",
                                                  std::bind(&StateMachineImpl::readGlobalState, this, std::placeholders::_1, std::placeholders::_2)));
-    pGetGlobalStatePV->setScanType(scanType_t::passive, 0);
-    pGetGlobalStatePV->setEnumeration(enumerationStrings);
-    pGetGlobalStatePV->processAtInit(true);
-    addChild(pGetGlobalStatePV);
+    m_pGetGlobalStatePV->setDescription("Get global state");
+    m_pGetGlobalStatePV->setScanType(scanType_t::interrupt, 0);
+    m_pGetGlobalStatePV->setEnumeration(enumerationStrings);
+    m_pGetGlobalStatePV->processAtInit(true);
+    addChild(m_pGetGlobalStatePV);
 
     // Register state transition commands
     /////////////////////////////////////
@@ -96,11 +93,7 @@ StateMachineImpl::~StateMachineImpl()
 {
     // Wait for pending transitions
     ///////////////////////////////
-    std::lock_guard<std::mutex> lockThread(m_lockTransitionThread);
-    if(m_transitionThread.joinable())
-    {
-        m_transitionThread.join();
-    }
+    waitQueuedTransitions();
 }
 
 
@@ -112,10 +105,42 @@ void StateMachineImpl::initialize(FactoryBaseImpl& controlSystem)
 {
     NodeImpl::initialize(controlSystem);
 
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+        m_localState.store(state_t::off, std::memory_order_release);
+        m_queuedState = state_t::off;
+        m_stateTimestamp = getTimestamp();
+    }
+
+    // The getState PV is registered with the control system when
+    //  the port completes its initialization
+    /////////////////////////////////////////////////////////////
+    getPort()->runAfterRegistration(std::bind(&StateMachineImpl::pushLocalState,
+                                              std::static_pointer_cast<StateMachineImpl>(shared_from_this())));
+}
+
+void StateMachineImpl::pushLocalState()
+{
     std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-    m_localState = state_t::off;
+    m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState.load(std::memory_order_relaxed));
+}
+
+void StateMachineImpl::setLocalState(const state_t state)
+{
+    m_localState.store(state, std::memory_order_release);
     m_stateTimestamp = getTimestamp();
-    m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState);
+    m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)state);
+
+    std::shared_ptr<NodeImpl> pParent(getParent());
+    if(pParent.get() != 0)
+    {
+        pParent->updateContributorState(this, state, m_stateTimestamp);
+    }
+}
+
+void StateMachineImpl::pushGlobalState(const timespec& timestamp, const state_t state)
+{
+    m_pGetGlobalStatePV->push(timestamp, (std::int32_t)state);
 }
 
 
@@ -125,11 +150,7 @@ void StateMachineImpl::initialize(FactoryBaseImpl& controlSystem)
  ********************/
 void StateMachineImpl::deinitialize()
 {
-    std::lock_guard<std::mutex> lockThread(m_lockTransitionThread);
-    if(m_transitionThread.joinable())
-    {
-        m_transitionThread.join();
-    }
+    waitQueuedTransitions();
     NodeImpl::deinitialize();
 }
 
@@ -143,7 +164,6 @@ bool StateMachineImpl::canChange(state_t newState) const
     state_t localState(state_t::unknown), globalState(state_t::unknown);
     {
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        state_t globalState;
         timespec unused;
         getGlobalState(&unused, &globalState);
         localState = getLocalState();
@@ -155,112 +175,290 @@ bool StateMachineImpl::canChange(state_t newState) const
 /*
  * Changes the state. First check if the change is allowed, then execute the
  *  state transition.
- * The state transition may be executed in a secondary thread
+ * Asynchronous state machines queue the transition: it is executed by a
+ *  pooled thread after the transitions requested before it
  *
  ***************************************************************************/
-void StateMachineImpl::setState(const state_t newState)
+std::future<state_t> StateMachineImpl::setState(const state_t newState)
 {
-    state_t localState;
-    state_t globalState;
-    state_t transitionState;
-    stateChange_t transitionFunction;
+    std::shared_ptr<std::promise<state_t> > pResult(std::make_shared<std::promise<state_t> >());
+    std::future<state_t> result(pResult->get_future());
+
+    transitionRequest_t request;
+    request.m_newState = newState;
+    request.m_bPrepared = false;
+    request.m_pResult = pResult;
+
+    if(!m_bAsync)
+    {
+        if(prepareTransition(newState, &request.m_initialState, &request.m_transitionFunction))
+        {
+            executeTransition(request.m_initialState, newState, request.m_transitionFunction);
+        }
+        pResult->set_value(getLocalState());
+        return result;
+    }
+
     {
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        localState = getLocalState();
 
-        // Nothing to do if we are already in the desidered state
-        /////////////////////////////////////////////////////////
-        if(localState == newState)
+        // Nothing to do if the queued transitions already lead to the
+        //  desidered state
+        //////////////////////////////////////////////////////////////
+        if(m_queuedState == newState)
         {
-            return;
+            pResult->set_value(newState);
+            return result;
         }
 
-        timespec unused;
-        getGlobalState(&unused, &globalState);
-
-        // Find the transitional state that we have to set and
-        //  the function to call to perform the transition
-        //////////////////////////////////////////////////////
-        if(localState == state_t::off && newState == state_t::on)
+        if(!m_bExecutingTransitions)
         {
-            transitionFunction = m_switchOn;
-            transitionState = state_t::initializing;
+            // Check the transition now and set the intermediate state, so the
+            //  caller sees the state change immediately
+            //////////////////////////////////////////////////////////////////
+            if(!prepareTransition(newState, &request.m_initialState, &request.m_transitionFunction))
+            {
+                pResult->set_value(newState);
+                return result;
+            }
+            request.m_bPrepared = true;
         }
-        else if(localState == state_t::on && newState == state_t::off)
+        else
         {
-            transitionFunction = m_switchOff;
-            transitionState = state_t::switchingOff;
+            // Checked again when the queued transition is executed
+            ///////////////////////////////////////////////////////
+            stateChange_t unusedFunction;
+            state_t unusedState;
+            if(!getTransition(m_queuedState, newState, &unusedFunction, &unusedState))
+            {
+                std::ostringstream buildErrorMessage;
+                buildErrorMessage << "No transition from state " << getStateName(m_queuedState) << " to state " << getStateName(newState);
+                throw StateMachineNoSuchTransition(buildErrorMessage.str());
+            }
         }
-        else if(localState == state_t::on && newState == state_t::running)
+
+        m_transitionsQueue.push_back(request);
+        m_queuedState = newState;
+        if(m_bExecutingTransitions)
         {
-            transitionFunction = m_start;
-            transitionState = state_t::starting;
+            return result;
         }
-        else if(localState == state_t::running && newState == state_t::on)
+        m_bExecutingTransitions = true;
+    }
+
+    // Launch the pooled thread that executes the queue. The previous one has
+    //  already emptied the queue and is terminating
+    /////////////////////////////////////////////////////////////////////////
+    std::exception_ptr launchError;
+    {
+        std::lock_guard<std::mutex> lockThread(m_lockTransitionThread);
+        if(m_pTransitionThread.get() != 0)
         {
-            transitionFunction = m_stop;
-            transitionState = state_t::stopping;
+            m_pTransitionThread->join();
         }
-        else if(localState == state_t::fault && newState == state_t::off)
+        try
         {
-            transitionFunction = m_recover;
-            transitionState = state_t::switchingOff;
+            m_pTransitionThread.reset(runInThread(getFullName() + "-transition",
+                                                  taskClass_t::stateTransition,
+                                                  std::bind(&StateMachineImpl::executeQueuedTransitions, this)));
         }
-        else
+        catch(...)
         {
-            std::ostringstream buildErrorMessage;
-            buildErrorMessage << "No transition from state " << getStateName(localState) << " to state " << getStateName(newState);
-            throw StateMachineNoSuchTransition(buildErrorMessage.str());
+            launchError = std::current_exception();
         }
+    }
+    if(launchError)
+    {
+        failQueuedTransitions(launchError);
+    }
+    return result;
+}
 
-        // Check if the transition is allowed, then set the intermediate state
-        //////////////////////////////////////////////////////////////////////
-        if(!m_allowChange(localState, globalState, newState))
+
+/*
+ * Called when the thread that executes the queued transitions cannot be
+ *  launched: restore the state set by setState() and fail all the queued
+ *  requests
+ *
+ ************************************************************************/
+void StateMachineImpl::failQueuedTransitions(std::exception_ptr error)
+{
+    transitionsQueue_t failedTransitions;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+        failedTransitions.swap(m_transitionsQueue);
+        if(!failedTransitions.empty() && failedTransitions.front().m_bPrepared)
         {
-            std::ostringstream buildErrorMessage;
-            buildErrorMessage << "The transition from state " << getStateName(localState) << " to state " << getStateName(newState) << " has been denied";
-            throw StateMachineTransitionDenied(buildErrorMessage.str());
+            setLocalState(failedTransitions.front().m_initialState);
         }
+        m_bExecutingTransitions = false;
+        m_queuedState = getLocalState();
+        m_transitionsExecuted.notify_all();
+    }
 
-        // The transition will be executed. Set the intermediate state
-        //////////////////////////////////////////////////////////////
-        m_localState = transitionState;
-        m_stateTimestamp = getTimestamp();
-        m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState);
+    ndsErrorStream(*this) << "Cannot launch the thread that executes the state transitions" << std::endl;
+    for(transitionsQueue_t::iterator scanTransitions(failedTransitions.begin()), endTransitions(failedTransitions.end());
+        scanTransitions != endTransitions;
+        ++scanTransitions)
+    {
+        scanTransitions->m_pResult->set_exception(error);
+    }
+}
+
+
+/*
+ * Find the transition function and set the intermediate state
+ *
+ *************************************************************/
+bool StateMachineImpl::prepareTransition(const state_t newState, state_t* pInitialState, stateChange_t* pTransitionFunction)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+
+    const state_t localState(getLocalState());
+    *pInitialState = localState;
+
+    // Nothing to do if we are already in the desidered state
+    /////////////////////////////////////////////////////////
+    if(localState == newState)
+    {
+        return false;
     }
 
-    // Execute the state transition. Launch a secondary thread if necessary
-    ///////////////////////////////////////////////////////////////////////
-    if(m_bAsync)
+    state_t globalState;
+    timespec unused;
+    getGlobalState(&unused, &globalState);
+
+    state_t transitionState;
+    if(!getTransition(localState, newState, pTransitionFunction, &transitionState))
     {
-        std::lock_guard<std::mutex> lockThread(m_lockTransitionThread);
-        if(m_transitionThread.joinable())
-        {
-            m_transitionThread.join();
-        }
-        m_transitionThread = std::thread(std::bind(&StateMachineImpl::executeTransitionThread, this, localState, newState, transitionFunction));
+        std::ostringstream buildErrorMessage;
+        buildErrorMessage << "No transition from state " << getStateName(localState) << " to state " << getStateName(newState);
+        throw StateMachineNoSuchTransition(buildErrorMessage.str());
     }
-    else
+
+    // Check if the transition is allowed, then set the intermediate state
+    //////////////////////////////////////////////////////////////////////
+    if(!m_allowChange(localState, globalState, newState))
     {
-        executeTransition(localState, newState, transitionFunction);
+        std::ostringstream buildErrorMessage;
+        buildErrorMessage << "The transition from state " << getStateName(localState) << " to state " << getStateName(newState) << " has been denied";
+        throw StateMachineTransitionDenied(buildErrorMessage.str());
     }
+
+    // The transition will be executed. Set the intermediate state
+    //////////////////////////////////////////////////////////////
+    setLocalState(transitionState);
+    return true;
 }
 
 
 /*
- * Execute the state transition in a separate thread
- * Exceptions are caught in the thread and just logged
+ * Find the transitional state that we have to set and
+ *  the function to call to perform the transition
  *
  *****************************************************/
-void StateMachineImpl::executeTransitionThread(const state_t initialState, const state_t finalState, stateChange_t transitionFunction)
+bool StateMachineImpl::getTransition(const state_t initialState, const state_t finalState, stateChange_t* pTransitionFunction, state_t* pTransitionState) const
+{
+    if(initialState == state_t::off && finalState == state_t::on)
+    {
+        *pTransitionFunction = m_switchOn;
+        *pTransitionState = state_t::initializing;
+    }
+    else if(initialState == state_t::on && finalState == state_t::off)
+    {
+        *pTransitionFunction = m_switchOff;
+        *pTransitionState = state_t::switchingOff;
+    }
+    else if(initialState == state_t::on && finalState == state_t::running)
+    {
+        *pTransitionFunction = m_start;
+        *pTransitionState = state_t::starting;
+    }
+    else if(initialState == state_t::running && finalState == state_t::on)
+    {
+        *pTransitionFunction = m_stop;
+        *pTransitionState = state_t::stopping;
+    }
+    else if(initialState == state_t::fault && finalState == state_t::off)
+    {
+        *pTransitionFunction = m_recover;
+        *pTransitionState = state_t::switchingOff;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * Execute the queued transitions in a pooled thread.
+ * Exceptions are logged and passed to the futures returned by setState()
+ *
+ ************************************************************************/
+void StateMachineImpl::executeQueuedTransitions()
+{
+    for(;;)
+    {
+        transitionRequest_t request;
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+            if(m_transitionsQueue.empty())
+            {
+                m_bExecutingTransitions = false;
+                m_queuedState = getLocalState();
+                m_transitionsExecuted.notify_all();
+                return;
+            }
+            request = m_transitionsQueue.front();
+            m_transitionsQueue.pop_front();
+        }
+
+        try
+        {
+            // The transitions queued while another one was executing are
+            //  checked against the state reached by the previous ones
+            //////////////////////////////////////////////////////////////
+            if(request.m_bPrepared ||
+               prepareTransition(request.m_newState, &request.m_initialState, &request.m_transitionFunction))
+            {
+                executeTransition(request.m_initialState, request.m_newState, request.m_transitionFunction);
+            }
+            request.m_pResult->set_value(getLocalState());
+        }
+        catch(const std::runtime_error& e)
+        {
+            ndsErrorStream(*this) << "Error while asyncronously changing the state: " << e.what() << std::endl;
+            request.m_pResult->set_exception(std::current_exception());
+        }
+        catch(...)
+        {
+            request.m_pResult->set_exception(std::current_exception());
+        }
+    }
+}
+
+
+/*
+ * Wait for the queued transitions and for the thread that executes them
+ *
+ ***********************************************************************/
+void StateMachineImpl::waitQueuedTransitions()
 {
-    try
     {
-        executeTransition(initialState, finalState, transitionFunction);
+        std::unique_lock<std::recursive_mutex> lock(m_stateMutex);
+        while(m_bExecutingTransitions)
+        {
+            m_transitionsExecuted.wait(lock);
+        }
     }
-    catch(const std::runtime_error& e)
+
+    std::lock_guard<std::mutex> lockThread(m_lockTransitionThread);
+    if(m_pTransitionThread.get() != 0)
     {
-        ndsErrorStream(*this) << "Error while asyncronously changing the state: " << e.what() << std::endl;
+        m_pTransitionThread->join();
+        m_pTransitionThread.reset();
     }
 }
 
@@ -281,9 +479,7 @@ void StateMachineImpl::executeTransition(const state_t initialState, const state
         ndsInfoStream(*this) << "State switching successful" << std::endl;
 
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        m_localState = finalState;
-        m_stateTimestamp = getTimestamp();
-        m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState);
+        setLocalState(finalState);
     }
     catch(StateMachineRollBack& e)
     {
@@ -293,9 +489,7 @@ void StateMachineImpl::executeTransition(const state_t initialState, const state
         ndsWarningStream(*this) << "Warning: " << e.what() << " - Rolling back to state " << getStateName(initialState) << std::endl;
 
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        m_localState = initialState;
-        m_stateTimestamp = getTimestamp();
-        m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState);
+        setLocalState(initialState);
         throw;
     }
     catch(std::runtime_error& e)
@@ -306,9 +500,7 @@ void StateMachineImpl::executeTransition(const state_t initialState, const state
         ndsErrorStream(*this) << "Error: " << e.what() << " - Switching to state " << getStateName(state_t::fault) << std::endl;
 
         std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-        m_localState = state_t::fault;
-        m_stateTimestamp = getTimestamp();
-        m_pGetStatePV->push(m_stateTimestamp, (std::int32_t)m_localState);
+        setLocalState(state_t::fault);
         throw;
     }
 }
@@ -320,9 +512,14 @@ void StateMachineImpl::executeTransition(const state_t initialState, const state
  ************************/
 state_t StateMachineImpl::getLocalState() const
 {
-    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    return m_localState.load(std::memory_order_acquire);
+}
 
-    return m_localState;
+void StateMachineImpl::getLocalState(timespec* pTimestamp, state_t* pState) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
+    *pTimestamp = m_stateTimestamp;
+    *pState = getLocalState();
 }
 
 
@@ -332,26 +529,13 @@ state_t StateMachineImpl::getLocalState() const
  *************************/
 void StateMachineImpl::getGlobalState(timespec* pTimestamp, state_t* pState) const
 {
-    std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
-
-    *pTimestamp = m_stateTimestamp;
-    *pState = m_localState;
-
     std::shared_ptr<NodeImpl> pParentNode(getParent());
-
-    timespec childrenTimestamp;
-    state_t childrenState;
-    pParentNode->getChildrenState(&childrenTimestamp, &childrenState);
-
-    if(
-            ((int)*pState < (int)childrenState) ||
-            ((int)*pState == (int)childrenState &&
-             (pTimestamp->tv_sec < childrenTimestamp.tv_sec ||
-              (pTimestamp->tv_sec == childrenTimestamp.tv_sec && pTimestamp->tv_nsec < childrenTimestamp.tv_nsec))))
+    if(pParentNode.get() == 0)
     {
-        *pTimestamp = childrenTimestamp;
-        *pState = childrenState;
+        getLocalState(pTimestamp, pState);
+        return;
     }
+    pParentNode->getGlobalState(pTimestamp, pState);
 }
 
 
@@ -393,7 +577,7 @@ void StateMachineImpl::readLocalState(timespec* pTimestamp, std::int32_t* pValue
 {
     std::lock_guard<std::recursive_mutex> lock(m_stateMutex);
     *pTimestamp = m_stateTimestamp;
-    *pValue = (std::int32_t)m_localState;
+    *pValue = (std::int32_t)getLocalState();
 }
 
 
@@ -37,4 +37,9 @@ void Thread::join()
     m_pImplementation->join();
 }
 
+threadAttributes_t Thread::getAppliedAttributes() const
+{
+    return m_pImplementation->getAppliedAttributes();
+}
+
 }
@@ -28,4 +28,9 @@ std::string ThreadBaseImpl::getName() const
     return m_name;
 }
 
+threadAttributes_t ThreadBaseImpl::getAppliedAttributes()
+{
+    return threadAttributes_t();
+}
+
 }
@@ -0,0 +1,575 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <limits.h>
+#include <alloca.h>
+#include <sys/mman.h>
+
+#include "nds3/impl/threadPoolImpl.h"
+
+namespace nds
+{
+
+/*
+ * Maximum length of a thread name accepted by pthread_setname_np()
+ *
+ ******************************************************************/
+static const size_t m_maxThreadNameLength(15);
+
+/*
+ * Part of the stack that is not prefaulted: it is already used by
+ *  the frames of the worker
+ *
+ *****************************************************************/
+static const size_t m_prefaultStackMargin(64 * 1024);
+
+
+ThreadPoolTask::ThreadPoolTask(const std::string& name, const threadAttributes_t& attributes, threadFunction_t function):
+    m_name(name), m_attributes(attributes), m_function(function), m_bStarted(false), m_bFinished(false)
+{
+}
+
+const std::string& ThreadPoolTask::getName() const
+{
+    return m_name;
+}
+
+const threadAttributes_t& ThreadPoolTask::getAttributes() const
+{
+    return m_attributes;
+}
+
+void ThreadPoolTask::run(const threadAttributes_t& appliedAttributes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lockStatus);
+        m_appliedAttributes = appliedAttributes;
+        m_bStarted = true;
+        m_statusCondition.notify_all();
+    }
+
+    m_function();
+
+    // Release the resources bound to the function now: the handle
+    //  may keep the task alive for a long time
+    //////////////////////////////////////////////////////////////
+    m_function = threadFunction_t();
+}
+
+threadAttributes_t ThreadPoolTask::waitAppliedAttributes()
+{
+    std::unique_lock<std::mutex> lock(m_lockStatus);
+    while(!m_bStarted)
+    {
+        m_statusCondition.wait(lock);
+    }
+    return m_appliedAttributes;
+}
+
+void ThreadPoolTask::setFinished()
+{
+    std::lock_guard<std::mutex> lock(m_lockStatus);
+    m_bFinished = true;
+    m_statusCondition.notify_all();
+}
+
+void ThreadPoolTask::waitFinished()
+{
+    std::unique_lock<std::mutex> lock(m_lockStatus);
+    while(!m_bFinished)
+    {
+        m_statusCondition.wait(lock);
+    }
+}
+
+
+ThreadPooled::ThreadPooled(FactoryBaseImpl* pFactory, std::shared_ptr<ThreadPoolTask> pTask):
+    ThreadBaseImpl(pFactory, pTask->getName()), m_pTask(pTask)
+{
+}
+
+void ThreadPooled::join()
+{
+    m_pTask->waitFinished();
+}
+
+threadAttributes_t ThreadPooled::getAppliedAttributes()
+{
+    return m_pTask->waitAppliedAttributes();
+}
+
+
+/*
+ * Set the CPU affinity of the calling thread. Failures leave the
+ *  thread with its current affinity
+ *
+ ****************************************************************/
+static void applyAffinity(const std::vector<size_t>& cpusList)
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for(std::vector<size_t>::const_iterator scanCpus(cpusList.begin()), endCpus(cpusList.end());
+        scanCpus != endCpus;
+        ++scanCpus)
+    {
+        if(*scanCpus < CPU_SETSIZE)
+        {
+            CPU_SET(*scanCpus, &cpus);
+        }
+    }
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+}
+
+/*
+ * Set the scheduling policy and priority of the calling thread.
+ * Failures (e.g. missing CAP_SYS_NICE for the real-time policies)
+ *  leave the thread with its current settings
+ *
+ *****************************************************************/
+static void applyPolicy(const schedulingPolicy_t schedulingPolicy, const int priority)
+{
+    int policy(SCHED_OTHER);
+    switch(schedulingPolicy)
+    {
+    case schedulingPolicy_t::inherit:
+    case schedulingPolicy_t::other:
+        policy = SCHED_OTHER;
+        break;
+    case schedulingPolicy_t::fifo:
+        policy = SCHED_FIFO;
+        break;
+    case schedulingPolicy_t::roundRobin:
+        policy = SCHED_RR;
+        break;
+    }
+
+    sched_param parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    parameters.sched_priority = std::max(::sched_get_priority_min(policy), std::min(::sched_get_priority_max(policy), priority));
+    ::pthread_setschedparam(::pthread_self(), policy, &parameters);
+}
+
+/*
+ * Read the CPU affinity, the scheduling policy and the stack size
+ *  of the calling thread
+ *
+ *****************************************************************/
+static void readScheduling(threadAttributes_t* pAttributes)
+{
+    pAttributes->m_cpus.clear();
+    cpu_set_t cpus;
+    if(::pthread_getaffinity_np(::pthread_self(), sizeof(cpus), &cpus) == 0)
+    {
+        for(size_t cpu(0); cpu != CPU_SETSIZE; ++cpu)
+        {
+            if(CPU_ISSET(cpu, &cpus))
+            {
+                pAttributes->m_cpus.push_back(cpu);
+            }
+        }
+    }
+
+    int policy(SCHED_OTHER);
+    sched_param parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    ::pthread_getschedparam(::pthread_self(), &policy, &parameters);
+    pAttributes->m_policy = policy == SCHED_FIFO ? schedulingPolicy_t::fifo :
+                            (policy == SCHED_RR ? schedulingPolicy_t::roundRobin : schedulingPolicy_t::other);
+    pAttributes->m_priority = parameters.sched_priority;
+
+    pAttributes->m_stackSize = 0;
+    pthread_attr_t threadAttributes;
+    if(::pthread_getattr_np(::pthread_self(), &threadAttributes) == 0)
+    {
+        ::pthread_attr_getstacksize(&threadAttributes, &pAttributes->m_stackSize);
+        ::pthread_attr_destroy(&threadAttributes);
+    }
+}
+
+/*
+ * Touch all the pages of the stack, so the time-critical code
+ *  does not take page faults when the stack grows
+ *
+ *************************************************************/
+static void __attribute__((noinline)) prefaultStack(const size_t stackSize)
+{
+    if(stackSize <= m_prefaultStackMargin)
+    {
+        return;
+    }
+    const size_t prefaultSize(stackSize - m_prefaultStackMargin);
+    const size_t pageSize((size_t)::sysconf(_SC_PAGESIZE));
+
+    volatile char* pStack((volatile char*)alloca(prefaultSize));
+    for(size_t offset(0); offset < prefaultSize; offset += pageSize)
+    {
+        pStack[offset] = 0;
+    }
+}
+
+/*
+ * Lock the process memory. The call is executed only once:
+ *  return true if it succeeded
+ *
+ **********************************************************/
+static bool lockMemory()
+{
+    static std::once_flag lockOnce;
+    static bool bLocked(false);
+    std::call_once(lockOnce, []()
+    {
+        bLocked = ::mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    });
+    return bLocked;
+}
+
+/*
+ * Attributes applied to a worker thread.
+ *
+ * The affinity and the policy are modified only when a task sets them
+ *  explicitly and differ from the ones currently in effect; a task that
+ *  does not set them gets the ones the worker inherited when it started.
+ *
+ ***********************************************************************/
+class WorkerAttributes
+{
+public:
+    WorkerAttributes(): m_bStackPrefaulted(false)
+    {
+        readScheduling(&m_inherited);
+        m_current = m_inherited;
+        m_applied = m_inherited;
+    }
+
+    const threadAttributes_t& apply(const threadAttributes_t& requested)
+    {
+        const std::vector<size_t>& cpus(requested.m_cpus.empty() ? m_inherited.m_cpus : requested.m_cpus);
+        const bool bInheritPolicy(requested.m_policy == schedulingPolicy_t::inherit);
+        const schedulingPolicy_t policy(bInheritPolicy ? m_inherited.m_policy : requested.m_policy);
+        const int priority(bInheritPolicy ? m_inherited.m_priority : requested.m_priority);
+
+        bool bModified(false);
+        if(cpus != m_current.m_cpus)
+        {
+            applyAffinity(cpus);
+            m_current.m_cpus = cpus;
+            bModified = true;
+        }
+        if(policy != m_current.m_policy || priority != m_current.m_priority)
+        {
+            applyPolicy(policy, priority);
+            m_current.m_policy = policy;
+            m_current.m_priority = priority;
+            bModified = true;
+        }
+        if(bModified)
+        {
+            readScheduling(&m_applied);
+        }
+
+        if(requested.m_bPrefaultStack && !m_bStackPrefaulted)
+        {
+            prefaultStack(m_applied.m_stackSize);
+            m_bStackPrefaulted = true;
+        }
+        m_applied.m_bPrefaultStack = m_bStackPrefaulted;
+        m_applied.m_bLockMemory = requested.m_bLockMemory && lockMemory();
+
+        return m_applied;
+    }
+
+private:
+    threadAttributes_t m_inherited; ///< Read when the worker starts
+    threadAttributes_t m_current;   ///< Last affinity and policy set on the worker
+    threadAttributes_t m_applied;   ///< Read back after the last change
+    bool m_bStackPrefaulted;
+};
+
+/*
+ * Apply the task's attributes and name to the calling thread,
+ *  then execute the task
+ *
+ *************************************************************/
+static void executeTask(ThreadPoolTask& task, WorkerAttributes& workerAttributes)
+{
+    const threadAttributes_t& appliedAttributes(workerAttributes.apply(task.getAttributes()));
+    ::pthread_setname_np(::pthread_self(), task.getName().substr(0, m_maxThreadNameLength).c_str());
+    task.run(appliedAttributes);
+}
+
+
+ThreadPoolImpl::poolState_t::poolState_t(const size_t maxIdleWorkers, const std::chrono::milliseconds& idleTimeout):
+    m_numWorkers(0), m_numIdleWorkers(0), m_bTerminate(false),
+    m_maxIdleWorkers(maxIdleWorkers), m_idleTimeout(idleTimeout)
+{
+}
+
+ThreadPoolImpl::ThreadPoolImpl(const size_t maxIdleWorkers, const std::chrono::milliseconds& idleTimeout):
+    m_pState(std::make_shared<poolState_t>(maxIdleWorkers, idleTimeout))
+{
+}
+
+ThreadPoolImpl::~ThreadPoolImpl()
+{
+    std::list<std::thread> workers;
+    std::list<pthread_t> dedicatedThreads;
+    {
+        std::lock_guard<std::mutex> lock(m_pState->m_lock);
+        m_pState->m_bTerminate = true;
+        m_pState->m_taskAvailable.notify_all();
+        workers.swap(m_pState->m_workers);
+        dedicatedThreads.swap(m_pState->m_dedicatedThreads);
+        m_pState->m_exitedWorkers.clear();
+        m_pState->m_exitedDedicatedThreads.clear();
+    }
+
+    // Wait for the threads to complete their current task. A task that
+    //  destroys the pool cannot wait for itself
+    ///////////////////////////////////////////////////////////////////
+    for(std::list<std::thread>::iterator scanWorkers(workers.begin()), endWorkers(workers.end()); scanWorkers != endWorkers; ++scanWorkers)
+    {
+        if(scanWorkers->get_id() == std::this_thread::get_id())
+        {
+            scanWorkers->detach();
+            continue;
+        }
+        scanWorkers->join();
+    }
+    for(std::list<pthread_t>::const_iterator scanThreads(dedicatedThreads.begin()), endThreads(dedicatedThreads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        if(::pthread_equal(*scanThreads, ::pthread_self()))
+        {
+            ::pthread_detach(*scanThreads);
+            continue;
+        }
+        ::pthread_join(*scanThreads, 0);
+    }
+}
+
+/*
+ * Join the threads that terminated on their own since the last call
+ *
+ *******************************************************************/
+void ThreadPoolImpl::joinExitedThreads()
+{
+    std::list<std::thread> workers;
+    std::list<pthread_t> dedicatedThreads;
+    {
+        std::lock_guard<std::mutex> lock(m_pState->m_lock);
+        for(std::list<std::thread::id>::const_iterator scanExited(m_pState->m_exitedWorkers.begin()), endExited(m_pState->m_exitedWorkers.end());
+            scanExited != endExited;
+            ++scanExited)
+        {
+            for(std::list<std::thread>::iterator scanWorkers(m_pState->m_workers.begin()), endWorkers(m_pState->m_workers.end()); scanWorkers != endWorkers; ++scanWorkers)
+            {
+                if(scanWorkers->get_id() == *scanExited)
+                {
+                    workers.splice(workers.end(), m_pState->m_workers, scanWorkers);
+                    break;
+                }
+            }
+        }
+        m_pState->m_exitedWorkers.clear();
+
+        for(std::list<pthread_t>::const_iterator scanExited(m_pState->m_exitedDedicatedThreads.begin()), endExited(m_pState->m_exitedDedicatedThreads.end());
+            scanExited != endExited;
+            ++scanExited)
+        {
+            for(std::list<pthread_t>::iterator scanThreads(m_pState->m_dedicatedThreads.begin()), endThreads(m_pState->m_dedicatedThreads.end()); scanThreads != endThreads; ++scanThreads)
+            {
+                if(::pthread_equal(*scanThreads, *scanExited))
+                {
+                    dedicatedThreads.splice(dedicatedThreads.end(), m_pState->m_dedicatedThreads, scanThreads);
+                    break;
+                }
+            }
+        }
+        m_pState->m_exitedDedicatedThreads.clear();
+    }
+
+    // The threads are returning: the joins don't block
+    ///////////////////////////////////////////////////
+    for(std::list<std::thread>::iterator scanWorkers(workers.begin()), endWorkers(workers.end()); scanWorkers != endWorkers; ++scanWorkers)
+    {
+        scanWorkers->join();
+    }
+    for(std::list<pthread_t>::const_iterator scanThreads(dedicatedThreads.begin()), endThreads(dedicatedThreads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        ::pthread_join(*scanThreads, 0);
+    }
+}
+
+ThreadBaseImpl* ThreadPoolImpl::run(FactoryBaseImpl* pFactory, const std::string& name, const taskClass_t taskClass, threadFunction_t function)
+{
+    threadAttributes_t attributes;
+    {
+        std::lock_guard<std::mutex> lock(m_pState->m_lock);
+        attributes = m_pState->m_classAttributes[(size_t)taskClass];
+    }
+    return run(pFactory, name, attributes, function);
+}
+
+ThreadBaseImpl* ThreadPoolImpl::run(FactoryBaseImpl* pFactory, const std::string& name, const threadAttributes_t& attributes, threadFunction_t function)
+{
+    return run(pFactory, std::make_shared<ThreadPoolTask>(name, attributes, function));
+}
+
+/*
+ * Entry point of the threads started with pthread_create()
+ *
+ **********************************************************/
+static void* dedicatedThreadEntry(void* pParameter)
+{
+    std::unique_ptr<threadFunction_t> pFunction((threadFunction_t*)pParameter);
+    (*pFunction)();
+    return 0;
+}
+
+ThreadBaseImpl* ThreadPoolImpl::run(FactoryBaseImpl* pFactory, std::shared_ptr<ThreadPoolTask> pTask)
+{
+    joinExitedThreads();
+
+    const size_t stackSize(pTask->getAttributes().m_stackSize);
+    if(stackSize != 0)
+    {
+        // The workers have the default stack: start a dedicated thread.
+        //  The lock is held until the thread is listed, so it cannot be
+        //  reported as exited before that
+        ////////////////////////////////////////////////////////////////
+        pthread_attr_t threadAttributes;
+        ::pthread_attr_init(&threadAttributes);
+        ::pthread_attr_setstacksize(&threadAttributes, std::max(stackSize, (size_t)PTHREAD_STACK_MIN));
+
+        threadFunction_t* pFunction(new threadFunction_t(std::bind(&ThreadPoolImpl::dedicatedThread, m_pState, pTask)));
+        std::lock_guard<std::mutex> lock(m_pState->m_lock);
+        pthread_t thread;
+        const int result(::pthread_create(&thread, &threadAttributes, &dedicatedThreadEntry, pFunction));
+        ::pthread_attr_destroy(&threadAttributes);
+        if(result != 0)
+        {
+            delete pFunction;
+            throw std::runtime_error(std::string("Cannot start the thread ") + pTask->getName() + ": " + std::strerror(result));
+        }
+        m_pState->m_dedicatedThreads.push_back(thread);
+        return new ThreadPooled(pFactory, pTask);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_pState->m_lock);
+        m_pState->m_pendingTasks.push_back(pTask);
+
+        // Start a new worker if the idle ones are not enough to
+        //  execute all the pending tasks
+        ////////////////////////////////////////////////////////
+        if(m_pState->m_pendingTasks.size() > m_pState->m_numIdleWorkers)
+        {
+            try
+            {
+                std::list<std::thread> newWorker(1);
+                newWorker.back() = std::thread(&ThreadPoolImpl::workerThread, m_pState);
+                m_pState->m_workers.splice(m_pState->m_workers.end(), newWorker);
+            }
+            catch(...)
+            {
+                m_pState->m_pendingTasks.pop_back();
+                throw;
+            }
+            ++m_pState->m_numWorkers;
+            ++m_pState->m_numIdleWorkers;
+        }
+        m_pState->m_taskAvailable.notify_one();
+    }
+
+    return new ThreadPooled(pFactory, pTask);
+}
+
+void ThreadPoolImpl::setTaskClassAttributes(const taskClass_t taskClass, const threadAttributes_t& attributes)
+{
+    std::lock_guard<std::mutex> lock(m_pState->m_lock);
+    m_pState->m_classAttributes[(size_t)taskClass] = attributes;
+}
+
+size_t ThreadPoolImpl::getNumWorkers() const
+{
+    std::lock_guard<std::mutex> lock(m_pState->m_lock);
+    return m_pState->m_numWorkers;
+}
+
+size_t ThreadPoolImpl::getNumIdleWorkers() const
+{
+    std::lock_guard<std::mutex> lock(m_pState->m_lock);
+    return m_pState->m_numIdleWorkers;
+}
+
+void ThreadPoolImpl::workerThread(std::shared_ptr<poolState_t> pState)
+{
+    WorkerAttributes workerAttributes;
+
+    std::unique_lock<std::mutex> lock(pState->m_lock);
+    for(;;)
+    {
+        if(pState->m_pendingTasks.empty())
+        {
+            if(pState->m_bTerminate ||
+               (pState->m_taskAvailable.wait_for(lock, pState->m_idleTimeout) == std::cv_status::timeout && pState->m_pendingTasks.empty()))
+            {
+                break;
+            }
+            continue;
+        }
+
+        std::shared_ptr<ThreadPoolTask> pTask(pState->m_pendingTasks.front());
+        pState->m_pendingTasks.pop_front();
+        --pState->m_numIdleWorkers;
+        lock.unlock();
+
+        executeTask(*pTask, workerAttributes);
+
+        // Become idle before signaling the completion, so a task started
+        //  right after a join() reuses this worker
+        //////////////////////////////////////////////////////////////////
+        lock.lock();
+        ++pState->m_numIdleWorkers;
+        pTask->setFinished();
+
+        if(pState->m_numIdleWorkers > pState->m_maxIdleWorkers && pState->m_pendingTasks.empty())
+        {
+            break;
+        }
+    }
+
+    --pState->m_numIdleWorkers;
+    --pState->m_numWorkers;
+    if(!pState->m_bTerminate)
+    {
+        pState->m_exitedWorkers.push_back(std::this_thread::get_id());
+    }
+}
+
+void ThreadPoolImpl::dedicatedThread(std::shared_ptr<poolState_t> pState, std::shared_ptr<ThreadPoolTask> pTask)
+{
+    WorkerAttributes workerAttributes;
+    executeTask(*pTask, workerAttributes);
+    pTask->setFinished();
+
+    std::lock_guard<std::mutex> lock(pState->m_lock);
+    if(!pState->m_bTerminate)
+    {
+        pState->m_exitedDedicatedThreads.push_back(::pthread_self());
+    }
+}
+
+}
@@ -0,0 +1,600 @@
+/*
+ * Nominal Device Support v3 (NDS3)
+ *
+ * Copyright (c) 2015 Cosylab d.d.
+ *
+ * For more information about the license please refer to the license.txt
+ * file included in the distribution.
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "nds3/impl/waveformReductionImpl.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define NDS3_REDUCTION_X86_64
+#include <immintrin.h>
+#endif
+
+namespace nds
+{
+
+/*
+ * The sums of the integer samples are accumulated in 64 bits
+ *
+ ************************************************************/
+template<typename T>
+struct ReductionAccumulator
+{
+    typedef typename std::conditional<std::is_integral<T>::value, std::int64_t, double>::type type;
+};
+
+/*
+ * The sums of the 64 bit samples would overflow in 64 bits: they are
+ *  accumulated in 128 bits when the compiler supports them, otherwise
+ *  in a double
+ *
+ *********************************************************************/
+template<>
+struct ReductionAccumulator<std::int64_t>
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 type;
+#else
+    typedef double type;
+#endif
+};
+
+
+/*
+ * Plain C++ kernels, used for the 8, 16 and 64 bit types, for float
+ *  and when SSE2 and AVX2 are not available.
+ *
+ * A NaN sample propagates: the minimum and the maximum of its group
+ *  are both NaN. All the min/max kernels follow this rule.
+ *
+ ********************************************************************/
+template<typename T>
+static void groupMinMaxScalar(const T* pInput, const size_t size, T* pMin, T* pMax)
+{
+    T minimum(pInput[0]);
+    T maximum(pInput[0]);
+    for(const T* pScanInput(pInput + 1), *pEndInput(pInput + size); pScanInput != pEndInput; ++pScanInput)
+    {
+        if(*pScanInput != *pScanInput) // NaN. Always false for the integers
+        {
+            *pMin = *pScanInput;
+            *pMax = *pScanInput;
+            return;
+        }
+        if(*pScanInput < minimum)
+        {
+            minimum = *pScanInput;
+        }
+        if(*pScanInput > maximum)
+        {
+            maximum = *pScanInput;
+        }
+    }
+    *pMin = minimum;
+    *pMax = maximum;
+}
+
+template<typename T>
+static typename ReductionAccumulator<T>::type groupSumScalar(const T* pInput, const size_t size)
+{
+    typename ReductionAccumulator<T>::type sum(0);
+    for(const T* pScanInput(pInput), *pEndInput(pInput + size); pScanInput != pEndInput; ++pScanInput)
+    {
+        sum += *pScanInput;
+    }
+    return sum;
+}
+
+
+#ifdef NDS3_REDUCTION_X86_64
+
+/*
+ * __builtin_cpu_init() must be called before __builtin_cpu_supports()
+ *  when the check runs during the static initialization
+ *
+ *********************************************************************/
+static bool detectAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const bool m_bAvx2(detectAvx2());
+
+
+// AVX2 kernels
+///////////////
+
+/*
+ * _mm256_min_pd and _mm256_max_pd don't propagate the NaNs: they are
+ *  detected separately and the group is then handled by the scalar
+ *  kernel
+ *
+ ********************************************************************/
+__attribute__((target("avx2")))
+static void groupMinMaxAvx2(const double* pInput, const size_t size, double* pMin, double* pMax)
+{
+    size_t scanInput(0);
+    double minimum(pInput[0]);
+    double maximum(pInput[0]);
+    if(size >= 4)
+    {
+        __m256d vectorMin(_mm256_loadu_pd(pInput));
+        __m256d vectorMax(vectorMin);
+        __m256d isNaN(_mm256_cmp_pd(vectorMin, vectorMin, _CMP_UNORD_Q));
+        for(scanInput = 4; scanInput + 4 <= size; scanInput += 4)
+        {
+            __m256d values(_mm256_loadu_pd(pInput + scanInput));
+            isNaN = _mm256_or_pd(isNaN, _mm256_cmp_pd(values, values, _CMP_UNORD_Q));
+            vectorMin = _mm256_min_pd(vectorMin, values);
+            vectorMax = _mm256_max_pd(vectorMax, values);
+        }
+        if(_mm256_movemask_pd(isNaN) != 0)
+        {
+            groupMinMaxScalar(pInput, size, pMin, pMax);
+            return;
+        }
+        double minimums[4], maximums[4];
+        _mm256_storeu_pd(minimums, vectorMin);
+        _mm256_storeu_pd(maximums, vectorMax);
+        double unused;
+        groupMinMaxScalar(minimums, 4, &minimum, &unused);
+        groupMinMaxScalar(maximums, 4, &unused, &maximum);
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        if(pInput[scanInput] != pInput[scanInput])
+        {
+            *pMin = pInput[scanInput];
+            *pMax = pInput[scanInput];
+            return;
+        }
+        minimum = pInput[scanInput] < minimum ? pInput[scanInput] : minimum;
+        maximum = pInput[scanInput] > maximum ? pInput[scanInput] : maximum;
+    }
+    *pMin = minimum;
+    *pMax = maximum;
+}
+
+__attribute__((target("avx2")))
+static void groupMinMaxAvx2(const std::int32_t* pInput, const size_t size, std::int32_t* pMin, std::int32_t* pMax)
+{
+    size_t scanInput(0);
+    std::int32_t minimum(pInput[0]);
+    std::int32_t maximum(pInput[0]);
+    if(size >= 8)
+    {
+        __m256i vectorMin(_mm256_loadu_si256((const __m256i*)pInput));
+        __m256i vectorMax(vectorMin);
+        for(scanInput = 8; scanInput + 8 <= size; scanInput += 8)
+        {
+            __m256i values(_mm256_loadu_si256((const __m256i*)(pInput + scanInput)));
+            vectorMin = _mm256_min_epi32(vectorMin, values);
+            vectorMax = _mm256_max_epi32(vectorMax, values);
+        }
+        std::int32_t minimums[8], maximums[8];
+        _mm256_storeu_si256((__m256i*)minimums, vectorMin);
+        _mm256_storeu_si256((__m256i*)maximums, vectorMax);
+        std::int32_t unused;
+        groupMinMaxScalar(minimums, 8, &minimum, &unused);
+        groupMinMaxScalar(maximums, 8, &unused, &maximum);
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        minimum = pInput[scanInput] < minimum ? pInput[scanInput] : minimum;
+        maximum = pInput[scanInput] > maximum ? pInput[scanInput] : maximum;
+    }
+    *pMin = minimum;
+    *pMax = maximum;
+}
+
+__attribute__((target("avx2")))
+static double groupSumAvx2(const double* pInput, const size_t size)
+{
+    size_t scanInput(0);
+    __m256d vectorSum(_mm256_setzero_pd());
+    for(; scanInput + 4 <= size; scanInput += 4)
+    {
+        vectorSum = _mm256_add_pd(vectorSum, _mm256_loadu_pd(pInput + scanInput));
+    }
+    double sums[4];
+    _mm256_storeu_pd(sums, vectorSum);
+    return sums[0] + sums[1] + sums[2] + sums[3] + groupSumScalar(pInput + scanInput, size - scanInput);
+}
+
+__attribute__((target("avx2")))
+static std::int64_t groupSumAvx2(const std::int32_t* pInput, const size_t size)
+{
+    size_t scanInput(0);
+    __m256i vectorSum(_mm256_setzero_si256());
+    for(; scanInput + 8 <= size; scanInput += 8)
+    {
+        __m256i values(_mm256_loadu_si256((const __m256i*)(pInput + scanInput)));
+        vectorSum = _mm256_add_epi64(vectorSum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        vectorSum = _mm256_add_epi64(vectorSum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+    std::int64_t sums[4];
+    _mm256_storeu_si256((__m256i*)sums, vectorSum);
+    return sums[0] + sums[1] + sums[2] + sums[3] + groupSumScalar(pInput + scanInput, size - scanInput);
+}
+
+
+// SSE2 kernels: SSE2 is always available on x86-64
+///////////////////////////////////////////////////
+
+static void groupMinMaxSse2(const double* pInput, const size_t size, double* pMin, double* pMax)
+{
+    size_t scanInput(0);
+    double minimum(pInput[0]);
+    double maximum(pInput[0]);
+    if(size >= 2)
+    {
+        __m128d vectorMin(_mm_loadu_pd(pInput));
+        __m128d vectorMax(vectorMin);
+        __m128d isNaN(_mm_cmpunord_pd(vectorMin, vectorMin));
+        for(scanInput = 2; scanInput + 2 <= size; scanInput += 2)
+        {
+            __m128d values(_mm_loadu_pd(pInput + scanInput));
+            isNaN = _mm_or_pd(isNaN, _mm_cmpunord_pd(values, values));
+            vectorMin = _mm_min_pd(vectorMin, values);
+            vectorMax = _mm_max_pd(vectorMax, values);
+        }
+        if(_mm_movemask_pd(isNaN) != 0)
+        {
+            groupMinMaxScalar(pInput, size, pMin, pMax);
+            return;
+        }
+        double minimums[2], maximums[2];
+        _mm_storeu_pd(minimums, vectorMin);
+        _mm_storeu_pd(maximums, vectorMax);
+        minimum = minimums[1] < minimums[0] ? minimums[1] : minimums[0];
+        maximum = maximums[1] > maximums[0] ? maximums[1] : maximums[0];
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        if(pInput[scanInput] != pInput[scanInput])
+        {
+            *pMin = pInput[scanInput];
+            *pMax = pInput[scanInput];
+            return;
+        }
+        minimum = pInput[scanInput] < minimum ? pInput[scanInput] : minimum;
+        maximum = pInput[scanInput] > maximum ? pInput[scanInput] : maximum;
+    }
+    *pMin = minimum;
+    *pMax = maximum;
+}
+
+/*
+ * SSE2 has no min/max instructions for the 32 bit integers:
+ *  select the values with a comparison mask
+ *
+ ***********************************************************/
+static void groupMinMaxSse2(const std::int32_t* pInput, const size_t size, std::int32_t* pMin, std::int32_t* pMax)
+{
+    size_t scanInput(0);
+    std::int32_t minimum(pInput[0]);
+    std::int32_t maximum(pInput[0]);
+    if(size >= 4)
+    {
+        __m128i vectorMin(_mm_loadu_si128((const __m128i*)pInput));
+        __m128i vectorMax(vectorMin);
+        for(scanInput = 4; scanInput + 4 <= size; scanInput += 4)
+        {
+            __m128i values(_mm_loadu_si128((const __m128i*)(pInput + scanInput)));
+            __m128i isLower(_mm_cmplt_epi32(values, vectorMin));
+            vectorMin = _mm_or_si128(_mm_and_si128(isLower, values), _mm_andnot_si128(isLower, vectorMin));
+            __m128i isHigher(_mm_cmpgt_epi32(values, vectorMax));
+            vectorMax = _mm_or_si128(_mm_and_si128(isHigher, values), _mm_andnot_si128(isHigher, vectorMax));
+        }
+        std::int32_t minimums[4], maximums[4];
+        _mm_storeu_si128((__m128i*)minimums, vectorMin);
+        _mm_storeu_si128((__m128i*)maximums, vectorMax);
+        std::int32_t unused;
+        groupMinMaxScalar(minimums, 4, &minimum, &unused);
+        groupMinMaxScalar(maximums, 4, &unused, &maximum);
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        minimum = pInput[scanInput] < minimum ? pInput[scanInput] : minimum;
+        maximum = pInput[scanInput] > maximum ? pInput[scanInput] : maximum;
+    }
+    *pMin = minimum;
+    *pMax = maximum;
+}
+
+static double groupSumSse2(const double* pInput, const size_t size)
+{
+    size_t scanInput(0);
+    __m128d vectorSum(_mm_setzero_pd());
+    for(; scanInput + 2 <= size; scanInput += 2)
+    {
+        vectorSum = _mm_add_pd(vectorSum, _mm_loadu_pd(pInput + scanInput));
+    }
+    double sums[2];
+    _mm_storeu_pd(sums, vectorSum);
+    return sums[0] + sums[1] + groupSumScalar(pInput + scanInput, size - scanInput);
+}
+
+/*
+ * The 32 bit integers are extended to 64 bits by interleaving
+ *  them with their sign
+ *
+ *************************************************************/
+static std::int64_t groupSumSse2(const std::int32_t* pInput, const size_t size)
+{
+    size_t scanInput(0);
+    __m128i vectorSum(_mm_setzero_si128());
+    for(; scanInput + 4 <= size; scanInput += 4)
+    {
+        __m128i values(_mm_loadu_si128((const __m128i*)(pInput + scanInput)));
+        __m128i signs(_mm_srai_epi32(values, 31));
+        vectorSum = _mm_add_epi64(vectorSum, _mm_unpacklo_epi32(values, signs));
+        vectorSum = _mm_add_epi64(vectorSum, _mm_unpackhi_epi32(values, signs));
+    }
+    std::int64_t sums[2];
+    _mm_storeu_si128((__m128i*)sums, vectorSum);
+    return sums[0] + sums[1] + groupSumScalar(pInput + scanInput, size - scanInput);
+}
+
+
+
+// Conversion to engineering units
+//////////////////////////////////
+
+__attribute__((target("avx2")))
+static void scaleAvx2(const std::int16_t* pInput, const size_t size, const double amplitude, const double offset, double* pOutput)
+{
+    const __m256d vectorAmplitude(_mm256_set1_pd(amplitude));
+    const __m256d vectorOffset(_mm256_set1_pd(offset));
+    size_t scanInput(0);
+    for(; scanInput + 8 <= size; scanInput += 8)
+    {
+        __m256i values(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(pInput + scanInput))));
+        __m256d low(_mm256_cvtepi32_pd(_mm256_castsi256_si128(values)));
+        __m256d high(_mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1)));
+        _mm256_storeu_pd(pOutput + scanInput, _mm256_add_pd(_mm256_mul_pd(low, vectorAmplitude), vectorOffset));
+        _mm256_storeu_pd(pOutput + scanInput + 4, _mm256_add_pd(_mm256_mul_pd(high, vectorAmplitude), vectorOffset));
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        pOutput[scanInput] = (double)pInput[scanInput] * amplitude + offset;
+    }
+}
+
+__attribute__((target("avx2")))
+static void scaleAvx2(const std::int32_t* pInput, const size_t size, const double amplitude, const double offset, double* pOutput)
+{
+    const __m256d vectorAmplitude(_mm256_set1_pd(amplitude));
+    const __m256d vectorOffset(_mm256_set1_pd(offset));
+    size_t scanInput(0);
+    for(; scanInput + 8 <= size; scanInput += 8)
+    {
+        __m256i values(_mm256_loadu_si256((const __m256i*)(pInput + scanInput)));
+        __m256d low(_mm256_cvtepi32_pd(_mm256_castsi256_si128(values)));
+        __m256d high(_mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1)));
+        _mm256_storeu_pd(pOutput + scanInput, _mm256_add_pd(_mm256_mul_pd(low, vectorAmplitude), vectorOffset));
+        _mm256_storeu_pd(pOutput + scanInput + 4, _mm256_add_pd(_mm256_mul_pd(high, vectorAmplitude), vectorOffset));
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        pOutput[scanInput] = (double)pInput[scanInput] * amplitude + offset;
+    }
+}
+
+/*
+ * The 16 bit integers are extended to 32 bits by duplicating them
+ *  in both halves and shifting right with the sign
+ *
+ *****************************************************************/
+static void scaleSse2(const std::int16_t* pInput, const size_t size, const double amplitude, const double offset, double* pOutput)
+{
+    const __m128d vectorAmplitude(_mm_set1_pd(amplitude));
+    const __m128d vectorOffset(_mm_set1_pd(offset));
+    size_t scanInput(0);
+    for(; scanInput + 8 <= size; scanInput += 8)
+    {
+        __m128i values(_mm_loadu_si128((const __m128i*)(pInput + scanInput)));
+        __m128i low(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16));
+        __m128i high(_mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16));
+        _mm_storeu_pd(pOutput + scanInput, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(low), vectorAmplitude), vectorOffset));
+        _mm_storeu_pd(pOutput + scanInput + 2, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(low, 8)), vectorAmplitude), vectorOffset));
+        _mm_storeu_pd(pOutput + scanInput + 4, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(high), vectorAmplitude), vectorOffset));
+        _mm_storeu_pd(pOutput + scanInput + 6, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(high, 8)), vectorAmplitude), vectorOffset));
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        pOutput[scanInput] = (double)pInput[scanInput] * amplitude + offset;
+    }
+}
+
+static void scaleSse2(const std::int32_t* pInput, const size_t size, const double amplitude, const double offset, double* pOutput)
+{
+    const __m128d vectorAmplitude(_mm_set1_pd(amplitude));
+    const __m128d vectorOffset(_mm_set1_pd(offset));
+    size_t scanInput(0);
+    for(; scanInput + 4 <= size; scanInput += 4)
+    {
+        __m128i values(_mm_loadu_si128((const __m128i*)(pInput + scanInput)));
+        _mm_storeu_pd(pOutput + scanInput, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(values), vectorAmplitude), vectorOffset));
+        _mm_storeu_pd(pOutput + scanInput + 2, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(values, 8)), vectorAmplitude), vectorOffset));
+    }
+    for(; scanInput != size; ++scanInput)
+    {
+        pOutput[scanInput] = (double)pInput[scanInput] * amplitude + offset;
+    }
+}
+
+#endif // NDS3_REDUCTION_X86_64
+
+
+/*
+ * Select the kernel for the data type and the CPU
+ *
+ *************************************************/
+template<typename T>
+static void groupMinMax(const T* pInput, const size_t size, T* pMin, T* pMax)
+{
+    groupMinMaxScalar(pInput, size, pMin, pMax);
+}
+
+template<typename T>
+static typename ReductionAccumulator<T>::type groupSum(const T* pInput, const size_t size)
+{
+    return groupSumScalar(pInput, size);
+}
+
+#ifdef NDS3_REDUCTION_X86_64
+
+static void groupMinMax(const double* pInput, const size_t size, double* pMin, double* pMax)
+{
+    if(m_bAvx2)
+    {
+        groupMinMaxAvx2(pInput, size, pMin, pMax);
+        return;
+    }
+    groupMinMaxSse2(pInput, size, pMin, pMax);
+}
+
+static void groupMinMax(const std::int32_t* pInput, const size_t size, std::int32_t* pMin, std::int32_t* pMax)
+{
+    if(m_bAvx2)
+    {
+        groupMinMaxAvx2(pInput, size, pMin, pMax);
+        return;
+    }
+    groupMinMaxSse2(pInput, size, pMin, pMax);
+}
+
+static double groupSum(const double* pInput, const size_t size)
+{
+    return m_bAvx2 ? groupSumAvx2(pInput, size) : groupSumSse2(pInput, size);
+}
+
+static std::int64_t groupSum(const std::int32_t* pInput, const size_t size)
+{
+    return m_bAvx2 ? groupSumAvx2(pInput, size) : groupSumSse2(pInput, size);
+}
+
+#endif // NDS3_REDUCTION_X86_64
+
+
+/*
+ * Reduce the waveform into the output vector: resizing the vector
+ *  to the same size as the previous call does not allocate memory
+ *
+ *****************************************************************/
+template<typename T>
+void reduceWaveform(const reductionMode_t mode,
+                    const size_t reductionFactor,
+                    const T* pInput,
+                    const size_t inputSize,
+                    std::vector<T>* pOutput)
+{
+    if(mode == reductionMode_t::none || reductionFactor <= 1)
+    {
+        pOutput->assign(pInput, pInput + inputSize);
+        return;
+    }
+
+    const size_t numGroups((inputSize + reductionFactor - 1) / reductionFactor);
+
+    switch(mode)
+    {
+    case reductionMode_t::subsample:
+    {
+        pOutput->resize(numGroups);
+        T* pOutputData(pOutput->data());
+        for(size_t scanGroups(0); scanGroups != numGroups; ++scanGroups)
+        {
+            pOutputData[scanGroups] = pInput[scanGroups * reductionFactor];
+        }
+        break;
+    }
+    case reductionMode_t::minMax:
+    {
+        pOutput->resize(numGroups * 2);
+        T* pOutputData(pOutput->data());
+        for(size_t groupStart(0); groupStart < inputSize; groupStart += reductionFactor, pOutputData += 2)
+        {
+            const size_t groupSize(inputSize - groupStart < reductionFactor ? inputSize - groupStart : reductionFactor);
+            groupMinMax(pInput + groupStart, groupSize, pOutputData, pOutputData + 1);
+        }
+        break;
+    }
+    case reductionMode_t::average:
+    {
+        typedef typename ReductionAccumulator<T>::type accumulator_t;
+
+        pOutput->resize(numGroups);
+        T* pOutputData(pOutput->data());
+        for(size_t groupStart(0); groupStart < inputSize; groupStart += reductionFactor, ++pOutputData)
+        {
+            const size_t groupSize(inputSize - groupStart < reductionFactor ? inputSize - groupStart : reductionFactor);
+            *pOutputData = (T)(groupSum(pInput + groupStart, groupSize) / (accumulator_t)groupSize);
+        }
+        break;
+    }
+    default:
+        throw std::logic_error("Unknown reduction mode");
+    }
+}
+
+
+/*
+ * Convert the raw samples directly into the output vector
+ *
+ *********************************************************/
+template<typename T>
+void scaleWaveform(const T* pInput,
+                   const size_t inputSize,
+                   const double amplitude,
+                   const double offset,
+                   std::vector<double>* pOutput)
+{
+    pOutput->resize(inputSize);
+    if(inputSize == 0)
+    {
+        return;
+    }
+
+#ifdef NDS3_REDUCTION_X86_64
+    if(m_bAvx2)
+    {
+        scaleAvx2(pInput, inputSize, amplitude, offset, pOutput->data());
+        return;
+    }
+    scaleSse2(pInput, inputSize, amplitude, offset, pOutput->data());
+#else
+    double* pOutputData(pOutput->data());
+    for(size_t scanInput(0); scanInput != inputSize; ++scanInput)
+    {
+        pOutputData[scanInput] = (double)pInput[scanInput] * amplitude + offset;
+    }
+#endif // NDS3_REDUCTION_X86_64
+}
+
+
+// Instantiate all the needed data types
+////////////////////////////////////////
+template void reduceWaveform<std::int8_t>(const reductionMode_t, const size_t, const std::int8_t*, const size_t, std::vector<std::int8_t>*);
+template void reduceWaveform<std::uint8_t>(const reductionMode_t, const size_t, const std::uint8_t*, const size_t, std::vector<std::uint8_t>*);
+template void reduceWaveform<std::int32_t>(const reductionMode_t, const size_t, const std::int32_t*, const size_t, std::vector<std::int32_t>*);
+template void reduceWaveform<double>(const reductionMode_t, const size_t, const double*, const size_t, std::vector<double>*);
+template void reduceWaveform<std::int16_t>(const reductionMode_t, const size_t, const std::int16_t*, const size_t, std::vector<std::int16_t>*);
+template void reduceWaveform<std::uint16_t>(const reductionMode_t, const size_t, const std::uint16_t*, const size_t, std::vector<std::uint16_t>*);
+template void reduceWaveform<std::int64_t>(const reductionMode_t, const size_t, const std::int64_t*, const size_t, std::vector<std::int64_t>*);
+template void reduceWaveform<float>(const reductionMode_t, const size_t, const float*, const size_t, std::vector<float>*);
+
+template void scaleWaveform<std::int16_t>(const std::int16_t*, const size_t, const double, const double, std::vector<double>*);
+template void scaleWaveform<std::int32_t>(const std::int32_t*, const size_t, const double, const double, std::vector<double>*);
+
+}
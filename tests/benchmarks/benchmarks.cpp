@@ -0,0 +1,687 @@
+/*
+ * Microbenchmarks for the PV hot paths.
+ *
+ * The benchmarks run against the test control system
+ *  (TestControlSystemInterfaceImpl) and print the results as JSON
+ *  on the standard output or into the file specified as first
+ *  argument.
+ *
+ * The allocations are counted by replacing the global operator new:
+ *  they include the allocations performed by the test control system
+ *  when it stores the pushed values.
+ *
+ *********************************************************************/
+
+#include <nds3/nds.h>
+#include <nds3/impl/pvVariableInImpl.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ndsTestFactory.h"
+#include "ndsTestInterface.h"
+
+/*
+ * Count the allocations. The replaced operator delete releases
+ *  the memory allocated with malloc(). The operators are not
+ *  inlined, so GCC does not pair an inlined free() with the
+ *  default operator new
+ *
+ *************************************************************/
+static std::atomic<std::uint64_t> m_allocations(0);
+
+void* __attribute__((noinline)) operator new(std::size_t size)
+{
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* pMemory(std::malloc(size == 0 ? 1 : size));
+    if(pMemory == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void __attribute__((noinline)) operator delete(void* pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void __attribute__((noinline)) operator delete(void* pMemory, std::size_t /* size */) noexcept
+{
+    std::free(pMemory);
+}
+
+
+namespace
+{
+
+// Each benchmark runs until one of the limits is reached
+/////////////////////////////////////////////////////////
+const std::chrono::milliseconds m_timeBudget(50);
+const std::uint64_t m_maxIterations(1000000);
+const std::uint64_t m_maxElementsPerBenchmark(4 * 1024 * 1024);
+
+// Number of subscribers or replication targets used in the "N" configurations
+///////////////////////////////////////////////////////////////////////////////
+const size_t m_manyReceivers(4);
+
+struct Result
+{
+    std::string m_benchmark;
+    std::string m_dataType;
+    size_t m_elements;
+    size_t m_subscribers;
+    size_t m_replicas;
+    std::uint64_t m_iterations;
+    double m_nsPerOp;
+    double m_allocationsPerOp;
+};
+
+std::vector<Result> m_results;
+
+/*
+ * Run an operation repeatedly and store the average time and
+ *  number of allocations
+ *
+ ************************************************************/
+void measure(const std::string& benchmark, const std::string& dataType, const size_t elements,
+             const size_t subscribers, const size_t replicas, std::function<void()> operation)
+{
+    // Warm up: the first call may allocate the buffers that are then reused
+    /////////////////////////////////////////////////////////////////////////
+    operation();
+
+    std::uint64_t maxIterations(m_maxElementsPerBenchmark / elements);
+    if(maxIterations > m_maxIterations)
+    {
+        maxIterations = m_maxIterations;
+    }
+    if(maxIterations < 4)
+    {
+        maxIterations = 4;
+    }
+
+    const std::uint64_t startAllocations(m_allocations.load());
+    const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+    std::chrono::steady_clock::duration elapsed(0);
+    std::uint64_t iterations(0);
+
+    for(std::uint64_t chunk(1);;)
+    {
+        for(std::uint64_t runChunk(0); runChunk != chunk; ++runChunk)
+        {
+            operation();
+        }
+        iterations += chunk;
+        elapsed = std::chrono::steady_clock::now() - startTime;
+        if(elapsed >= m_timeBudget || iterations >= maxIterations)
+        {
+            break;
+        }
+        chunk *= 2;
+        if(chunk > maxIterations - iterations)
+        {
+            chunk = maxIterations - iterations;
+        }
+    }
+
+    const std::uint64_t allocations(m_allocations.load() - startAllocations);
+
+    Result result;
+    result.m_benchmark = benchmark;
+    result.m_dataType = dataType;
+    result.m_elements = elements;
+    result.m_subscribers = subscribers;
+    result.m_replicas = replicas;
+    result.m_iterations = iterations;
+    result.m_nsPerOp = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (double)iterations;
+    result.m_allocationsPerOp = (double)allocations / (double)iterations;
+    m_results.push_back(result);
+
+    std::cerr << benchmark << " " << dataType << " elements=" << elements
+              << " subscribers=" << subscribers << " replicas=" << replicas
+              << ": " << result.m_nsPerOp << " ns/op" << std::endl;
+}
+
+/*
+ * Run a long operation once and store its duration and number
+ *  of allocations
+ *
+ *************************************************************/
+void measureOnce(const std::string& benchmark, const size_t elements, std::function<void()> operation)
+{
+    const std::uint64_t startAllocations(m_allocations.load());
+    const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+
+    operation();
+
+    const std::chrono::steady_clock::duration elapsed(std::chrono::steady_clock::now() - startTime);
+    const std::uint64_t allocations(m_allocations.load() - startAllocations);
+
+    Result result;
+    result.m_benchmark = benchmark;
+    result.m_elements = elements;
+    result.m_subscribers = 0;
+    result.m_replicas = 0;
+    result.m_iterations = 1;
+    result.m_nsPerOp = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    result.m_allocationsPerOp = (double)allocations;
+    m_results.push_back(result);
+
+    std::cerr << benchmark << " elements=" << elements << ": " << result.m_nsPerOp / 1000000.0 << " ms" << std::endl;
+}
+
+/*
+ * Build the values pushed by the benchmarks
+ *
+ *******************************************/
+template<typename T>
+struct BenchmarkType
+{
+};
+
+template<>
+struct BenchmarkType<std::int32_t>
+{
+    static const char* getName() { return "int32"; }
+    static bool isArray() { return false; }
+    static std::int32_t getValue(const size_t /* elements */) { return 10; }
+};
+
+template<>
+struct BenchmarkType<double>
+{
+    static const char* getName() { return "float64"; }
+    static bool isArray() { return false; }
+    static double getValue(const size_t /* elements */) { return 10.5; }
+};
+
+template<typename T>
+struct BenchmarkArrayType
+{
+    static bool isArray() { return true; }
+    static std::vector<T> getValue(const size_t elements) { return std::vector<T>(elements, (T)1); }
+};
+
+template<>
+struct BenchmarkType<std::vector<std::int8_t> >: public BenchmarkArrayType<std::int8_t>
+{
+    static const char* getName() { return "int8Array"; }
+};
+
+template<>
+struct BenchmarkType<std::vector<std::uint8_t> >: public BenchmarkArrayType<std::uint8_t>
+{
+    static const char* getName() { return "uint8Array"; }
+};
+
+template<>
+struct BenchmarkType<std::vector<std::int32_t> >: public BenchmarkArrayType<std::int32_t>
+{
+    static const char* getName() { return "int32Array"; }
+};
+
+template<>
+struct BenchmarkType<std::vector<double> >: public BenchmarkArrayType<double>
+{
+    static const char* getName() { return "float64Array"; }
+};
+
+template<>
+struct BenchmarkType<std::string>
+{
+    static const char* getName() { return "string"; }
+    static bool isArray() { return true; }
+    static std::string getValue(const size_t elements) { return std::string(elements, 'a'); }
+};
+
+/*
+ * Return a name that has not been used by any other benchmark,
+ *  so each benchmark gets a new test control system interface
+ *
+ **************************************************************/
+std::string getUniqueNodeName()
+{
+    static size_t m_nodeCounter(0);
+    std::ostringstream name;
+    name << "benchmark" << m_nodeCounter++;
+    return name.str();
+}
+
+void doNothing()
+{
+}
+
+bool allowChange(const nds::state_t, const nds::state_t, const nds::state_t)
+{
+    return true;
+}
+
+template<typename T>
+void readDelegate(const T* pSource, timespec* pTimestamp, T* pValue)
+{
+    pTimestamp->tv_sec = 0;
+    pTimestamp->tv_nsec = 0;
+    *pValue = *pSource;
+}
+
+/*
+ * PVVariableIn::setValue with 0, 1 or N subscribed output PVs
+ *
+ *************************************************************/
+template<typename T>
+void benchmarkSetValue(nds::Factory& factory, const size_t elements, const size_t subscribers)
+{
+    {
+        nds::Port rootNode(getUniqueNodeName());
+        nds::PVVariableIn<T> variable = rootNode.addChild(nds::PVVariableIn<T>("variable"));
+        std::vector<nds::PVVariableOut<T> > outputs;
+        for(size_t addOutput(0); addOutput != subscribers; ++addOutput)
+        {
+            std::ostringstream outputName;
+            outputName << "output" << addOutput;
+            outputs.push_back(rootNode.addChild(nds::PVVariableOut<T>(outputName.str())));
+        }
+        rootNode.initialize(0, factory);
+
+        for(size_t subscribe(0); subscribe != subscribers; ++subscribe)
+        {
+            factory.subscribe(variable.getFullName(), outputs[subscribe].getFullName());
+        }
+
+        const T value(BenchmarkType<T>::getValue(elements));
+        measure("PVVariableIn::setValue", BenchmarkType<T>::getName(), elements, subscribers, 0,
+                [&variable, &value]() { variable.setValue(value); });
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * PVDelegateIn::read, called via the control system interface
+ *
+ **************************************************************/
+template<typename T>
+void benchmarkDelegateRead(nds::Factory& factory, const size_t elements)
+{
+    {
+        const T value(BenchmarkType<T>::getValue(elements));
+
+        const std::string nodeName(getUniqueNodeName());
+        nds::Port rootNode(nodeName);
+        nds::PVDelegateIn<T> delegate = rootNode.addChild(nds::PVDelegateIn<T>("delegate",
+                                                                              std::bind(&readDelegate<T>, &value, std::placeholders::_1, std::placeholders::_2)));
+        rootNode.initialize(0, factory);
+
+        nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance(nodeName);
+        const std::string pvName(delegate.getFullExternalName());
+        timespec readTimestamp;
+        T readValue;
+        measure("PVDelegateIn::read", BenchmarkType<T>::getName(), elements, 0, 0,
+                [pInterface, &pvName, &readTimestamp, &readValue]() { pInterface->readCSValue(pvName, &readTimestamp, &readValue); });
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * DataAcquisition::push with 0, 1 or N subscribed output PVs
+ *  and replication targets
+ *
+ ************************************************************/
+template<typename T>
+void benchmarkPush(nds::Factory& factory, const size_t elements, const size_t subscribers, const size_t replicas)
+{
+    {
+        nds::Port rootNode(getUniqueNodeName());
+        nds::DataAcquisition<T> acquisition = rootNode.addChild(nds::DataAcquisition<T>("acquisition", elements,
+                                                                                        &doNothing, &doNothing, &doNothing, &doNothing, &doNothing,
+                                                                                        &allowChange));
+        std::vector<nds::PVVariableOut<T> > outputs;
+        for(size_t addOutput(0); addOutput != subscribers; ++addOutput)
+        {
+            std::ostringstream outputName;
+            outputName << "output" << addOutput;
+            outputs.push_back(rootNode.addChild(nds::PVVariableOut<T>(outputName.str())));
+        }
+        std::vector<nds::PVVariableIn<T> > destinations;
+        for(size_t addDestination(0); addDestination != replicas; ++addDestination)
+        {
+            std::ostringstream destinationName;
+            destinationName << "replica" << addDestination;
+            destinations.push_back(rootNode.addChild(nds::PVVariableIn<T>(destinationName.str())));
+        }
+        rootNode.initialize(0, factory);
+
+        const std::string dataPVName(acquisition.getFullName() + "-Data");
+        for(size_t subscribe(0); subscribe != subscribers; ++subscribe)
+        {
+            factory.subscribe(dataPVName, outputs[subscribe].getFullName());
+        }
+        for(size_t replicate(0); replicate != replicas; ++replicate)
+        {
+            destinations[replicate].replicateFrom(dataPVName);
+        }
+
+        const T value(BenchmarkType<T>::getValue(elements));
+        const timespec timestamp = {0, 0};
+        measure("DataAcquisition::push", BenchmarkType<T>::getName(), elements, subscribers, replicas,
+                [&acquisition, &timestamp, &value]() { acquisition.push(timestamp, value); });
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * PVBaseIn::push on ports with asynchronous delivery, from one thread
+ *  or from several threads pushing at the same time on the PVs of
+ *  different ports. The push reaches the queue through a plain atomic
+ *  pointer and the producers share no lock: on a machine with enough
+ *  cores the time per push does not grow with the number of producers.
+ *
+ *********************************************************************/
+void benchmarkAsyncPush(nds::Factory& factory, const size_t producers)
+{
+    const std::uint64_t pushesPerProducer(1000000);
+    {
+        std::vector<nds::Port> ports;
+        std::vector<nds::PVVariableIn<std::int32_t> > variables;
+        for(size_t addProducer(0); addProducer != producers; ++addProducer)
+        {
+            ports.push_back(nds::Port(getUniqueNodeName()));
+            ports.back().setAsyncDelivery(1024, nds::overflowPolicy_t::dropOldest);
+            variables.push_back(ports.back().addChild(nds::PVVariableIn<std::int32_t>("variable")));
+            ports.back().initialize(0, factory);
+        }
+
+        std::atomic<bool> bStart(false);
+        std::vector<std::thread> threads;
+        for(size_t scanProducers(0); scanProducers != producers; ++scanProducers)
+        {
+            nds::PVVariableIn<std::int32_t>* pVariable(&(variables[scanProducers]));
+            threads.push_back(std::thread([pVariable, &bStart, pushesPerProducer]()
+            {
+                while(!bStart.load())
+                {
+                }
+                const timespec timestamp = {0, 0};
+                for(std::uint64_t scanPushes(0); scanPushes != pushesPerProducer; ++scanPushes)
+                {
+                    pVariable->push(timestamp, (std::int32_t)scanPushes);
+                }
+            }));
+        }
+
+        const std::uint64_t startAllocations(m_allocations.load());
+        const std::chrono::steady_clock::time_point startTime(std::chrono::steady_clock::now());
+        bStart.store(true);
+        for(std::vector<std::thread>::iterator scanThreads(threads.begin()), endThreads(threads.end()); scanThreads != endThreads; ++scanThreads)
+        {
+            scanThreads->join();
+        }
+        const std::chrono::steady_clock::duration elapsed(std::chrono::steady_clock::now() - startTime);
+        const std::uint64_t allocations(m_allocations.load() - startAllocations);
+
+        std::ostringstream benchmarkName;
+        benchmarkName << "PVBaseIn::push async producers=" << producers;
+
+        Result result;
+        result.m_benchmark = benchmarkName.str();
+        result.m_dataType = BenchmarkType<std::int32_t>::getName();
+        result.m_elements = 1;
+        result.m_subscribers = 0;
+        result.m_replicas = 0;
+        result.m_iterations = pushesPerProducer;
+        result.m_nsPerOp = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (double)pushesPerProducer;
+        result.m_allocationsPerOp = (double)allocations / (double)(pushesPerProducer * producers);
+        m_results.push_back(result);
+
+        std::cerr << result.m_benchmark << " " << result.m_dataType << ": " << result.m_nsPerOp << " ns/op" << std::endl;
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * StateMachine::setState on a synchronous state machine,
+ *  alternating between on and off
+ *
+ ********************************************************/
+void benchmarkSetState(nds::Factory& factory)
+{
+    {
+        nds::Port rootNode(getUniqueNodeName());
+        nds::StateMachine stateMachine = rootNode.addChild(nds::StateMachine(false, &doNothing, &doNothing, &doNothing, &doNothing, &doNothing, &allowChange));
+        rootNode.initialize(0, factory);
+
+        bool bSwitchOn(true);
+        measure("StateMachine::setState", "", 1, 0, 0,
+                [&stateMachine, &bSwitchOn]()
+        {
+            stateMachine.setState(bSwitchOn ? nds::state_t::on : nds::state_t::off);
+            bSwitchOn = !bSwitchOn;
+        });
+        if(!bSwitchOn)
+        {
+            stateMachine.setState(nds::state_t::off);
+        }
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * StateMachine::getGlobalState on a root node with 2000 channels,
+ *  each one with its own state machine
+ *
+ *****************************************************************/
+void benchmarkGetGlobalState(nds::Factory& factory)
+{
+    const size_t numChannels(2000);
+    {
+        nds::Port rootNode(getUniqueNodeName());
+        nds::StateMachine stateMachine = rootNode.addChild(nds::StateMachine(false, &doNothing, &doNothing, &doNothing, &doNothing, &doNothing, &allowChange));
+        std::vector<nds::StateMachine> channelsStateMachines;
+        channelsStateMachines.reserve(numChannels);
+        for(size_t scanChannels(0); scanChannels != numChannels; ++scanChannels)
+        {
+            std::ostringstream channelName;
+            channelName << "channel" << scanChannels;
+            nds::Node channel = rootNode.addChild(nds::Node(channelName.str()));
+            channelsStateMachines.push_back(channel.addChild(nds::StateMachine(false, &doNothing, &doNothing, &doNothing, &doNothing, &doNothing, &allowChange)));
+        }
+        rootNode.initialize(0, factory);
+        channelsStateMachines[numChannels / 2].setState(nds::state_t::on);
+
+        measure("StateMachine::getGlobalState", "", numChannels, 0, 0,
+                [&stateMachine]() { stateMachine.getGlobalState(); });
+    }
+    factory.destroyDevice("");
+}
+
+/*
+ * Initialization and destruction of a synthetic tree with 100k PVs,
+ *  with naming rules that exercise the separators and the templates
+ *
+ *******************************************************************/
+void benchmarkStartup(nds::Factory& factory)
+{
+    const size_t numChannels(100);
+    const size_t pvsPerChannel(1000);
+
+    std::string rules;
+    rules += "[BENCHMARK]\n";
+    rules += "separator0 = /\n";
+    rules += "separator1 = :\n";
+    rules += "separator2 = -\n";
+    rules += "rootNode = ROOT%s\n";
+    rules += "genericNode = CH%3s\n";
+    rules += "inputPV = GET_%s\n";
+    rules += "outputPV = SET_%s\n";
+    rules += "toUpper = 1\n";
+    std::istringstream rulesStream(rules);
+    factory.loadNamingRules(rulesStream);
+
+    {
+        nds::Port rootNode(getUniqueNodeName());
+        for(size_t scanChannels(0); scanChannels != numChannels; ++scanChannels)
+        {
+            std::ostringstream channelName;
+            channelName << scanChannels;
+            nds::Node channel = rootNode.addChild(nds::Node(channelName.str()));
+            for(size_t scanPVs(0); scanPVs != pvsPerChannel; ++scanPVs)
+            {
+                std::ostringstream pvName;
+                pvName << "value" << scanPVs;
+                if((scanPVs & 1) == 0)
+                {
+                    channel.addChild(nds::PVVariableIn<std::int32_t>(pvName.str()));
+                }
+                else
+                {
+                    channel.addChild(nds::PVVariableOut<std::int32_t>(pvName.str()));
+                }
+            }
+        }
+
+        measureOnce("Node::initialize", numChannels * pvsPerChannel, [&rootNode, &factory]()
+        {
+            rootNode.initialize(0, factory);
+        });
+    }
+    measureOnce("Factory::destroyDevice", numChannels * pvsPerChannel, [&factory]()
+    {
+        factory.destroyDevice("");
+    });
+
+    factory.setNamingRules("");
+}
+
+/*
+ * Registration of 100k PVs with the test control system interface,
+ *  one PV at a time and with a single registerPVs() call
+ *
+ ******************************************************************/
+void benchmarkRegistration()
+{
+    const size_t numPVs(100000);
+
+    nds::FactoryBaseImpl& controlSystem(*nds::tests::TestControlSystemFactoryImpl::getInstance());
+
+    nds::InterfaceBaseImpl::pvsList_t pvs;
+    pvs.reserve(numPVs);
+    for(size_t scanPVs(0); scanPVs != numPVs; ++scanPVs)
+    {
+        std::ostringstream pvName;
+        pvName << "registration" << scanPVs;
+        std::shared_ptr<nds::PVBaseImpl> pPV(std::make_shared<nds::PVVariableInImpl<std::int32_t> >(pvName.str()));
+        pPV->prepareInitialization(controlSystem, 1);
+        pvs.push_back(pPV);
+    }
+
+    {
+        nds::tests::TestControlSystemInterfaceImpl interface(getUniqueNodeName());
+        measureOnce("InterfaceBaseImpl::registerPV", numPVs, [&interface, &pvs]()
+        {
+            for(nds::InterfaceBaseImpl::pvsList_t::const_iterator scanPVs(pvs.begin()), endPVs(pvs.end()); scanPVs != endPVs; ++scanPVs)
+            {
+                interface.registerPV(*scanPVs);
+            }
+        });
+    }
+
+    {
+        nds::tests::TestControlSystemInterfaceImpl interface(getUniqueNodeName());
+        measureOnce("InterfaceBaseImpl::registerPVs", numPVs, [&interface, &pvs]()
+        {
+            interface.registerPVs(pvs);
+        });
+    }
+}
+
+template<typename T>
+void benchmarkDataType(nds::Factory& factory)
+{
+    std::vector<size_t> sizes;
+    sizes.push_back(1);
+    if(BenchmarkType<T>::isArray())
+    {
+        for(size_t size(16); size <= 1024 * 1024; size *= 16)
+        {
+            sizes.push_back(size);
+        }
+    }
+
+    for(std::vector<size_t>::const_iterator scanSizes(sizes.begin()), endSizes(sizes.end()); scanSizes != endSizes; ++scanSizes)
+    {
+        benchmarkSetValue<T>(factory, *scanSizes, 0);
+        benchmarkSetValue<T>(factory, *scanSizes, 1);
+        benchmarkSetValue<T>(factory, *scanSizes, m_manyReceivers);
+
+        benchmarkDelegateRead<T>(factory, *scanSizes);
+
+        benchmarkPush<T>(factory, *scanSizes, 0, 0);
+        benchmarkPush<T>(factory, *scanSizes, 1, 0);
+        benchmarkPush<T>(factory, *scanSizes, m_manyReceivers, 0);
+        benchmarkPush<T>(factory, *scanSizes, 0, 1);
+        benchmarkPush<T>(factory, *scanSizes, 0, m_manyReceivers);
+    }
+}
+
+void writeResults(std::ostream& output)
+{
+    output << "{\n  \"benchmarks\": [";
+    for(std::vector<Result>::const_iterator scanResults(m_results.begin()), endResults(m_results.end()); scanResults != endResults; ++scanResults)
+    {
+        output << (scanResults == m_results.begin() ? "\n" : ",\n")
+               << "    {"
+               << "\"benchmark\": \"" << scanResults->m_benchmark << "\", "
+               << "\"dataType\": \"" << scanResults->m_dataType << "\", "
+               << "\"elements\": " << scanResults->m_elements << ", "
+               << "\"subscribers\": " << scanResults->m_subscribers << ", "
+               << "\"replicas\": " << scanResults->m_replicas << ", "
+               << "\"iterations\": " << scanResults->m_iterations << ", "
+               << "\"nsPerOp\": " << scanResults->m_nsPerOp << ", "
+               << "\"allocationsPerOp\": " << scanResults->m_allocationsPerOp
+               << "}";
+    }
+    output << "\n  ]\n}\n";
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    nds::Factory testControlSystem(std::shared_ptr<nds::FactoryBaseImpl>(new nds::tests::TestControlSystemFactoryImpl()));
+    nds::Factory::registerControlSystem(testControlSystem);
+
+    nds::Factory factory("test");
+
+    benchmarkDataType<std::int32_t>(factory);
+    benchmarkDataType<double>(factory);
+    benchmarkDataType<std::vector<std::int8_t> >(factory);
+    benchmarkDataType<std::vector<std::uint8_t> >(factory);
+    benchmarkDataType<std::vector<std::int32_t> >(factory);
+    benchmarkDataType<std::vector<double> >(factory);
+    benchmarkDataType<std::string>(factory);
+    benchmarkAsyncPush(factory, 1);
+    benchmarkAsyncPush(factory, m_manyReceivers);
+    benchmarkSetState(factory);
+    benchmarkGetGlobalState(factory);
+    benchmarkStartup(factory);
+    benchmarkRegistration();
+
+    if(argc > 1)
+    {
+        std::ofstream outputFile(argv[1]);
+        writeResults(outputFile);
+    }
+    else
+    {
+        writeResults(std::cout);
+    }
+    return 0;
+}
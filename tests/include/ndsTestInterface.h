@@ -4,6 +4,7 @@
 #include <nds3/impl/interfaceBaseImpl.h>
 #include <nds3/definitions.h>
 #include <vector>
+#include <unordered_map>
 
 namespace nds
 {
@@ -27,6 +28,10 @@ public:
 
     virtual void deregisterPV(std::shared_ptr<PVBaseImpl> pv);
 
+    virtual void registerPVs(const pvsList_t& pvs);
+
+    virtual void deregisterPVs(const pvsList_t& pvs);
+
     virtual void registrationTerminated();
 
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::int32_t& value);
@@ -36,6 +41,28 @@ public:
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int32_t> & value);
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<double> & value);
     virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::string & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::int16_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::uint16_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::int64_t& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const float& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int16_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::uint16_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int64_t> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<float> & value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int8_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint8_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int32_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<double> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int16_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint16_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int64_t> >& value);
+    virtual void push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<float> >& value);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int32_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const double* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int16_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::uint16_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int64_t* pValues, const size_t count);
+    virtual void pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const float* pValues, const size_t count);
 
     template<typename T>
     void readCSValue(const std::string& pvName, timespec* pTimestamp, T* pValue);
@@ -50,12 +77,55 @@ public:
     void getPushedVectorInt32(const std::string& pvName, const timespec*& pTime, const std::vector<std::int32_t>*& pValue);
     void getPushedVectorDouble(const std::string& pvName, const timespec*& pTime, const std::vector<double>*& pValue);
     void getPushedString(const std::string& pvName, const timespec*& pTime, const std::string*& pValue);
+    void getPushedInt16(const std::string& pvName, const timespec*& pTime, const std::int16_t*& pValue);
+    void getPushedUint16(const std::string& pvName, const timespec*& pTime, const std::uint16_t*& pValue);
+    void getPushedInt64(const std::string& pvName, const timespec*& pTime, const std::int64_t*& pValue);
+    void getPushedFloat(const std::string& pvName, const timespec*& pTime, const float*& pValue);
+    void getPushedVectorInt16(const std::string& pvName, const timespec*& pTime, const std::vector<std::int16_t>*& pValue);
+    void getPushedVectorUint16(const std::string& pvName, const timespec*& pTime, const std::vector<std::uint16_t>*& pValue);
+    void getPushedVectorInt64(const std::string& pvName, const timespec*& pTime, const std::vector<std::int64_t>*& pValue);
+    void getPushedVectorFloat(const std::string& pvName, const timespec*& pTime, const std::vector<float>*& pValue);
+
+    /*
+     * Return the address of the data held by the last SharedBuffer pushed
+     *  to the PV, so the tests can verify that it has not been copied
+     */
+    const void* getPushedBufferAddress(const std::string& pvName);
+
+    /*
+     * Return the number of pushBatch() calls received for the PV
+     */
+    size_t getPushedBatches(const std::string& pvName);
+
+    /*
+     * Return the number of PVs that were registered when registrationTerminated()
+     *  was called
+     */
+    size_t getRegisteredPVsAtTermination() const;
+
+    /*
+     * Return the number of registerPVs() calls received by the interface
+     */
+    size_t getRegistrationBatches() const;
+
+    /*
+     * Return the number of PVs currently registered
+     */
+    size_t getRegisteredPVsNumber() const;
+
+    /*
+     * Return a registered PV, so the tests can push data for it through
+     *  another interface
+     */
+    const PVBaseImpl& getRegisteredPV(const std::string& pvName) const;
 
 private:
     const std::string m_name;
 
-    typedef std::map<std::string, PVBaseImpl*> registeredPVs_t;
+    typedef std::unordered_map<std::string, PVBaseImpl*> registeredPVs_t;
     registeredPVs_t m_registeredPVs;
+    size_t m_registeredPVsAtTermination;
+    size_t m_registrationBatches;
 
     template <typename T>
     class PushedValues
@@ -100,6 +170,33 @@ private:
     std::map<std::string, PushedValues<std::vector<std::int32_t> > >m_pushedVectorInt32;
     std::map<std::string, PushedValues<std::vector<double> > >m_pushedVectorDouble;
     std::map<std::string, PushedValues<std::string> >m_pushedString;
+    std::map<std::string, PushedValues<std::int16_t> >m_pushedInt16;
+    std::map<std::string, PushedValues<std::uint16_t> >m_pushedUint16;
+    std::map<std::string, PushedValues<std::int64_t> >m_pushedInt64;
+    std::map<std::string, PushedValues<float> >m_pushedFloat;
+    std::map<std::string, PushedValues<std::vector<std::int16_t> > >m_pushedVectorInt16;
+    std::map<std::string, PushedValues<std::vector<std::uint16_t> > >m_pushedVectorUint16;
+    std::map<std::string, PushedValues<std::vector<std::int64_t> > >m_pushedVectorInt64;
+    std::map<std::string, PushedValues<std::vector<float> > >m_pushedVectorFloat;
+
+    std::map<std::string, const void*> m_pushedBufferAddresses;
+
+    std::map<std::string, size_t> m_pushedBatches;
+
+    template <typename T>
+    void storePushedBatch(const std::string& pvName,
+                          std::map<std::string, PushedValues<T> >& storeInto,
+                          const timespec* pTimestamps,
+                          const T* pValues,
+                          const size_t count)
+    {
+        ++m_pushedBatches[pvName];
+        PushedValues<T>& pushedValues(storeInto[pvName]);
+        for(size_t scanSamples(0); scanSamples != count; ++scanSamples)
+        {
+            pushedValues.storeValue(pTimestamps[scanSamples], pValues[scanSamples]);
+        }
+    }
 
     template <typename T>
     void storePushedData(const std::string& pvName,
@@ -0,0 +1,33 @@
+#include <nds3/nds.h>
+
+/*
+ * Device module used by the driver reload tests.
+ *
+ * Compiled several times: RELOADED_MODULE_DRIVER selects the name of the
+ *  exported driver and RELOADED_MODULE_VERSION the value of the version
+ *  PV, so the tests can tell which module created a device.
+ *
+ * The device class has internal linkage: two versions loaded at the same
+ *  time don't resolve their symbols to each other.
+ */
+namespace
+{
+
+class ReloadedDevice
+{
+public:
+    ReloadedDevice(nds::Factory& factory, const std::string& deviceName, const nds::namedParameters_t& /* parameters */)
+    {
+        nds::Port rootNode(deviceName);
+        nds::PVVariableIn<std::int32_t> version(rootNode.addChild(nds::PVVariableIn<std::int32_t>("version")));
+        version.setValue(RELOADED_MODULE_VERSION);
+        rootNode.initialize(this, factory);
+    }
+};
+
+}
+
+// Expand RELOADED_MODULE_DRIVER before NDS_DEFINE_DRIVER stringizes it
+////////////////////////////////////////////////////////////////////////
+#define DEFINE_RELOADED_DRIVER(driverName) NDS_DEFINE_DRIVER(driverName, ReloadedDevice)
+DEFINE_RELOADED_DRIVER(RELOADED_MODULE_DRIVER)
@@ -61,9 +61,9 @@ size_t TestControlSystemFactoryImpl::getRegisteredCommandsNumber()
     return m_commandNodes.size();
 }
 
-void TestControlSystemFactoryImpl::executeCommand(const std::string& command, const std::string& node, nds::parameters_t& parameters)
+nds::parameters_t TestControlSystemFactoryImpl::executeCommand(const std::string& command, const std::string& node, nds::parameters_t& parameters)
 {
-    m_commandNodes[node][command](parameters);
+    return m_commandNodes[node][command](parameters);
 }
 
 const std::string& TestControlSystemFactoryImpl::getDefaultSeparator(const uint32_t nodeLevel) const
@@ -11,7 +11,7 @@ static std::mutex m_lockInterfacesMap;
 
 
 TestControlSystemInterfaceImpl::TestControlSystemInterfaceImpl(const std::string &fullName):
-    m_name(fullName)
+    m_name(fullName), m_registeredPVsAtTermination(0), m_registrationBatches(0)
 {
     std::lock_guard<std::mutex> lock(m_lockInterfacesMap);
     if(m_interfacesMap.find(fullName) != m_interfacesMap.end())
@@ -52,9 +52,55 @@ void TestControlSystemInterfaceImpl::deregisterPV(std::shared_ptr<PVBaseImpl> pv
     m_registeredPVs.erase(pv->getFullExternalName());
 }
 
+void TestControlSystemInterfaceImpl::registerPVs(const pvsList_t& pvs)
+{
+    ++m_registrationBatches;
+
+    // Size the table once for the whole port
+    /////////////////////////////////////////
+    m_registeredPVs.reserve(m_registeredPVs.size() + pvs.size());
+    for(pvsList_t::const_iterator scanPVs(pvs.begin()), endPVs(pvs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        m_registeredPVs[(*scanPVs)->getFullExternalName()] = scanPVs->get();
+    }
+}
+
+void TestControlSystemInterfaceImpl::deregisterPVs(const pvsList_t& pvs)
+{
+    for(pvsList_t::const_iterator scanPVs(pvs.begin()), endPVs(pvs.end()); scanPVs != endPVs; ++scanPVs)
+    {
+        m_registeredPVs.erase((*scanPVs)->getFullExternalName());
+    }
+}
+
 void TestControlSystemInterfaceImpl::registrationTerminated()
 {
+    m_registeredPVsAtTermination = m_registeredPVs.size();
+}
+
+size_t TestControlSystemInterfaceImpl::getRegisteredPVsAtTermination() const
+{
+    return m_registeredPVsAtTermination;
+}
 
+size_t TestControlSystemInterfaceImpl::getRegistrationBatches() const
+{
+    return m_registrationBatches;
+}
+
+size_t TestControlSystemInterfaceImpl::getRegisteredPVsNumber() const
+{
+    return m_registeredPVs.size();
+}
+
+const PVBaseImpl& TestControlSystemInterfaceImpl::getRegisteredPV(const std::string& pvName) const
+{
+    registeredPVs_t::const_iterator findPV(m_registeredPVs.find(pvName));
+    if(findPV == m_registeredPVs.end())
+    {
+        throw std::runtime_error("PV not registered");
+    }
+    return *(findPV->second);
 }
 
 void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::int32_t& value)
@@ -92,6 +138,94 @@ void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec&
     storePushedData(pv.getFullExternalName(), m_pushedString, timestamp, value);
 }
 
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::int16_t& value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedInt16, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::uint16_t& value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedUint16, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::int64_t& value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedInt64, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const float& value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedFloat, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int16_t> & value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt16, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::uint16_t> & value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedVectorUint16, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<std::int64_t> & value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt64, timestamp, value);
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const std::vector<float> & value)
+{
+    storePushedData(pv.getFullExternalName(), m_pushedVectorFloat, timestamp, value);
+}
+
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int8_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt8, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint8_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorUint8, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int32_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt32, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<double> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorDouble, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int16_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt16, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::uint16_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorUint16, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<std::int64_t> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorInt64, timestamp, value.get());
+}
+
+void TestControlSystemInterfaceImpl::push(const PVBaseImpl& pv, const timespec& timestamp, const SharedBuffer<std::vector<float> >& value)
+{
+    m_pushedBufferAddresses[pv.getFullExternalName()] = value->data();
+    storePushedData(pv.getFullExternalName(), m_pushedVectorFloat, timestamp, value.get());
+}
 
 
 template<typename T>
@@ -112,6 +246,14 @@ template void TestControlSystemInterfaceImpl::readCSValue<std::vector<std::uint8
 template void TestControlSystemInterfaceImpl::readCSValue<std::vector<std::int32_t> >(const std::string& pvName, timespec* timestamp, std::vector<std::int32_t>* value);
 template void TestControlSystemInterfaceImpl::readCSValue<std::vector<double> >(const std::string& pvName, timespec* timestamp, std::vector<double>* value);
 template void TestControlSystemInterfaceImpl::readCSValue<std::string>(const std::string& pvName, timespec* timestamp, std::string* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::int16_t>(const std::string& pvName, timespec* timestamp, std::int16_t* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::uint16_t>(const std::string& pvName, timespec* timestamp, std::uint16_t* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::int64_t>(const std::string& pvName, timespec* timestamp, std::int64_t* value);
+template void TestControlSystemInterfaceImpl::readCSValue<float>(const std::string& pvName, timespec* timestamp, float* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::vector<std::int16_t> >(const std::string& pvName, timespec* timestamp, std::vector<std::int16_t>* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::vector<std::uint16_t> >(const std::string& pvName, timespec* timestamp, std::vector<std::uint16_t>* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::vector<std::int64_t> >(const std::string& pvName, timespec* timestamp, std::vector<std::int64_t>* value);
+template void TestControlSystemInterfaceImpl::readCSValue<std::vector<float> >(const std::string& pvName, timespec* timestamp, std::vector<float>* value);
 
 
 template<typename T>
@@ -132,6 +274,14 @@ template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<std::uint
 template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<std::int32_t> >(const std::string& pvName, const timespec& timestamp, const std::vector<std::int32_t>& value);
 template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<double> >(const std::string& pvName, const timespec& timestamp, const std::vector<double>& value);
 template void TestControlSystemInterfaceImpl::writeCSValue<std::string>(const std::string& pvName, const timespec& timestamp, const std::string& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::int16_t>(const std::string& pvName, const timespec& timestamp, const std::int16_t& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::uint16_t>(const std::string& pvName, const timespec& timestamp, const std::uint16_t& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::int64_t>(const std::string& pvName, const timespec& timestamp, const std::int64_t& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<float>(const std::string& pvName, const timespec& timestamp, const float& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<std::int16_t> >(const std::string& pvName, const timespec& timestamp, const std::vector<std::int16_t>& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<std::uint16_t> >(const std::string& pvName, const timespec& timestamp, const std::vector<std::uint16_t>& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<std::int64_t> >(const std::string& pvName, const timespec& timestamp, const std::vector<std::int64_t>& value);
+template void TestControlSystemInterfaceImpl::writeCSValue<std::vector<float> >(const std::string& pvName, const timespec& timestamp, const std::vector<float>& value);
 
 
 void TestControlSystemInterfaceImpl::getPushedInt32(const std::string& pvName, const timespec*& pTime, const std::int32_t*& pValue)
@@ -169,6 +319,91 @@ void TestControlSystemInterfaceImpl::getPushedString(const std::string& pvName,
     return getPushedData(pvName, m_pushedString, pTime, pValue);
 }
 
+void TestControlSystemInterfaceImpl::getPushedInt16(const std::string& pvName, const timespec*& pTime, const std::int16_t*& pValue)
+{
+    return getPushedData(pvName, m_pushedInt16, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedUint16(const std::string& pvName, const timespec*& pTime, const std::uint16_t*& pValue)
+{
+    return getPushedData(pvName, m_pushedUint16, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedInt64(const std::string& pvName, const timespec*& pTime, const std::int64_t*& pValue)
+{
+    return getPushedData(pvName, m_pushedInt64, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedFloat(const std::string& pvName, const timespec*& pTime, const float*& pValue)
+{
+    return getPushedData(pvName, m_pushedFloat, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedVectorInt16(const std::string& pvName, const timespec*& pTime, const std::vector<std::int16_t>*& pValue)
+{
+    return getPushedData(pvName, m_pushedVectorInt16, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedVectorUint16(const std::string& pvName, const timespec*& pTime, const std::vector<std::uint16_t>*& pValue)
+{
+    return getPushedData(pvName, m_pushedVectorUint16, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedVectorInt64(const std::string& pvName, const timespec*& pTime, const std::vector<std::int64_t>*& pValue)
+{
+    return getPushedData(pvName, m_pushedVectorInt64, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::getPushedVectorFloat(const std::string& pvName, const timespec*& pTime, const std::vector<float>*& pValue)
+{
+    return getPushedData(pvName, m_pushedVectorFloat, pTime, pValue);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int32_t* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedInt32, pTimestamps, pValues, count);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const double* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedDouble, pTimestamps, pValues, count);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int16_t* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedInt16, pTimestamps, pValues, count);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::uint16_t* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedUint16, pTimestamps, pValues, count);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const std::int64_t* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedInt64, pTimestamps, pValues, count);
+}
+
+void TestControlSystemInterfaceImpl::pushBatch(const PVBaseImpl& pv, const timespec* pTimestamps, const float* pValues, const size_t count)
+{
+    storePushedBatch(pv.getFullExternalName(), m_pushedFloat, pTimestamps, pValues, count);
+}
+
+size_t TestControlSystemInterfaceImpl::getPushedBatches(const std::string& pvName)
+{
+    return m_pushedBatches[pvName];
+}
+
+const void* TestControlSystemInterfaceImpl::getPushedBufferAddress(const std::string& pvName)
+{
+    std::map<std::string, const void*>::const_iterator findAddress = m_pushedBufferAddresses.find(pvName);
+    if(findAddress == m_pushedBufferAddresses.end())
+    {
+        throw std::runtime_error("No shared buffer has been pushed");
+    }
+    return findAddress->second;
+}
+
 }
 
 }
@@ -3,6 +3,12 @@
 #include "testDevice.h"
 #include "ndsTestInterface.h"
 #include "ndsTestFactory.h"
+#include <unistd.h>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 TEST(testDataAcquisition, testPushData)
 {
@@ -159,3 +165,435 @@ TEST(testDataAcquisition, testDecimation)
 
 }
 
+
+TEST(testDataAcquisition, testPushSharedBuffer)
+{
+    nds::Factory factory("test");
+
+    factory.createDevice("testDevice", "rootNode", nds::namedParameters_t());
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("rootNode-Channel1");
+    TestDevice* pDevice = TestDevice::getInstance("rootNode");
+
+    nds::SharedBufferPool<std::vector<std::int32_t> > pool(2, 100);
+
+    for(std::int32_t numAcquisitions(0); numAcquisitions != 10; ++numAcquisitions)
+    {
+        std::shared_ptr<std::vector<std::int32_t> > pBuffer(pool.getBuffer());
+        pBuffer->resize(100);
+        for(size_t fillBuffer(0); fillBuffer != pBuffer->size(); ++fillBuffer)
+        {
+            (*pBuffer)[fillBuffer] = numAcquisitions + (std::int32_t)fillBuffer;
+        }
+
+        timespec timestamp = {numAcquisitions, 0};
+        pDevice->m_dataAcquisition.push(timestamp, nds::SharedBuffer<std::vector<std::int32_t> >(pBuffer));
+
+        // The control system must receive the very same memory
+        ////////////////////////////////////////////////////////
+        EXPECT_EQ((const void*)pBuffer->data(), pInterface->getPushedBufferAddress("/rootNode-Channel1.data.Data"));
+
+        const std::vector<std::int32_t>* pRetrievedPushedValues;
+        const timespec* pTime;
+        pInterface->getPushedVectorInt32("/rootNode-Channel1.data.Data", pTime, pRetrievedPushedValues);
+        EXPECT_EQ(numAcquisitions, pTime->tv_sec);
+        ASSERT_EQ(100u, pRetrievedPushedValues->size());
+        for(size_t compare(0); compare != pRetrievedPushedValues->size(); ++compare)
+        {
+            EXPECT_EQ(numAcquisitions + (std::int32_t)compare, (*pRetrievedPushedValues)[compare]);
+        }
+    }
+
+    // The buffers have been released by the control system: the pool didn't need to grow
+    //////////////////////////////////////////////////////////////////////////////////////
+    EXPECT_EQ(2u, pool.getSize());
+
+    // The containers added when the pool grows are reserved too
+    ////////////////////////////////////////////////////////////
+    std::shared_ptr<std::vector<std::int32_t> > pHeld0(pool.getBuffer());
+    std::shared_ptr<std::vector<std::int32_t> > pHeld1(pool.getBuffer());
+    std::shared_ptr<std::vector<std::int32_t> > pGrown(pool.getBuffer());
+    EXPECT_EQ(3u, pool.getSize());
+    EXPECT_LE(100u, pGrown->capacity());
+
+    factory.destroyDevice("rootNode");
+}
+
+static void doNothing()
+{
+}
+
+static bool allowChange(const nds::state_t, const nds::state_t, const nds::state_t)
+{
+    return true;
+}
+
+template<typename T>
+static nds::DataAcquisition<std::vector<T> > createAcquisitionNode(const std::string& name)
+{
+    return nds::DataAcquisition<std::vector<T> >(name, 100, doNothing, doNothing, doNothing, doNothing, doNothing,
+                                                 std::bind(allowChange, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+}
+
+static void startAcquisition(nds::tests::TestControlSystemInterfaceImpl* pInterface, const std::string& stateMachineName)
+{
+    timespec timestamp = {0, 0};
+    pInterface->writeCSValue(stateMachineName + ".setState", timestamp, (std::int32_t)nds::state_t::on);
+    pInterface->writeCSValue(stateMachineName + ".setState", timestamp, (std::int32_t)nds::state_t::running);
+
+    std::int32_t state((std::int32_t)nds::state_t::unknown);
+    for(int waitState(0); waitState != 1000 && state != (std::int32_t)nds::state_t::running; ++waitState)
+    {
+        ::usleep(1000);
+        pInterface->readCSValue(stateMachineName + ".getState", &timestamp, &state);
+    }
+    ASSERT_EQ((std::int32_t)nds::state_t::running, state);
+}
+
+TEST(testDataAcquisition, testReduction)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("reductionNode");
+    nds::DataAcquisition<std::vector<double> > acquisitionDouble = rootNode.addChild(createAcquisitionNode<double>("dataDouble"));
+    nds::DataAcquisition<std::vector<std::int32_t> > acquisitionInt32 = rootNode.addChild(createAcquisitionNode<std::int32_t>("dataInt32"));
+    nds::DataAcquisition<std::vector<std::int64_t> > acquisitionInt64 = rootNode.addChild(createAcquisitionNode<std::int64_t>("dataInt64"));
+    nds::PVVariableIn<std::vector<double> > replica = rootNode.addChild(nds::PVVariableIn<std::vector<double> >("replica"));
+    replica.setMaxElements(100);
+    replica.setScanType(nds::scanType_t::interrupt, 0);
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("reductionNode");
+
+    factory.replicate(acquisitionDouble.getFullName() + "-Data", replica.getFullName());
+
+    timespec timestamp = {0, 0};
+    pInterface->writeCSValue("/reductionNode-dataDouble.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::minMax);
+    pInterface->writeCSValue("/reductionNode-dataDouble.ReductionFactor", timestamp, (std::int32_t)10);
+    pInterface->writeCSValue("/reductionNode-dataInt32.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::average);
+    pInterface->writeCSValue("/reductionNode-dataInt32.ReductionFactor", timestamp, (std::int32_t)8);
+    pInterface->writeCSValue("/reductionNode-dataInt64.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::average);
+    pInterface->writeCSValue("/reductionNode-dataInt64.ReductionFactor", timestamp, (std::int32_t)4);
+
+    // The settings are applied when the acquisition starts
+    ///////////////////////////////////////////////////////
+    EXPECT_EQ(nds::reductionMode_t::minMax, acquisitionDouble.getReductionMode());
+    EXPECT_EQ(10u, acquisitionDouble.getReductionFactor());
+    startAcquisition(pInterface, "/reductionNode-dataDouble.StateMachine");
+    startAcquisition(pInterface, "/reductionNode-dataInt32.StateMachine");
+    startAcquisition(pInterface, "/reductionNode-dataInt64.StateMachine");
+
+    // 95 samples: the last group contains 5 samples
+    ////////////////////////////////////////////////
+    std::vector<double> dataDouble(95);
+    for(size_t fillData(0); fillData != dataDouble.size(); ++fillData)
+    {
+        dataDouble[fillData] = (fillData % 10 == 3) ? -(double)fillData : (double)fillData;
+    }
+    acquisitionDouble.push(timestamp, dataDouble);
+
+    const timespec* pTime;
+    const std::vector<double>* pReducedDouble;
+    pInterface->getPushedVectorDouble("/reductionNode-dataDouble.Data", pTime, pReducedDouble);
+    ASSERT_EQ(20u, pReducedDouble->size());
+    for(size_t group(0); group != 10; ++group)
+    {
+        EXPECT_EQ(-(double)(group * 10 + 3), (*pReducedDouble)[group * 2]);
+        EXPECT_EQ(group == 9 ? 94.0 : (double)(group * 10 + 9), (*pReducedDouble)[group * 2 + 1]);
+    }
+
+    // The replicated PV receives the full array
+    ////////////////////////////////////////////
+    const std::vector<double>* pReplicated;
+    pInterface->getPushedVectorDouble("/reductionNode-replica", pTime, pReplicated);
+    EXPECT_EQ(dataDouble, *pReplicated);
+
+    std::vector<std::int32_t> dataInt32(20);
+    for(size_t fillData(0); fillData != dataInt32.size(); ++fillData)
+    {
+        dataInt32[fillData] = (std::int32_t)fillData - 10;
+    }
+    acquisitionInt32.push(timestamp, dataInt32);
+
+    const std::vector<std::int32_t>* pReducedInt32;
+    pInterface->getPushedVectorInt32("/reductionNode-dataInt32.Data", pTime, pReducedInt32);
+    ASSERT_EQ(3u, pReducedInt32->size());
+    EXPECT_EQ(-6, (*pReducedInt32)[0]);  // (-10 ... -3) / 8 = -6.5, rounded toward zero
+    EXPECT_EQ(1, (*pReducedInt32)[1]);   // (-2 ... 5) / 8 = 1.5
+    EXPECT_EQ(7, (*pReducedInt32)[2]);   // (6 ... 9) / 4 = 7.5
+
+    // The sums of the int64 samples do not overflow
+    ////////////////////////////////////////////////
+    const std::int64_t maxInt64(std::numeric_limits<std::int64_t>::max());
+    const std::int64_t minInt64(std::numeric_limits<std::int64_t>::min());
+    std::vector<std::int64_t> dataInt64(8);
+    for(size_t fillData(0); fillData != 4; ++fillData)
+    {
+        dataInt64[fillData] = maxInt64 - (std::int64_t)fillData;
+        dataInt64[fillData + 4] = minInt64 + (std::int64_t)fillData;
+    }
+    acquisitionInt64.push(timestamp, dataInt64);
+
+    const std::vector<std::int64_t>* pReducedInt64;
+    pInterface->getPushedVectorInt64("/reductionNode-dataInt64.Data", pTime, pReducedInt64);
+    ASSERT_EQ(2u, pReducedInt64->size());
+    EXPECT_EQ(maxInt64 - 2, (*pReducedInt64)[0]); // max - 1.5, rounded toward zero
+    EXPECT_EQ(minInt64 + 2, (*pReducedInt64)[1]); // min + 1.5, rounded toward zero
+
+    factory.destroyDevice("");
+}
+
+/*
+ * The double groups are reduced by the SSE2 or AVX2 kernels on x86-64,
+ *  the float groups by the plain C++ one: both must give the same result
+ *
+ ***********************************************************************/
+template<typename T>
+static void checkMinMaxNaN(const std::vector<T>& reduced)
+{
+    ASSERT_EQ(10u, reduced.size());
+    EXPECT_EQ((T)0, reduced[0]);
+    EXPECT_EQ((T)9, reduced[1]);
+    for(size_t group(1); group != 4; ++group)
+    {
+        EXPECT_TRUE(std::isnan(reduced[group * 2])) << "group " << group;
+        EXPECT_TRUE(std::isnan(reduced[group * 2 + 1])) << "group " << group;
+    }
+    EXPECT_EQ((T)40, reduced[8]);
+    EXPECT_EQ((T)44, reduced[9]);
+}
+
+TEST(testDataAcquisition, testReductionNaN)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("reductionNaNNode");
+    nds::DataAcquisition<std::vector<double> > acquisitionDouble = rootNode.addChild(createAcquisitionNode<double>("dataDouble"));
+    nds::DataAcquisition<std::vector<float> > acquisitionFloat = rootNode.addChild(createAcquisitionNode<float>("dataFloat"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("reductionNaNNode");
+
+    timespec timestamp = {0, 0};
+    pInterface->writeCSValue("/reductionNaNNode-dataDouble.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::minMax);
+    pInterface->writeCSValue("/reductionNaNNode-dataDouble.ReductionFactor", timestamp, (std::int32_t)10);
+    pInterface->writeCSValue("/reductionNaNNode-dataFloat.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::minMax);
+    pInterface->writeCSValue("/reductionNaNNode-dataFloat.ReductionFactor", timestamp, (std::int32_t)10);
+    startAcquisition(pInterface, "/reductionNaNNode-dataDouble.StateMachine");
+    startAcquisition(pInterface, "/reductionNaNNode-dataFloat.StateMachine");
+
+    // 45 samples in 5 groups. The NaNs are at the start of the second group,
+    //  in the vectorized part of the third and in the tail of the fourth
+    ///////////////////////////////////////////////////////////////////////////
+    std::vector<double> dataDouble(45);
+    std::vector<float> dataFloat(45);
+    for(size_t fillData(0); fillData != dataDouble.size(); ++fillData)
+    {
+        dataDouble[fillData] = (double)fillData;
+        dataFloat[fillData] = (float)fillData;
+    }
+    const size_t nanPositions[] = {10, 25, 39};
+    for(size_t scanPositions(0); scanPositions != sizeof(nanPositions) / sizeof(nanPositions[0]); ++scanPositions)
+    {
+        dataDouble[nanPositions[scanPositions]] = std::numeric_limits<double>::quiet_NaN();
+        dataFloat[nanPositions[scanPositions]] = std::numeric_limits<float>::quiet_NaN();
+    }
+    acquisitionDouble.push(timestamp, dataDouble);
+    acquisitionFloat.push(timestamp, dataFloat);
+
+    const timespec* pTime;
+    const std::vector<double>* pReducedDouble;
+    pInterface->getPushedVectorDouble("/reductionNaNNode-dataDouble.Data", pTime, pReducedDouble);
+    checkMinMaxNaN(*pReducedDouble);
+
+    const std::vector<float>* pReducedFloat;
+    pInterface->getPushedVectorFloat("/reductionNaNNode-dataFloat.Data", pTime, pReducedFloat);
+    checkMinMaxNaN(*pReducedFloat);
+
+    factory.destroyDevice("");
+}
+
+TEST(testDataAcquisition, testReductionDecimation)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("reductionDecimationNode");
+    nds::DataAcquisition<std::vector<double> > acquisition = rootNode.addChild(createAcquisitionNode<double>("data"));
+    nds::PVVariableIn<std::vector<double> > replica = rootNode.addChild(nds::PVVariableIn<std::vector<double> >("replica"));
+    replica.setMaxElements(100);
+    replica.setScanType(nds::scanType_t::interrupt, 0);
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("reductionDecimationNode");
+
+    factory.replicate(acquisition.getFullName() + "-Data", replica.getFullName());
+
+    timespec timestamp = {0, 0};
+    pInterface->writeCSValue("/reductionDecimationNode-data.Decimation", timestamp, (std::int32_t)2);
+    pInterface->writeCSValue("/reductionDecimationNode-data.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::average);
+    pInterface->writeCSValue("/reductionDecimationNode-data.ReductionFactor", timestamp, (std::int32_t)2);
+    startAcquisition(pInterface, "/reductionDecimationNode-data.StateMachine");
+
+    // Only every second array reaches the control system, reduced
+    //////////////////////////////////////////////////////////////
+    const std::vector<double> data[3] = {{1.0, 3.0}, {10.0, 20.0}, {100.0, 300.0}};
+    const timespec* pTime;
+    const std::vector<double>* pReduced;
+    const std::vector<double>* pReplicated;
+
+    acquisition.push(timestamp, data[0]);
+    acquisition.push(timestamp, data[1]);
+    pInterface->getPushedVectorDouble("/reductionDecimationNode-data.Data", pTime, pReduced);
+    ASSERT_EQ(1u, pReduced->size());
+    EXPECT_EQ(15.0, (*pReduced)[0]);
+
+    acquisition.push(timestamp, data[2]);
+    EXPECT_THROW(pInterface->getPushedVectorDouble("/reductionDecimationNode-data.Data", pTime, pReduced), std::runtime_error);
+
+    // The replicated PV receives all the full arrays
+    /////////////////////////////////////////////////
+    for(size_t scanData(0); scanData != 3; ++scanData)
+    {
+        pInterface->getPushedVectorDouble("/reductionDecimationNode-replica", pTime, pReplicated);
+        EXPECT_EQ(data[scanData], *pReplicated);
+    }
+
+    factory.destroyDevice("");
+}
+
+TEST(testDataAcquisition, testInvalidReductionMode)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("invalidReductionNode");
+    nds::DataAcquisition<std::vector<double> > acquisition = rootNode.addChild(createAcquisitionNode<double>("data"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("invalidReductionNode");
+
+    const std::string stateMachineName("/invalidReductionNode-data.StateMachine");
+    timespec timestamp = {0, 0};
+    pInterface->writeCSValue("/invalidReductionNode-data.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::average + 1);
+    pInterface->writeCSValue(stateMachineName + ".setState", timestamp, (std::int32_t)nds::state_t::on);
+
+    std::int32_t state((std::int32_t)nds::state_t::unknown);
+    for(int waitState(0); waitState != 1000 && state != (std::int32_t)nds::state_t::on; ++waitState)
+    {
+        ::usleep(1000);
+        pInterface->readCSValue(stateMachineName + ".getState", &timestamp, &state);
+    }
+    ASSERT_EQ((std::int32_t)nds::state_t::on, state);
+
+    // Discard the states pushed while switching on
+    ///////////////////////////////////////////////
+    const timespec* pTime;
+    const std::int32_t* pState;
+    for(;;)
+    {
+        try
+        {
+            pInterface->getPushedInt32(stateMachineName + ".getState", pTime, pState);
+        }
+        catch(const std::runtime_error&)
+        {
+            break;
+        }
+    }
+
+    // The start is refused and the state machine rolls back to on
+    //////////////////////////////////////////////////////////////
+    pInterface->writeCSValue(stateMachineName + ".setState", timestamp, (std::int32_t)nds::state_t::running);
+    std::vector<std::int32_t> pushedStates;
+    for(int waitState(0); waitState != 1000 && pushedStates.size() != 2; ++waitState)
+    {
+        try
+        {
+            pInterface->getPushedInt32(stateMachineName + ".getState", pTime, pState);
+            pushedStates.push_back(*pState);
+        }
+        catch(const std::runtime_error&)
+        {
+            ::usleep(1000);
+        }
+    }
+    ASSERT_EQ(2u, pushedStates.size());
+    EXPECT_EQ((std::int32_t)nds::state_t::starting, pushedStates[0]);
+    EXPECT_EQ((std::int32_t)nds::state_t::on, pushedStates[1]);
+
+    // A valid mode is accepted by the next start
+    /////////////////////////////////////////////
+    pInterface->writeCSValue("/invalidReductionNode-data.ReductionMode", timestamp, (std::int32_t)nds::reductionMode_t::average);
+    pInterface->writeCSValue(stateMachineName + ".setState", timestamp, (std::int32_t)nds::state_t::running);
+    for(int waitState(0); waitState != 1000 && state != (std::int32_t)nds::state_t::running; ++waitState)
+    {
+        ::usleep(1000);
+        pInterface->readCSValue(stateMachineName + ".getState", &timestamp, &state);
+    }
+    ASSERT_EQ((std::int32_t)nds::state_t::running, state);
+    EXPECT_EQ(nds::reductionMode_t::average, acquisition.getReductionMode());
+
+    factory.destroyDevice("");
+}
+
+/*
+ * Detect at compile time whether pushRaw() can be called on a node
+ *
+ *******************************************************************/
+template<typename A, typename = decltype(std::declval<A&>().pushRaw(timespec(), std::vector<std::int32_t>()))>
+static std::true_type canPushRaw(int);
+
+template<typename A>
+static std::false_type canPushRaw(...);
+
+static_assert(decltype(canPushRaw<nds::DataAcquisition<std::vector<double> > >(0))::value, "pushRaw() must be available for the arrays of doubles");
+static_assert(!decltype(canPushRaw<nds::DataAcquisition<std::vector<std::int32_t> > >(0))::value, "pushRaw() must not be available for the other data types");
+
+TEST(testDataAcquisition, testPushRaw)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("rawNode");
+    nds::DataAcquisition<std::vector<double> > acquisitionDouble = rootNode.addChild(createAcquisitionNode<double>("dataDouble"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("rawNode");
+
+    timespec timestamp = {0, 0};
+    EXPECT_EQ(1.0, acquisitionDouble.getAmplitude());
+    EXPECT_EQ(0.0, acquisitionDouble.getOffset());
+    pInterface->writeCSValue("/rawNode-dataDouble.Amplitude", timestamp, 0.5);
+    pInterface->writeCSValue("/rawNode-dataDouble.Offset", timestamp, 10.0);
+    EXPECT_EQ(0.5, acquisitionDouble.getAmplitude());
+    EXPECT_EQ(10.0, acquisitionDouble.getOffset());
+
+    // 19 samples: the last ones are converted outside the vector loop
+    //////////////////////////////////////////////////////////////////
+    std::vector<std::int16_t> rawInt16(19);
+    std::vector<std::int32_t> rawInt32(19);
+    for(size_t fillData(0); fillData != rawInt16.size(); ++fillData)
+    {
+        rawInt16[fillData] = (std::int16_t)(fillData * 3000 - 30000);
+        rawInt32[fillData] = (std::int32_t)(fillData * 100000 - 1000000);
+    }
+
+    const timespec* pTime;
+    const std::vector<double>* pConverted;
+
+    acquisitionDouble.pushRaw(timestamp, rawInt16);
+    pInterface->getPushedVectorDouble("/rawNode-dataDouble.Data", pTime, pConverted);
+    ASSERT_EQ(rawInt16.size(), pConverted->size());
+    for(size_t compare(0); compare != rawInt16.size(); ++compare)
+    {
+        EXPECT_EQ((double)rawInt16[compare] * 0.5 + 10.0, (*pConverted)[compare]);
+    }
+
+    acquisitionDouble.pushRaw(timestamp, rawInt32);
+    pInterface->getPushedVectorDouble("/rawNode-dataDouble.Data", pTime, pConverted);
+    ASSERT_EQ(rawInt32.size(), pConverted->size());
+    for(size_t compare(0); compare != rawInt32.size(); ++compare)
+    {
+        EXPECT_EQ((double)rawInt32[compare] * 0.5 + 10.0, (*pConverted)[compare]);
+    }
+
+    factory.destroyDevice("");
+}
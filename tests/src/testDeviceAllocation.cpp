@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
+#include <sstream>
+#include <map>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
 #include <nds3/nds.h>
+#include <nds3/impl/modulesManifestImpl.h>
 #include "testDevice.h"
 #include "ndsTestInterface.h"
 
@@ -98,3 +105,262 @@ TEST(testDeviceAllocation, testTwoAllocations)
     EXPECT_THROW(factory.destroyDevice("rootNode1"), nds::DeviceNotAllocated);
 }
 
+
+/*
+ * Build a device with many channels, so the channels are prepared
+ *  by several threads
+ */
+static void initializeLargeDevice(nds::Factory* pFactory, nds::Port* pRootNode)
+{
+    for(size_t channel(0); channel != 64; ++channel)
+    {
+        std::ostringstream channelName;
+        channelName << "channel" << channel;
+        nds::Node channelNode = pRootNode->addChild(nds::Node(channelName.str()));
+        for(size_t pv(0); pv != 8; ++pv)
+        {
+            std::ostringstream pvName;
+            pvName << "pv" << pv;
+            channelNode.addChild(nds::PVVariableIn<std::int32_t>(pvName.str()));
+        }
+        channelNode.addChild(nds::PVVariableOut<std::int32_t>("out"));
+    }
+    pRootNode->initialize(0, *pFactory);
+}
+
+/*
+ * Initialize two devices concurrently, building the names in parallel.
+ * All the PVs must be registered before registrationTerminated() is called
+ */
+TEST(testDeviceAllocation, testParallelInitialization)
+{
+    nds::Factory factory("test");
+    factory.setInitializationThreads(4);
+
+    nds::Port rootNode0("parallelRoot0");
+    nds::Port rootNode1("parallelRoot1");
+    std::thread initialize0(std::bind(&initializeLargeDevice, &factory, &rootNode0));
+    std::thread initialize1(std::bind(&initializeLargeDevice, &factory, &rootNode1));
+    initialize0.join();
+    initialize1.join();
+
+    factory.setInitializationThreads(1);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface0 = nds::tests::TestControlSystemInterfaceImpl::getInstance("parallelRoot0");
+    nds::tests::TestControlSystemInterfaceImpl* pInterface1 = nds::tests::TestControlSystemInterfaceImpl::getInstance("parallelRoot1");
+    ASSERT_NE((void*)0, pInterface0);
+    ASSERT_NE((void*)0, pInterface1);
+    EXPECT_EQ(64u * 9u, pInterface0->getRegisteredPVsAtTermination());
+    EXPECT_EQ(64u * 9u, pInterface1->getRegisteredPVsAtTermination());
+
+    // The PVs have been registered with NDS
+    ////////////////////////////////////////
+    factory.subscribe("parallelRoot0-channel63-pv7", "parallelRoot1-channel0-out");
+    factory.subscribe("parallelRoot1-channel63-pv7", "parallelRoot0-channel0-out");
+
+    factory.destroyDevice("");
+
+    EXPECT_THROW(factory.subscribe("parallelRoot0-channel63-pv7", "parallelRoot1-channel0-out"), nds::MissingOutputPV);
+}
+
+/*
+ * The manifest remembers the driver exported by a module until the
+ *  module is modified
+ */
+TEST(testDeviceAllocation, testModulesManifest)
+{
+    std::ostringstream manifestName;
+    manifestName << "/tmp/nds3TestManifest" << ::getpid();
+    const std::string moduleName(manifestName.str() + "Module");
+    std::remove(manifestName.str().c_str());
+
+    {
+        std::ofstream module(moduleName.c_str());
+        module << "module";
+    }
+
+    std::string driverName;
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        EXPECT_FALSE(manifest.getDriverName(moduleName, &driverName));
+        manifest.setDriverName(moduleName, "testDriver");
+        manifest.setDriverName("/tmp/nds3MissingModule", "missingDriver");
+        EXPECT_TRUE(manifest.save());
+    }
+
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        EXPECT_TRUE(manifest.getDriverName(moduleName, &driverName));
+        EXPECT_EQ("testDriver", driverName);
+        EXPECT_FALSE(manifest.getDriverName("/tmp/nds3MissingModule", &driverName));
+    }
+
+    // A module with a different size invalidates the entry
+    ///////////////////////////////////////////////////////
+    {
+        std::ofstream module(moduleName.c_str());
+        module << "modified module";
+    }
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        EXPECT_FALSE(manifest.getDriverName(moduleName, &driverName));
+
+        // Modules without a driver are cached too
+        manifest.setDriverName(moduleName, "");
+        EXPECT_TRUE(manifest.save());
+    }
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        driverName = "notEmpty";
+        EXPECT_TRUE(manifest.getDriverName(moduleName, &driverName));
+        EXPECT_TRUE(driverName.empty());
+    }
+
+    // Two processes sharing the manifest keep each other's entries
+    ///////////////////////////////////////////////////////////////
+    const std::string otherModuleName(manifestName.str() + "OtherModule");
+    {
+        std::ofstream module(otherModuleName.c_str());
+        module << "other module";
+    }
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        nds::ModulesManifestImpl otherManifest(manifestName.str());
+        manifest.setDriverName(moduleName, "testDriver");
+        otherManifest.setDriverName(otherModuleName, "otherDriver");
+        EXPECT_TRUE(otherManifest.save());
+        EXPECT_TRUE(manifest.save());
+    }
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        EXPECT_TRUE(manifest.getDriverName(moduleName, &driverName));
+        EXPECT_EQ("testDriver", driverName);
+        EXPECT_TRUE(manifest.getDriverName(otherModuleName, &driverName));
+        EXPECT_EQ("otherDriver", driverName);
+    }
+
+    // An entry not queried in a run survives the save
+    //////////////////////////////////////////////////
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        manifest.setDriverName(moduleName, "newDriver");
+        EXPECT_TRUE(manifest.save());
+    }
+    {
+        nds::ModulesManifestImpl manifest(manifestName.str());
+        EXPECT_TRUE(manifest.getDriverName(otherModuleName, &driverName));
+        EXPECT_EQ("otherDriver", driverName);
+        EXPECT_TRUE(manifest.getDriverName(moduleName, &driverName));
+        EXPECT_EQ("newDriver", driverName);
+    }
+
+    std::remove(otherModuleName.c_str());
+    std::remove(moduleName.c_str());
+    std::remove(manifestName.str().c_str());
+}
+
+/*
+ * Allocation function that records the parameters of the allocated devices
+ */
+static std::map<std::string, nds::namedParameters_t> m_reloadedDevicesParameters;
+static size_t m_reloadedDevicesAllocations(0);
+
+void* allocateReloadedDevice(nds::Factory& factory, const std::string& device, const nds::namedParameters_t& parameters)
+{
+    m_reloadedDevicesParameters[device] = parameters;
+    ++m_reloadedDevicesAllocations;
+    return TestDevice::allocateDevice(factory, device, parameters);
+}
+
+/*
+ * Reloading a driver re-creates its devices with the original parameters and
+ *  leaves the other devices untouched
+ */
+TEST(testDeviceAllocation, testReloadDriver)
+{
+    nds::Factory::registerDriver("reloadedDevice",
+                                 std::bind(&allocateReloadedDevice, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                                 std::bind(&TestDevice::deallocateDevice, std::placeholders::_1));
+
+    nds::Factory factory("test");
+
+    nds::namedParameters_t parameters0;
+    parameters0["channels"] = "4";
+    nds::namedParameters_t parameters1;
+    parameters1["channels"] = "8";
+
+    factory.createDevice("reloadedDevice", "reloadedDevice0", parameters0);
+    factory.createDevice("reloadedDevice", "reloadedDevice1", parameters1);
+    factory.createDevice("testDevice", "notReloadedDevice", nds::namedParameters_t());
+    EXPECT_EQ(2u, m_reloadedDevicesAllocations);
+
+    TestDevice* pNotReloaded = TestDevice::getInstance("notReloadedDevice");
+    ASSERT_NE((void*)0, pNotReloaded);
+
+    m_reloadedDevicesParameters.clear();
+    nds::Factory::reloadDriver("reloadedDevice", "");
+
+    EXPECT_EQ(4u, m_reloadedDevicesAllocations);
+    ASSERT_EQ(2u, m_reloadedDevicesParameters.size());
+    EXPECT_EQ("4", m_reloadedDevicesParameters["reloadedDevice0"]["channels"]);
+    EXPECT_EQ("8", m_reloadedDevicesParameters["reloadedDevice1"]["channels"]);
+    EXPECT_NE((void*)0, TestDevice::getInstance("reloadedDevice0"));
+    EXPECT_NE((void*)0, TestDevice::getInstance("reloadedDevice1"));
+    EXPECT_EQ(pNotReloaded, TestDevice::getInstance("notReloadedDevice"));
+
+    // A driver without devices is reloaded without errors
+    //////////////////////////////////////////////////////
+    nds::Factory::reloadDriver("driverWithoutDevices", "");
+
+    factory.destroyDevice("reloadedDevice0");
+    factory.destroyDevice("reloadedDevice1");
+    factory.destroyDevice("notReloadedDevice");
+    EXPECT_EQ((void*)0, TestDevice::getInstance("reloadedDevice0"));
+}
+
+#ifdef NDS3_TEST_MODULES_FOLDER
+/*
+ * Read the version PV of a device created by the reloaded module
+ */
+static std::int32_t getReloadedModuleVersion(const std::string& deviceName)
+{
+    timespec timestamp;
+    std::int32_t version(0);
+    nds::tests::TestControlSystemInterfaceImpl::getInstance(deviceName)->readCSValue("/" + deviceName + "-version", &timestamp, &version);
+    return version;
+}
+
+/*
+ * Reload a driver from its modules. A module that cannot be loaded or that
+ *  exports another driver leaves the previous version running
+ */
+TEST(testDeviceAllocation, testReloadDriverModule)
+{
+    const std::string modulesFolder(NDS3_TEST_MODULES_FOLDER);
+
+    nds::Factory factory("test");
+
+    nds::Factory::reloadDriver("reloadedModule", modulesFolder + "/libnds3ReloadedModule1.so");
+    factory.createDevice("reloadedModule", "moduleDevice", nds::namedParameters_t());
+    EXPECT_EQ(1, getReloadedModuleVersion("moduleDevice"));
+
+    nds::Factory::reloadDriver("reloadedModule", modulesFolder + "/libnds3ReloadedModule2.so");
+    EXPECT_EQ(2, getReloadedModuleVersion("moduleDevice"));
+
+    // Failed loads
+    ///////////////
+    EXPECT_THROW(nds::Factory::reloadDriver("reloadedModule", modulesFolder + "/libnds3MissingModule.so"), nds::DriverNotFound);
+    EXPECT_EQ(2, getReloadedModuleVersion("moduleDevice"));
+
+    EXPECT_THROW(nds::Factory::reloadDriver("reloadedModule", modulesFolder + "/libnds3ReloadedModuleOther.so"), nds::DriverNotFound);
+    EXPECT_EQ(2, getReloadedModuleVersion("moduleDevice"));
+
+    // The restored driver can still allocate new devices
+    //////////////////////////////////////////////////////
+    factory.createDevice("reloadedModule", "otherModuleDevice", nds::namedParameters_t());
+    EXPECT_EQ(2, getReloadedModuleVersion("otherModuleDevice"));
+
+    factory.destroyDevice("moduleDevice");
+    factory.destroyDevice("otherModuleDevice");
+}
+#endif
@@ -3,6 +3,9 @@
 #include "testDevice.h"
 #include "ndsTestInterface.h"
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
 
 TEST(testIniParser, parseFile)
 {
@@ -68,3 +71,56 @@ TEST(testIniParser, testEmptySectionAndComments)
 
 
 
+
+TEST(testIniParser, testFile)
+{
+    std::ostringstream fileName;
+    fileName << "/tmp/nds3TestIniParser" << ::getpid() << ".ini";
+
+    {
+        std::ofstream iniFile(fileName.str().c_str(), std::ios::out | std::ios::trunc);
+        iniFile << " key0 = value0 #This is a comment\n";
+        iniFile << "[section1]\r\n";
+        iniFile << "key1 = 'value1 ' \n";
+        iniFile << "[ emptySection ]\n";
+        iniFile << "  ; only comments\n";
+        iniFile << "[section2]\n";
+        iniFile << "key2 = value2\n";
+        iniFile << "[section1]\n";
+        iniFile << "key1 = value1b\n";
+        iniFile << "key3 = \"value3\"\n";
+        iniFile << "[unterminatedQuotes]\n";
+        iniFile << "key6 = 'value6\n";
+        iniFile << "[missingKey]\n";
+        iniFile << " = value7\n";
+        iniFile << "[wrongSection]\n";
+        iniFile << "key4 = value4\n";
+        iniFile << "key5";
+    }
+
+    nds::IniFileParser parser(fileName.str());
+
+    // The parser does not depend on the file after the constructor
+    ///////////////////////////////////////////////////////////////
+    {
+        std::ofstream iniFile(fileName.str().c_str(), std::ios::out | std::ios::trunc);
+    }
+    std::remove(fileName.str().c_str());
+
+    EXPECT_EQ("value0", parser.getString("", "key0", "default0"));
+    EXPECT_EQ("value1b", parser.getString("section1", "key1", "default1"));
+    EXPECT_EQ("value2", parser.getString("section2", "key2", "default2"));
+    EXPECT_EQ("value3", parser.getString("section1", "key3", "default3"));
+    EXPECT_FALSE(parser.keyExists("section2", "key1"));
+    EXPECT_THROW(parser.keyExists("emptySection", "key1"), nds::INIParserMissingSection);
+    EXPECT_THROW(parser.keyExists("section3", "key1"), nds::INIParserMissingSection);
+
+    // The syntax errors are detected when the section is accessed
+    //////////////////////////////////////////////////////////////
+    EXPECT_THROW(parser.getString("wrongSection", "key4", "default4"), nds::INIParserSyntaxError);
+    EXPECT_THROW(parser.keyExists("wrongSection", "key4"), nds::INIParserSyntaxError);
+    EXPECT_THROW(parser.getString("unterminatedQuotes", "key6", "default6"), nds::INIParserSyntaxError);
+    EXPECT_THROW(parser.getString("missingKey", "key7", "default7"), nds::INIParserSyntaxError);
+
+    EXPECT_THROW(nds::IniFileParser(fileName.str()), std::runtime_error);
+}
@@ -4,6 +4,9 @@
 #include "testDevice.h"
 #include "ndsTestInterface.h"
 #include "ndsTestFactory.h"
+#include <nds3/impl/asyncLogStreamGetterImpl.h>
+#include <mutex>
+#include <thread>
 #include <unistd.h>
 
 void log(std::vector<nds::PVBase>& pvs, nds::logLevel_t severity)
@@ -110,3 +113,69 @@ TEST(testLogging, testLotOfPVs)
     EXPECT_EQ(0, pFactory->getRegisteredCommandsNumber());
 
 }
+
+
+TEST(testLogging, testAsyncLogging)
+{
+    std::mutex lockRecords;
+    std::vector<std::string> records;
+    auto writer = [&](const timespec&, const nds::logLevel_t logLevel, const std::string& message)
+    {
+        std::lock_guard<std::mutex> lock(lockRecords);
+        records.push_back(std::to_string((int)logLevel) + " " + message);
+    };
+
+    {
+        nds::AsyncLogStreamGetterImpl getter(writer, 4096, 64, std::chrono::milliseconds(100000));
+
+        *getter.getLogStream(nds::logLevel_t::info) << "Info string" << 1 << std::endl;
+        std::thread otherThread([&getter]()
+        {
+            *getter.getLogStream(nds::logLevel_t::error) << "Error string" << 2 << std::endl;
+        });
+        otherThread.join();
+
+        getter.flush();
+        {
+            std::lock_guard<std::mutex> lock(lockRecords);
+            ASSERT_EQ(2u, records.size());
+            EXPECT_EQ(std::to_string((int)nds::logLevel_t::info) + " Info string1\n", records[0]);
+            EXPECT_EQ(std::to_string((int)nds::logLevel_t::error) + " Error string2\n", records[1]);
+            records.clear();
+        }
+
+        // Lines longer than the maximum length are truncated
+        /////////////////////////////////////////////////////
+        *getter.getLogStream(nds::logLevel_t::info) << std::string(200, 'x') << std::endl;
+        getter.flush();
+        {
+            std::lock_guard<std::mutex> lock(lockRecords);
+            ASSERT_EQ(1u, records.size());
+            EXPECT_EQ(std::to_string((int)nds::logLevel_t::info) + " " + std::string(64, 'x'), records[0]);
+            records.clear();
+        }
+
+        // Fill the ring without flushing: the records are dropped, not blocked
+        ///////////////////////////////////////////////////////////////////////
+        EXPECT_EQ(0u, getter.getDroppedRecords());
+        for(size_t scanRecords(0); scanRecords != 1000; ++scanRecords)
+        {
+            *getter.getLogStream(nds::logLevel_t::warning) << "Warning string" << scanRecords << std::endl;
+        }
+        EXPECT_GT(getter.getDroppedRecords(), 0u);
+        getter.flush();
+        {
+            std::lock_guard<std::mutex> lock(lockRecords);
+            EXPECT_EQ(1000u, records.size() + getter.getDroppedRecords());
+            EXPECT_EQ(std::to_string((int)nds::logLevel_t::warning) + " Warning string0\n", records[0]);
+            records.clear();
+        }
+
+        // The destructor writes the pending records
+        ////////////////////////////////////////////
+        *getter.getLogStream(nds::logLevel_t::debug) << "Debug string" << std::endl;
+    }
+
+    ASSERT_EQ(1u, records.size());
+    EXPECT_EQ(std::to_string((int)nds::logLevel_t::debug) + " Debug string\n", records[0]);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <nds3/nds.h>
+#include <nds3/impl/nameTableImpl.h>
 
 // Callback for the state machine
 void noFunction()
@@ -130,3 +131,117 @@ TEST(testNamingRules, testFallbackRules)
 
 
 
+
+TEST(testNamingRules, testFormattedRules)
+{
+    nds::Factory factory("test");
+
+    std::string rules;
+    rules += "[TEST]\n";
+    rules += "separator0 = /\n";
+    rules += "separator1 = :\n";
+    rules += "rootNode = R%4s\n";
+    rules += "genericNode = %-3s|\n";
+    rules += "inputPV = %.3s_100%%\n";
+    rules += "toUpper = 1\n";
+
+    std::istringstream rulesStream(rules);
+    factory.loadNamingRules(rulesStream);
+
+    // Selecting a missing section keeps the current rules
+    //////////////////////////////////////////////////////
+    EXPECT_THROW(factory.setNamingRules("MISSING"), nds::INIParserMissingSection);
+
+    // Deeper than the separators resolved in advance
+    /////////////////////////////////////////////////
+    nds::Port rootNode("ab");
+    nds::Node node = rootNode.addChild(nds::Node("a b"));
+    std::string expectedName("/R00AB:A0B|");
+    for(size_t level(2); level != 20; ++level)
+    {
+        node = node.addChild(nds::Node("n"));
+        expectedName += ":N00|";
+    }
+    nds::Base pv = node.addChild(nds::PVVariableIn<std::int32_t>("value x"));
+
+    rootNode.initialize(0, factory);
+
+    EXPECT_EQ(expectedName, node.getFullExternalName());
+    EXPECT_EQ(expectedName + ":VAL_100%", pv.getFullExternalName());
+
+    factory.setNamingRules("");
+    factory.destroyDevice("");
+}
+
+TEST(testNamingRules, testNameTable)
+{
+    nds::NameTableImpl nameTable;
+
+    const nds::InternedName* pRoot = nameTable.intern("root");
+    const nds::InternedName* pChild = nameTable.intern("root-child");
+
+    // The same name is stored once and keeps its ID
+    ////////////////////////////////////////////////
+    EXPECT_EQ(pRoot, nameTable.intern(std::string("ro") + "ot"));
+    EXPECT_EQ(pChild, nameTable.intern("root-child"));
+    EXPECT_NE(pRoot->m_id, pChild->m_id);
+    EXPECT_EQ(2u, nameTable.size());
+
+    EXPECT_EQ(pChild->m_id, nameTable.find("root-child"));
+    EXPECT_EQ(nds::NameTableImpl::m_invalidNameId, nameTable.find("root-missing"));
+    EXPECT_EQ(2u, nameTable.size());
+
+    EXPECT_EQ(pRoot, &(nameTable.getName(pRoot->m_id)));
+    EXPECT_EQ("root-child", nameTable.getName(pChild->m_id).m_name);
+    EXPECT_THROW(nameTable.getName(nds::NameTableImpl::m_invalidNameId), std::logic_error);
+
+    // The shard is in the lowest bits: the third name of the root's shard
+    //  cannot exist
+    ///////////////////////////////////////////////////////////////////////
+    EXPECT_THROW(nameTable.getName(pRoot->m_id + 2 * 64), std::logic_error);
+
+    // A name is removed when all its references are released, and its
+    //  slot and ID are reused by the next new name
+    ////////////////////////////////////////////////////////////////////
+    nameTable.release(pChild);
+    EXPECT_EQ(pChild->m_id, nameTable.find("root-child"));
+    const nds::nameId_t childId(pChild->m_id);
+    nameTable.release(pChild);
+    EXPECT_EQ(nds::NameTableImpl::m_invalidNameId, nameTable.find("root-child"));
+    EXPECT_THROW(nameTable.getName(childId), std::logic_error);
+    EXPECT_EQ(1u, nameTable.size());
+
+    for(size_t scanNames(0); scanNames != 1000; ++scanNames)
+    {
+        nameTable.release(nameTable.intern("root-child" + std::to_string(scanNames)));
+    }
+    EXPECT_EQ(1u, nameTable.size());
+
+    const nds::InternedName* pOtherChild = nameTable.intern("root-otherChild");
+    EXPECT_EQ("root-otherChild", nameTable.getName(pOtherChild->m_id).m_name);
+    EXPECT_EQ(2u, nameTable.size());
+
+    // The nodes share the interned names
+    /////////////////////////////////////
+    nds::Factory factory("test");
+    nds::Port rootNode("internedNames");
+    nds::Node child = rootNode.addChild(nds::Node("child"));
+    nds::Base pv = child.addChild(nds::PVVariableIn<std::int32_t>("pv"));
+
+    EXPECT_EQ("pv", pv.getFullName());
+    EXPECT_EQ("", pv.getFullExternalName());
+
+    rootNode.initialize(0, factory);
+
+    EXPECT_EQ("internedNames-child-pv", pv.getFullName());
+    EXPECT_EQ("child-pv", pv.getFullNameFromPort());
+
+    // A root node named like the child's name from the port reuses the same string
+    ///////////////////////////////////////////////////////////////////////////////
+    nds::Port otherRootNode("child");
+    otherRootNode.initialize(0, factory);
+    EXPECT_EQ("child", child.getFullNameFromPort());
+    EXPECT_EQ(&(child.getFullNameFromPort()), &(otherRootNode.getFullName()));
+
+    factory.destroyDevice("");
+}
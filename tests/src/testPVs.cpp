@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include <nds3/nds.h>
+#include <thread>
+#include <atomic>
+#include <sstream>
 #include "testDevice.h"
 #include "ndsTestInterface.h"
 #include "ndsTestFactory.h"
+#include <nds3/impl/copyOnWriteListImpl.h>
+#include <nds3/impl/interfaceBaseImpl.h>
 
 TEST(testPVs, testDelegate)
 {
@@ -75,6 +80,260 @@ TEST(testPVs, testVariable)
     factory.destroyDevice("rootNode");
 }
 
+TEST(testPVs, testDataTypes)
+{
+    nds::Factory factory("test");
+
+    factory.createDevice("testDevice", "rootNode", nds::namedParameters_t());
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("rootNode-Channel1");
+
+    // The arrays of uint8 and int8 are converted to and from strings
+    {
+        timespec timestamp;
+        timestamp.tv_sec = 6;
+        timestamp.tv_nsec = 16;
+        const std::string text("bytes into a string");
+        pInterface->writeCSValue("/rootNode-Channel1.testVariableOut", timestamp, std::vector<std::uint8_t>(text.begin(), text.end()));
+
+        std::string readValue;
+        timespec readTimestamp;
+        pInterface->readCSValue("/rootNode-Channel1.readTestVariableOut", &readTimestamp, &readValue);
+        EXPECT_EQ(text, readValue);
+        EXPECT_EQ(6, readTimestamp.tv_sec);
+        EXPECT_EQ(16, readTimestamp.tv_nsec);
+
+        std::vector<std::uint8_t> readBytes;
+        pInterface->readCSValue("/rootNode-Channel1.testVariableOut", &readTimestamp, &readBytes);
+        EXPECT_EQ(std::vector<std::uint8_t>(text.begin(), text.end()), readBytes);
+
+        std::vector<std::int8_t> readSignedBytes;
+        pInterface->readCSValue("/rootNode-Channel1.testVariableOut", &readTimestamp, &readSignedBytes);
+        EXPECT_EQ(std::vector<std::int8_t>(text.begin(), text.end()), readSignedBytes);
+
+        // Through a delegate PV
+        readBytes.clear();
+        pInterface->readCSValue("/rootNode-Channel1.readTestVariableOut", &readTimestamp, &readBytes);
+        EXPECT_EQ(std::vector<std::uint8_t>(text.begin(), text.end()), readBytes);
+        EXPECT_EQ(6, readTimestamp.tv_sec);
+
+        // From an input PV
+        const std::string initialValue("Initial value");
+        pInterface->readCSValue("/rootNode-Channel1.testVariableIn", &readTimestamp, &readBytes);
+        EXPECT_EQ(std::vector<std::uint8_t>(initialValue.begin(), initialValue.end()), readBytes);
+    }
+
+    // The other data types are rejected
+    {
+        timespec timestamp;
+        timestamp.tv_sec = 0;
+        timestamp.tv_nsec = 0;
+        EXPECT_THROW(pInterface->writeCSValue("/rootNode-Channel1.testVariableOut", timestamp, (std::int32_t)1), nds::PVDataTypeError);
+        EXPECT_THROW(pInterface->writeCSValue("/rootNode-Channel1.testVariableIn", timestamp, std::string("read only")), nds::PVDataTypeError);
+
+        double readValue;
+        timespec readTimestamp;
+        EXPECT_THROW(pInterface->readCSValue("/rootNode-Channel1.testVariableIn", &readTimestamp, &readValue), nds::PVDataTypeError);
+    }
+
+    factory.destroyDevice("rootNode");
+}
+
+TEST(testPVs, testNumericTypes)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("numericNode");
+    nds::PVVariableIn<std::int16_t> int16PV = rootNode.addChild(nds::PVVariableIn<std::int16_t>("int16"));
+    nds::PVVariableIn<std::int64_t> int64PV = rootNode.addChild(nds::PVVariableIn<std::int64_t>("int64"));
+    nds::PVVariableIn<std::vector<std::uint16_t> > uint16ArrayPV = rootNode.addChild(nds::PVVariableIn<std::vector<std::uint16_t> >("uint16Array"));
+    nds::PVVariableOut<float> floatPV = rootNode.addChild(nds::PVVariableOut<float>("float"));
+    nds::PVVariableOut<std::vector<float> > floatArrayPV = rootNode.addChild(nds::PVVariableOut<std::vector<float> >("floatArray"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("numericNode");
+
+    // The control system receives the values without conversions
+    /////////////////////////////////////////////////////////////
+    timespec timestamp = {3, 0};
+    int16PV.push(timestamp, (std::int16_t)-1234);
+    int64PV.push(timestamp, (std::int64_t)1 << 40);
+    uint16ArrayPV.push(timestamp, std::vector<std::uint16_t>(3, 65535));
+
+    const timespec* pTimestamp;
+    const std::int16_t* pInt16;
+    pInterface->getPushedInt16(int16PV.getFullExternalName(), pTimestamp, pInt16);
+    EXPECT_EQ(-1234, *pInt16);
+    EXPECT_EQ(3, pTimestamp->tv_sec);
+
+    const std::int64_t* pInt64;
+    pInterface->getPushedInt64(int64PV.getFullExternalName(), pTimestamp, pInt64);
+    EXPECT_EQ((std::int64_t)1 << 40, *pInt64);
+
+    const std::vector<std::uint16_t>* pUint16Array;
+    pInterface->getPushedVectorUint16(uint16ArrayPV.getFullExternalName(), pTimestamp, pUint16Array);
+    EXPECT_EQ(std::vector<std::uint16_t>(3, 65535), *pUint16Array);
+
+    // The PVs refuse the values of a different data type
+    ///////////////////////////////////////////////////////
+    EXPECT_THROW(pInterface->writeCSValue(floatPV.getFullExternalName(), timestamp, 2.25), nds::PVDataTypeError);
+
+    // Read and write from the control system
+    /////////////////////////////////////////
+    std::vector<float> floats(4, 1.5f);
+    pInterface->writeCSValue(floatArrayPV.getFullExternalName(), timestamp, floats);
+    EXPECT_EQ(floats, floatArrayPV.getValue());
+
+    std::vector<float> readFloats;
+    pInterface->readCSValue(floatArrayPV.getFullExternalName(), &timestamp, &readFloats);
+    EXPECT_EQ(floats, readFloats);
+
+    pInterface->writeCSValue(floatPV.getFullExternalName(), timestamp, 2.25f);
+    EXPECT_EQ(2.25f, floatPV.getValue());
+}
+
+/*
+ * Control system interface that implements only the mandatory push()
+ *  overloads: the other data types go through the conversions of
+ *  InterfaceBaseImpl
+ *
+ *********************************************************************/
+class MinimalInterface: public nds::InterfaceBaseImpl
+{
+public:
+    virtual void registerPV(std::shared_ptr<nds::PVBaseImpl> /* pv */){}
+    virtual void deregisterPV(std::shared_ptr<nds::PVBaseImpl> /* pv */){}
+    virtual void registrationTerminated(){}
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& timestamp, const std::int32_t& value)
+    {
+        m_timestamps.push_back(timestamp.tv_sec);
+        m_int32.push_back(value);
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& timestamp, const double& value)
+    {
+        m_timestamps.push_back(timestamp.tv_sec);
+        m_double.push_back(value);
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& /* timestamp */, const std::vector<std::int8_t>& value)
+    {
+        m_vectorInt8 = value;
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& /* timestamp */, const std::vector<std::uint8_t>& value)
+    {
+        m_vectorUint8 = value;
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& /* timestamp */, const std::vector<std::int32_t>& value)
+    {
+        m_vectorInt32 = value;
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& /* timestamp */, const std::vector<double>& value)
+    {
+        m_vectorDouble = value;
+    }
+
+    virtual void push(const nds::PVBaseImpl& /* pv */, const timespec& /* timestamp */, const std::string& /* value */)
+    {
+    }
+
+    std::vector<time_t> m_timestamps;
+    std::vector<std::int32_t> m_int32;
+    std::vector<double> m_double;
+    std::vector<std::int8_t> m_vectorInt8;
+    std::vector<std::uint8_t> m_vectorUint8;
+    std::vector<std::int32_t> m_vectorInt32;
+    std::vector<double> m_vectorDouble;
+};
+
+TEST(testPVs, testNumericTypesDefaultConversions)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("conversionNode");
+    nds::PVVariableIn<std::int32_t> convertedPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("converted"));
+    rootNode.initialize(0, factory);
+
+    const nds::PVBaseImpl& pv(nds::tests::TestControlSystemInterfaceImpl::getInstance("conversionNode")->getRegisteredPV(convertedPV.getFullExternalName()));
+    MinimalInterface minimalInterface;
+    nds::InterfaceBaseImpl& interface(minimalInterface);
+
+    // The 16 bit integers are widened to 32 bits, the 64 bit integers
+    //  and the floats to doubles
+    //////////////////////////////////////////////////////////////////
+    timespec timestamp = {5, 0};
+    interface.push(pv, timestamp, (std::int16_t)-1234);
+    interface.push(pv, timestamp, (std::uint16_t)65535);
+    interface.push(pv, timestamp, (std::int64_t)1 << 40);
+    interface.push(pv, timestamp, 2.25f);
+    EXPECT_EQ(std::vector<std::int32_t>({-1234, 65535}), minimalInterface.m_int32);
+    EXPECT_EQ(std::vector<double>({(double)((std::int64_t)1 << 40), 2.25}), minimalInterface.m_double);
+    EXPECT_EQ(std::vector<time_t>(4, 5), minimalInterface.m_timestamps);
+
+    interface.push(pv, timestamp, std::vector<std::int16_t>({-1, 2}));
+    EXPECT_EQ(std::vector<std::int32_t>({-1, 2}), minimalInterface.m_vectorInt32);
+    interface.push(pv, timestamp, std::vector<std::uint16_t>({65535, 3}));
+    EXPECT_EQ(std::vector<std::int32_t>({65535, 3}), minimalInterface.m_vectorInt32);
+    interface.push(pv, timestamp, std::vector<std::int64_t>({-((std::int64_t)1 << 40), 4}));
+    EXPECT_EQ(std::vector<double>({-(double)((std::int64_t)1 << 40), 4.0}), minimalInterface.m_vectorDouble);
+    interface.push(pv, timestamp, std::vector<float>({0.5f, -1.5f}));
+    EXPECT_EQ(std::vector<double>({0.5, -1.5}), minimalInterface.m_vectorDouble);
+
+    // The SharedBuffers are pushed as vectors, then converted
+    //////////////////////////////////////////////////////////
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::int8_t> >(std::vector<std::int8_t>({-8, 8})));
+    EXPECT_EQ(std::vector<std::int8_t>({-8, 8}), minimalInterface.m_vectorInt8);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::uint8_t> >(std::vector<std::uint8_t>({255, 8})));
+    EXPECT_EQ(std::vector<std::uint8_t>({255, 8}), minimalInterface.m_vectorUint8);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::int32_t> >(std::vector<std::int32_t>({-32, 32})));
+    EXPECT_EQ(std::vector<std::int32_t>({-32, 32}), minimalInterface.m_vectorInt32);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<double> >(std::vector<double>({-0.25, 0.25})));
+    EXPECT_EQ(std::vector<double>({-0.25, 0.25}), minimalInterface.m_vectorDouble);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::int16_t> >(std::vector<std::int16_t>({-16, 16})));
+    EXPECT_EQ(std::vector<std::int32_t>({-16, 16}), minimalInterface.m_vectorInt32);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::uint16_t> >(std::vector<std::uint16_t>({65535, 16})));
+    EXPECT_EQ(std::vector<std::int32_t>({65535, 16}), minimalInterface.m_vectorInt32);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<std::int64_t> >(std::vector<std::int64_t>({-64, 64})));
+    EXPECT_EQ(std::vector<double>({-64.0, 64.0}), minimalInterface.m_vectorDouble);
+    interface.push(pv, timestamp, nds::SharedBuffer<std::vector<float> >(std::vector<float>({-0.5f, 0.5f})));
+    EXPECT_EQ(std::vector<double>({-0.5, 0.5}), minimalInterface.m_vectorDouble);
+
+    // The batches are pushed one sample at a time, then converted
+    //////////////////////////////////////////////////////////////
+    minimalInterface.m_timestamps.clear();
+    minimalInterface.m_int32.clear();
+    minimalInterface.m_double.clear();
+    const timespec timestamps[2] = {{6, 0}, {7, 0}};
+
+    const std::int32_t int32Batch[2] = {-32, 32};
+    interface.pushBatch(pv, timestamps, int32Batch, 2);
+    const std::int16_t int16Batch[2] = {-16, 16};
+    interface.pushBatch(pv, timestamps, int16Batch, 2);
+    const std::uint16_t uint16Batch[2] = {65535, 16};
+    interface.pushBatch(pv, timestamps, uint16Batch, 2);
+    EXPECT_EQ(std::vector<std::int32_t>({-32, 32, -16, 16, 65535, 16}), minimalInterface.m_int32);
+
+    const double doubleBatch[2] = {-0.25, 0.25};
+    interface.pushBatch(pv, timestamps, doubleBatch, 2);
+    const std::int64_t int64Batch[2] = {-64, 64};
+    interface.pushBatch(pv, timestamps, int64Batch, 2);
+    const float floatBatch[2] = {-0.5f, 0.5f};
+    interface.pushBatch(pv, timestamps, floatBatch, 2);
+    EXPECT_EQ(std::vector<double>({-0.25, 0.25, -64.0, 64.0, -0.5, 0.5}), minimalInterface.m_double);
+
+    std::vector<time_t> batchTimestamps;
+    for(size_t batch(0); batch != 6; ++batch)
+    {
+        batchTimestamps.push_back(6);
+        batchTimestamps.push_back(7);
+    }
+    EXPECT_EQ(batchTimestamps, minimalInterface.m_timestamps);
+}
+
 TEST(testPVs, testSubscription0)
 {
     nds::Factory factory("test");
@@ -188,3 +447,479 @@ TEST(testPVs, testReplication)
     factory.destroyDevice("rootNode");
 }
 
+
+TEST(testPVs, testLinksRemovedWithSource)
+{
+    nds::Factory factory("test");
+
+    nds::Port destinationNode("linkDestination");
+    nds::PVVariableOut<std::string> outputPV = destinationNode.addChild(nds::PVVariableOut<std::string>("output"));
+    nds::PVVariableIn<std::string> replicaPV = destinationNode.addChild(nds::PVVariableIn<std::string>("replica"));
+    destinationNode.initialize(0, factory);
+
+    factory.createDevice("testDevice", "linkSource", nds::namedParameters_t());
+    factory.subscribe("linkSource-Channel1-testVariableIn", outputPV.getFullName());
+    factory.replicate("linkSource-Channel1-testVariableIn", replicaPV.getFullName());
+
+    timespec timestamp = {0, 0};
+    nds::tests::TestControlSystemInterfaceImpl::getInstance("linkSource-Channel1")->writeCSValue("/linkSource-Channel1.writeTestVariableIn", timestamp, std::string("first"));
+    EXPECT_EQ("first", outputPV.getValue());
+
+    // Destroying the source removes its links: the new source with the
+    //  same name does not reach the destination PVs
+    ///////////////////////////////////////////////////////////////////
+    factory.destroyDevice("linkSource");
+    factory.createDevice("testDevice", "linkSource", nds::namedParameters_t());
+    nds::tests::TestControlSystemInterfaceImpl::getInstance("linkSource-Channel1")->writeCSValue("/linkSource-Channel1.writeTestVariableIn", timestamp, std::string("second"));
+    EXPECT_EQ("first", outputPV.getValue());
+
+    factory.subscribe("linkSource-Channel1-testVariableIn", outputPV.getFullName());
+    nds::tests::TestControlSystemInterfaceImpl::getInstance("linkSource-Channel1")->writeCSValue("/linkSource-Channel1.writeTestVariableIn", timestamp, std::string("third"));
+    EXPECT_EQ("third", outputPV.getValue());
+
+    factory.unsubscribe(outputPV.getFullName());
+    nds::tests::TestControlSystemInterfaceImpl::getInstance("linkSource-Channel1")->writeCSValue("/linkSource-Channel1.writeTestVariableIn", timestamp, std::string("fourth"));
+    EXPECT_EQ("third", outputPV.getValue());
+
+    factory.destroyDevice("");
+}
+
+
+TEST(testPVs, testAsyncDeliveryBlock)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("asyncNodeBlock");
+    rootNode.setAsyncDelivery(16, nds::overflowPolicy_t::block);
+    nds::PVVariableIn<std::int32_t> pushedPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("value"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("asyncNodeBlock");
+
+    timespec timestamp;
+    timestamp.tv_sec = 0;
+    for(std::int32_t value(0); value != 1000; ++value)
+    {
+        timestamp.tv_nsec = value;
+        pushedPV.push(timestamp, value);
+    }
+    rootNode.flushAsyncDelivery();
+
+    // All the values must reach the control system, in order
+    //////////////////////////////////////////////////////////
+    for(std::int32_t value(0); value != 1000; ++value)
+    {
+        const timespec* pTimestamp;
+        const std::int32_t* pValue;
+        pInterface->getPushedInt32(pushedPV.getFullExternalName(), pTimestamp, pValue);
+        EXPECT_EQ(value, *pValue);
+        EXPECT_EQ(value, pTimestamp->tv_nsec);
+    }
+    EXPECT_EQ(0u, pushedPV.getDroppedSamples());
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testAsyncDeliveryDropOldest)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("asyncNodeDropOldest");
+    rootNode.setAsyncDelivery(4, nds::overflowPolicy_t::dropOldest);
+    nds::PVVariableIn<std::vector<std::int32_t> > pushedPV = rootNode.addChild(nds::PVVariableIn<std::vector<std::int32_t> >("value"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("asyncNodeDropOldest");
+
+    timespec timestamp = {0, 0};
+    std::vector<std::int32_t> pushedValue(100);
+    for(std::int32_t value(0); value != 1000; ++value)
+    {
+        pushedValue[0] = value;
+        pushedPV.push(timestamp, pushedValue);
+    }
+    rootNode.flushAsyncDelivery();
+
+    // The delivered values are in order and the last one is always delivered
+    //////////////////////////////////////////////////////////////////////////
+    std::int32_t lastValue(-1);
+    std::uint64_t delivered(0);
+    for(;;)
+    {
+        const timespec* pTimestamp;
+        const std::vector<std::int32_t>* pValue;
+        try
+        {
+            pInterface->getPushedVectorInt32(pushedPV.getFullExternalName(), pTimestamp, pValue);
+        }
+        catch(const std::runtime_error&)
+        {
+            break;
+        }
+        EXPECT_LT(lastValue, (*pValue)[0]);
+        EXPECT_EQ(100u, pValue->size());
+        lastValue = (*pValue)[0];
+        ++delivered;
+    }
+    EXPECT_EQ(999, lastValue);
+    EXPECT_EQ(1000u, delivered + pushedPV.getDroppedSamples());
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testSubscribeWhilePushing)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("subscribeNode");
+    nds::PVVariableIn<std::int32_t> inputPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("input"));
+    nds::PVVariableOut<std::int32_t> outputPV = rootNode.addChild(nds::PVVariableOut<std::int32_t>("output"));
+    rootNode.initialize(0, factory);
+
+    // Keep writing into the input PV while the output PV subscribes and
+    //  unsubscribes
+    ////////////////////////////////////////////////////////////////////
+    std::atomic<bool> bWriting(true);
+    std::thread writeThread([&inputPV, &bWriting]()
+    {
+        for(std::int32_t value(0); bWriting.load(); ++value)
+        {
+            inputPV.setValue(value);
+        }
+    });
+
+    for(int subscribe(0); subscribe != 1000; ++subscribe)
+    {
+        factory.subscribe(inputPV.getFullName(), outputPV.getFullName());
+        factory.unsubscribe(outputPV.getFullName());
+    }
+
+    bWriting.store(false);
+    writeThread.join();
+
+    // The last subscription receives the written values
+    ////////////////////////////////////////////////////
+    factory.subscribe(inputPV.getFullName(), outputPV.getFullName());
+    inputPV.setValue(12345);
+    EXPECT_EQ(12345, outputPV.getValue());
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testCopyOnWriteListOverlappingReaders)
+{
+    nds::CopyOnWriteList<int> list;
+
+    // Several threads keep the list always traversed: the writers must
+    //  not wait for them forever
+    ///////////////////////////////////////////////////////////////////
+    std::atomic<bool> bReading(true);
+    std::vector<std::thread> readThreads;
+    for(int thread(0); thread != 4; ++thread)
+    {
+        readThreads.push_back(std::thread([&list, &bReading]()
+        {
+            while(bReading.load())
+            {
+                nds::CopyOnWriteList<int>::Reader reader(list);
+                for(nds::CopyOnWriteList<int>::list_t::const_iterator scanList(reader.begin()), endList(reader.end()); scanList != endList; ++scanList)
+                {
+                    EXPECT_LE(0, *scanList);
+                }
+            }
+        }));
+    }
+
+    for(int element(0); element != 1000; ++element)
+    {
+        EXPECT_TRUE(list.insert(element));
+        if(element % 2 == 0)
+        {
+            EXPECT_TRUE(list.erase(element));
+        }
+    }
+
+    bReading.store(false);
+    for(std::vector<std::thread>::iterator scanThreads(readThreads.begin()), endThreads(readThreads.end()); scanThreads != endThreads; ++scanThreads)
+    {
+        scanThreads->join();
+    }
+
+    nds::CopyOnWriteList<int>::Reader reader(list);
+    EXPECT_EQ(500, std::distance(reader.begin(), reader.end()));
+}
+
+TEST(testPVs, testPushBatch)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("batchNode");
+    nds::PVVariableIn<std::int32_t> pushedPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("value"));
+    nds::PVVariableOut<std::int32_t> subscribedPV = rootNode.addChild(nds::PVVariableOut<std::int32_t>("subscribed"));
+    rootNode.initialize(0, factory);
+    factory.subscribe(pushedPV.getFullName(), subscribedPV.getFullName());
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("batchNode");
+
+    std::vector<timespec> timestamps(100);
+    std::vector<std::int32_t> values(100);
+    for(std::int32_t sample(0); sample != 100; ++sample)
+    {
+        timestamps[sample].tv_sec = 0;
+        timestamps[sample].tv_nsec = sample;
+        values[sample] = sample * 2;
+    }
+
+    // The whole block reaches the control system in one call
+    //////////////////////////////////////////////////////////
+    pushedPV.pushBatch(timestamps.data(), values.data(), 100);
+    EXPECT_EQ(1u, pInterface->getPushedBatches(pushedPV.getFullExternalName()));
+    for(std::int32_t sample(0); sample != 100; ++sample)
+    {
+        const timespec* pTimestamp;
+        const std::int32_t* pValue;
+        pInterface->getPushedInt32(pushedPV.getFullExternalName(), pTimestamp, pValue);
+        EXPECT_EQ(sample * 2, *pValue);
+        EXPECT_EQ(sample, pTimestamp->tv_nsec);
+    }
+    EXPECT_EQ(198, subscribedPV.getValue());
+
+    // Decimation continues across the blocks: push 100 samples in
+    //  two blocks with decimation 3
+    ///////////////////////////////////////////////////////////////
+    pushedPV.setDecimation(3);
+    pushedPV.pushBatch(timestamps.data(), values.data(), 50);
+    pushedPV.pushBatch(timestamps.data() + 50, values.data() + 50, 50);
+    EXPECT_EQ(3u, pInterface->getPushedBatches(pushedPV.getFullExternalName()));
+    for(std::int32_t sample(2); sample < 100; sample += 3)
+    {
+        const timespec* pTimestamp;
+        const std::int32_t* pValue;
+        pInterface->getPushedInt32(pushedPV.getFullExternalName(), pTimestamp, pValue);
+        EXPECT_EQ(sample * 2, *pValue);
+        EXPECT_EQ(sample, pTimestamp->tv_nsec);
+    }
+    const timespec* pTimestamp;
+    const std::int32_t* pValue;
+    EXPECT_THROW(pInterface->getPushedInt32(pushedPV.getFullExternalName(), pTimestamp, pValue), std::runtime_error);
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testPushAfterDeinitialize)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("deinitializedNode");
+    nds::PVVariableIn<std::int32_t> pushedPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("value"));
+    rootNode.initialize(0, factory);
+
+    timespec timestamp = {1, 0};
+    pushedPV.push(timestamp, 10);
+
+    // The deinitialized PV forgets its port and its interface
+    //////////////////////////////////////////////////////////
+    factory.destroyDevice("");
+    EXPECT_THROW(pushedPV.push(timestamp, 11), std::logic_error);
+}
+
+TEST(testPVs, testBulkRegistration)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("bulkRegistration");
+    rootNode.addChild(nds::PVVariableIn<std::int32_t>("value"));
+    for(size_t scanChannels(0); scanChannels != 4; ++scanChannels)
+    {
+        std::ostringstream channelName;
+        channelName << "channel" << scanChannels;
+        nds::Node channel = rootNode.addChild(nds::Node(channelName.str()));
+        channel.addChild(nds::PVVariableIn<std::int32_t>("input"));
+        channel.addChild(nds::PVVariableOut<std::int32_t>("output"));
+    }
+
+    // A nested port registers its own PVs
+    //////////////////////////////////////
+    nds::Port nestedPort = rootNode.addChild(nds::Port("nested"));
+    nestedPort.addChild(nds::PVVariableIn<std::int32_t>("value"));
+
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("bulkRegistration");
+    nds::tests::TestControlSystemInterfaceImpl* pNestedInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("bulkRegistration-nested");
+    EXPECT_EQ(1u, pInterface->getRegistrationBatches());
+    EXPECT_EQ(9u, pInterface->getRegisteredPVsAtTermination());
+    EXPECT_EQ(1u, pNestedInterface->getRegistrationBatches());
+    EXPECT_EQ(1u, pNestedInterface->getRegisteredPVsAtTermination());
+
+    timespec timestamp = {1, 0};
+    pInterface->writeCSValue("/bulkRegistration-channel2.output", timestamp, (std::int32_t)5);
+
+    factory.destroyDevice("");
+    EXPECT_EQ(0u, pInterface->getRegisteredPVsNumber());
+    EXPECT_EQ(0u, pNestedInterface->getRegisteredPVsNumber());
+}
+
+TEST(testPVs, testStatistics)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("statisticsNode");
+    nds::PVVariableIn<std::int32_t> pushedPV = rootNode.addChild(nds::PVVariableIn<std::int32_t>("value"));
+    nds::PVVariableOut<std::int32_t> writtenPV = rootNode.addChild(nds::PVVariableOut<std::int32_t>("setpoint"));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemFactoryImpl* pFactory = nds::tests::TestControlSystemFactoryImpl::getInstance();
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("statisticsNode");
+
+    // The statistics are disabled by default
+    /////////////////////////////////////////
+    nds::parameters_t parameters;
+    EXPECT_TRUE(pFactory->executeCommand("stats", rootNode.getFullName(), parameters).empty());
+
+    // Only the nodes have the statistics commands
+    //////////////////////////////////////////////
+    EXPECT_THROW(pFactory->executeCommand("stats", pushedPV.getFullName(), parameters), std::bad_function_call);
+
+    pFactory->executeCommand("enableStats", rootNode.getFullName(), parameters);
+
+    pushedPV.setDecimation(2);
+    timespec timestamp = {1, 0};
+    for(std::int32_t value(0); value != 10; ++value)
+    {
+        pushedPV.push(timestamp, value);
+    }
+
+    std::int32_t readValue;
+    pInterface->readCSValue(pushedPV.getFullExternalName(), &timestamp, &readValue);
+    pInterface->writeCSValue(writtenPV.getFullExternalName(), timestamp, (std::int32_t)3);
+    pInterface->writeCSValue(writtenPV.getFullExternalName(), timestamp, (std::int32_t)4);
+
+    nds::parameters_t statistics(pFactory->executeCommand("stats", rootNode.getFullName(), parameters));
+
+    bool bFoundPushed(false), bFoundInterfacePush(false), bFoundWritten(false);
+    for(nds::parameters_t::const_iterator scanStatistics(statistics.begin()), endStatistics(statistics.end());
+        scanStatistics != endStatistics;
+        ++scanStatistics)
+    {
+        if(scanStatistics->find(pushedPV.getFullName() + " pushes=10 ") == 0)
+        {
+            bFoundPushed = true;
+            EXPECT_NE(std::string::npos, scanStatistics->find(" decimated=5 "));
+            EXPECT_NE(std::string::npos, scanStatistics->find(" reads=1 "));
+        }
+        else if(scanStatistics->find(pushedPV.getFullName() + " interfacePush count=5 ") == 0)
+        {
+            bFoundInterfacePush = true;
+        }
+        else if(scanStatistics->find(writtenPV.getFullName() + " pushes=0 ") == 0)
+        {
+            bFoundWritten = true;
+            EXPECT_NE(std::string::npos, scanStatistics->find(" writes=2 "));
+        }
+    }
+    EXPECT_TRUE(bFoundPushed);
+    EXPECT_TRUE(bFoundInterfacePush);
+    EXPECT_TRUE(bFoundWritten);
+
+    pFactory->executeCommand("disableStats", rootNode.getFullName(), parameters);
+    EXPECT_TRUE(pFactory->executeCommand("stats", rootNode.getFullName(), parameters).empty());
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testHistory)
+{
+    nds::Factory factory("test");
+
+    nds::Port rootNode("historyNode");
+    nds::PVHistoryIn<std::int32_t> historyPV = rootNode.addChild(nds::PVHistoryIn<std::int32_t>("history", 5));
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("historyNode");
+
+    EXPECT_EQ(8, historyPV.getHistorySize());
+
+    std::vector<timespec> timestamps;
+    std::vector<std::int32_t> values;
+    EXPECT_EQ(0, historyPV.getLast(3, &timestamps, &values));
+
+    for(std::int32_t value(0); value != 20; ++value)
+    {
+        timespec timestamp = {value, 10};
+        historyPV.setValue(timestamp, value);
+    }
+
+    // The control system reads the last value
+    //////////////////////////////////////////
+    timespec readTimestamp;
+    std::int32_t readValue;
+    pInterface->readCSValue(historyPV.getFullExternalName(), &readTimestamp, &readValue);
+    EXPECT_EQ(19, readValue);
+    EXPECT_EQ(19, readTimestamp.tv_sec);
+
+    ASSERT_EQ(3, historyPV.getLast(3, &timestamps, &values));
+    EXPECT_EQ(17, values[0]);
+    EXPECT_EQ(19, values[2]);
+    EXPECT_EQ(17, timestamps[0].tv_sec);
+
+    // Only the last 8 values are kept
+    //////////////////////////////////
+    ASSERT_EQ(8, historyPV.getLast(100, &timestamps, &values));
+    EXPECT_EQ(12, values.front());
+    EXPECT_EQ(19, values.back());
+
+    timespec since = {15, 10};
+    ASSERT_EQ(4, historyPV.getSince(since, &timestamps, &values));
+    EXPECT_EQ(16, values.front());
+    EXPECT_EQ(16, timestamps.front().tv_sec);
+
+    since.tv_sec = 0;
+    EXPECT_EQ(8, historyPV.getSince(since, &timestamps, &values));
+
+    since.tv_sec = 19;
+    EXPECT_EQ(0, historyPV.getSince(since, &timestamps, &values));
+
+    factory.destroyDevice("");
+}
+
+TEST(testPVs, testHistoryConcurrentReads)
+{
+    nds::PVHistoryIn<std::vector<std::int32_t> > historyPV("history", 64);
+
+    const std::int32_t numValues(100000);
+    std::atomic<bool> bWriterDone(false);
+
+    std::thread writer([&historyPV, &bWriterDone, numValues]()
+    {
+        for(std::int32_t value(0); value != numValues; ++value)
+        {
+            timespec timestamp = {value, 0};
+            historyPV.setValue(timestamp, std::vector<std::int32_t>(4, value));
+        }
+        bWriterDone.store(true);
+    });
+
+    // The windows must contain increasing and consistent values
+    ////////////////////////////////////////////////////////////
+    std::vector<timespec> timestamps;
+    std::vector<std::vector<std::int32_t> > values;
+    bool bConsistent(true);
+    while(!bWriterDone.load() && bConsistent)
+    {
+        historyPV.getLast(32, &timestamps, &values);
+        for(size_t scanValues(0); scanValues != values.size(); ++scanValues)
+        {
+            bConsistent = bConsistent &&
+                    values[scanValues].size() == 4 &&
+                    values[scanValues][0] == values[scanValues][3] &&
+                    values[scanValues][0] == (std::int32_t)timestamps[scanValues].tv_sec &&
+                    (scanValues == 0 || values[scanValues][0] > values[scanValues - 1][0]);
+        }
+    }
+    writer.join();
+    EXPECT_TRUE(bConsistent);
+
+    ASSERT_EQ(32, historyPV.getLast(32, &timestamps, &values));
+    EXPECT_EQ(numValues - 1, values.back()[0]);
+}
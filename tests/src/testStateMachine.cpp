@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <nds3/nds.h>
 #include <functional>
+#include <future>
+#include <sstream>
+#include <vector>
 #include "ndsTestInterface.h"
 #include "ndsTestFactory.h"
 #include <unistd.h>
@@ -92,3 +95,251 @@ TEST(testStateMachine, testLocalGlobalState)
     factory.destroyDevice("");
 }
 
+
+void wait100msec()
+{
+    ::usleep(100000);
+}
+
+/*
+ * The transitions requested while another one is executing are queued
+ */
+TEST(testStateMachine, testQueuedTransitions)
+{
+    nds::Port rootNode("queuedTransitions");
+    nds::StateMachine stateMachine = rootNode.addChild(nds::StateMachine(true,
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+
+    nds::Factory factory("test");
+    rootNode.initialize(0, factory);
+
+    std::future<nds::state_t> switchOn = stateMachine.setState(nds::state_t::on);
+    EXPECT_EQ((int)nds::state_t::initializing, (int)stateMachine.getLocalState());
+
+    // Queued: the transitions are checked against the state reached by the
+    //  queued ones
+    std::future<nds::state_t> start = stateMachine.setState(nds::state_t::running);
+    EXPECT_EQ((int)nds::state_t::initializing, (int)stateMachine.getLocalState());
+    EXPECT_THROW(stateMachine.setState(nds::state_t::off), nds::StateMachineNoSuchTransition);
+    std::future<nds::state_t> stop = stateMachine.setState(nds::state_t::on);
+
+    // Already the queued state: the future is ready
+    std::future<nds::state_t> alreadyOn = stateMachine.setState(nds::state_t::on);
+    EXPECT_EQ((int)nds::state_t::on, (int)alreadyOn.get());
+
+    EXPECT_EQ((int)nds::state_t::on, (int)switchOn.get());
+    EXPECT_EQ((int)nds::state_t::running, (int)start.get());
+    EXPECT_EQ((int)nds::state_t::on, (int)stop.get());
+    EXPECT_EQ((int)nds::state_t::on, (int)stateMachine.getLocalState());
+
+    // The exceptions thrown by the transitions are stored in the futures
+    nds::Port rollbackNode("queuedRollback");
+    nds::StateMachine rollbackStateMachine = rollbackNode.addChild(nds::StateMachine(true,
+                                                                                     std::bind(&wait100msec),
+                                                                                     std::bind(&wait100msec),
+                                                                                     std::bind(&rollback),
+                                                                                     std::bind(&wait100msec),
+                                                                                     std::bind(&wait100msec),
+                                                                                     std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+    rollbackNode.initialize(0, factory);
+
+    rollbackStateMachine.setState(nds::state_t::on);
+    std::future<nds::state_t> failedStart = rollbackStateMachine.setState(nds::state_t::running);
+    std::future<nds::state_t> failedStop = rollbackStateMachine.setState(nds::state_t::on);
+    std::future<nds::state_t> switchOff = rollbackStateMachine.setState(nds::state_t::off);
+    EXPECT_THROW(failedStart.get(), nds::StateMachineRollBack);
+
+    // After the rollback the state is on: the queued stop is a no-op
+    EXPECT_EQ((int)nds::state_t::on, (int)failedStop.get());
+    EXPECT_EQ((int)nds::state_t::off, (int)switchOff.get());
+
+    factory.destroyDevice("");
+}
+
+/*
+ * A transition thread that cannot be started fails the queued transition
+ *  and restores the state
+ */
+TEST(testStateMachine, testTransitionThreadNotStarted)
+{
+    nds::Port rootNode("transitionThreadNotStarted");
+    nds::StateMachine stateMachine = rootNode.addChild(nds::StateMachine(true,
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&wait100msec),
+                                                                         std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+
+    nds::Factory factory("test");
+    rootNode.initialize(0, factory);
+
+    // A stack that cannot be allocated
+    nds::threadAttributes_t attributes;
+    attributes.m_stackSize = (size_t)1 << 62;
+    factory.setTaskClassAttributes(nds::taskClass_t::stateTransition, attributes);
+
+    std::future<nds::state_t> switchOn = stateMachine.setState(nds::state_t::on);
+    EXPECT_THROW(switchOn.get(), std::runtime_error);
+    EXPECT_EQ((int)nds::state_t::off, (int)stateMachine.getLocalState());
+
+    // The state machine accepts new transitions
+    factory.setTaskClassAttributes(nds::taskClass_t::stateTransition, nds::threadAttributes_t());
+    EXPECT_EQ((int)nds::state_t::on, (int)stateMachine.setState(nds::state_t::on).get());
+
+    factory.destroyDevice("");
+}
+
+void doNothing()
+{
+}
+
+/*
+ * The global state is updated when the children change state and is pushed
+ *  to the getGlobalState PV only when it changes
+ */
+TEST(testStateMachine, testGlobalStatePushed)
+{
+    nds::Port rootNode("globalStateRoot");
+    nds::StateMachine rootStateMachine = rootNode.addChild(nds::StateMachine(false,
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+
+    std::vector<nds::StateMachine> channelsStateMachines;
+    for(size_t scanChannels(0); scanChannels != 3; ++scanChannels)
+    {
+        std::ostringstream channelName;
+        channelName << "ch" << scanChannels;
+        nds::Node channel = rootNode.addChild(nds::Node(channelName.str()));
+        nds::Node group = channel.addChild(nds::Node("group"));
+        channelsStateMachines.push_back(group.addChild(nds::StateMachine(false,
+                                                                         std::bind(&doNothing),
+                                                                         std::bind(&doNothing),
+                                                                         std::bind(&doNothing),
+                                                                         std::bind(&doNothing),
+                                                                         std::bind(&doNothing),
+                                                                         std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3))));
+    }
+
+    nds::Factory factory("test");
+    rootNode.initialize(0, factory);
+
+    nds::tests::TestControlSystemInterfaceImpl* pInterface = nds::tests::TestControlSystemInterfaceImpl::getInstance("globalStateRoot");
+    const std::string globalStatePV("/globalStateRoot-StateMachine.getGlobalState");
+
+    EXPECT_EQ((int)nds::state_t::off, (int)rootStateMachine.getGlobalState());
+
+    // Switching on a channel changes the global state twice (initializing, on)
+    channelsStateMachines[1].setState(nds::state_t::on);
+    EXPECT_EQ((int)nds::state_t::on, (int)rootStateMachine.getGlobalState());
+    EXPECT_EQ((int)nds::state_t::off, (int)rootStateMachine.getLocalState());
+
+    const timespec* pTimestamp;
+    const std::int32_t* pState;
+    pInterface->getPushedInt32(globalStatePV, pTimestamp, pState);
+    EXPECT_EQ((std::int32_t)nds::state_t::initializing, *pState);
+    pInterface->getPushedInt32(globalStatePV, pTimestamp, pState);
+    EXPECT_EQ((std::int32_t)nds::state_t::on, *pState);
+
+    // Start a second channel, then stop it: the global state goes back to on
+    channelsStateMachines[2].setState(nds::state_t::on);
+    channelsStateMachines[2].setState(nds::state_t::running);
+    EXPECT_EQ((int)nds::state_t::running, (int)rootStateMachine.getGlobalState());
+    channelsStateMachines[2].setState(nds::state_t::on);
+    EXPECT_EQ((int)nds::state_t::on, (int)rootStateMachine.getGlobalState());
+
+    // Switching off one of the two channels that are on does not change the
+    //  global state
+    channelsStateMachines[1].setState(nds::state_t::off);
+    EXPECT_EQ((int)nds::state_t::on, (int)rootStateMachine.getGlobalState());
+    channelsStateMachines[2].setState(nds::state_t::off);
+    EXPECT_EQ((int)nds::state_t::off, (int)rootStateMachine.getGlobalState());
+
+    // The local state of the root contributes to the global state
+    rootStateMachine.setState(nds::state_t::on);
+    EXPECT_EQ((int)nds::state_t::on, (int)rootStateMachine.getGlobalState());
+    rootStateMachine.setState(nds::state_t::off);
+    EXPECT_EQ((int)nds::state_t::off, (int)rootStateMachine.getGlobalState());
+
+    // When the most recent channel leaves a state, the global state takes
+    //  the timestamp of the most recent channel still in that state
+    channelsStateMachines[1].setState(nds::state_t::on);
+    timespec firstOnTimestamp;
+    std::int32_t globalState;
+    pInterface->readCSValue(globalStatePV, &firstOnTimestamp, &globalState);
+
+    ::usleep(1000);
+    channelsStateMachines[2].setState(nds::state_t::on);
+    timespec secondOnTimestamp;
+    pInterface->readCSValue(globalStatePV, &secondOnTimestamp, &globalState);
+    EXPECT_TRUE(secondOnTimestamp.tv_sec > firstOnTimestamp.tv_sec ||
+                (secondOnTimestamp.tv_sec == firstOnTimestamp.tv_sec && secondOnTimestamp.tv_nsec > firstOnTimestamp.tv_nsec));
+
+    channelsStateMachines[2].setState(nds::state_t::off);
+    timespec globalStateTimestamp;
+    pInterface->readCSValue(globalStatePV, &globalStateTimestamp, &globalState);
+    EXPECT_EQ((std::int32_t)nds::state_t::on, globalState);
+    EXPECT_EQ(firstOnTimestamp.tv_sec, globalStateTimestamp.tv_sec);
+    EXPECT_EQ(firstOnTimestamp.tv_nsec, globalStateTimestamp.tv_nsec);
+
+    channelsStateMachines[1].setState(nds::state_t::off);
+
+    factory.destroyDevice("");
+}
+
+/*
+ * Read the global state from a PV subscribed to the getGlobalState PV
+ */
+static void readGlobalState(nds::StateMachine* pStateMachine, std::int32_t* pReadState, const timespec& /* timestamp */, const std::int32_t& /* value */)
+{
+    *pReadState = (std::int32_t)pStateMachine->getGlobalState();
+}
+
+/*
+ * The getGlobalState PV is pushed without holding the nodes' locks, so its
+ *  subscribers can read the global state
+ */
+TEST(testStateMachine, testGlobalStateReadWhilePushed)
+{
+    nds::Port rootNode("globalStateReader");
+    nds::StateMachine rootStateMachine = rootNode.addChild(nds::StateMachine(false,
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&doNothing),
+                                                                             std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+    nds::Node channel = rootNode.addChild(nds::Node("channel"));
+    nds::StateMachine channelStateMachine = channel.addChild(nds::StateMachine(false,
+                                                                               std::bind(&doNothing),
+                                                                               std::bind(&doNothing),
+                                                                               std::bind(&doNothing),
+                                                                               std::bind(&doNothing),
+                                                                               std::bind(&doNothing),
+                                                                               std::bind(&returnTrue, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)));
+
+    std::int32_t readState(-1);
+    rootNode.addChild(nds::PVDelegateOut<std::int32_t>("reader",
+                                                       std::bind(&readGlobalState, &rootStateMachine, &readState, std::placeholders::_1, std::placeholders::_2)));
+
+    nds::Factory factory("test");
+    rootNode.initialize(0, factory);
+    factory.subscribe("globalStateReader-StateMachine-getGlobalState", "globalStateReader-reader");
+
+    channelStateMachine.setState(nds::state_t::on);
+    EXPECT_EQ((std::int32_t)nds::state_t::on, readState);
+
+    channelStateMachine.setState(nds::state_t::off);
+    EXPECT_EQ((std::int32_t)nds::state_t::off, readState);
+
+    factory.destroyDevice("");
+}
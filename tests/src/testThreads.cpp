@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include <nds3/nds.h>
+#include <nds3/impl/threadPoolImpl.h>
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include "ndsTestFactory.h"
 
 
 void runInThreadFunction(std::int32_t* pCounter)
@@ -28,5 +33,152 @@ TEST(testThreads, testThreads)
     factory.destroyDevice("");
 }
 
+void storeAffinity(cpu_set_t* pAffinity)
+{
+    ::pthread_getaffinity_np(::pthread_self(), sizeof(*pAffinity), pAffinity);
+}
+
+TEST(testThreads, testThreadPoolReuse)
+{
+    nds::Factory factory("test");
+    nds::ThreadPoolImpl& pool(nds::tests::TestControlSystemFactoryImpl::getInstance()->getThreadPool());
+
+    std::int32_t counter(0);
+    nds::Thread firstThread = factory.runInThread("first", std::bind(&runInThreadFunction, &counter));
+    firstThread.join();
+    EXPECT_EQ(4, counter);
+
+    // The tasks started after the previous one completed
+    //  reuse its worker
+    /////////////////////////////////////////////////////
+    const size_t numWorkers(pool.getNumWorkers());
+    EXPECT_LE(1u, pool.getNumIdleWorkers());
+    for(int scanTasks(0); scanTasks != 10; ++scanTasks)
+    {
+        std::atomic<bool> bExecuted(false);
+        nds::Thread thread = factory.runInThread("housekeeping", nds::taskClass_t::housekeeping, [&bExecuted](){bExecuted.store(true);});
+        thread.join();
+        EXPECT_TRUE(bExecuted.load());
+    }
+    EXPECT_LE(pool.getNumWorkers(), numWorkers);
+}
+
+TEST(testThreads, testTaskClassAffinity)
+{
+    nds::Factory factory("test");
 
+    cpu_set_t allowedCpus;
+    ::sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus);
+    size_t firstCpu(0);
+    while(!CPU_ISSET(firstCpu, &allowedCpus))
+    {
+        ++firstCpu;
+    }
+
+    nds::threadAttributes_t attributes;
+    attributes.m_cpus.push_back(firstCpu);
+    factory.setTaskClassAttributes(nds::taskClass_t::housekeeping, attributes);
+
+    cpu_set_t taskAffinity;
+    CPU_ZERO(&taskAffinity);
+    nds::Thread thread = factory.runInThread("affinity", nds::taskClass_t::housekeeping, std::bind(&storeAffinity, &taskAffinity));
+    thread.join();
+    EXPECT_EQ(1, CPU_COUNT(&taskAffinity));
+    EXPECT_TRUE(CPU_ISSET(firstCpu, &taskAffinity));
+
+    factory.setTaskClassAttributes(nds::taskClass_t::housekeeping, nds::threadAttributes_t());
+}
+
+TEST(testThreads, testThreadAttributes)
+{
+    nds::Port rootNode("attributesNode");
+    nds::Factory factory("test");
+    rootNode.initialize(0, factory);
+
+    cpu_set_t allowedCpus;
+    ::sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus);
+    size_t firstCpu(0);
+    while(!CPU_ISSET(firstCpu, &allowedCpus))
+    {
+        ++firstCpu;
+    }
 
+    nds::threadAttributes_t attributes;
+    attributes.m_cpus.push_back(firstCpu);
+    attributes.m_policy = nds::schedulingPolicy_t::fifo;
+    attributes.m_priority = 10;
+    attributes.m_stackSize = 1024 * 1024;
+    attributes.m_bPrefaultStack = true;
+
+    std::int32_t counter(0);
+    nds::Thread thread = rootNode.runInThread("realTime", attributes, std::bind(&runInThreadFunction, &counter));
+    const nds::threadAttributes_t applied(thread.getAppliedAttributes());
+    thread.join();
+    EXPECT_EQ(4, counter);
+
+    ASSERT_EQ(1u, applied.m_cpus.size());
+    EXPECT_EQ(firstCpu, applied.m_cpus[0]);
+    EXPECT_LE(attributes.m_stackSize, applied.m_stackSize);
+    EXPECT_TRUE(applied.m_bPrefaultStack);
+    EXPECT_FALSE(applied.m_bLockMemory);
+
+    // Without CAP_SYS_NICE the thread keeps the default policy
+    ///////////////////////////////////////////////////////////
+    if(applied.m_policy == nds::schedulingPolicy_t::fifo)
+    {
+        EXPECT_EQ(10, applied.m_priority);
+    }
+    else
+    {
+        EXPECT_EQ(nds::schedulingPolicy_t::other, applied.m_policy);
+        EXPECT_EQ(0, applied.m_priority);
+    }
+
+    factory.destroyDevice("");
+}
+
+TEST(testThreads, testInheritedAttributes)
+{
+    nds::Factory factory("test");
+    nds::FactoryBaseImpl* pFactory(nds::tests::TestControlSystemFactoryImpl::getInstance());
+
+    cpu_set_t originalCpus;
+    ::pthread_getaffinity_np(::pthread_self(), sizeof(originalCpus), &originalCpus);
+    size_t lastCpu(CPU_SETSIZE - 1);
+    while(!CPU_ISSET(lastCpu, &originalCpus))
+    {
+        --lastCpu;
+    }
+
+    // Restrict the affinity as taskset would do: the workers started
+    //  afterwards keep it when the task class does not set one
+    /////////////////////////////////////////////////////////////////
+    cpu_set_t restrictedCpus;
+    CPU_ZERO(&restrictedCpus);
+    CPU_SET(lastCpu, &restrictedCpus);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(restrictedCpus), &restrictedCpus);
+
+    cpu_set_t taskAffinity;
+    CPU_ZERO(&taskAffinity);
+    std::atomic<bool> bCompleted(false);
+    {
+        nds::ThreadPoolImpl pool(1, std::chrono::milliseconds(1000));
+        std::unique_ptr<nds::ThreadBaseImpl> pThread(pool.run(pFactory, "inherited", nds::taskClass_t::housekeeping, std::bind(&storeAffinity, &taskAffinity)));
+        pThread->join();
+
+        std::unique_ptr<nds::ThreadBaseImpl> pSlowThread(pool.run(pFactory, "slow", nds::taskClass_t::housekeeping, [&bCompleted]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            bCompleted.store(true);
+        }));
+    }
+
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(originalCpus), &originalCpus);
+
+    EXPECT_EQ(1, CPU_COUNT(&taskAffinity));
+    EXPECT_TRUE(CPU_ISSET(lastCpu, &taskAffinity));
+
+    // The pool waits for its workers when it is destroyed
+    //////////////////////////////////////////////////////
+    EXPECT_TRUE(bCompleted.load());
+}